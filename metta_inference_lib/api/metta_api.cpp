@@ -1,9 +1,20 @@
 #include "metta_api.hpp"
 #include "metta_inference/inference_engine.hpp"
 #include "metta_inference/config.hpp"
+#include "metta_inference/module_watcher.hpp"
+#include "metta_inference/output_sink.hpp"
+#include "metta_inference/batch_export.hpp"
+#include "metta_inference/process_reactor.hpp"
+#include "metta_inference/request_coalescer.hpp"
+#include "metta_inference/inference_scheduler.hpp"
+#include "metta_inference/result_codec.hpp"
 #include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
 #include <fstream>
 #include <sstream>
+#include <utility>
 
 namespace metta_api {
 
@@ -14,9 +25,572 @@ class MettaAPI::Impl {
 public:
     mi::Config config;
     
+    // Replaced by enableModuleWatching while async requests read it
+    mutable std::mutex watcherMutex;
+    std::shared_ptr<mi::ModuleWatcher> watcher;
+    std::atomic<uint64_t> temporaryCount{0};
+    
+    // Reactor callbacks lock these, so they are declared before it and
+    // outlive it
+    mutable std::mutex schedulerMutex;
+    std::mutex coalescerMutex;
+    
+    // Created on the first async request. Declared before the scheduler and
+    // the coalescer, so it is destroyed after both: in-flight requests are
+    // failed and delivered while everything they touch is still there.
+    mutable std::mutex reactorMutex;
+    std::unique_ptr<mi::ProcessReactor> reactor;
+    
     Impl() {
         config.outputFormat = mi::OutputFormat::JSON;
     }
+    
+    ~Impl() {
+        // Shut down in order: flush waiting groups, then fail whatever is
+        // still queued while the reactor is there to deliver it. The
+        // reactor goes last, as a member.
+        std::shared_ptr<Coalescer> lastCoalescer;
+        {
+            std::lock_guard<std::mutex> lock(coalescerMutex);
+            lastCoalescer.swap(coalescer);
+        }
+        lastCoalescer.reset();
+        
+        std::shared_ptr<mi::InferenceScheduler> lastScheduler;
+        {
+            std::lock_guard<std::mutex> lock(schedulerMutex);
+            lastScheduler.swap(scheduler);
+        }
+        if (lastScheduler) {
+            lastScheduler->close();
+        }
+    }
+    
+    mi::ProcessReactor& asyncReactor() {
+        std::lock_guard<std::mutex> lock(reactorMutex);
+        if (!reactor) {
+            reactor = std::make_unique<mi::ProcessReactor>();
+        }
+        return *reactor;
+    }
+    
+    fs::path temporaryExamplePath() {
+        return fs::temp_directory_path() /
+               ("metta_api_example_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) +
+                "_" + std::to_string(temporaryCount.fetch_add(1)) + ".metta");
+    }
+    
+    // Example content goes through a file, as the REPL reads files
+    fs::path writeTemporaryExample(const std::string& content) {
+        fs::path tempFile = temporaryExamplePath();
+        
+        std::ofstream outFile(tempFile);
+        if (!outFile.is_open()) {
+            throw std::runtime_error("Failed to create temporary file");
+        }
+        outFile << content;
+        return tempFile;
+    }
+    
+    // submitted is when the request came in, for its deadline
+    mi::Config requestConfig(const fs::path& exampleFile, const InferenceRequest& request,
+                             std::chrono::steady_clock::time_point submitted) const {
+        auto localConfig = config;
+        localConfig.exampleFile = exampleFile;
+        localConfig.verbose = request.verbose;
+        localConfig.cancellation = request.cancellation;
+        if (request.deadline.count() > 0) {
+            localConfig.deadline = submitted + request.deadline;
+        }
+        localConfig.stopOnFirst = request.stopOnFirst;
+        
+        applyModules(localConfig, request);
+        applyMetricsDetail(localConfig, request);
+        
+        if (request.outputFormat == "pretty") {
+            localConfig.outputFormat = mi::OutputFormat::Pretty;
+        } else if (request.outputFormat == "json") {
+            localConfig.outputFormat = mi::OutputFormat::JSON;
+        } else if (request.outputFormat == "csv") {
+            localConfig.outputFormat = mi::OutputFormat::CSV;
+        } else if (request.outputFormat == "markdown") {
+            localConfig.outputFormat = mi::OutputFormat::Markdown;
+        } else if (request.outputFormat == "binary") {
+            localConfig.outputFormat = mi::OutputFormat::Binary;
+        }
+        return localConfig;
+    }
+    
+    // State of one async request, shared by the reactor callbacks
+    struct AsyncRun {
+        mi::InferenceScheduler::Slot slot;  // Released last, once everything else is done
+        mi::CancellationToken::Registration onCancel;  // While queued or sharing a coalesced run
+        std::chrono::milliseconds queueTime{0};
+        std::unique_ptr<mi::InferenceEngine> engine;
+        mi::InferenceEngine::PreparedRun prepared;
+        InferenceRequest request;
+        InferenceCallback callback;
+        fs::path temporaryExample;  // Written by runInferenceAsync; removed when done
+        std::chrono::steady_clock::time_point startTime;
+        
+        ~AsyncRun() {
+            if (!temporaryExample.empty()) {
+                std::error_code ec;
+                fs::remove(temporaryExample, ec);
+            }
+        }
+        
+        void deliver(InferenceResponse response) {
+            response.processingTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startTime).count();
+            response.queueTimeMs = queueTime.count();
+            callback(std::move(response));
+        }
+        
+        void deliverError(const std::string& error) {
+            InferenceResponse response;
+            response.error = error;
+            deliver(std::move(response));
+        }
+        
+        void deliverOverloaded(const std::string& reason) {
+            InferenceResponse response;
+            response.error = reason;
+            response.overloaded = true;
+            deliver(std::move(response));
+        }
+        
+        void deliverCancelled() {
+            InferenceResponse response;
+            response.error = mi::CancelledError().what();
+            response.cancelled = true;
+            deliver(std::move(response));
+        }
+        
+        void deliverFailure(std::exception_ptr error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const mi::CancelledError&) {
+                deliverCancelled();
+            } catch (const std::exception& e) {
+                deliverError(e.what());
+            }
+        }
+    };
+    
+    std::shared_ptr<mi::InferenceScheduler> scheduler;  // Set by enableScheduling
+    
+    std::shared_ptr<mi::InferenceScheduler> currentScheduler() const {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        return scheduler;
+    }
+    
+    // Calls launchRun once the scheduler admits the request, right away
+    // when scheduling is off. holder keeps the slot until it is done.
+    // Cancelling cancel while the request is queued takes it out of the
+    // queue and calls cancelled instead.
+    void schedule(const InferenceRequest& request, const std::shared_ptr<AsyncRun>& holder,
+                  const mi::CancellationToken& cancel, std::function<void()> launchRun,
+                  std::function<void(const std::string&)> reject, std::function<void()> cancelled) {
+        auto active = currentScheduler();
+        if (!active) {
+            launchRun();
+            return;
+        }
+        
+        // Registered before submitting, so a cancellation cannot slip in
+        // between; the ticket is known once submit returns
+        auto ticket = std::make_shared<std::atomic<uint64_t>>(0);
+        std::weak_ptr<mi::InferenceScheduler> weakScheduler = active;
+        auto withdraw = [this, weakScheduler, ticket, cancelled]() {
+            auto scheduler = weakScheduler.lock();
+            uint64_t queued = ticket->load();
+            if (scheduler && queued != 0 && scheduler->withdraw(queued)) {
+                asyncReactor().post(cancelled);
+            }
+        };
+        holder->onCancel = cancel.onCancel(withdraw);
+        
+        ticket->store(active->submit(mi::InferenceScheduler::parsePriority(request.priority), request.tenant,
+                       [holder, launchRun](mi::InferenceScheduler::Slot slot) {
+                           holder->onCancel.reset();
+                           holder->queueTime = slot.queueTime();
+                           holder->slot = std::move(slot);
+                           launchRun();
+                       },
+                       [this, holder, reject](const std::string& reason) {
+                           holder->onCancel.reset();
+                           // Delivered on a completion thread, like every other outcome
+                           asyncReactor().post([reject, reason]() { reject(reason); });
+                       }));
+        if (cancel.isCancelled()) {
+            withdraw();
+        }
+    }
+    
+    void scheduleRun(const std::shared_ptr<AsyncRun>& run, const fs::path& exampleFile) {
+        schedule(run->request, run, run->request.cancellation,
+                 [this, run, exampleFile]() { launch(run, exampleFile); },
+                 [run](const std::string& reason) { run->deliverOverloaded(reason); },
+                 [run]() { run->deliverCancelled(); });
+    }
+    
+    static std::shared_ptr<AsyncRun> makeRun(const InferenceRequest& request, InferenceCallback callback) {
+        auto run = std::make_shared<AsyncRun>();
+        run->startTime = std::chrono::steady_clock::now();
+        run->request = request;
+        run->callback = std::move(callback);
+        return run;
+    }
+    
+    void startAsync(const fs::path& exampleFile, const InferenceRequest& request,
+                    InferenceCallback callback, bool temporary) {
+        auto run = makeRun(request, std::move(callback));
+        if (temporary) {
+            run->temporaryExample = exampleFile;
+        }
+        scheduleRun(run, exampleFile);
+    }
+    
+    void launch(const std::shared_ptr<AsyncRun>& run, const fs::path& exampleFile) {
+        auto& executor = asyncReactor();
+        try {
+            if (!fs::exists(exampleFile)) {
+                throw std::runtime_error("File not found: " + exampleFile.string());
+            }
+            
+            run->engine = mi::createInferenceEngineV2(requestConfig(exampleFile, run->request, run->startTime));
+            run->prepared = run->engine->prepare(exampleFile);
+            
+            if (!run->prepared.ok()) {
+                // Reported like the blocking call does: success, error as raw output
+                executor.post([run]() {
+                    mi::InferenceEngine::Result result;
+                    result.rawOutput = run->prepared.error;
+                    InferenceResponse response;
+                    try {
+                        fillResponse(response, std::move(result), run->request);
+                    } catch (const std::exception& e) {
+                        run->deliverError(e.what());
+                        return;
+                    }
+                    run->deliver(std::move(response));
+                });
+                return;
+            }
+            
+            executor.submit(run->prepared.command, run->prepared.timeout,
+                            [run](mi::ProcessExecutor::ExecutionResult&& execution, std::exception_ptr error) {
+                if (error) {
+                    run->deliverFailure(error);
+                    return;
+                }
+                completeRun(*run, std::move(execution));
+            }, run->prepared.cancellation, run->prepared.observer, run->prepared.deadline);
+        } catch (const std::exception&) {
+            auto error = std::current_exception();
+            executor.post([run, error]() { run->deliverFailure(error); });
+        }
+    }
+    
+    static void completeRun(AsyncRun& run, mi::ProcessExecutor::ExecutionResult&& execution) {
+        InferenceResponse response;
+        try {
+            mi::InferenceEngine::Result result;
+            if (run.request.outputCallback) {
+                mi::CallbackSink sink(run.request.outputCallback);
+                result = run.engine->complete(run.prepared, std::move(execution), &sink);
+            } else {
+                result = run.engine->complete(run.prepared, std::move(execution), nullptr);
+            }
+            fillResponse(response, std::move(result), run.request);
+        } catch (const mi::CancelledError&) {
+            run.deliverCancelled();
+            return;
+        } catch (const std::exception& e) {
+            response.error = e.what();
+        }
+        run.deliver(std::move(response));
+    }
+    
+    using Coalescer = mi::RequestCoalescer<std::shared_ptr<AsyncRun>>;
+    
+    // Larger examples gain little from sharing a process
+    static constexpr size_t COALESCE_MAX_EXAMPLE = 16 * 1024;
+    
+    std::shared_ptr<Coalescer> coalescer;  // Set by enableRequestCoalescing
+    
+    std::shared_ptr<Coalescer> coalescerFor(const InferenceRequest& request) {
+        // Stopping early would cut short the requests sharing the run too
+        if (request.verbose || request.deadline.count() > 0 || request.stopOnFirst ||
+            request.exampleContent.size() > COALESCE_MAX_EXAMPLE) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(coalescerMutex);
+        return coalescer;
+    }
+    
+    // Requests only share a run when they load the same modules, are
+    // scheduled alike and bring the same rules, which the run shares
+    static std::string coalescingGroup(const InferenceRequest& request) {
+        std::string key = request.priority + '\n' + request.tenant + '\n';
+        for (const auto& path : request.modulePaths) {
+            key += path;
+            key += '\n';
+        }
+        key += '\n';
+        key += mi::sharedDefinitions(request.exampleContent);
+        return key;
+    }
+    
+    // Runs a request queued for coalescing by itself
+    void launchAlone(const std::shared_ptr<AsyncRun>& run) {
+        try {
+            run->temporaryExample = writeTemporaryExample(run->request.exampleContent);
+        } catch (const std::exception& e) {
+            std::string message = e.what();
+            asyncReactor().post([run, message]() { run->deliverError(message); });
+            return;
+        }
+        scheduleRun(run, run->temporaryExample);
+    }
+    
+    // Cancelled once every run is; never when one of them cannot be
+    static mi::CancellationToken sharedCancellation(const std::vector<std::shared_ptr<AsyncRun>>& runs) {
+        for (const auto& run : runs) {
+            if (!run->request.cancellation.canBeCancelled()) {
+                return {};
+            }
+        }
+        auto shared = mi::CancellationToken::create();
+        auto remaining = std::make_shared<std::atomic<size_t>>(runs.size());
+        for (const auto& run : runs) {
+            run->onCancel = run->request.cancellation.onCancel([shared, remaining]() mutable {
+                if (remaining->fetch_sub(1) == 1) {
+                    shared.cancel();
+                }
+            });
+        }
+        return shared;
+    }
+    
+    void launchCoalesced(std::vector<std::shared_ptr<AsyncRun>> runs) {
+        // Requests cancelled while they waited for their group are done
+        auto cancelled = std::partition(runs.begin(), runs.end(), [](const std::shared_ptr<AsyncRun>& run) {
+            return !run->request.cancellation.isCancelled();
+        });
+        for (auto it = cancelled; it != runs.end(); ++it) {
+            asyncReactor().post([run = *it]() { run->deliverCancelled(); });
+        }
+        runs.erase(cancelled, runs.end());
+        
+        if (runs.empty()) {
+            return;
+        }
+        if (runs.size() == 1) {
+            launchAlone(runs.front());
+            return;
+        }
+        
+        auto batch = std::make_shared<AsyncRun>();
+        std::shared_ptr<const mi::CoalescedLayout> layout;
+        auto cancellation = sharedCancellation(runs);
+        try {
+            std::vector<std::string> examples;
+            examples.reserve(runs.size());
+            for (const auto& run : runs) {
+                examples.push_back(run->request.exampleContent);
+            }
+            auto combined = mi::coalesceExamples(examples);
+            layout = std::make_shared<const mi::CoalescedLayout>(std::move(combined.layout));
+            
+            batch->temporaryExample = writeTemporaryExample(combined.content);
+            auto batchConfig = requestConfig(batch->temporaryExample, runs.front()->request,
+                                             runs.front()->startTime);
+            batchConfig.cancellation = cancellation;
+            batch->engine = mi::createInferenceEngineV2(batchConfig);
+            batch->prepared = batch->engine->prepare(batch->temporaryExample);
+        } catch (const std::exception&) {
+            batch->prepared.error = "coalescing failed";
+        }
+        
+        if (!batch->prepared.ok()) {
+            // Each request then reports the problem as it would alone
+            for (const auto& run : runs) {
+                launchAlone(run);
+            }
+            return;
+        }
+        
+        // The batch takes one scheduler slot, as it runs one process
+        auto deliverAll = [runs](auto deliver) {
+            for (const auto& run : runs) {
+                deliver(*run);
+            }
+        };
+        schedule(runs.front()->request, batch, cancellation,
+                 [this, runs, batch, layout]() { submitCoalesced(runs, batch, layout); },
+                 [deliverAll](const std::string& reason) {
+                     deliverAll([&reason](AsyncRun& run) { run.deliverOverloaded(reason); });
+                 },
+                 [deliverAll]() {
+                     deliverAll([](AsyncRun& run) { run.deliverCancelled(); });
+                 });
+    }
+    
+    void submitCoalesced(const std::vector<std::shared_ptr<AsyncRun>>& runs, const std::shared_ptr<AsyncRun>& batch,
+                         const std::shared_ptr<const mi::CoalescedLayout>& layout) {
+        for (const auto& run : runs) {
+            run->queueTime = batch->queueTime;
+        }
+        
+        auto& executor = asyncReactor();
+        try {
+            executor.submit(batch->prepared.command, batch->prepared.timeout,
+                            [this, runs, batch, layout](mi::ProcessExecutor::ExecutionResult&& execution,
+                                                        std::exception_ptr error) {
+                if (error) {
+                    for (const auto& run : runs) {
+                        run->deliverFailure(error);
+                    }
+                    return;
+                }
+                
+                std::vector<std::string> outputs;
+                try {
+                    if (execution.exitCode != 0) {
+                        throw std::runtime_error("Coalesced run failed");
+                    }
+                    outputs = mi::SemanticAnalyzer::demultiplex(execution.output, *layout);
+                } catch (const std::exception&) {
+                    // One bad example must not fail the others
+                    for (const auto& run : runs) {
+                        launchAlone(run);
+                    }
+                    return;
+                }
+                
+                for (size_t i = 0; i < runs.size(); ++i) {
+                    completeCoalesced(runs[i], std::move(outputs[i]), execution.duration);
+                }
+            }, batch->prepared.cancellation);
+        } catch (const std::exception& e) {
+            std::string message = e.what();
+            executor.post([runs, message]() {
+                for (const auto& run : runs) {
+                    run->deliverError(message);
+                }
+            });
+        }
+    }
+    
+    // Analysis and formatting as if the request's output came from its own run
+    void completeCoalesced(const std::shared_ptr<AsyncRun>& run, std::string output,
+                           std::chrono::milliseconds duration) {
+        try {
+            run->prepared.exampleFile = temporaryExamplePath();
+            run->engine = mi::createInferenceEngineV2(
+                requestConfig(run->prepared.exampleFile, run->request, run->startTime));
+        } catch (const std::exception& e) {
+            std::string message = e.what();
+            asyncReactor().post([run, message]() { run->deliverError(message); });
+            return;
+        }
+        
+        // Spread analysis of the batch over the completion threads
+        asyncReactor().post([run, output = std::move(output), duration]() mutable {
+            completeRun(*run, mi::ProcessExecutor::ExecutionResult{std::move(output), 0, duration});
+        });
+    }
+    
+    // Requests that bring their own module paths bypass the watcher
+    void applyModules(mi::Config& localConfig, const InferenceRequest& request) const {
+        if (!request.modulePaths.empty()) {
+            localConfig.modulePaths.clear();
+            for (const auto& path : request.modulePaths) {
+                localConfig.modulePaths.push_back(fs::path(path));
+            }
+        } else if (auto active = currentWatcher()) {
+            localConfig.moduleSnapshot = active->current();
+        }
+    }
+    
+    std::shared_ptr<mi::ModuleWatcher> currentWatcher() const {
+        std::lock_guard<std::mutex> lock(watcherMutex);
+        return watcher;
+    }
+    
+    static void applyMetricsDetail(mi::Config& localConfig, const InferenceRequest& request) {
+        if (request.metricsDetail == "full") {
+            localConfig.metricsDetail = mi::MetricsDetail::Full;
+        } else if (request.metricsDetail == "counts") {
+            localConfig.metricsDetail = mi::MetricsDetail::CountsOnly;
+        } else {
+            localConfig.metricsDetail = mi::MetricsDetail::Lazy;
+        }
+    }
+    
+    static void fillFindings(InferenceResponse& response, const mi::Metrics& metrics) {
+        auto& findings = response.findings;
+        findings.reserve(metrics.contradictionDetails.size() + metrics.conflictDetails.size() +
+                         metrics.violationDetails.size() + metrics.inferredStateOfAffairs.size());
+        for (size_t i = 0; i < metrics.contradictionDetails.size(); ++i) {
+            const auto& detail = metrics.contradictionDetails[i];
+            findings.push_back({"contradiction", detail.entity1, detail.entity2, metrics.contradictionDescription(i)});
+        }
+        for (size_t i = 0; i < metrics.conflictDetails.size(); ++i) {
+            const auto& detail = metrics.conflictDetails[i];
+            findings.push_back({"conflict", detail.entity1, detail.entity2, metrics.conflictDescription(i)});
+        }
+        for (size_t i = 0; i < metrics.violationDetails.size(); ++i) {
+            const auto& detail = metrics.violationDetails[i];
+            findings.push_back({"violation", detail.violator, detail.violated_rule, metrics.violationDescription(i)});
+        }
+        for (const auto& fact : metrics.inferredStateOfAffairs) {
+            findings.push_back({"inferred_fact", fact, "", ""});
+        }
+    }
+    
+    // Moves the engine result into the response; nothing large is copied
+    static void fillResponse(InferenceResponse& response, mi::InferenceEngine::Result&& result,
+                             const InferenceRequest& request) {
+        response.success = true;
+        response.metrics.contradictions = result.metrics.contradictions;
+        response.metrics.compliances = result.metrics.compliances;
+        response.metrics.conflicts = result.metrics.conflicts;
+        response.metrics.violations = result.metrics.violations;
+        response.formattedOutput = std::move(result.formattedOutput);
+        response.hasLogicalIssues = result.hasLogicalIssues;
+        response.partial = result.metrics.partial;
+        response.coverage = result.metrics.coverage;
+        
+        if (request.rawOutputMode == "shared") {
+            response.sharedRawOutput = std::make_shared<const std::string>(std::move(result.rawOutput));
+        } else if (request.rawOutputMode == "shm") {
+            // The one copy the output makes on its way to other processes;
+            // descriptions are rendered only for callers that read findings
+            response.sharedResult = SharedResult::create(
+                mi::ResultCodec::encode(result.metrics, request.includeFindings), result.rawOutput);
+            std::string().swap(result.rawOutput);
+        } else if (request.rawOutputMode == "omit") {
+            std::string().swap(result.rawOutput);
+        } else {
+            response.rawOutput = std::move(result.rawOutput);
+        }
+        
+        if (request.includeFindings) {
+            fillFindings(response, result.metrics);
+        }
+    }
+    
+    mi::InferenceEngine::Result runEngine(mi::InferenceEngine& engine, const fs::path& exampleFile,
+                                          const InferenceRequest& request) const {
+        if (!request.outputCallback) {
+            return engine.run(exampleFile);
+        }
+        mi::CallbackSink sink(request.outputCallback);
+        return engine.run(exampleFile, sink);
+    }
 };
 
 MettaAPI::MettaAPI() : pImpl(std::make_unique<Impl>()) {}
@@ -31,72 +605,89 @@ void MettaAPI::setDefaultModulePaths(const std::vector<std::string>& paths) {
     for (const auto& path : paths) {
         pImpl->config.modulePaths.push_back(fs::path(path));
     }
+    
+    // Re-point an active watcher at the new directories
+    if (pImpl->currentWatcher()) {
+        enableModuleWatching(true);
+    }
 }
 
 void MettaAPI::setVerbose(bool verbose) {
     pImpl->config.verbose = verbose;
 }
 
+void MettaAPI::setInferenceConfigFile(const std::string& path) {
+    // Load it now, so a bad file fails here rather than every request
+    mi::Config loading = pImpl->config;
+    loading.inferenceConfig.reset();
+    loading.inferenceConfigFile = path;
+    mi::captureInferenceConfiguration(loading);
+    pImpl->config.inferenceConfigFile = path;
+}
+
+void MettaAPI::setOutputDir(const std::string& path) {
+    pImpl->config.outputDir = path;
+}
+
+void MettaAPI::enableModuleWatching(bool enable) {
+    std::shared_ptr<mi::ModuleWatcher> replacement;
+    if (enable) {
+        replacement = std::make_shared<mi::ModuleWatcher>(pImpl->config.modulePaths);
+        replacement->start();
+    }
+    
+    // Requests that already took the old watcher keep it alive until they
+    // are done with it; it is stopped outside the lock
+    std::shared_ptr<mi::ModuleWatcher> previous;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->watcherMutex);
+        previous = std::exchange(pImpl->watcher, std::move(replacement));
+    }
+}
+
+uint64_t MettaAPI::moduleSnapshotVersion() const {
+    auto active = pImpl->currentWatcher();
+    return active ? active->version() : 0;
+}
+
+uint64_t MettaAPI::inferenceConfigGeneration() const {
+    return mi::captureInferenceConfiguration(pImpl->config)->stats.generation;
+}
+
 InferenceResponse MettaAPI::runInference(const InferenceRequest& request) {
+    // Concurrent blocking callers share REPL runs too, except from a
+    // callback of an async request: it would wait on the threads and the
+    // scheduler slot its own request holds
+    if ((pImpl->coalescerFor(request) || pImpl->currentScheduler()) &&
+        !mi::ProcessReactor::onReactorThread()) {
+        return runInferenceAsync(request).get();
+    }
+    
     InferenceResponse response;
     auto startTime = std::chrono::steady_clock::now();
     
     try {
         // Create temporary file with example content
-        fs::path tempFile = fs::temp_directory_path() / 
-                           ("metta_api_example_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".metta");
-        
-        std::ofstream outFile(tempFile);
-        if (!outFile.is_open()) {
-            response.error = "Failed to create temporary file";
-            return response;
-        }
-        outFile << request.exampleContent;
-        outFile.close();
-        
-        // Set up config
-        auto localConfig = pImpl->config;
-        localConfig.exampleFile = tempFile;
-        localConfig.verbose = request.verbose;
-        
-        if (!request.modulePaths.empty()) {
-            localConfig.modulePaths.clear();
-            for (const auto& path : request.modulePaths) {
-                localConfig.modulePaths.push_back(fs::path(path));
-            }
-        }
-        
-        if (request.outputFormat == "pretty") {
-            localConfig.outputFormat = mi::OutputFormat::Pretty;
-        } else if (request.outputFormat == "json") {
-            localConfig.outputFormat = mi::OutputFormat::JSON;
-        } else if (request.outputFormat == "csv") {
-            localConfig.outputFormat = mi::OutputFormat::CSV;
-        } else if (request.outputFormat == "markdown") {
-            localConfig.outputFormat = mi::OutputFormat::Markdown;
-        }
+        fs::path tempFile = pImpl->writeTemporaryExample(request.exampleContent);
+        auto localConfig = pImpl->requestConfig(tempFile, request, startTime);
         
         // Run inference with V2 engine (S-expression parsing)
         auto engine = mi::createInferenceEngineV2(localConfig);
-        auto result = engine->run(tempFile);
+        auto result = pImpl->runEngine(*engine, tempFile, request);
         
         // Clean up temp file
         fs::remove(tempFile);
         
         // Fill response
-        response.success = true;
-        response.metrics.contradictions = result.metrics.contradictions;
-        response.metrics.compliances = result.metrics.compliances;
-        response.metrics.conflicts = result.metrics.conflicts;
-        response.metrics.violations = result.metrics.violations;
-        response.formattedOutput = result.formattedOutput;
-        response.rawOutput = result.rawOutput;
-        response.hasLogicalIssues = result.hasLogicalIssues;
+        Impl::fillResponse(response, std::move(result), request);
         
         auto endTime = std::chrono::steady_clock::now();
         response.processingTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
             endTime - startTime).count();
         
+    } catch (const mi::CancelledError& e) {
+        response.error = e.what();
+        response.cancelled = true;
     } catch (const std::exception& e) {
         response.error = e.what();
         response.success = false;
@@ -107,6 +698,10 @@ InferenceResponse MettaAPI::runInference(const InferenceRequest& request) {
 
 InferenceResponse MettaAPI::runInferenceFromFile(const std::string& filePath, 
                                                  const InferenceRequest& request) {
+    if (pImpl->currentScheduler() && !mi::ProcessReactor::onReactorThread()) {
+        return runInferenceFromFileAsync(filePath, request).get();
+    }
+    
     InferenceResponse response;
     auto startTime = std::chrono::steady_clock::now();
     
@@ -117,48 +712,22 @@ InferenceResponse MettaAPI::runInferenceFromFile(const std::string& filePath,
             return response;
         }
         
-        // Set up config
-        auto localConfig = pImpl->config;
-        localConfig.exampleFile = fs::path(filePath);
-        localConfig.verbose = request.verbose;
-        
-        if (!request.modulePaths.empty()) {
-            localConfig.modulePaths.clear();
-            for (const auto& path : request.modulePaths) {
-                localConfig.modulePaths.push_back(fs::path(path));
-            }
-        }
-        
-        if (!request.outputFormat.empty()) {
-            if (request.outputFormat == "pretty") {
-                localConfig.outputFormat = mi::OutputFormat::Pretty;
-            } else if (request.outputFormat == "json") {
-                localConfig.outputFormat = mi::OutputFormat::JSON;
-            } else if (request.outputFormat == "csv") {
-                localConfig.outputFormat = mi::OutputFormat::CSV;
-            } else if (request.outputFormat == "markdown") {
-                localConfig.outputFormat = mi::OutputFormat::Markdown;
-            }
-        }
+        auto localConfig = pImpl->requestConfig(fs::path(filePath), request, startTime);
         
         // Run inference with V2 engine (S-expression parsing)
         auto engine = mi::createInferenceEngineV2(localConfig);
-        auto result = engine->run(localConfig.exampleFile);
+        auto result = pImpl->runEngine(*engine, localConfig.exampleFile, request);
         
         // Fill response
-        response.success = true;
-        response.metrics.contradictions = result.metrics.contradictions;
-        response.metrics.compliances = result.metrics.compliances;
-        response.metrics.conflicts = result.metrics.conflicts;
-        response.metrics.violations = result.metrics.violations;
-        response.formattedOutput = result.formattedOutput;
-        response.rawOutput = result.rawOutput;
-        response.hasLogicalIssues = result.hasLogicalIssues;
+        Impl::fillResponse(response, std::move(result), request);
         
         auto endTime = std::chrono::steady_clock::now();
         response.processingTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
             endTime - startTime).count();
         
+    } catch (const mi::CancelledError& e) {
+        response.error = e.what();
+        response.cancelled = true;
     } catch (const std::exception& e) {
         response.error = e.what();
         response.success = false;
@@ -167,6 +736,99 @@ InferenceResponse MettaAPI::runInferenceFromFile(const std::string& filePath,
     return response;
 }
 
+std::future<InferenceResponse> MettaAPI::runInferenceAsync(const InferenceRequest& request) {
+    auto promise = std::make_shared<std::promise<InferenceResponse>>();
+    auto future = promise->get_future();
+    runInferenceAsync(request, [promise](InferenceResponse response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+std::future<InferenceResponse> MettaAPI::runInferenceFromFileAsync(const std::string& filePath,
+                                                                   const InferenceRequest& request) {
+    auto promise = std::make_shared<std::promise<InferenceResponse>>();
+    auto future = promise->get_future();
+    runInferenceFromFileAsync(filePath, request, [promise](InferenceResponse response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+void MettaAPI::enableScheduling(bool enable, const SchedulingOptions& options) {
+    std::shared_ptr<mi::InferenceScheduler> replacement;
+    if (enable) {
+        mi::InferenceScheduler::Options schedulerOptions;
+        schedulerOptions.maxConcurrent = options.maxConcurrent;
+        schedulerOptions.maxBatchConcurrent = options.maxBatchConcurrent;
+        schedulerOptions.maxPerTenant = options.maxPerTenant;
+        schedulerOptions.maxQueued = options.maxQueued;
+        replacement = mi::InferenceScheduler::create(schedulerOptions);
+    }
+    // A replaced scheduler still starts what it has queued as its runs finish
+    std::lock_guard<std::mutex> lock(pImpl->schedulerMutex);
+    pImpl->scheduler.swap(replacement);
+}
+
+SchedulingStats MettaAPI::schedulingStats() const {
+    SchedulingStats stats;
+    if (auto active = pImpl->currentScheduler()) {
+        auto current = active->stats();
+        stats.running = current.running;
+        stats.queued = current.queued;
+        stats.started = current.started;
+        stats.rejected = current.rejected;
+    }
+    return stats;
+}
+
+void MettaAPI::runInferenceAsync(const InferenceRequest& request, InferenceCallback callback) {
+    if (auto coalescer = pImpl->coalescerFor(request)) {
+        coalescer->add(Impl::coalescingGroup(request), Impl::makeRun(request, std::move(callback)));
+        return;
+    }
+    
+    fs::path tempFile;
+    try {
+        tempFile = pImpl->writeTemporaryExample(request.exampleContent);
+    } catch (const std::exception& e) {
+        std::string message = e.what();
+        pImpl->asyncReactor().post([callback = std::move(callback), message]() {
+            InferenceResponse response;
+            response.error = message;
+            callback(std::move(response));
+        });
+        return;
+    }
+    pImpl->startAsync(tempFile, request, std::move(callback), true);
+}
+
+void MettaAPI::runInferenceFromFileAsync(const std::string& filePath, const InferenceRequest& request,
+                                         InferenceCallback callback) {
+    pImpl->startAsync(fs::path(filePath), request, std::move(callback), false);
+}
+
+void MettaAPI::enableRequestCoalescing(bool enable, std::chrono::milliseconds window, size_t maxBatch) {
+    std::shared_ptr<Impl::Coalescer> replaced;
+    if (enable) {
+        replaced = std::make_shared<Impl::Coalescer>(
+            Impl::Coalescer::Options{window, maxBatch},
+            [impl = pImpl.get()](std::vector<std::shared_ptr<Impl::AsyncRun>> runs) {
+                impl->launchCoalesced(std::move(runs));
+            });
+    }
+    {
+        std::lock_guard<std::mutex> lock(pImpl->coalescerMutex);
+        pImpl->coalescer.swap(replaced);
+    }
+    // The previous coalescer flushes what it still holds on destruction
+}
+
+size_t MettaAPI::asyncInFlight() const {
+    std::lock_guard<std::mutex> lock(pImpl->reactorMutex);
+    return pImpl->reactor ? pImpl->reactor->inFlight() : 0;
+}
+
 bool MettaAPI::validateModulePath(const std::string& path) const {
     return fs::exists(path) && fs::is_directory(path);
 }
@@ -219,15 +881,70 @@ std::vector<BatchProcessor::BatchResult> BatchProcessor::processFiles(
     const InferenceRequest& baseRequest) {
     
     std::vector<BatchResult> results;
+    results.reserve(files.size());
     
     for (const auto& file : files) {
-        BatchResult result;
+        BatchResult& result = results.emplace_back();
         result.filename = fs::path(file).filename().string();
         result.response = api.runInferenceFromFile(file, baseRequest);
-        results.push_back(result);
     }
     
     return results;
 }
 
-}
\ No newline at end of file
+BatchProcessor::ExportSummary BatchProcessor::exportFiles(
+    const std::vector<std::string>& files,
+    const InferenceRequest& baseRequest,
+    const std::string& outputPath,
+    const std::string& format) {
+    
+    auto exportFormat = format == "csv" ? mi::BatchExportFormat::CSV : mi::BatchExportFormat::Columnar;
+    
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open export file: " + outputPath);
+    }
+    out.exceptions(std::ios::badbit);
+    
+    mi::StreamSink sink(out);
+    auto exporter = mi::BatchExporter::create(exportFormat, sink);
+    
+    InferenceRequest request = baseRequest;
+    request.includeFindings = true;
+    request.rawOutputMode = "omit";
+    if (!request.outputCallback) {
+        // Only the findings are exported; don't keep each formatted report
+        request.outputCallback = [](std::string_view) {};
+    }
+    
+    ExportSummary summary;
+    for (const auto& file : files) {
+        std::string filename = fs::path(file).filename().string();
+        auto response = api.runInferenceFromFile(file, request);
+        
+        ++summary.files;
+        if (!response.success) {
+            ++summary.failed;
+            exporter->addRow({filename, "error", response.error, {}, {}});
+            continue;
+        }
+        for (const auto& finding : response.findings) {
+            exporter->addRow({filename, finding.kind, finding.subject, finding.object, finding.description});
+        }
+    }
+    
+    exporter->finish();
+    summary.rows = exporter->rowCount();
+    return summary;
+}
+
+BatchProcessor::ExportSummary BatchProcessor::exportDirectory(
+    const std::string& directory,
+    const InferenceRequest& baseRequest,
+    const std::string& outputPath,
+    const std::string& format) {
+    
+    return exportFiles(api.listMettaFiles(directory), baseRequest, outputPath, format);
+}
+
+}
@@ -1,19 +1,70 @@
 #ifndef METTA_API_HPP
 #define METTA_API_HPP
 
+#include "metta_inference/cancellation.hpp"
+#include "metta_shared_result.hpp"
 #include <string>
 #include <vector>
 #include <optional>
 #include <memory>
 #include <filesystem>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <future>
+#include <chrono>
 
 namespace metta_api {
 
+using CancellationToken = metta_inference::CancellationToken;
+
 struct InferenceRequest {
     std::string exampleContent;
     std::vector<std::string> modulePaths;
     std::string outputFormat = "json";
     bool verbose = false;
+    
+    // "lazy" renders finding descriptions only if the output format needs
+    // them; "counts" skips details entirely (metrics and threshold checks
+    // only); "full" renders every description up front
+    std::string metricsDetail = "lazy";
+    
+    // Fill InferenceResponse::findings (renders descriptions)
+    bool includeFindings = false;
+    
+    // What happens to the REPL output: "include" moves it into
+    // InferenceResponse::rawOutput, "shared" hands it out as an immutable
+    // shared buffer (sharedRawOutput), "omit" drops it after analysis.
+    // "shm" places it, with the binary-encoded metrics, in a sealed
+    // shared-memory segment (sharedResult) that other local processes can
+    // map; through MettaClient the daemon passes the segment itself.
+    std::string rawOutputMode = "include";
+    
+    // Scheduling class, "interactive", "normal" or "batch", and who the
+    // request is for; used once MettaAPI::enableScheduling is on
+    std::string priority = "normal";
+    std::string tenant;
+    
+    // Set to CancellationToken::create() to be able to cancel the request.
+    // cancel() stops it wherever it is: queued, running (the REPL's process
+    // group is killed) or being analyzed, and the response comes back with
+    // InferenceResponse::cancelled set. One token may cover many requests.
+    CancellationToken cancellation;
+    
+    // Time allowed from submission, queueing included; 0 for no limit. A
+    // REPL still running when it runs out is stopped, and the response
+    // carries the findings from the results printed so far, with partial
+    // and coverage set, instead of failing.
+    std::chrono::milliseconds deadline{0};
+    
+    // Stop inference at the first contradiction, conflict or violation in
+    // the REPL output, for yes/no checks; a response that stopped there is
+    // partial, with findings from the results printed up to it
+    bool stopOnFirst = false;
+    
+    // When set, the formatted report is delivered here in chunks as it is
+    // written and InferenceResponse::formattedOutput stays empty
+    std::function<void(std::string_view)> outputCallback;
 };
 
 struct InferenceMetrics {
@@ -27,14 +78,59 @@ struct InferenceMetrics {
     }
 };
 
+struct InferenceFinding {
+    std::string kind;         // "contradiction", "conflict", "violation" or "inferred_fact"
+    std::string subject;
+    std::string object;
+    std::string description;
+};
+
+// Move-only, like the engine result it is built from: outputs are moved
+// through, never copied
 struct InferenceResponse {
     bool success = false;
     std::string error;
     InferenceMetrics metrics;
+    std::vector<InferenceFinding> findings;  // Only with InferenceRequest::includeFindings
     std::string formattedOutput;
-    std::string rawOutput;
+    std::string rawOutput;                                  // rawOutputMode "include"
+    std::shared_ptr<const std::string> sharedRawOutput;     // rawOutputMode "shared"
+    std::shared_ptr<const SharedResult> sharedResult;       // rawOutputMode "shm"
     bool hasLogicalIssues = false;
-    double processingTimeMs = 0.0;
+    double processingTimeMs = 0.0;      // Includes queueTimeMs
+    double queueTimeMs = 0.0;           // Waiting for the scheduler to admit the request
+    bool overloaded = false;            // Shed by the scheduler (see error); retry later
+    bool cancelled = false;             // Stopped through InferenceRequest::cancellation
+    bool partial = false;               // Stopped at the deadline or, with stopOnFirst, at a finding
+    double coverage = 1.0;              // Share of the REPL's results a partial response covers
+    
+    InferenceResponse() = default;
+    InferenceResponse(InferenceResponse&&) = default;
+    InferenceResponse& operator=(InferenceResponse&&) = default;
+    InferenceResponse(const InferenceResponse&) = delete;
+    InferenceResponse& operator=(const InferenceResponse&) = delete;
+    
+    // The REPL output in any mode (empty when omitted)
+    std::string_view raw() const {
+        if (sharedResult) return sharedResult->rawOutput();
+        return sharedRawOutput ? std::string_view(*sharedRawOutput) : std::string_view(rawOutput);
+    }
+};
+
+using InferenceCallback = std::function<void(InferenceResponse)>;
+
+struct SchedulingOptions {
+    size_t maxConcurrent = 0;       // REPL processes at once; 0: one per core
+    size_t maxBatchConcurrent = 0;  // Of those, for "batch" requests; 0: half
+    size_t maxPerTenant = 0;        // 0: unlimited; requests without a tenant are exempt
+    size_t maxQueued = 1024;        // Requests waiting beyond this are shed
+};
+
+struct SchedulingStats {
+    size_t running = 0;
+    size_t queued = 0;
+    uint64_t started = 0;
+    uint64_t rejected = 0;
 };
 
 class MettaAPI {
@@ -46,10 +142,68 @@ public:
     void setDefaultModulePaths(const std::vector<std::string>& paths);
     void setVerbose(bool verbose);
     
+    // Entity mappings and description templates come from this JSON file
+    // instead of the default location, reloaded when it changes. Throws
+    // std::runtime_error when it cannot be loaded.
+    void setInferenceConfigFile(const std::string& path);
+    
+    // Where reports go (Config::outputDir). Without an inference config
+    // file, config/inference_config.json next to it is used, as for a
+    // single metta_cli run.
+    void setOutputDir(const std::string& path);
+    
+    // Watch the default module paths and serve requests from an in-memory
+    // snapshot that is swapped when module files change
+    void enableModuleWatching(bool enable = true);
+    uint64_t moduleSnapshotVersion() const;
+    
+    // Generation of the inference configuration new requests use, after
+    // picking up changes to its file; throws like setInferenceConfigFile
+    uint64_t inferenceConfigGeneration() const;
+    
+    // Blocking runs. With scheduling or coalescing on they go through the
+    // async path, except when called from a callback, which runs them
+    // directly on its completion thread.
     InferenceResponse runInference(const InferenceRequest& request);
     InferenceResponse runInferenceFromFile(const std::string& filePath, 
                                           const InferenceRequest& request = {});
     
+    // Non-blocking variants. Module preparation happens on the calling
+    // thread; the REPL processes of all in-flight requests are then
+    // multiplexed by one reactor thread, and analysis, formatting and
+    // callbacks run on a small pool of completion threads (one per core).
+    // Callbacks should not block; errors arrive in the response as with
+    // the blocking calls. A cancelled request is answered right away when
+    // it was still queued, otherwise as soon as its process is killed.
+    std::future<InferenceResponse> runInferenceAsync(const InferenceRequest& request);
+    std::future<InferenceResponse> runInferenceFromFileAsync(const std::string& filePath,
+                                                             const InferenceRequest& request = {});
+    void runInferenceAsync(const InferenceRequest& request, InferenceCallback callback);
+    void runInferenceFromFileAsync(const std::string& filePath, const InferenceRequest& request,
+                                   InferenceCallback callback);
+    
+    // REPL processes currently running for async requests
+    size_t asyncInFlight() const;
+    
+    // Run small concurrent requests (exampleContent up to 16 KiB) together:
+    // requests with the same modules that arrive within window of each
+    // other share one REPL process, up to maxBatch at a time, and each
+    // gets back only its own results. Applies to runInference and
+    // runInferenceAsync; verbose requests always run alone. A shared
+    // process is killed only once every request in it is cancelled;
+    // until then a cancelled request is answered when the process ends.
+    void enableRequestCoalescing(bool enable = true,
+                                 std::chrono::milliseconds window = std::chrono::milliseconds(5),
+                                 size_t maxBatch = 16);
+    
+    // Admission control for all requests: they queue by priority class and
+    // start within the concurrency limits, interactive first, with batch
+    // work capped so it cannot take every slot. Requests that do not fit
+    // the queue fail with InferenceResponse::overloaded set. Blocking calls
+    // are scheduled too.
+    void enableScheduling(bool enable = true, const SchedulingOptions& options = {});
+    SchedulingStats schedulingStats() const;
+    
     bool validateModulePath(const std::string& path) const;
     bool validateMettaReplPath(const std::string& path) const;
     
@@ -64,6 +218,7 @@ class BatchProcessor {
 public:
     BatchProcessor(MettaAPI& api);
     
+    // Move-only, as it holds an InferenceResponse
     struct BatchResult {
         std::string filename;
         InferenceResponse response;
@@ -75,6 +230,26 @@ public:
     std::vector<BatchResult> processFiles(const std::vector<std::string>& files,
                                          const InferenceRequest& baseRequest);
     
+    struct ExportSummary {
+        size_t files = 0;
+        size_t failed = 0;
+        size_t rows = 0;
+    };
+    
+    // Streams the findings of every file into one export at outputPath,
+    // one row per finding (failures become "error" rows). format is
+    // "columnar" (dictionary-encoded, see ColumnarBatchReader) or "csv".
+    // Throws std::runtime_error when the output cannot be written.
+    ExportSummary exportFiles(const std::vector<std::string>& files,
+                              const InferenceRequest& baseRequest,
+                              const std::string& outputPath,
+                              const std::string& format = "columnar");
+    
+    ExportSummary exportDirectory(const std::string& directory,
+                                  const InferenceRequest& baseRequest,
+                                  const std::string& outputPath,
+                                  const std::string& format = "columnar");
+    
 private:
     MettaAPI& api;
 };
@@ -0,0 +1,408 @@
+#include "metta_api_c.h"
+#include "metta_api.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <new>
+
+using namespace metta_api;
+
+struct metta_engine {
+    MettaAPI api;
+};
+
+struct metta_request {
+    InferenceRequest request;
+};
+
+struct metta_response {
+    InferenceResponse response;
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+metta_status fail(metta_status status, const std::string& message) {
+    lastError = message;
+    return status;
+}
+
+metta_status invalid(const char* message) {
+    return fail(METTA_ERROR_INVALID_ARGUMENT, message);
+}
+
+// Nothing may unwind into C callers
+template <typename Body>
+metta_status guarded(Body&& body) {
+    try {
+        return body();
+    } catch (const std::bad_alloc&) {
+        return fail(METTA_ERROR_INTERNAL, "Out of memory");
+    } catch (const std::exception& e) {
+        return fail(METTA_ERROR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(METTA_ERROR_INTERNAL, "Unknown error");
+    }
+}
+
+metta_status statusOf(const InferenceResponse& response) {
+    if (response.cancelled) return METTA_ERROR_CANCELLED;
+    if (response.overloaded) return METTA_ERROR_OVERLOADED;
+    if (!response.success) return METTA_ERROR_INFERENCE;
+    return METTA_OK;
+}
+
+metta_string view(std::string_view text) {
+    return {text.data(), text.size()};
+}
+
+metta_status parseFlag(const char* value, bool& flag) {
+    if (std::strcmp(value, "true") == 0 || std::strcmp(value, "1") == 0) {
+        flag = true;
+    } else if (std::strcmp(value, "false") == 0 || std::strcmp(value, "0") == 0) {
+        flag = false;
+    } else {
+        return invalid("Expected \"true\" or \"false\"");
+    }
+    return METTA_OK;
+}
+
+metta_status copyInto(std::string_view text, char* buffer, size_t capacity, size_t* size) {
+    if (!size) return invalid("size is NULL");
+    *size = text.size();
+    if (!buffer || capacity < text.size()) {
+        return fail(METTA_ERROR_BUFFER_TOO_SMALL,
+                    "Buffer too small: " + std::to_string(text.size()) + " bytes needed");
+    }
+    std::memcpy(buffer, text.data(), text.size());
+    return METTA_OK;
+}
+
+// Hands the response over to C, reporting failed requests like failed calls
+metta_status release(InferenceResponse&& response, metta_response** out) {
+    auto status = statusOf(response);
+    if (status != METTA_OK) {
+        lastError = response.error;
+    }
+    *out = new metta_response{std::move(response)};
+    return status;
+}
+
+InferenceCallback adopt(metta_callback callback, void* userData) {
+    return [callback, userData](InferenceResponse response) {
+        callback(userData, new metta_response{std::move(response)});
+    };
+}
+
+}
+
+extern "C" {
+
+uint32_t metta_abi_version(void) {
+    return METTA_ABI_VERSION;
+}
+
+const char* metta_last_error(void) {
+    return lastError.c_str();
+}
+
+metta_engine* metta_engine_create(void) {
+    try {
+        return new metta_engine();
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return nullptr;
+    }
+}
+
+void metta_engine_destroy(metta_engine* engine) {
+    delete engine;
+}
+
+metta_status metta_engine_set_repl_path(metta_engine* engine, const char* path) {
+    if (!engine || !path) return invalid("engine or path is NULL");
+    return guarded([&]() {
+        engine->api.setMettaReplPath(path);
+        return METTA_OK;
+    });
+}
+
+metta_status metta_engine_set_module_paths(metta_engine* engine, const char* const* paths, size_t count) {
+    if (!engine || (!paths && count > 0)) return invalid("engine or paths is NULL");
+    return guarded([&]() {
+        std::vector<std::string> modules;
+        modules.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!paths[i]) return invalid("Module path is NULL");
+            modules.emplace_back(paths[i]);
+        }
+        engine->api.setDefaultModulePaths(modules);
+        return METTA_OK;
+    });
+}
+
+metta_status metta_engine_set_verbose(metta_engine* engine, int verbose) {
+    if (!engine) return invalid("engine is NULL");
+    return guarded([&]() {
+        engine->api.setVerbose(verbose != 0);
+        return METTA_OK;
+    });
+}
+
+metta_status metta_engine_enable_module_watching(metta_engine* engine, int enable) {
+    if (!engine) return invalid("engine is NULL");
+    return guarded([&]() {
+        engine->api.enableModuleWatching(enable != 0);
+        return METTA_OK;
+    });
+}
+
+metta_status metta_engine_enable_request_coalescing(metta_engine* engine, int enable, uint32_t window_ms,
+                                                    size_t max_batch) {
+    if (!engine) return invalid("engine is NULL");
+    return guarded([&]() {
+        engine->api.enableRequestCoalescing(enable != 0, std::chrono::milliseconds(window_ms),
+                                         max_batch == 0 ? 16 : max_batch);
+        return METTA_OK;
+    });
+}
+
+metta_status metta_engine_enable_scheduling(metta_engine* engine, int enable,
+                                            const metta_scheduling_options* options) {
+    if (!engine) return invalid("engine is NULL");
+    return guarded([&]() {
+        SchedulingOptions scheduling;
+        if (options) {
+            scheduling.maxConcurrent = options->max_concurrent;
+            scheduling.maxBatchConcurrent = options->max_batch_concurrent;
+            scheduling.maxPerTenant = options->max_per_tenant;
+            if (options->max_queued > 0) {
+                scheduling.maxQueued = options->max_queued;
+            }
+        }
+        engine->api.enableScheduling(enable != 0, scheduling);
+        return METTA_OK;
+    });
+}
+
+metta_request* metta_request_create(void) {
+    try {
+        auto* request = new metta_request();
+        request->request.cancellation = CancellationToken::create();
+        return request;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return nullptr;
+    }
+}
+
+void metta_request_destroy(metta_request* request) {
+    delete request;
+}
+
+metta_status metta_request_set_content(metta_request* request, const char* data, size_t size) {
+    if (!request || (!data && size > 0)) return invalid("request or data is NULL");
+    return guarded([&]() {
+        request->request.exampleContent.assign(data ? data : "", size);
+        return METTA_OK;
+    });
+}
+
+metta_status metta_request_add_module_path(metta_request* request, const char* path) {
+    if (!request || !path) return invalid("request or path is NULL");
+    return guarded([&]() {
+        request->request.modulePaths.emplace_back(path);
+        return METTA_OK;
+    });
+}
+
+metta_status metta_request_set_option(metta_request* request, const char* key, const char* value) {
+    if (!request || !key || !value) return invalid("request, key or value is NULL");
+    return guarded([&]() {
+        auto& fields = request->request;
+        std::string_view name(key);
+        if (name == "output_format") {
+            std::string_view format(value);
+            if (format != "pretty" && format != "json" && format != "csv" &&
+                format != "markdown" && format != "binary") {
+                return invalid("output_format must be \"pretty\", \"json\", \"csv\", \"markdown\" or \"binary\"");
+            }
+            fields.outputFormat = value;
+        } else if (name == "metrics_detail") {
+            std::string_view detail(value);
+            if (detail != "lazy" && detail != "counts" && detail != "full") {
+                return invalid("metrics_detail must be \"lazy\", \"counts\" or \"full\"");
+            }
+            fields.metricsDetail = value;
+        } else if (name == "raw_output") {
+            std::string_view mode(value);
+            if (mode != "include" && mode != "shared" && mode != "shm" && mode != "omit") {
+                return invalid("raw_output must be \"include\", \"shared\", \"shm\" or \"omit\"");
+            }
+            fields.rawOutputMode = value;
+        } else if (name == "priority") {
+            fields.priority = value;
+        } else if (name == "tenant") {
+            fields.tenant = value;
+        } else if (name == "deadline_ms") {
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long milliseconds = std::strtoull(value, &end, 10);
+            if (end == value || *end != '\0' || errno == ERANGE || value[0] == '-') {
+                return invalid("deadline_ms must be a number of milliseconds");
+            }
+            fields.deadline = std::chrono::milliseconds(milliseconds);
+        } else if (name == "verbose") {
+            return parseFlag(value, fields.verbose);
+        } else if (name == "include_findings") {
+            return parseFlag(value, fields.includeFindings);
+        } else if (name == "stop_on_first") {
+            return parseFlag(value, fields.stopOnFirst);
+        } else {
+            return fail(METTA_ERROR_INVALID_ARGUMENT, "Unknown request option: " + std::string(name));
+        }
+        return METTA_OK;
+    });
+}
+
+metta_status metta_request_set_output_callback(metta_request* request, metta_output_callback callback,
+                                               void* user_data) {
+    if (!request) return invalid("request is NULL");
+    return guarded([&]() {
+        if (!callback) {
+            request->request.outputCallback = nullptr;
+        } else {
+            request->request.outputCallback = [callback, user_data](std::string_view chunk) {
+                callback(user_data, chunk.data(), chunk.size());
+            };
+        }
+        return METTA_OK;
+    });
+}
+
+metta_status metta_request_cancel(metta_request* request) {
+    if (!request) return invalid("request is NULL");
+    return guarded([&]() {
+        request->request.cancellation.cancel();
+        return METTA_OK;
+    });
+}
+
+metta_status metta_run(metta_engine* engine, const metta_request* request, metta_response** response) {
+    if (!engine || !request || !response) return invalid("engine, request or response is NULL");
+    *response = nullptr;
+    return guarded([&]() {
+        return release(engine->api.runInference(request->request), response);
+    });
+}
+
+metta_status metta_run_file(metta_engine* engine, const char* path, const metta_request* request,
+                            metta_response** response) {
+    if (!engine || !path || !request || !response) return invalid("engine, path, request or response is NULL");
+    *response = nullptr;
+    return guarded([&]() {
+        return release(engine->api.runInferenceFromFile(path, request->request), response);
+    });
+}
+
+metta_status metta_run_async(metta_engine* engine, const metta_request* request, metta_callback callback,
+                             void* user_data) {
+    if (!engine || !request || !callback) return invalid("engine, request or callback is NULL");
+    return guarded([&]() {
+        engine->api.runInferenceAsync(request->request, adopt(callback, user_data));
+        return METTA_OK;
+    });
+}
+
+metta_status metta_run_file_async(metta_engine* engine, const char* path, const metta_request* request,
+                                  metta_callback callback, void* user_data) {
+    if (!engine || !path || !request || !callback) return invalid("engine, path, request or callback is NULL");
+    return guarded([&]() {
+        engine->api.runInferenceFromFileAsync(path, request->request, adopt(callback, user_data));
+        return METTA_OK;
+    });
+}
+
+void metta_response_destroy(metta_response* response) {
+    delete response;
+}
+
+metta_status metta_response_status(const metta_response* response) {
+    if (!response) return invalid("response is NULL");
+    return statusOf(response->response);
+}
+
+int metta_response_has_logical_issues(const metta_response* response) {
+    return response && response->response.hasLogicalIssues ? 1 : 0;
+}
+
+metta_status metta_response_metrics(const metta_response* response, metta_metrics* metrics) {
+    if (!response || !metrics) return invalid("response or metrics is NULL");
+    const auto& source = response->response;
+    metrics->contradictions = source.metrics.contradictions;
+    metrics->compliances = source.metrics.compliances;
+    metrics->conflicts = source.metrics.conflicts;
+    metrics->violations = source.metrics.violations;
+    metrics->processing_time_ms = source.processingTimeMs;
+    metrics->queue_time_ms = source.queueTimeMs;
+    return METTA_OK;
+}
+
+int metta_response_is_partial(const metta_response* response, double* coverage) {
+    if (!response || !response->response.partial) return 0;
+    if (coverage) {
+        *coverage = response->response.coverage;
+    }
+    return 1;
+}
+
+metta_string metta_response_error(const metta_response* response) {
+    return response ? view(response->response.error) : metta_string{"", 0};
+}
+
+metta_string metta_response_output(const metta_response* response) {
+    return response ? view(response->response.formattedOutput) : metta_string{"", 0};
+}
+
+metta_string metta_response_raw_output(const metta_response* response) {
+    return response ? view(response->response.raw()) : metta_string{"", 0};
+}
+
+int metta_response_shared_fd(const metta_response* response) {
+    return response && response->response.sharedResult ? response->response.sharedResult->fd() : -1;
+}
+
+metta_string metta_response_encoded_metrics(const metta_response* response) {
+    if (!response || !response->response.sharedResult) return {"", 0};
+    return view(response->response.sharedResult->metrics());
+}
+
+metta_status metta_response_copy_output(const metta_response* response, char* buffer, size_t capacity,
+                                        size_t* size) {
+    if (!response) return invalid("response is NULL");
+    return copyInto(response->response.formattedOutput, buffer, capacity, size);
+}
+
+metta_status metta_response_copy_raw_output(const metta_response* response, char* buffer, size_t capacity,
+                                            size_t* size) {
+    if (!response) return invalid("response is NULL");
+    return copyInto(response->response.raw(), buffer, capacity, size);
+}
+
+size_t metta_response_finding_count(const metta_response* response) {
+    return response ? response->response.findings.size() : 0;
+}
+
+metta_status metta_response_finding(const metta_response* response, size_t index, metta_finding* finding) {
+    if (!response || !finding) return invalid("response or finding is NULL");
+    if (index >= response->response.findings.size()) return invalid("Finding index out of range");
+    const auto& source = response->response.findings[index];
+    finding->kind = view(source.kind);
+    finding->subject = view(source.subject);
+    finding->object = view(source.object);
+    finding->description = view(source.description);
+    return METTA_OK;
+}
+
+}
@@ -0,0 +1,200 @@
+#ifndef METTA_API_C_H
+#define METTA_API_C_H
+
+/*
+ * C ABI over MettaAPI, for services that cannot link C++ (Python via
+ * ctypes/cffi, Go via cgo, ...). Everything goes through opaque handles;
+ * no C++ type or exception crosses this boundary.
+ *
+ * Strings passed in are copied (or read during the call) unless noted.
+ * Strings handed out point into library-owned memory and stay valid
+ * until the owning handle is destroyed; they are not NUL-terminated
+ * unless noted, so always use the returned size. The metta_*_copy_*
+ * functions write into caller-provided buffers instead.
+ *
+ * Handles may be used from any thread, but one metta_request or
+ * metta_response must not be modified by two threads at once.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(METTA_API_C_BUILD)
+#    define METTA_C_API __declspec(dllexport)
+#  else
+#    define METTA_C_API __declspec(dllimport)
+#  endif
+#else
+#  define METTA_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a function or struct in this header changes */
+#define METTA_ABI_VERSION 2
+
+typedef struct metta_engine metta_engine;
+typedef struct metta_request metta_request;
+typedef struct metta_response metta_response;
+
+typedef enum metta_status {
+    METTA_OK = 0,
+    METTA_ERROR_INVALID_ARGUMENT = 1,
+    METTA_ERROR_BUFFER_TOO_SMALL = 2,
+    METTA_ERROR_INFERENCE = 3,      /* The request ran but failed; see metta_response_error */
+    METTA_ERROR_OVERLOADED = 4,     /* Shed by the scheduler; retry later */
+    METTA_ERROR_CANCELLED = 5,
+    METTA_ERROR_INTERNAL = 6
+} metta_status;
+
+/* A view into library-owned bytes */
+typedef struct metta_string {
+    const char* data;
+    size_t size;
+} metta_string;
+
+typedef struct metta_metrics {
+    int32_t contradictions;
+    int32_t compliances;
+    int32_t conflicts;
+    int32_t violations;
+    double processing_time_ms;
+    double queue_time_ms;
+} metta_metrics;
+
+typedef struct metta_finding {
+    metta_string kind;      /* "contradiction", "conflict", "violation" or "inferred_fact" */
+    metta_string subject;
+    metta_string object;
+    metta_string description;
+} metta_finding;
+
+typedef struct metta_scheduling_options {
+    size_t max_concurrent;          /* 0: one per core */
+    size_t max_batch_concurrent;    /* 0: half */
+    size_t max_per_tenant;          /* 0: unlimited */
+    size_t max_queued;              /* 0: the library default */
+} metta_scheduling_options;
+
+/* Receives ownership of response; release it with metta_response_destroy */
+typedef void (*metta_callback)(void* user_data, metta_response* response);
+
+/* Receives the formatted report in chunks while it is written; chunk is
+   only valid during the call */
+typedef void (*metta_output_callback)(void* user_data, const char* chunk, size_t size);
+
+/* METTA_ABI_VERSION of the loaded library */
+METTA_C_API uint32_t metta_abi_version(void);
+
+/* Message of the last failed call on this thread (NUL-terminated, valid
+   until the next call on this thread); "" when there is none */
+METTA_C_API const char* metta_last_error(void);
+
+/* Engine */
+
+/* NULL on failure. Destroying the handle waits for its async requests,
+   whose callbacks still run. */
+METTA_C_API metta_engine* metta_engine_create(void);
+METTA_C_API void metta_engine_destroy(metta_engine* engine);
+
+METTA_C_API metta_status metta_engine_set_repl_path(metta_engine* engine, const char* path);
+METTA_C_API metta_status metta_engine_set_module_paths(metta_engine* engine, const char* const* paths,
+                                                      size_t count);
+METTA_C_API metta_status metta_engine_set_verbose(metta_engine* engine, int verbose);
+
+/* See MettaAPI::enableModuleWatching, enableRequestCoalescing and
+   enableScheduling; options may be NULL for the defaults */
+METTA_C_API metta_status metta_engine_enable_module_watching(metta_engine* engine, int enable);
+METTA_C_API metta_status metta_engine_enable_request_coalescing(metta_engine* engine, int enable,
+                                                                uint32_t window_ms, size_t max_batch);
+METTA_C_API metta_status metta_engine_enable_scheduling(metta_engine* engine, int enable,
+                                                        const metta_scheduling_options* options);
+
+/* Requests */
+
+METTA_C_API metta_request* metta_request_create(void);
+METTA_C_API void metta_request_destroy(metta_request* request);
+
+METTA_C_API metta_status metta_request_set_content(metta_request* request, const char* data, size_t size);
+METTA_C_API metta_status metta_request_add_module_path(metta_request* request, const char* path);
+
+/* Options by InferenceRequest field name: "output_format" ("pretty", "json",
+   "csv", "markdown" or "binary"), "metrics_detail" ("lazy", "counts" or
+   "full"), "raw_output" ("include", "shared", "shm" or "omit"), "priority",
+   "tenant", "deadline_ms" (decimal, "0" for none), "verbose",
+   "include_findings" and "stop_on_first" ("true"/"false") */
+METTA_C_API metta_status metta_request_set_option(metta_request* request, const char* key, const char* value);
+
+/* callback may be NULL to turn streaming off again */
+METTA_C_API metta_status metta_request_set_output_callback(metta_request* request,
+                                                           metta_output_callback callback, void* user_data);
+
+/* Cancels every run started from this request so far (and later ones, as
+   cancellation is sticky); safe from any thread */
+METTA_C_API metta_status metta_request_cancel(metta_request* request);
+
+/* Running. The request may be reused or destroyed once these return. */
+
+/* Blocking. *response is set whenever the status is not
+   METTA_ERROR_INVALID_ARGUMENT or METTA_ERROR_INTERNAL, even for failed,
+   shed or cancelled requests, and must be destroyed. */
+METTA_C_API metta_status metta_run(metta_engine* engine, const metta_request* request, metta_response** response);
+METTA_C_API metta_status metta_run_file(metta_engine* engine, const char* path, const metta_request* request,
+                                        metta_response** response);
+
+/* Non-blocking; callback runs exactly once, on a library thread, unless
+   METTA_ERROR_INVALID_ARGUMENT or METTA_ERROR_INTERNAL is returned */
+METTA_C_API metta_status metta_run_async(metta_engine* engine, const metta_request* request,
+                                         metta_callback callback, void* user_data);
+METTA_C_API metta_status metta_run_file_async(metta_engine* engine, const char* path,
+                                              const metta_request* request, metta_callback callback,
+                                              void* user_data);
+
+/* Responses */
+
+METTA_C_API void metta_response_destroy(metta_response* response);
+
+/* METTA_OK, METTA_ERROR_INFERENCE, METTA_ERROR_OVERLOADED or METTA_ERROR_CANCELLED */
+METTA_C_API metta_status metta_response_status(const metta_response* response);
+METTA_C_API int metta_response_has_logical_issues(const metta_response* response);
+METTA_C_API metta_status metta_response_metrics(const metta_response* response, metta_metrics* metrics);
+
+/* 1 when the run was stopped early (deadline_ms, stop_on_first) and the
+   findings cover only part of it; *coverage (may be NULL) is then the
+   share of results covered */
+METTA_C_API int metta_response_is_partial(const metta_response* response, double* coverage);
+
+/* Zero-copy views, valid until metta_response_destroy. The error is also
+   NUL-terminated. */
+METTA_C_API metta_string metta_response_error(const metta_response* response);
+METTA_C_API metta_string metta_response_output(const metta_response* response);
+METTA_C_API metta_string metta_response_raw_output(const metta_response* response);
+
+/* With the "shm" raw_output option: the sealed shared-memory segment
+   holding the raw output and the ResultCodec-encoded metrics, for other
+   local processes to map. The descriptor belongs to the response (dup()
+   it to keep it); -1 and an empty view in the other modes. */
+METTA_C_API int metta_response_shared_fd(const metta_response* response);
+METTA_C_API metta_string metta_response_encoded_metrics(const metta_response* response);
+
+/* Copies into buffer. With a NULL buffer or one smaller than needed,
+   *size is set to the bytes required and METTA_ERROR_BUFFER_TOO_SMALL
+   returned (nothing is written). */
+METTA_C_API metta_status metta_response_copy_output(const metta_response* response, char* buffer, size_t capacity,
+                                                    size_t* size);
+METTA_C_API metta_status metta_response_copy_raw_output(const metta_response* response, char* buffer,
+                                                        size_t capacity, size_t* size);
+
+/* Only filled with the "include_findings" option */
+METTA_C_API size_t metta_response_finding_count(const metta_response* response);
+METTA_C_API metta_status metta_response_finding(const metta_response* response, size_t index,
+                                                metta_finding* finding);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,299 @@
+#include "metta_client.hpp"
+#include "metta_protocol.hpp"
+#include <filesystem>
+#include <unordered_map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace metta_api {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+InferenceResponse errorResponse(const std::string& error) {
+    InferenceResponse response;
+    response.error = error;
+    return response;
+}
+
+}
+
+class MettaClient::Impl {
+public:
+    struct Pending {
+        InferenceCallback callback;
+        std::function<void(std::string_view)> outputCallback;
+        bool sharedRawOutput = false;
+        CancellationToken::Registration onCancel;  // Forwards a cancellation to the daemon
+    };
+
+    int fd = -1;
+    std::atomic<bool> connected{false};
+    std::atomic<uint32_t> nextId{1};
+
+    std::mutex writeMutex;
+    std::mutex pendingMutex;
+    std::unordered_map<uint32_t, Pending> pending;
+
+    std::thread reader;
+
+    explicit Impl(const std::string& socketPath) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Invalid socket path: " + socketPath);
+        }
+        std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
+        }
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            std::string error = strerror(errno);
+            close(fd);
+            throw std::runtime_error("Failed to connect to inference daemon at " + socketPath + ": " + error);
+        }
+
+        connected = true;
+        reader = std::thread(&Impl::readLoop, this);
+    }
+
+    ~Impl() {
+        shutdown(fd, SHUT_RDWR);
+        if (reader.joinable()) {
+            reader.join();
+        }
+        close(fd);
+    }
+
+    void submit(const InferenceRequest& request, const std::string& filePath, InferenceCallback callback) {
+        uint32_t id = nextId.fetch_add(1);
+
+        std::string frame;
+        try {
+            frame = WireProtocol::encodeRequest(id, request, filePath);
+        } catch (const std::exception& e) {
+            callback(errorResponse(e.what()));
+            return;
+        }
+
+        bool registered = false;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            if (connected.load()) {
+                pending[id] = {std::move(callback), request.outputCallback, request.rawOutputMode == "shared", {}};
+                registered = true;
+            }
+        }
+        if (!registered) {
+            callback(errorResponse("Not connected to inference daemon"));
+            return;
+        }
+
+        if (!sendFrame(frame)) {
+            // The reader may already have failed it when the connection dropped
+            Pending failed;
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                auto it = pending.find(id);
+                if (it == pending.end()) return;
+                failed = std::move(it->second);
+                pending.erase(it);
+            }
+            failed.callback(errorResponse("Failed to send request to inference daemon"));
+            return;
+        }
+
+        // Only once the request is out, so the daemon knows the id; the
+        // daemon answers the cancelled request as usual
+        auto onCancel = request.cancellation.onCancel([this, id]() {
+            sendFrame(WireProtocol::encodeCancel(id));
+        });
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        auto it = pending.find(id);
+        if (it != pending.end()) {
+            it->second.onCancel = std::move(onCancel);
+        }
+    }
+
+    bool sendFrame(const std::string& frame) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        size_t written = 0;
+        while (written < frame.size()) {
+            ssize_t sent = send(fd, frame.data() + written, frame.size() - written, MSG_NOSIGNAL);
+            if (sent > 0) {
+                written += static_cast<size_t>(sent);
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reads into chunk, queueing any descriptors that came with the bytes
+    ssize_t receive(std::string& chunk, std::deque<int>& descriptors) {
+        iovec part{chunk.data(), chunk.size()};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 16)];
+        msghdr message{};
+        message.msg_iov = &part;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t bytesRead = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+        if (bytesRead < 0) return bytesRead;
+
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) continue;
+            size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < count; ++i) {
+                int received;
+                std::memcpy(&received, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+                descriptors.push_back(received);
+            }
+        }
+        return bytesRead;
+    }
+
+    void readLoop() {
+        FrameBuffer inbound;
+        std::string payload;
+        std::string chunk(64 * 1024, '\0');
+        std::deque<int> descriptors;  // Segments not yet claimed by a response
+
+        try {
+            while (true) {
+                ssize_t bytesRead = receive(chunk, descriptors);
+                if (bytesRead < 0 && errno == EINTR) continue;
+                if (bytesRead <= 0) break;
+
+                inbound.append(chunk.data(), static_cast<size_t>(bytesRead));
+                while (inbound.next(payload)) {
+                    uint32_t id = 0;
+                    auto response = WireProtocol::decodeResponse(payload, id);
+                    if (WireProtocol::hasSharedResult(payload)) {
+                        attachSharedResult(response, descriptors);
+                    }
+                    deliver(id, std::move(response));
+                }
+            }
+        } catch (const std::exception&) {
+            // A garbled stream cannot be resynchronised
+        }
+
+        for (int unclaimed : descriptors) {
+            close(unclaimed);
+        }
+        failPending("Connection to inference daemon lost");
+    }
+
+    static void attachSharedResult(InferenceResponse& response, std::deque<int>& descriptors) {
+        if (descriptors.empty()) {
+            throw std::runtime_error("Shared result descriptor missing");
+        }
+        int segment = descriptors.front();
+        descriptors.pop_front();
+        try {
+            response.sharedResult = SharedResult::adopt(segment);
+        } catch (const std::exception& e) {
+            // The response arrived; only its output is unusable
+            response.success = false;
+            response.error = e.what();
+        }
+    }
+
+    void deliver(uint32_t id, InferenceResponse response) {
+        Pending request;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            auto it = pending.find(id);
+            if (it == pending.end()) return;
+            request = std::move(it->second);
+            pending.erase(it);
+        }
+
+        if (request.outputCallback && !response.formattedOutput.empty()) {
+            request.outputCallback(response.formattedOutput);
+            response.formattedOutput.clear();
+        }
+        if (request.sharedRawOutput) {
+            response.sharedRawOutput = std::make_shared<const std::string>(std::move(response.rawOutput));
+            response.rawOutput.clear();
+        }
+        request.callback(std::move(response));
+    }
+
+    void failPending(const std::string& error) {
+        std::unordered_map<uint32_t, Pending> failed;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            connected = false;
+            failed.swap(pending);
+        }
+        for (auto& [id, request] : failed) {
+            request.callback(errorResponse(error));
+        }
+    }
+};
+
+MettaClient::MettaClient(const std::string& socketPath)
+    : pImpl(std::make_unique<Impl>(socketPath)) {}
+
+MettaClient::~MettaClient() = default;
+
+InferenceResponse MettaClient::runInference(const InferenceRequest& request) {
+    return runInferenceAsync(request).get();
+}
+
+InferenceResponse MettaClient::runInferenceFromFile(const std::string& filePath,
+                                                    const InferenceRequest& request) {
+    return runInferenceFromFileAsync(filePath, request).get();
+}
+
+std::future<InferenceResponse> MettaClient::runInferenceAsync(const InferenceRequest& request) {
+    auto promise = std::make_shared<std::promise<InferenceResponse>>();
+    auto future = promise->get_future();
+    runInferenceAsync(request, [promise](InferenceResponse response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+std::future<InferenceResponse> MettaClient::runInferenceFromFileAsync(const std::string& filePath,
+                                                                      const InferenceRequest& request) {
+    auto promise = std::make_shared<std::promise<InferenceResponse>>();
+    auto future = promise->get_future();
+    runInferenceFromFileAsync(filePath, request, [promise](InferenceResponse response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+void MettaClient::runInferenceAsync(const InferenceRequest& request, InferenceCallback callback) {
+    pImpl->submit(request, {}, std::move(callback));
+}
+
+void MettaClient::runInferenceFromFileAsync(const std::string& filePath, const InferenceRequest& request,
+                                            InferenceCallback callback) {
+    // The daemon resolves paths against its own working directory
+    std::error_code ec;
+    auto absolute = fs::absolute(filePath, ec);
+    pImpl->submit(request, ec ? filePath : absolute.string(), std::move(callback));
+}
+
+bool MettaClient::isConnected() const {
+    return pImpl->connected.load();
+}
+
+}
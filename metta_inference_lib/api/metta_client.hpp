@@ -0,0 +1,53 @@
+#ifndef METTA_CLIENT_HPP
+#define METTA_CLIENT_HPP
+
+#include "metta_api.hpp"
+#include <string>
+#include <memory>
+#include <future>
+
+namespace metta_api {
+
+// Talks to a metta_inferenced daemon instead of running the engine in
+// process; mirrors the request methods of MettaAPI. One connection is
+// shared by all calls and requests are pipelined on it, so the client is
+// safe to use from many threads at once.
+//
+// Callbacks run on the client's reader thread. A request's
+// outputCallback receives the whole report once it arrives. Cancelling a
+// request's cancellation token asks the daemon to stop it; the response
+// then arrives with InferenceResponse::cancelled set. With rawOutputMode
+// "shm" the daemon's shared-memory segment is mapped, not copied.
+class MettaClient {
+public:
+    // Connects to the daemon; throws std::runtime_error when nothing
+    // listens at socketPath
+    explicit MettaClient(const std::string& socketPath);
+    ~MettaClient();
+
+    MettaClient(const MettaClient&) = delete;
+    MettaClient& operator=(const MettaClient&) = delete;
+
+    InferenceResponse runInference(const InferenceRequest& request);
+    InferenceResponse runInferenceFromFile(const std::string& filePath,
+                                          const InferenceRequest& request = {});
+
+    std::future<InferenceResponse> runInferenceAsync(const InferenceRequest& request);
+    std::future<InferenceResponse> runInferenceFromFileAsync(const std::string& filePath,
+                                                             const InferenceRequest& request = {});
+    void runInferenceAsync(const InferenceRequest& request, InferenceCallback callback);
+    void runInferenceFromFileAsync(const std::string& filePath, const InferenceRequest& request,
+                                   InferenceCallback callback);
+
+    // False once the daemon closed the connection; pending and later
+    // requests then fail with an error response
+    bool isConnected() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+}
+
+#endif
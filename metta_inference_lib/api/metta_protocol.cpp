@@ -0,0 +1,343 @@
+#include "metta_protocol.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace metta_api {
+
+namespace {
+
+constexpr uint8_t FLAG_VERBOSE = 1;
+constexpr uint8_t FLAG_INCLUDE_FINDINGS = 2;
+constexpr uint8_t FLAG_STOP_ON_FIRST = 4;
+
+constexpr uint8_t FLAG_SUCCESS = 1;
+constexpr uint8_t FLAG_LOGICAL_ISSUES = 2;
+constexpr uint8_t FLAG_OVERLOADED = 4;
+constexpr uint8_t FLAG_CANCELLED = 8;
+constexpr uint8_t FLAG_SHARED_RESULT = 16;
+constexpr uint8_t FLAG_PARTIAL = 32;
+
+uint64_t doubleBits(double value) {
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value));
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void putString(std::string& out, std::string_view text) {
+    if (text.size() > WireProtocol::MAX_PAYLOAD) {
+        throw std::runtime_error("Inference message field too large");
+    }
+    putU32(out, static_cast<uint32_t>(text.size()));
+    out.append(text);
+}
+
+uint32_t getU32(const char* p) {
+    auto b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+           (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+// Starts a frame; finishFrame fills in the length
+std::string beginFrame(WireProtocol::MessageType type, uint32_t id) {
+    std::string frame(WireProtocol::LENGTH_SIZE, '\0');
+    frame.push_back(static_cast<char>(type));
+    putU16(frame, WireProtocol::VERSION);
+    putU32(frame, id);
+    return frame;
+}
+
+std::string finishFrame(std::string frame) {
+    size_t payload = frame.size() - WireProtocol::LENGTH_SIZE;
+    if (payload > WireProtocol::MAX_PAYLOAD) {
+        throw std::runtime_error("Inference message too large");
+    }
+    std::string length;
+    putU32(length, static_cast<uint32_t>(payload));
+    frame.replace(0, WireProtocol::LENGTH_SIZE, length);
+    return frame;
+}
+
+// Bounds-checked little-endian reader over one payload
+class Cursor {
+public:
+    explicit Cursor(std::string_view data) : data(data) {}
+
+    std::string_view take(size_t count) {
+        if (count > data.size() - pos) {
+            throw std::runtime_error("Malformed inference message: truncated");
+        }
+        auto view = data.substr(pos, count);
+        pos += count;
+        return view;
+    }
+
+    uint8_t u8() { return static_cast<uint8_t>(take(1)[0]); }
+
+    uint16_t u16() {
+        auto b = reinterpret_cast<const unsigned char*>(take(2).data());
+        return static_cast<uint16_t>(b[0] | (b[1] << 8));
+    }
+
+    uint32_t u32() { return getU32(take(4).data()); }
+
+    uint64_t u64() {
+        uint64_t low = u32();
+        uint64_t high = u32();
+        return low | (high << 32);
+    }
+
+    std::string string() { return std::string(take(u32())); }
+
+    void expectEnd() const {
+        if (pos != data.size()) {
+            throw std::runtime_error("Malformed inference message: trailing bytes");
+        }
+    }
+
+private:
+    std::string_view data;
+    size_t pos = 0;
+};
+
+// Type, version and id; leaves the cursor at the body
+uint32_t readHeader(Cursor& cursor, WireProtocol::MessageType expected) {
+    if (cursor.u8() != static_cast<uint8_t>(expected)) {
+        throw std::runtime_error("Malformed inference message: unexpected type");
+    }
+    if (cursor.u16() != WireProtocol::VERSION) {
+        throw std::runtime_error("Unsupported inference protocol version");
+    }
+    return cursor.u32();
+}
+
+}
+
+std::string WireProtocol::encodeRequest(uint32_t id, const InferenceRequest& request,
+                                        const std::string& filePath) {
+    std::string frame = beginFrame(MessageType::Request, id);
+    frame.reserve(frame.size() + request.exampleContent.size() + filePath.size() + 128);
+
+    putString(frame, filePath);
+    putString(frame, request.exampleContent);
+    putU32(frame, static_cast<uint32_t>(request.modulePaths.size()));
+    for (const auto& path : request.modulePaths) {
+        putString(frame, path);
+    }
+    putString(frame, request.outputFormat);
+    putString(frame, request.metricsDetail);
+    // A shared buffer cannot cross the socket; the client rebuilds it, and
+    // both modes then share one cache key on the daemon
+    putString(frame, request.rawOutputMode == "shared" ? std::string("include") : request.rawOutputMode);
+    putString(frame, request.priority);
+    putString(frame, request.tenant);
+    putU32(frame, static_cast<uint32_t>(std::clamp<int64_t>(request.deadline.count(), 0, UINT32_MAX)));
+
+    uint8_t flags = 0;
+    if (request.verbose) flags |= FLAG_VERBOSE;
+    if (request.includeFindings) flags |= FLAG_INCLUDE_FINDINGS;
+    if (request.stopOnFirst) flags |= FLAG_STOP_ON_FIRST;
+    frame.push_back(static_cast<char>(flags));
+
+    return finishFrame(std::move(frame));
+}
+
+WireProtocol::Request WireProtocol::decodeRequest(std::string_view payload) {
+    Cursor cursor(payload);
+    Request decoded;
+    decoded.id = readHeader(cursor, MessageType::Request);
+
+    auto& request = decoded.request;
+    decoded.filePath = cursor.string();
+    request.exampleContent = cursor.string();
+    uint32_t moduleCount = cursor.u32();
+    for (uint32_t i = 0; i < moduleCount; ++i) {
+        request.modulePaths.push_back(cursor.string());
+    }
+    request.outputFormat = cursor.string();
+    request.metricsDetail = cursor.string();
+    request.rawOutputMode = cursor.string();
+    request.priority = cursor.string();
+    request.tenant = cursor.string();
+    request.deadline = std::chrono::milliseconds(cursor.u32());
+
+    uint8_t flags = cursor.u8();
+    request.verbose = (flags & FLAG_VERBOSE) != 0;
+    request.includeFindings = (flags & FLAG_INCLUDE_FINDINGS) != 0;
+    request.stopOnFirst = (flags & FLAG_STOP_ON_FIRST) != 0;
+
+    cursor.expectEnd();
+    return decoded;
+}
+
+std::string WireProtocol::encodeResponse(uint32_t id, const InferenceResponse& response) {
+    std::string frame = beginFrame(MessageType::Response, id);
+    // A shared segment goes next to the frame, not into it
+    auto raw = response.sharedResult ? std::string_view() : response.raw();
+    frame.reserve(frame.size() + response.formattedOutput.size() + raw.size() + 128);
+
+    uint8_t flags = 0;
+    if (response.success) flags |= FLAG_SUCCESS;
+    if (response.hasLogicalIssues) flags |= FLAG_LOGICAL_ISSUES;
+    if (response.overloaded) flags |= FLAG_OVERLOADED;
+    if (response.cancelled) flags |= FLAG_CANCELLED;
+    if (response.sharedResult) flags |= FLAG_SHARED_RESULT;
+    if (response.partial) flags |= FLAG_PARTIAL;
+    frame.push_back(static_cast<char>(flags));
+
+    putString(frame, response.error);
+    putU32(frame, static_cast<uint32_t>(response.metrics.contradictions));
+    putU32(frame, static_cast<uint32_t>(response.metrics.compliances));
+    putU32(frame, static_cast<uint32_t>(response.metrics.conflicts));
+    putU32(frame, static_cast<uint32_t>(response.metrics.violations));
+
+    putU64(frame, doubleBits(response.processingTimeMs));
+    putU64(frame, doubleBits(response.queueTimeMs));
+    putU64(frame, doubleBits(response.coverage));
+
+    putString(frame, response.formattedOutput);
+    putString(frame, raw);
+
+    putU32(frame, static_cast<uint32_t>(response.findings.size()));
+    for (const auto& finding : response.findings) {
+        putString(frame, finding.kind);
+        putString(frame, finding.subject);
+        putString(frame, finding.object);
+        putString(frame, finding.description);
+    }
+
+    return finishFrame(std::move(frame));
+}
+
+InferenceResponse WireProtocol::decodeResponse(std::string_view payload, uint32_t& id) {
+    Cursor cursor(payload);
+    id = readHeader(cursor, MessageType::Response);
+
+    InferenceResponse response;
+    uint8_t flags = cursor.u8();
+    response.success = (flags & FLAG_SUCCESS) != 0;
+    response.hasLogicalIssues = (flags & FLAG_LOGICAL_ISSUES) != 0;
+    response.overloaded = (flags & FLAG_OVERLOADED) != 0;
+    response.cancelled = (flags & FLAG_CANCELLED) != 0;
+    response.partial = (flags & FLAG_PARTIAL) != 0;
+
+    response.error = cursor.string();
+    response.metrics.contradictions = static_cast<int>(cursor.u32());
+    response.metrics.compliances = static_cast<int>(cursor.u32());
+    response.metrics.conflicts = static_cast<int>(cursor.u32());
+    response.metrics.violations = static_cast<int>(cursor.u32());
+
+    response.processingTimeMs = bitsDouble(cursor.u64());
+    response.queueTimeMs = bitsDouble(cursor.u64());
+    response.coverage = bitsDouble(cursor.u64());
+
+    response.formattedOutput = cursor.string();
+    response.rawOutput = cursor.string();
+
+    uint32_t findingCount = cursor.u32();
+    for (uint32_t i = 0; i < findingCount; ++i) {
+        InferenceFinding finding;
+        finding.kind = cursor.string();
+        finding.subject = cursor.string();
+        finding.object = cursor.string();
+        finding.description = cursor.string();
+        response.findings.push_back(std::move(finding));
+    }
+
+    cursor.expectEnd();
+    return response;
+}
+
+std::string WireProtocol::encodeCancel(uint32_t id) {
+    return finishFrame(beginFrame(MessageType::Cancel, id));
+}
+
+uint32_t WireProtocol::decodeCancel(std::string_view payload) {
+    Cursor cursor(payload);
+    uint32_t id = readHeader(cursor, MessageType::Cancel);
+    cursor.expectEnd();
+    return id;
+}
+
+bool WireProtocol::hasSharedResult(std::string_view responsePayload) {
+    Cursor cursor(responsePayload);
+    readHeader(cursor, MessageType::Response);
+    return (cursor.u8() & FLAG_SHARED_RESULT) != 0;
+}
+
+WireProtocol::MessageType WireProtocol::messageType(std::string_view payload) {
+    if (payload.empty()) {
+        throw std::runtime_error("Malformed inference message: empty");
+    }
+    return static_cast<MessageType>(payload[0]);
+}
+
+std::string_view WireProtocol::requestKey(std::string_view payload) {
+    if (payload.size() < PAYLOAD_HEADER_SIZE) {
+        throw std::runtime_error("Malformed inference message: truncated");
+    }
+    return payload.substr(PAYLOAD_HEADER_SIZE);
+}
+
+void WireProtocol::setRequestId(std::string& frame, uint32_t id) {
+    if (frame.size() < LENGTH_SIZE + PAYLOAD_HEADER_SIZE) {
+        throw std::runtime_error("Malformed inference message: truncated");
+    }
+    std::string encoded;
+    putU32(encoded, id);
+    frame.replace(LENGTH_SIZE + 3, 4, encoded);
+}
+
+// FrameBuffer implementation
+void FrameBuffer::append(const char* data, size_t size) {
+    // Drop consumed frames before growing
+    if (consumed > 0 && consumed >= buffer.size() / 2) {
+        buffer.erase(0, consumed);
+        consumed = 0;
+    }
+    buffer.append(data, size);
+}
+
+bool FrameBuffer::next(std::string& payload) {
+    if (buffered() < WireProtocol::LENGTH_SIZE) return false;
+
+    uint32_t length = getU32(buffer.data() + consumed);
+    if (length > WireProtocol::MAX_PAYLOAD) {
+        throw std::runtime_error("Inference message of " + std::to_string(length) + " bytes exceeds the limit");
+    }
+    if (buffered() < WireProtocol::LENGTH_SIZE + length) return false;
+
+    payload.assign(buffer, consumed + WireProtocol::LENGTH_SIZE, length);
+    consumed += WireProtocol::LENGTH_SIZE + length;
+    if (consumed == buffer.size()) {
+        buffer.clear();
+        consumed = 0;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,86 @@
+#ifndef METTA_PROTOCOL_HPP
+#define METTA_PROTOCOL_HPP
+
+#include "metta_api.hpp"
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace metta_api {
+
+// Messages between MettaClient and metta_inferenced over a Unix socket.
+//
+// Every message is a frame: u32 payload length, then the payload
+//   u8 type, u16 version, u32 request id, body
+// Strings are u32 length + bytes; all integers little-endian.
+// Responses carry the id of their request and may arrive in any order,
+// so a client can pipeline many requests on one connection. A Cancel
+// message (no body) cancels the request with its id; that request is
+// still answered, with InferenceResponse::cancelled set.
+//
+// A response whose request asked for rawOutputMode "shm" leaves the raw
+// output out of the frame; its SharedResult segment travels as a file
+// descriptor (SCM_RIGHTS) sent with the frame's first byte. Descriptors
+// arrive in frame order, so a reader queues them and hands the next one
+// to each response for which hasSharedResult is true.
+class WireProtocol {
+public:
+    static constexpr uint16_t VERSION = 3;
+    static constexpr size_t LENGTH_SIZE = 4;
+    static constexpr size_t PAYLOAD_HEADER_SIZE = 7;
+    static constexpr size_t MAX_PAYLOAD = size_t(512) << 20;
+
+    enum class MessageType : uint8_t {
+        Request = 1,
+        Response = 2,
+        Cancel = 3
+    };
+
+    struct Request {
+        uint32_t id = 0;
+        std::string filePath;  // Empty: the example is request.exampleContent
+        InferenceRequest request;
+    };
+
+    // Encoders return a whole frame, ready to send
+    static std::string encodeRequest(uint32_t id, const InferenceRequest& request,
+                                     const std::string& filePath = {});
+    static std::string encodeResponse(uint32_t id, const InferenceResponse& response);
+    static std::string encodeCancel(uint32_t id);
+
+    // Decoders take a payload (see FrameBuffer) and throw
+    // std::runtime_error on malformed input
+    static MessageType messageType(std::string_view payload);
+    static Request decodeRequest(std::string_view payload);
+    static InferenceResponse decodeResponse(std::string_view payload, uint32_t& id);
+    static uint32_t decodeCancel(std::string_view payload);
+
+    // True when a response payload's segment came as a descriptor
+    static bool hasSharedResult(std::string_view responsePayload);
+
+    // The request body without its id: equal requests have equal keys
+    static std::string_view requestKey(std::string_view payload);
+
+    // Re-addresses an encoded frame (a cached response) to another request
+    static void setRequestId(std::string& frame, uint32_t id);
+};
+
+// Splits a byte stream into frame payloads
+class FrameBuffer {
+public:
+    void append(const char* data, size_t size);
+
+    // Moves the next complete payload into payload; false when none is
+    // complete yet. Throws std::runtime_error on an oversized frame.
+    bool next(std::string& payload);
+
+    size_t buffered() const { return buffer.size() - consumed; }
+
+private:
+    std::string buffer;
+    size_t consumed = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,577 @@
+#include "metta_server.hpp"
+#include "metta_protocol.hpp"
+#include "metta_inference/lru_cache.hpp"
+#include <iostream>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace metta_api {
+
+namespace fs = std::filesystem;
+namespace mi = metta_inference;
+
+namespace {
+
+constexpr uint64_t LISTEN_ID = 0;
+constexpr uint64_t WAKE_ID = 1;
+constexpr size_t READ_CHUNK = 64 * 1024;
+
+std::runtime_error socketError(const std::string& what) {
+    return std::runtime_error(what + ": " + strerror(errno));
+}
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+// Sends bytes, with fd attached to the first one when it is not -1
+ssize_t sendWithDescriptor(int socketFd, const char* data, size_t size, int fd) {
+    if (fd < 0) {
+        return ::send(socketFd, data, size, MSG_NOSIGNAL);
+    }
+
+    iovec part{const_cast<char*>(data), size};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr message{};
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(header), &fd, sizeof(int));
+
+    return sendmsg(socketFd, &message, MSG_NOSIGNAL);
+}
+
+// True when something accepts connections at path
+bool socketInUse(const sockaddr_un& address) {
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) return false;
+    bool inUse = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    close(probe);
+    return inUse;
+}
+
+}
+
+class MettaServer::Impl {
+public:
+    Impl(MettaAPI& api, Options options)
+        : api(api), options(std::move(options)), cache(this->options.cacheEntries) {}
+
+    MettaAPI& api;
+    Options options;
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::atomic<bool> running{false};
+    std::thread loop;
+
+    struct Connection {
+        int fd = -1;
+        FrameBuffer inbound;
+        std::string outbound;
+        size_t written = 0;
+        bool waitingToWrite = false;
+        std::unordered_map<uint32_t, mi::CancellationToken> inFlight;  // By request id
+        // Segments to pass along, by the outbound offset of their frame
+        std::deque<std::pair<size_t, std::shared_ptr<const SharedResult>>> descriptors;
+    };
+
+    // Owned by the loop thread
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t nextConnectionId = WAKE_ID + 1;
+
+    // Responses finished on completion threads, picked up by the loop
+    struct Completed {
+        uint64_t connectionId;
+        uint32_t requestId;
+        std::string frame;
+        std::shared_ptr<const SharedResult> segment;
+    };
+    std::mutex completedMutex;
+    std::vector<Completed> completed;
+
+    // Requests whose callbacks have not run yet; stop() waits for them
+    std::mutex pendingMutex;
+    std::condition_variable pendingDone;
+    size_t pending = 0;
+
+    // Sealed segments are immutable, so cached responses share them
+    struct CachedResponse {
+        std::string frame;
+        std::shared_ptr<const SharedResult> segment;
+    };
+    mi::LruCache<std::string, std::shared_ptr<const CachedResponse>> cache;
+
+    std::atomic<uint64_t> acceptedCount{0};
+    std::atomic<uint64_t> requestCount{0};
+    std::atomic<uint64_t> cacheHitCount{0};
+    std::atomic<uint64_t> protocolErrorCount{0};
+    std::atomic<uint64_t> cancelledCount{0};
+    std::atomic<uint64_t> slowReaderCount{0};
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    bool watch(int fd, uint64_t id, uint32_t events, int op) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+        return epoll_ctl(epollFd, op, fd, &event) == 0;
+    }
+
+    void bindSocket() {
+        auto address = socketAddress(options.socketPath);
+
+        // A socket file nobody answers on is left over from a crash
+        if (fs::exists(options.socketPath)) {
+            if (socketInUse(address)) {
+                throw std::runtime_error("Inference daemon already listening on " + options.socketPath);
+            }
+            fs::remove(options.socketPath);
+        }
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) {
+            throw socketError("Failed to create socket");
+        }
+        // Nobody can connect before listen(), so the mode is set in time
+        if (bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            chmod(options.socketPath.c_str(), static_cast<mode_t>(options.socketMode)) != 0 ||
+            listen(listenFd, SOMAXCONN) != 0) {
+            auto error = socketError("Failed to listen on " + options.socketPath);
+            closeAll();
+            throw error;
+        }
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0 ||
+            !watch(listenFd, LISTEN_ID, EPOLLIN, EPOLL_CTL_ADD) ||
+            !watch(wakeFd, WAKE_ID, EPOLLIN, EPOLL_CTL_ADD)) {
+            auto error = socketError("Failed to create server event loop");
+            closeAll();
+            throw error;
+        }
+    }
+
+    void closeAll() {
+        for (int* fd : {&listenFd, &epollFd, &wakeFd}) {
+            if (*fd >= 0) close(*fd);
+            *fd = -1;
+        }
+    }
+
+    void serve() {
+        epoll_event events[64];
+        while (running.load()) {
+            int ready = epoll_wait(epollFd, events, 64, -1);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Warning: Inference server wait failed: " << strerror(errno) << "\n";
+                break;
+            }
+
+            for (int i = 0; i < ready; ++i) {
+                uint64_t id = events[i].data.u64;
+                if (id == LISTEN_ID) {
+                    acceptConnections();
+                } else if (id == WAKE_ID) {
+                    uint64_t count;
+                    ssize_t ignored = read(wakeFd, &count, sizeof(count));
+                    (void)ignored;
+                } else {
+                    if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                        readFrom(id);
+                    }
+                    if (events[i].events & EPOLLOUT) {
+                        flush(id);
+                    }
+                }
+            }
+
+            deliverCompleted();
+        }
+
+        // Cancels what each connection still had running, so stop() does
+        // not wait for it to finish
+        while (!connections.empty()) {
+            closeConnection(connections.begin()->first);
+        }
+    }
+
+    void acceptConnections() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::cerr << "Warning: Inference server accept failed: " << strerror(errno) << "\n";
+                }
+                return;
+            }
+            uint64_t id = nextConnectionId++;
+            if (connections.size() >= options.maxConnections || !watch(fd, id, EPOLLIN, EPOLL_CTL_ADD)) {
+                close(fd);
+                continue;
+            }
+            connections[id].fd = fd;
+            ++acceptedCount;
+        }
+    }
+
+    void closeConnection(uint64_t id) {
+        auto it = connections.find(id);
+        if (it == connections.end()) return;
+        // Nobody is left to read the answers
+        for (auto& [requestId, token] : it->second.inFlight) {
+            if (!token.isCancelled()) {
+                token.cancel();
+                ++cancelledCount;
+            }
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        close(it->second.fd);
+        connections.erase(it);
+    }
+
+    void readFrom(uint64_t id) {
+        char chunk[READ_CHUNK];
+        while (true) {
+            auto it = connections.find(id);
+            if (it == connections.end()) return;
+
+            ssize_t bytesRead = read(it->second.fd, chunk, sizeof(chunk));
+            if (bytesRead > 0) {
+                it->second.inbound.append(chunk, static_cast<size_t>(bytesRead));
+                if (!dispatchFrames(id)) return;
+                continue;
+            }
+            if (bytesRead < 0 && errno == EINTR) continue;
+            if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+
+            // Peer closed or failed; responses still in flight are dropped
+            closeConnection(id);
+            return;
+        }
+    }
+
+    // False once the connection is gone (closed for a protocol error, or
+    // by a failed write while answering from the cache)
+    bool dispatchFrames(uint64_t id) {
+        std::string payload;
+        try {
+            while (true) {
+                auto it = connections.find(id);
+                if (it == connections.end()) return false;
+                if (!it->second.inbound.next(payload)) return true;
+
+                switch (WireProtocol::messageType(payload)) {
+                    case WireProtocol::MessageType::Request:
+                        handleRequest(id, payload);
+                        break;
+                    case WireProtocol::MessageType::Cancel:
+                        handleCancel(id, WireProtocol::decodeCancel(payload));
+                        break;
+                    default:
+                        throw std::runtime_error("Malformed inference message: unexpected type");
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Dropping inference client: " << e.what() << "\n";
+            ++protocolErrorCount;
+            closeConnection(id);
+            return false;
+        }
+    }
+
+    // Empty when the response must not be cached
+    std::string cacheKey(const WireProtocol::Request& request, std::string_view payload) const {
+        uint64_t moduleVersion = api.moduleSnapshotVersion();
+        if (options.cacheEntries == 0 || moduleVersion == 0 || !request.request.modulePaths.empty()) {
+            return {};
+        }
+
+        uint64_t configGeneration;
+        try {
+            configGeneration = api.inferenceConfigGeneration();
+        } catch (const std::exception&) {
+            return {};  // The request reports it
+        }
+
+        std::string key = std::to_string(moduleVersion) + ":" + std::to_string(configGeneration);
+        if (!request.filePath.empty()) {
+            std::error_code ec;
+            auto size = fs::file_size(request.filePath, ec);
+            auto modified = fs::last_write_time(request.filePath, ec);
+            if (ec) return {};
+            key += ":" + std::to_string(size) + ":" +
+                   std::to_string(modified.time_since_epoch().count());
+        }
+        key += ":";
+        key += WireProtocol::requestKey(payload);
+        return key;
+    }
+
+    void handleRequest(uint64_t connectionId, std::string_view payload) {
+        auto decoded = WireProtocol::decodeRequest(payload);
+        ++requestCount;
+
+        std::string key = cacheKey(decoded, payload);
+        if (!key.empty()) {
+            if (auto hit = cache.get(key)) {
+                std::string frame = (*hit)->frame;
+                WireProtocol::setRequestId(frame, decoded.id);
+                ++cacheHitCount;
+                send(connectionId, std::move(frame), (*hit)->segment);
+                return;
+            }
+        }
+
+        // The daemon's console is not the client's; shared buffers are
+        // rebuilt on the client side
+        auto& request = decoded.request;
+        request.verbose = false;
+        if (request.rawOutputMode == "shared") {
+            request.rawOutputMode = "include";
+        }
+
+        auto cancellation = mi::CancellationToken::create();
+        request.cancellation = cancellation;
+        connections[connectionId].inFlight[decoded.id] = cancellation;
+
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            ++pending;
+        }
+
+        auto callback = [this, connectionId, id = decoded.id, key](InferenceResponse response) {
+            std::string frame;
+            std::shared_ptr<const SharedResult> segment = response.sharedResult;
+            try {
+                frame = WireProtocol::encodeResponse(id, response);
+                // A partial answer depends on timing, not just on the request
+                if (!key.empty() && response.success && !response.partial) {
+                    cache.put(key, std::make_shared<const CachedResponse>(CachedResponse{frame, segment}));
+                }
+            } catch (const std::exception& e) {
+                InferenceResponse failure;
+                failure.error = e.what();
+                frame = WireProtocol::encodeResponse(id, failure);
+                segment.reset();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(completedMutex);
+                completed.push_back({connectionId, id, std::move(frame), std::move(segment)});
+            }
+            wake();
+
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            if (--pending == 0) {
+                pendingDone.notify_all();
+            }
+        };
+
+        if (decoded.filePath.empty()) {
+            api.runInferenceAsync(request, std::move(callback));
+        } else {
+            api.runInferenceFromFileAsync(decoded.filePath, request, std::move(callback));
+        }
+    }
+
+    void handleCancel(uint64_t connectionId, uint32_t requestId) {
+        auto& inFlight = connections[connectionId].inFlight;
+        auto it = inFlight.find(requestId);
+        // Unknown ids finished (or were answered from the cache) meanwhile
+        if (it != inFlight.end() && !it->second.isCancelled()) {
+            it->second.cancel();
+            ++cancelledCount;
+        }
+    }
+
+    void deliverCompleted() {
+        std::vector<Completed> ready;
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+            ready.swap(completed);
+        }
+        for (auto& response : ready) {
+            auto it = connections.find(response.connectionId);
+            if (it != connections.end()) {
+                it->second.inFlight.erase(response.requestId);
+            }
+            send(response.connectionId, std::move(response.frame), std::move(response.segment));
+        }
+    }
+
+    void send(uint64_t id, std::string frame, std::shared_ptr<const SharedResult> segment = nullptr) {
+        auto it = connections.find(id);
+        if (it == connections.end()) return;  // Client went away meanwhile
+
+        auto& connection = it->second;
+        size_t unsent = connection.outbound.size() - connection.written;
+        if (unsent > 0 && unsent + frame.size() > options.maxOutboundBytes) {
+            std::cerr << "Warning: Dropping inference client that does not read its responses\n";
+            ++slowReaderCount;
+            closeConnection(id);
+            return;
+        }
+
+        // Let go of what was sent once it is most of the buffer
+        if (connection.written > 0 && connection.written >= unsent) {
+            connection.outbound.erase(0, connection.written);
+            for (auto& descriptor : connection.descriptors) {
+                descriptor.first -= connection.written;
+            }
+            connection.written = 0;
+        }
+
+        if (segment) {
+            connection.descriptors.emplace_back(connection.outbound.size(), std::move(segment));
+        }
+        if (connection.outbound.empty()) {
+            connection.outbound = std::move(frame);
+            connection.written = 0;
+        } else {
+            connection.outbound += frame;
+        }
+        flush(id);
+    }
+
+    void flush(uint64_t id) {
+        auto it = connections.find(id);
+        if (it == connections.end()) return;
+        auto& connection = it->second;
+
+        auto& descriptors = connection.descriptors;
+        while (connection.written < connection.outbound.size()) {
+            // A segment goes with the first byte of its frame, and each
+            // send carries at most one
+            size_t end = connection.outbound.size();
+            int segmentFd = -1;
+            if (!descriptors.empty()) {
+                if (descriptors.front().first == connection.written) {
+                    segmentFd = descriptors.front().second->fd();
+                    if (descriptors.size() > 1) end = descriptors[1].first;
+                } else {
+                    end = descriptors.front().first;
+                }
+            }
+
+            ssize_t sent = sendWithDescriptor(connection.fd, connection.outbound.data() + connection.written,
+                                              end - connection.written, segmentFd);
+            if (sent > 0) {
+                connection.written += static_cast<size_t>(sent);
+                if (segmentFd >= 0) descriptors.pop_front();
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!connection.waitingToWrite) {
+                    if (!watch(connection.fd, id, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD)) {
+                        closeConnection(id);
+                        return;
+                    }
+                    connection.waitingToWrite = true;
+                }
+                return;
+            }
+            closeConnection(id);
+            return;
+        }
+
+        connection.outbound.clear();
+        connection.written = 0;
+        if (connection.waitingToWrite) {
+            connection.waitingToWrite = false;
+            if (!watch(connection.fd, id, EPOLLIN, EPOLL_CTL_MOD)) {
+                closeConnection(id);
+            }
+        }
+    }
+};
+
+MettaServer::MettaServer(MettaAPI& api, Options options)
+    : pImpl(std::make_unique<Impl>(api, std::move(options))) {}
+
+MettaServer::~MettaServer() {
+    stop();
+}
+
+void MettaServer::start() {
+    if (pImpl->running.load()) return;
+
+    pImpl->bindSocket();
+    pImpl->running = true;
+    pImpl->loop = std::thread(&Impl::serve, pImpl.get());
+}
+
+void MettaServer::stop() {
+    if (!pImpl->running.exchange(false)) return;
+
+    pImpl->wake();
+    if (pImpl->loop.joinable()) {
+        pImpl->loop.join();
+    }
+
+    // Callbacks still reference the server
+    {
+        std::unique_lock<std::mutex> lock(pImpl->pendingMutex);
+        pImpl->pendingDone.wait(lock, [this] { return pImpl->pending == 0; });
+    }
+
+    pImpl->closeAll();
+    std::error_code ec;
+    fs::remove(pImpl->options.socketPath, ec);
+}
+
+bool MettaServer::isRunning() const {
+    return pImpl->running.load();
+}
+
+MettaServer::Stats MettaServer::stats() const {
+    Stats stats;
+    stats.connections = pImpl->acceptedCount.load();
+    stats.requests = pImpl->requestCount.load();
+    stats.cacheHits = pImpl->cacheHitCount.load();
+    stats.protocolErrors = pImpl->protocolErrorCount.load();
+    stats.cancelled = pImpl->cancelledCount.load();
+    stats.slowReaders = pImpl->slowReaderCount.load();
+    return stats;
+}
+
+const std::string& MettaServer::socketPath() const {
+    return pImpl->options.socketPath;
+}
+
+}
@@ -0,0 +1,78 @@
+#ifndef METTA_SERVER_HPP
+#define METTA_SERVER_HPP
+
+#include "metta_api.hpp"
+#include <string>
+#include <memory>
+#include <cstdint>
+
+namespace metta_api {
+
+// Serves a MettaAPI to MettaClients over a Unix domain socket (see
+// WireProtocol). One thread multiplexes all connections and requests run
+// through the API's async path, so each connection can pipeline any
+// number of requests; responses are sent as they complete.
+//
+// A client's Cancel message cancels that request, and a client that
+// disconnects cancels everything it still had running, so abandoned work
+// frees its REPL process right away.
+//
+// Requests with rawOutputMode "shm" get their SharedResult segment as a
+// file descriptor next to the response, so large outputs reach the client
+// without passing through the socket.
+//
+// Successful responses are cached by request content (and file stamp for
+// file requests) while the API watches its modules, keyed to the module
+// snapshot version and the inference configuration generation so edits to
+// either invalidate them. Requests that bring their own module paths are
+// never cached.
+//
+// Clients name files and modules the daemon reads and runs, so the socket
+// is created with socketMode (owner only by default). A client that stops
+// reading is dropped once maxOutboundBytes of its responses are unsent.
+class MettaServer {
+public:
+    struct Options {
+        std::string socketPath;
+        size_t cacheEntries = 256;     // 0 disables the result cache
+        size_t maxConnections = 1024;
+        unsigned int socketMode = 0600;           // Permission bits of the socket file
+        size_t maxOutboundBytes = size_t(64) << 20;  // Unsent per connection; one response may exceed it
+    };
+
+    struct Stats {
+        uint64_t connections = 0;      // Accepted since start
+        uint64_t requests = 0;
+        uint64_t cacheHits = 0;
+        uint64_t protocolErrors = 0;   // Connections dropped for bad frames
+        uint64_t cancelled = 0;        // Requests cancelled by their client or its disconnect
+        uint64_t slowReaders = 0;      // Connections dropped with maxOutboundBytes unsent
+    };
+
+    MettaServer(MettaAPI& api, Options options);
+    ~MettaServer();
+
+    MettaServer(const MettaServer&) = delete;
+    MettaServer& operator=(const MettaServer&) = delete;
+
+    // Binds the socket and serves on a background thread. Throws
+    // std::runtime_error when the socket cannot be created or another
+    // server is already listening on it.
+    void start();
+
+    // Closes the socket and every connection, cancelling their in-flight
+    // requests, and waits for those to be answered
+    void stop();
+
+    bool isRunning() const;
+    Stats stats() const;
+    const std::string& socketPath() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+#include "metta_shared_result.hpp"
+#include <stdexcept>
+#include <string>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace metta_api {
+
+namespace {
+
+constexpr char MAGIC[4] = {'M', 'T', 'R', 'S'};
+constexpr size_t HEADER_SIZE = 32;
+
+std::runtime_error segmentError(const std::string& what) {
+    return std::runtime_error(what + ": " + strerror(errno));
+}
+
+void putU32(char* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void putU64(char* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint32_t getU32(const char* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(in[i]);
+    }
+    return value;
+}
+
+uint64_t getU64(const char* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(in[i]);
+    }
+    return value;
+}
+
+}
+
+#ifdef __linux__
+
+namespace {
+
+// Readers rely on the contents never changing under their mapping
+constexpr int REQUIRED_SEALS = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+
+// Writes all of the parts, continuing after short writes
+void writeAll(int fd, iovec* parts, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, parts, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw segmentError("Failed to write shared result");
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= parts->iov_len) {
+            remaining -= parts->iov_len;
+            ++parts;
+            --count;
+        }
+        if (count > 0) {
+            parts->iov_base = static_cast<char*>(parts->iov_base) + remaining;
+            parts->iov_len -= remaining;
+        }
+    }
+}
+
+}
+
+std::shared_ptr<const SharedResult> SharedResult::create(std::string_view metrics, std::string_view rawOutput) {
+    int fd = memfd_create("metta-result", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        throw segmentError("Failed to create shared result");
+    }
+
+    std::shared_ptr<SharedResult> result(new SharedResult());
+    result->descriptor = fd;
+
+    char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    putU32(header + 4, VERSION);
+    putU64(header + 8, metrics.size());
+    putU64(header + 16, rawOutput.size());
+
+    // Written through the descriptor: the kernel copies straight into the
+    // segment's pages, with no writable mapping to fault in
+    iovec parts[3] = {
+        {header, HEADER_SIZE},
+        {const_cast<char*>(metrics.data()), metrics.size()},
+        {const_cast<char*>(rawOutput.data()), rawOutput.size()}
+    };
+    writeAll(fd, parts, 3);
+
+    if (fcntl(fd, F_ADD_SEALS, REQUIRED_SEALS | F_SEAL_SEAL) != 0) {
+        throw segmentError("Failed to seal shared result");
+    }
+    result->map(fd);
+    return result;
+}
+
+std::shared_ptr<const SharedResult> SharedResult::adopt(int fd) {
+    std::shared_ptr<SharedResult> result(new SharedResult());
+    result->descriptor = fd;
+
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & REQUIRED_SEALS) != REQUIRED_SEALS) {
+        throw std::runtime_error("Shared result is not sealed");
+    }
+    result->map(fd);
+    return result;
+}
+
+void SharedResult::map(int fd) {
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        throw segmentError("Failed to inspect shared result");
+    }
+    if (info.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        throw std::runtime_error("Malformed shared result: truncated");
+    }
+
+    mappedSize = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        throw segmentError("Failed to map shared result");
+    }
+    mapping = address;
+
+    const char* data = static_cast<const char*>(mapping);
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || getU32(data + 4) != VERSION) {
+        throw std::runtime_error("Malformed shared result: bad header");
+    }
+
+    uint64_t metricsSize = getU64(data + 8);
+    uint64_t rawSize = getU64(data + 16);
+    uint64_t available = mappedSize - HEADER_SIZE;
+    if (metricsSize > available || rawSize > available - metricsSize) {
+        throw std::runtime_error("Malformed shared result: sizes exceed the segment");
+    }
+    metricsView = std::string_view(data + HEADER_SIZE, metricsSize);
+    rawView = std::string_view(data + HEADER_SIZE + metricsSize, rawSize);
+}
+
+SharedResult::~SharedResult() {
+    if (mapping) {
+        munmap(mapping, mappedSize);
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+}
+
+#else
+
+std::shared_ptr<const SharedResult> SharedResult::create(std::string_view, std::string_view) {
+    throw std::runtime_error("Shared-memory results need Linux");
+}
+
+std::shared_ptr<const SharedResult> SharedResult::adopt(int) {
+    throw std::runtime_error("Shared-memory results need Linux");
+}
+
+void SharedResult::map(int) {}
+
+SharedResult::~SharedResult() = default;
+
+#endif
+
+}
@@ -0,0 +1,63 @@
+#ifndef METTA_SHARED_RESULT_HPP
+#define METTA_SHARED_RESULT_HPP
+
+#include <string_view>
+#include <memory>
+#include <cstdint>
+
+namespace metta_api {
+
+// One inference result in a sealed shared-memory segment (Linux memfd),
+// for handing large outputs to other local processes without copying.
+//
+// The segment holds the ResultCodec encoding of the Metrics and the raw
+// REPL output. It is sealed against writes, growing and shrinking before
+// anyone else sees it, so readers in other processes can map it and use
+// the views directly. Pass fd() on (e.g. with SCM_RIGHTS, as the daemon
+// does) and open it there with SharedResult::adopt; the memory lives as
+// long as any descriptor or mapping does.
+//
+// Layout: magic "MTRS", u32 version, u64 metrics size, u64 raw output
+// size, 8 reserved bytes, then the metrics and the raw output.
+class SharedResult {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // Copies both parts into a new sealed segment. Throws
+    // std::runtime_error when shared memory is unavailable.
+    static std::shared_ptr<const SharedResult> create(std::string_view metrics, std::string_view rawOutput);
+
+    // Maps a segment received from another process and takes ownership of
+    // fd (closed even on failure). Throws std::runtime_error unless fd is
+    // a fully sealed, well-formed segment.
+    static std::shared_ptr<const SharedResult> adopt(int fd);
+
+    ~SharedResult();
+
+    SharedResult(const SharedResult&) = delete;
+    SharedResult& operator=(const SharedResult&) = delete;
+
+    // Owned by the segment; dup() it to keep it beyond the segment
+    int fd() const { return descriptor; }
+    size_t size() const { return mappedSize; }
+
+    // Views into the mapping, valid while the segment is
+    std::string_view metrics() const { return metricsView; }  // Read with metta_inference::ResultReader
+    std::string_view rawOutput() const { return rawView; }
+
+private:
+    SharedResult() = default;
+
+    // Maps the sealed fd read-only and checks the layout
+    void map(int fd);
+
+    int descriptor = -1;
+    void* mapping = nullptr;
+    size_t mappedSize = 0;
+    std::string_view metricsView;
+    std::string_view rawView;
+};
+
+}
+
+#endif
@@ -1,12 +1,25 @@
 #include "CLI11.hpp"
 #include "metta_inference/inference_engine.hpp"
 #include "metta_inference/config.hpp"
+#include "metta_inference/scenario_partitioner.hpp"
+#include "metta_inference/output_sink.hpp"
 #include <iostream>
 #include <filesystem>
 #include <sstream>
 #include <fstream>
 #include <regex>
+#include <iomanip>
+#include <ctime>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <thread>
+#include <fnmatch.h>
+
+#ifdef METTA_CLI_WITH_API
+#include "metta_api.hpp"
+#endif
 
 namespace mi = metta_inference;
 namespace fs = std::filesystem;
@@ -47,20 +60,33 @@ private:
         return paths;
     }
 
-    void saveOutput(const std::string& exampleName, const std::string& formattedOutput,
-                   const std::string& extension) {
-        if (!config.saveOutput) return;
+    static std::string extensionFor(mi::OutputFormat format) {
+        switch (format) {
+            case mi::OutputFormat::Pretty: return ".txt";
+            case mi::OutputFormat::JSON: return ".json";
+            case mi::OutputFormat::CSV: return ".csv";
+            case mi::OutputFormat::Markdown: return ".md";
+            case mi::OutputFormat::Binary: return ".mtrb";
+        }
+        return ".txt";
+    }
+
+    // Returns the file written, or an empty path when saving failed
+    fs::path saveOutput(const std::string& exampleName, const std::string& formattedOutput,
+                        const std::string& extension) {
 
         try {
             fs::create_directories(config.outputDir);
 
             auto now = std::chrono::system_clock::now();
             auto time_t = std::chrono::system_clock::to_time_t(now);
+            std::tm local{};
+            localtime_r(&time_t, &local);  // Batch runs save from several threads
             std::ostringstream filename;
             filename << config.outputDir.string() << "/" << exampleName << "_"
-                    << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S") << extension;
+                    << std::put_time(&local, "%Y%m%d_%H%M%S") << extension;
 
-            std::ofstream file(filename.str());
+            std::ofstream file(filename.str(), std::ios::binary);
             if (!file.is_open()) {
                 throw std::runtime_error("Failed to open output file: " + filename.str());
             }
@@ -75,13 +101,263 @@ private:
             }
 
             file.close();
-            std::cout << "\n" << Color::BOLD << "Results saved to:" << Color::NC
-                     << " " << filename.str() << "\n";
+            return filename.str();
 
         } catch (const std::exception& e) {
             std::cerr << Color::RED << "Warning: Failed to save output: "
                      << e.what() << Color::NC << "\n";
+            return {};
+        }
+    }
+
+    // Files, directories (their .metta files) and glob patterns, expanded
+    // in order; a pattern may only have wildcards in its file name.
+    // Returns false after reporting an input that cannot be used.
+    bool expandInputs(const std::vector<std::string>& inputs, std::vector<fs::path>& files) {
+        std::set<fs::path> seen;
+        auto add = [&](const fs::path& file) {
+            if (seen.insert(fs::weakly_canonical(file)).second) {
+                files.push_back(file);
+            }
+        };
+
+        for (const auto& input : inputs) {
+            fs::path path(input);
+            bool pattern = input.find_first_of("*?[") != std::string::npos;
+
+            if (!pattern && fs::is_regular_file(path)) {
+                add(path);
+                continue;
+            }
+            if (pattern && path.parent_path().string().find_first_of("*?[") != std::string::npos) {
+                std::cerr << Color::RED << "Error: Wildcards are only supported in the file name: "
+                         << input << Color::NC << "\n";
+                return false;
+            }
+            if (!pattern && !fs::is_directory(path)) {
+                std::cerr << Color::RED << "Error: Example file not found: "
+                         << input << Color::NC << "\n";
+                return false;
+            }
+
+            fs::path directory = pattern ? path.parent_path() : path;
+            std::string filename = path.filename().string();
+            std::vector<fs::path> matches;
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(directory.empty() ? "." : directory, ec)) {
+                if (!entry.is_regular_file()) continue;
+                bool match = pattern
+                    ? fnmatch(filename.c_str(), entry.path().filename().c_str(), 0) == 0
+                    : entry.path().extension() == ".metta";
+                if (match) {
+                    // Keep the directory as given ("./x.metta" stays "x.metta")
+                    matches.push_back(directory / entry.path().filename());
+                }
+            }
+            if (ec) {
+                std::cerr << Color::RED << "Error: Cannot read directory " << directory
+                         << ": " << ec.message() << Color::NC << "\n";
+                return false;
+            }
+            if (matches.empty()) {
+                std::cerr << Color::RED << "Warning: No example files in " << input
+                         << Color::NC << "\n";
+            }
+            std::sort(matches.begin(), matches.end());
+            for (const auto& match : matches) {
+                add(match);
+            }
+        }
+        return true;
+    }
+
+    struct BatchOutcome {
+        int contradictions = 0;
+        int conflicts = 0;
+        int violations = 0;
+        bool partial = false;
+        bool hasLogicalIssues = false;
+        std::string error;  // Set when the example could not be inferred
+        double seconds = 0.0;
+        fs::path saved;
+    };
+
+    // Runs every example through MettaAPI, with its scheduler keeping at
+    // most jobs REPL processes running (without the API library they run
+    // one after another). Prints a line per example as it finishes, then
+    // totals.
+    int runBatch(const std::vector<fs::path>& files, size_t jobs, const std::string& format) {
+#ifdef METTA_CLI_WITH_API
+        size_t limit = jobs ? jobs : std::max(1u, std::thread::hardware_concurrency());
+#else
+        if (jobs > 1) {
+            std::cerr << Color::RED << "Warning: --jobs needs the API library; examples run one at a time"
+                     << Color::NC << "\n";
+        }
+        size_t limit = 1;
+#endif
+        auto startTime = std::chrono::steady_clock::now();
+
+        // Examples with the same name would save over each other's reports
+        std::set<std::string> stems;
+        for (const auto& file : files) {
+            if (config.saveOutput && !stems.insert(file.stem().string()).second) {
+                std::cerr << Color::RED << "Warning: Several examples are named "
+                         << file.stem() << "; their saved reports may overwrite each other"
+                         << Color::NC << "\n";
+            }
+        }
+
+        if (config.verbose) {
+            std::cout << Color::CYAN << "=== MeTTa CT Modular Inference Runner V2 ===" << Color::NC << "\n";
+            std::cout << Color::BOLD << "Engine:" << Color::NC << " " << config.mettaReplPath << "\n";
+            std::cout << Color::BOLD << "Examples:" << Color::NC << " " << files.size()
+                     << " (" << limit << " at a time)\n\n";
+        }
+
+        std::string extension = extensionFor(config.outputFormat);
+        std::vector<BatchOutcome> outcomes(files.size());
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t finished = 0;
+
+        // Called once per example, from a completion thread or this one
+        auto report = [&](size_t index, BatchOutcome&& outcome) {
+            std::lock_guard<std::mutex> lock(mutex);
+            outcomes[index] = std::move(outcome);
+            const auto& done = outcomes[index];
+            ++finished;
+
+            std::ostringstream line;
+            line << "[" << std::setw(std::to_string(files.size()).size()) << finished << "/" << files.size() << "] ";
+            if (!done.error.empty()) {
+                line << Color::RED << "✗ " << Color::NC << files[index].string() << "  "
+                     << Color::RED << done.error << Color::NC;
+            } else {
+                line << (done.hasLogicalIssues ? Color::RED : Color::GREEN)
+                     << (done.hasLogicalIssues ? "✗ " : "✓ ") << Color::NC << files[index].string()
+                     << std::fixed << std::setprecision(1) << "  " << done.seconds << "s  "
+                     << done.contradictions << " contradictions, "
+                     << done.conflicts << " conflicts, "
+                     << done.violations << " violations";
+                if (done.partial) {
+                    line << " (partial)";
+                }
+                if (!done.saved.empty()) {
+                    line << "  → " << done.saved.string();
+                }
+            }
+            std::cout << line.str() << "\n" << std::flush;
+            changed.notify_all();
+        };
+
+#ifdef METTA_CLI_WITH_API
+        {
+            metta_api::MettaAPI api;
+            api.setMettaReplPath(config.mettaReplPath.string());
+            std::vector<std::string> modules;
+            for (const auto& path : config.modulePaths) {
+                modules.push_back(path.string());
+            }
+            api.setDefaultModulePaths(modules);
+            api.setOutputDir(config.outputDir.string());
+            if (!config.inferenceConfigFile.empty()) {
+                api.setInferenceConfigFile(config.inferenceConfigFile.string());
+            }
+
+            metta_api::SchedulingOptions scheduling;
+            scheduling.maxConcurrent = limit;
+            scheduling.maxQueued = files.size();  // All are submitted up front
+            api.enableScheduling(true, scheduling);
+
+            metta_api::InferenceRequest request;
+            request.outputFormat = format;
+            request.rawOutputMode = "omit";
+            request.stopOnFirst = config.stopOnFirst;
+
+            for (size_t index = 0; index < files.size(); ++index) {
+                api.runInferenceFromFileAsync(files[index].string(), request,
+                    [this, &report, &files, &extension, index](metta_api::InferenceResponse response) {
+                        BatchOutcome outcome;
+                        if (!response.success) {
+                            outcome.error = response.error.empty() ? "Inference failed" : response.error;
+                        } else {
+                            outcome.contradictions = response.metrics.contradictions;
+                            outcome.conflicts = response.metrics.conflicts;
+                            outcome.violations = response.metrics.violations;
+                            outcome.partial = response.partial;
+                            outcome.hasLogicalIssues = response.hasLogicalIssues;
+                            // Time running, not waiting for a slot
+                            outcome.seconds = (response.processingTimeMs - response.queueTimeMs) / 1000.0;
+                            if (config.saveOutput) {
+                                outcome.saved = saveOutput(files[index].stem().string(),
+                                                           response.formattedOutput, extension);
+                            }
+                        }
+                        report(index, std::move(outcome));
+                    });
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return finished == files.size(); });
+        }
+#else
+        (void)format;
+        mi::Config shared = config;
+        shared.verbose = false;
+        // Every example resolves and describes with the same configuration
+        shared.inferenceConfig = mi::captureInferenceConfiguration(config);
+
+        for (size_t index = 0; index < files.size(); ++index) {
+            auto started = std::chrono::steady_clock::now();
+            BatchOutcome outcome;
+            try {
+                mi::Config exampleConfig = shared;
+                exampleConfig.exampleFile = files[index];
+                auto result = mi::createInferenceEngineV2(exampleConfig)->run(files[index]);
+                outcome.contradictions = result.metrics.contradictions;
+                outcome.conflicts = result.metrics.conflicts;
+                outcome.violations = result.metrics.violations;
+                outcome.partial = result.metrics.partial;
+                outcome.hasLogicalIssues = result.hasLogicalIssues;
+                outcome.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+                if (config.saveOutput) {
+                    outcome.saved = saveOutput(files[index].stem().string(), result.formattedOutput, extension);
+                }
+            } catch (const std::exception& e) {
+                outcome.error = e.what();
+            }
+            report(index, std::move(outcome));
+        }
+#endif
+
+        size_t failed = 0;
+        size_t withIssues = 0;
+        BatchOutcome totals;
+        for (const auto& outcome : outcomes) {
+            if (!outcome.error.empty()) {
+                ++failed;
+                continue;
+            }
+            if (outcome.hasLogicalIssues) ++withIssues;
+            totals.contradictions += outcome.contradictions;
+            totals.conflicts += outcome.conflicts;
+            totals.violations += outcome.violations;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        std::cout << "\n" << Color::BOLD << "Summary:" << Color::NC << "\n";
+        std::cout << "  • Examples: " << files.size() << " (" << (files.size() - failed - withIssues)
+                 << " clean, " << withIssues << " with issues, " << failed << " failed)\n";
+        std::cout << "  • Findings: " << totals.contradictions << " contradictions, "
+                 << totals.conflicts << " conflicts, " << totals.violations << " violations\n";
+        std::cout << "  • Processing time: " << std::fixed << std::setprecision(1) << seconds << "s\n";
+        if (config.saveOutput) {
+            std::cout << "  • Reports saved to: " << config.outputDir.string() << "\n";
         }
+
+        if (failed > 0) return 1;
+        return withIssues > 0 ? 2 : 0;
     }
 
 public:
@@ -93,7 +369,7 @@ public:
 
         std::string formatStr = "pretty";
         app.add_option("-f,--format", formatStr, "Output format")
-            ->check(CLI::IsMember({"pretty", "json", "csv", "markdown"}))
+            ->check(CLI::IsMember({"pretty", "json", "csv", "markdown", "binary"}))
             ->default_val("pretty");
 
         app.add_flag("-s,--save", config.saveOutput, "Save results to file");
@@ -115,9 +391,24 @@ public:
             "Path to metta-repl executable")
             ->default_val("/usr/local/bin/metta-repl");
 
-        app.add_option("example", config.exampleFile, "Example MeTTa file to process")
-            ->required()
-            ->check(CLI::ExistingFile);
+        size_t shards = 1;
+        app.add_option("--shards", shards,
+            "Split the scenario into up to N independent shards and infer them in parallel (0 = one per component)")
+            ->default_val(1);
+
+        app.add_flag("--stop-on-first", config.stopOnFirst,
+            "Stop inference at the first contradiction, conflict or violation (for yes/no checks)");
+
+        size_t jobs = 0;
+        app.add_option("-j,--jobs", jobs,
+            "Examples to infer at once when several are given (0 = one per core)")
+            ->default_val(0);
+        
+        std::vector<std::string> inputs;
+        app.add_option("examples", inputs,
+            "Example MeTTa files to process; directories and quoted glob patterns\n"
+            "expand to the .metta files they hold")
+            ->required();
 
         // Set up version and help info
         app.set_version_flag("--version", "2.0.0 (S-Expression Parser)");
@@ -135,7 +426,14 @@ public:
                   "  metta_cli -v -s example1.metta              # Verbose with saved output\n"
                   "  metta_cli -f json -s example1.metta         # Save as JSON\n"
                   "  metta_cli -m ./base,./knowledge example1.metta  # Custom module paths\n"
-                  "  metta_cli -e /path/to/metta-repl example1.metta  # Custom engine path");
+                  "  metta_cli -e /path/to/metta-repl example1.metta  # Custom engine path\n"
+                  "  metta_cli --shards 8 large_scenario.metta       # Parallel inference over 8 shards\n"
+                  "  metta_cli --stop-on-first -f json gate.metta    # Fail fast at the first finding\n"
+                  "  metta_cli -j 8 -s -f json ./scenarios        # Every scenario, 8 at a time\n"
+                  "  metta_cli 'scenarios/port_*.metta' other.metta  # Glob patterns and files\n"
+                  "\n"
+                  "With several examples, a line is printed per example and then a summary;\n"
+                  "use -s to keep each report. Exit status: 0 clean, 2 logical issues, 1 errors.");
 
         // Parse arguments
         CLI11_PARSE(app, argc, argv);
@@ -145,6 +443,10 @@ public:
         else if (formatStr == "json") config.outputFormat = mi::OutputFormat::JSON;
         else if (formatStr == "csv") config.outputFormat = mi::OutputFormat::CSV;
         else if (formatStr == "markdown") config.outputFormat = mi::OutputFormat::Markdown;
+        else if (formatStr == "binary") config.outputFormat = mi::OutputFormat::Binary;
+
+        // Formatters render finding descriptions on demand
+        config.metricsDetail = mi::MetricsDetail::Lazy;
 
         // Parse module paths
         config.modulePaths = parseModulePaths(modulePaths);
@@ -152,16 +454,17 @@ public:
         // Load configuration file if specified
         if (!configFile.empty()) {
             fs::path configPath(configFile);
-            if (fs::exists(configPath)) {
-                if (config.verbose) {
-                    std::cout << Color::CYAN << "Loading configuration from: "
-                             << configPath << Color::NC << "\n";
-                }
-                // Configuration will be loaded by the V2 engine
-            } else {
-                std::cerr << Color::RED << "Warning: Config file not found: "
+            if (!fs::exists(configPath)) {
+                std::cerr << Color::RED << "Error: Config file not found: "
                          << configPath << Color::NC << "\n";
+                return 1;
             }
+            if (config.verbose) {
+                std::cout << Color::CYAN << "Loading configuration from: "
+                         << configPath << Color::NC << "\n";
+            }
+            // Loaded by the engine in place of the default location
+            config.inferenceConfigFile = configPath;
         }
 
         // Validate module paths exist
@@ -209,6 +512,35 @@ public:
             return 1;
         }
 
+        std::vector<fs::path> files;
+        if (!expandInputs(inputs, files)) {
+            return 1;
+        }
+        if (files.empty()) {
+            std::cerr << Color::RED << "Error: No example files to process" << Color::NC << "\n";
+            return 1;
+        }
+
+        // A directory or pattern is a batch even when it holds one example
+        if (inputs.size() > 1 || files.size() > 1 || !fs::is_regular_file(inputs.front())) {
+            if (shards != 1) {
+                std::cerr << Color::RED << "Error: --shards applies to a single example"
+                         << Color::NC << "\n";
+                return 1;
+            }
+            if (config.showRaw) {
+                std::cerr << Color::RED << "Warning: --raw is ignored with several examples"
+                         << Color::NC << "\n";
+            }
+            try {
+                return runBatch(files, jobs, formatStr);
+            } catch (const std::exception& e) {
+                std::cerr << Color::RED << "Error: " << e.what() << Color::NC << "\n";
+                return 1;
+            }
+        }
+        config.exampleFile = files.front();
+
         // Run the inference
         try {
             auto startTime = std::chrono::steady_clock::now();
@@ -228,21 +560,34 @@ public:
             }
 
             // Use V2 engine with improved S-Expression parser
-            auto engine = mi::createInferenceEngineV2(config);
-            auto result = engine->run(config.exampleFile);
-
-            std::cout << result.formattedOutput << "\n";
-
-            // Get extension based on format
-            std::string extension;
-            switch (config.outputFormat) {
-                case mi::OutputFormat::Pretty: extension = ".txt"; break;
-                case mi::OutputFormat::JSON: extension = ".json"; break;
-                case mi::OutputFormat::CSV: extension = ".csv"; break;
-                case mi::OutputFormat::Markdown: extension = ".md"; break;
+            // Binary output must reach stdout byte for byte
+            const char* terminator = config.outputFormat == mi::OutputFormat::Binary ? "" : "\n";
+
+            mi::InferenceEngine::Result result;
+            if (shards == 1 && !config.saveOutput) {
+                // Nothing to save, so write the report straight to stdout
+                auto engine = mi::createInferenceEngineV2(config);
+                mi::StreamSink sink(std::cout);
+                result = engine->run(config.exampleFile, sink);
+                std::cout << terminator;
+            } else {
+                if (shards == 1) {
+                    auto engine = mi::createInferenceEngineV2(config);
+                    result = engine->run(config.exampleFile);
+                } else {
+                    result = mi::ScenarioPartitioner::runParallel(config, config.exampleFile, shards);
+                }
+                std::cout << result.formattedOutput << terminator;
             }
 
-            saveOutput(config.exampleFile.stem().string(), result.formattedOutput, extension);
+            if (config.saveOutput) {
+                auto saved = saveOutput(config.exampleFile.stem().string(), result.formattedOutput,
+                                        extensionFor(config.outputFormat));
+                if (!saved.empty()) {
+                    std::cout << "\n" << Color::BOLD << "Results saved to:" << Color::NC
+                             << " " << saved.string() << "\n";
+                }
+            }
 
             if (config.showRaw) {
                 std::cout << "\n" << Color::CYAN << "=== RAW METTA OUTPUT ==="
@@ -0,0 +1,138 @@
+#include "CLI11.hpp"
+#include "metta_api.hpp"
+#include "metta_server.hpp"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <csignal>
+#include <pthread.h>
+
+namespace Color {
+    inline constexpr std::string_view RED = "\033[0;31m";
+    inline constexpr std::string_view GREEN = "\033[0;32m";
+    inline constexpr std::string_view NC = "\033[0m";
+}
+
+std::vector<std::string> parseModulePaths(const std::string& pathsStr) {
+    std::vector<std::string> paths;
+    std::istringstream stream(pathsStr);
+    std::string path;
+
+    while (std::getline(stream, path, ',')) {
+        path.erase(path.begin(), std::find_if(path.begin(), path.end(),
+                  [](unsigned char ch) { return !std::isspace(ch); }));
+        path.erase(std::find_if(path.rbegin(), path.rend(),
+                  [](unsigned char ch) { return !std::isspace(ch); }).base(), path.end());
+
+        if (!path.empty()) {
+            paths.push_back(path);
+        }
+    }
+
+    return paths;
+}
+
+int main(int argc, char* argv[]) {
+    CLI::App app{"MeTTa inference daemon - serves inference over a Unix domain socket"};
+
+    metta_api::MettaServer::Options options;
+    options.socketPath = "/tmp/metta_inferenced.sock";
+    app.add_option("-s,--socket", options.socketPath, "Unix domain socket to listen on")
+        ->default_val(options.socketPath);
+
+    std::string modulePaths = "/app/base,/app/knowledge,/app/reason";
+    app.add_option("-m,--modules", modulePaths, "Module directories (comma-separated)")
+        ->default_val(modulePaths);
+
+    std::string replPath = "/usr/local/bin/metta-repl";
+    app.add_option("-e,--engine", replPath, "Path to metta-repl executable")
+        ->default_val(replPath);
+
+    app.add_option("--cache", options.cacheEntries, "Cached responses (0 disables the cache)")
+        ->default_val(options.cacheEntries);
+
+    app.add_option("--max-connections", options.maxConnections, "Concurrent client connections")
+        ->default_val(options.maxConnections);
+
+    // Anyone who can connect can have the daemon read files and run modules
+    std::string socketMode = "0600";
+    app.add_option("--socket-mode", socketMode, "Permissions of the socket file (octal)")
+        ->default_val(socketMode);
+
+    // Interactive checks and bulk sweeps share the daemon; the scheduler
+    // keeps batch work from taking every REPL slot
+    metta_api::SchedulingOptions scheduling;
+    app.add_option("--max-concurrent", scheduling.maxConcurrent, "Concurrent REPL processes (0 = one per core)")
+        ->default_val(scheduling.maxConcurrent);
+    app.add_option("--max-batch", scheduling.maxBatchConcurrent,
+                   "Concurrent REPL processes for batch requests (0 = half)")
+        ->default_val(scheduling.maxBatchConcurrent);
+    app.add_option("--max-per-tenant", scheduling.maxPerTenant, "Concurrent requests per tenant (0 = unlimited)")
+        ->default_val(scheduling.maxPerTenant);
+    app.add_option("--max-queued", scheduling.maxQueued, "Queued requests before new ones are shed")
+        ->default_val(scheduling.maxQueued);
+
+    app.footer("EXAMPLES:\n"
+              "  metta_inferenced -m ./base,./knowledge,./reason -e ./metta-repl\n"
+              "  metta_inferenced -s /run/metta/inference.sock --cache 1024\n"
+              "  metta_inferenced --max-concurrent 8 --max-batch 2 --max-per-tenant 4");
+
+    CLI11_PARSE(app, argc, argv);
+
+    try {
+        size_t parsed = 0;
+        options.socketMode = static_cast<unsigned int>(std::stoul(socketMode, &parsed, 8));
+        if (parsed != socketMode.size() || options.socketMode > 0777) {
+            throw std::invalid_argument(socketMode);
+        }
+    } catch (const std::exception&) {
+        std::cerr << Color::RED << "Error: Invalid socket mode: " << socketMode << Color::NC << "\n";
+        return 1;
+    }
+
+    // Handle termination signals synchronously; blocked before any thread
+    // starts, so every thread inherits the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try {
+        metta_api::MettaAPI api;
+        if (!api.validateMettaReplPath(replPath)) {
+            std::cerr << Color::RED << "Error: MeTTa REPL executable not found: " << replPath
+                      << Color::NC << "\n";
+            return 1;
+        }
+        api.setMettaReplPath(replPath);
+        api.setDefaultModulePaths(parseModulePaths(modulePaths));
+
+        // Modules stay loaded and are swapped on change; cached responses
+        // are tied to the snapshot version
+        api.enableModuleWatching();
+        api.enableScheduling(true, scheduling);
+
+        metta_api::MettaServer server(api, options);
+        server.start();
+        std::cout << Color::GREEN << "Listening on " << server.socketPath() << Color::NC
+                  << " (module snapshot v" << api.moduleSnapshotVersion() << ")\n";
+
+        int received = 0;
+        sigwait(&signals, &received);
+
+        std::cout << "Shutting down...\n";
+        server.stop();
+
+        auto stats = server.stats();
+        std::cout << "Served " << stats.requests << " requests on " << stats.connections
+                  << " connections (" << stats.cacheHits << " from cache, "
+                  << api.schedulingStats().rejected << " shed)\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "Fatal error: " << e.what() << Color::NC << "\n";
+        return 1;
+    }
+}
@@ -53,7 +53,7 @@ private:
         }
     }
     
-    void printStateOfAffairs(const mi::StateOfAffairs& soa) {
+    void printStateOfAffairs(const mi::KnowledgeStateOfAffairs& soa) {
         if (!soa.description.empty()) {
             std::cout << Color::CYAN << "Description: " << Color::NC 
                      << soa.description << "\n";
@@ -193,7 +193,7 @@ public:
         create->callback([&]() {
             try {
                 mi::Norm exampleNorm;
-                mi::StateOfAffairs exampleSoa;
+                mi::KnowledgeStateOfAffairs exampleSoa;
                 
                 if (createType == "norm" || createType == "both") {
                     // Create example norm
@@ -546,6 +546,112 @@ public:
             }
         });
         
+        // Diff command
+        auto* diff = app.add_subcommand("diff",
+            "Show what changed between two state of affairs files");
+        
+        std::string diffOld;
+        std::string diffNew;
+        bool diffSummary = false;
+        bool diffExitCode = false;
+        
+        diff->add_option("old", diffOld, "Earlier MeTTa file")
+            ->required()
+            ->check(CLI::ExistingFile);
+        diff->add_option("new", diffNew, "Later MeTTa file")
+            ->required()
+            ->check(CLI::ExistingFile);
+        diff->add_flag("--summary", diffSummary, "Only print change counts");
+        diff->add_flag("--exit-code", diffExitCode,
+            "Exit with 1 if the files differ (re-evaluation needed)");
+        
+        diff->callback([&]() {
+            try {
+                auto before = mi::KnowledgeIO::readMettaDocument(diffOld);
+                auto after = mi::KnowledgeIO::readMettaDocument(diffNew);
+                auto result = mi::KnowledgeIO::diffDocuments(before, after);
+                
+                std::cout << Color::BOLD << "Diff: " << Color::NC 
+                         << diffOld << " → " << diffNew << "\n\n";
+                
+                if (result.empty()) {
+                    std::cout << Color::GREEN << "✓ No semantic changes" << Color::NC << "\n";
+                    return;
+                }
+                
+                auto printNames = [](const std::string& label, const std::vector<std::string>& added,
+                                     const std::vector<std::string>& removed,
+                                     const std::vector<std::string>& changed) {
+                    if (added.empty() && removed.empty() && changed.empty()) return;
+                    std::cout << Color::CYAN << label << ":" << Color::NC << "\n";
+                    for (const auto& name : added) {
+                        std::cout << "  " << Color::GREEN << "+ " << name << Color::NC << "\n";
+                    }
+                    for (const auto& name : removed) {
+                        std::cout << "  " << Color::RED << "- " << name << Color::NC << "\n";
+                    }
+                    for (const auto& name : changed) {
+                        std::cout << "  " << Color::YELLOW << "~ " << name << Color::NC << "\n";
+                    }
+                };
+                
+                if (!diffSummary) {
+                    if (!result.addedFacts.empty() || !result.removedFacts.empty() ||
+                        !result.changedFacts.empty()) {
+                        std::cout << Color::CYAN << "Facts:" << Color::NC << "\n";
+                        for (const auto& fact : result.addedFacts) {
+                            std::cout << "  " << Color::GREEN << "+ " << fact.toString() << Color::NC << "\n";
+                        }
+                        for (const auto& fact : result.removedFacts) {
+                            std::cout << "  " << Color::RED << "- " << fact.toString() << Color::NC << "\n";
+                        }
+                        for (const auto& change : result.changedFacts) {
+                            std::cout << "  " << Color::YELLOW << "~ " << change.before.toString()
+                                     << " → " << change.after.object << Color::NC << "\n";
+                        }
+                    }
+                    
+                    printNames("Eventualities", result.addedEventualities,
+                               result.removedEventualities, result.changedEventualities);
+                    printNames("Entities", result.addedEntities,
+                               result.removedEntities, result.changedEntities);
+                    printNames("Constraints", result.addedConstraints, result.removedConstraints, {});
+                    printNames("Norms", result.addedNorms, result.removedNorms, result.changedNorms);
+                    std::cout << "\n";
+                }
+                
+                std::cout << Color::CYAN << "Summary:" << Color::NC << "\n";
+                std::cout << "  • Facts: +" << result.addedFacts.size() << " -" 
+                         << result.removedFacts.size() << " ~" << result.changedFacts.size() << "\n";
+                std::cout << "  • Eventualities: +" << result.addedEventualities.size() << " -"
+                         << result.removedEventualities.size() << " ~" 
+                         << result.changedEventualities.size() << "\n";
+                std::cout << "  • Entities: +" << result.addedEntities.size() << " -"
+                         << result.removedEntities.size() << " ~" 
+                         << result.changedEntities.size() << "\n";
+                std::cout << "  • Constraints: +" << result.addedConstraints.size() << " -"
+                         << result.removedConstraints.size() << "\n";
+                std::cout << "  • Norms: +" << result.addedNorms.size() << " -"
+                         << result.removedNorms.size() << " ~" << result.changedNorms.size() << "\n";
+                std::cout << "  • Affected subjects: " << result.affectedSubjects().size() << "\n";
+                
+                if (result.requiresReevaluation()) {
+                    std::cout << "\n" << Color::YELLOW << "Re-evaluation required" << Color::NC << "\n";
+                }
+                
+                if (diffExitCode) {
+                    std::exit(1);
+                }
+                
+            } catch (const std::exception& e) {
+                std::cerr << Color::RED << "Error: " << e.what() 
+                         << Color::NC << "\n";
+                if (diffExitCode) {
+                    std::exit(2);
+                }
+            }
+        });
+        
         // Setup version and help
         app.set_version_flag("--version", "1.0.0");
         app.description("Tool for reading, writing, and manipulating MeTTa knowledge (norms and state of affairs).\n\n"
@@ -554,6 +660,7 @@ public:
                        "  • Creating template files for new norms and facts\n"
                        "  • Analyzing MeTTa file structure and statistics\n"
                        "  • Validating state of affairs against knowledge representation rules\n"
+                       "  • Diffing two state of affairs snapshots\n"
                        "  • Converting between different formats");
         
         app.footer("EXAMPLES:\n"
@@ -562,6 +669,7 @@ public:
                   "  metta_knowledge_cli create norm -o template.metta   # Create norm template\n"
                   "  metta_knowledge_cli analyze input.metta -v          # Analyze with verbose output\n"
                   "  metta_knowledge_cli validate input.metta -v         # Validate state of affairs\n"
+                  "  metta_knowledge_cli diff old.metta new.metta        # Show changed facts and eventualities\n"
                   "  metta_knowledge_cli convert input.metta -o output.metta # Convert/clean MeTTa file");
         
         CLI11_PARSE(app, argc, argv);
@@ -0,0 +1,132 @@
+#include "CLI11.hpp"
+#include "metta_inference/scenario_generator.hpp"
+#include <iostream>
+#include <filesystem>
+#include <cstdlib>
+
+namespace mi = metta_inference;
+namespace fs = std::filesystem;
+
+namespace Color {
+    inline constexpr std::string_view RED = "\033[0;31m";
+    inline constexpr std::string_view GREEN = "\033[0;32m";
+    inline constexpr std::string_view CYAN = "\033[0;36m";
+    inline constexpr std::string_view NC = "\033[0m";
+    inline constexpr std::string_view BOLD = "\033[1m";
+}
+
+class ScenarioGenCLI {
+private:
+    static fs::path defaultKnowledgeDir() {
+        const char* mettaBase = std::getenv("METTA_BASE_PATH");
+        if (mettaBase) {
+            return fs::path(mettaBase) / "knowledge";
+        }
+        return fs::path("../knowledge");
+    }
+
+    static void printStats(const mi::ScenarioGenerator::Stats& stats) {
+        std::cerr << Color::CYAN << "Generated:" << Color::NC << "\n";
+        std::cerr << "  • Vessels: " << stats.vessels << "\n";
+        std::cerr << "  • Eventualities: " << stats.eventualities << "\n";
+        std::cerr << "  • Obligations: " << stats.obligations << "\n";
+        std::cerr << "  • Negations: " << stats.negations << "\n";
+        std::cerr << "  • Contradictions: " << stats.contradictions << "\n";
+        std::cerr << "  • Disjunctions: " << stats.disjunctions << "\n";
+        std::cerr << "  • Facts: " << stats.facts << "\n";
+    }
+
+public:
+    int run(int argc, char* argv[]) {
+        CLI::App app{"MeTTa Synthetic Scenario Generator"};
+
+        mi::ScenarioGenerator::Options options;
+        fs::path knowledgeDir = defaultKnowledgeDir();
+        std::string output;
+        bool noQueries = false;
+        bool quiet = false;
+
+        app.add_option("-n,--vessels", options.vessels, "Number of vessels")
+            ->default_val(options.vessels)
+            ->check(CLI::PositiveNumber);
+        app.add_option("-e,--eventualities", options.eventualities, "Number of eventualities")
+            ->default_val(options.eventualities);
+        app.add_option("--negations", options.negationRatio,
+            "Share of eventualities that are negated instead of asserted")
+            ->default_val(options.negationRatio)
+            ->check(CLI::Range(0.0, 1.0));
+        app.add_option("--disjunctions", options.disjunctionRatio,
+            "Disjunctions (ct-or pairs) per asserted eventuality")
+            ->default_val(options.disjunctionRatio)
+            ->check(CLI::Range(0.0, 1.0));
+        app.add_option("--obligations", options.obligationRatio,
+            "Share of eventualities that are obligatory")
+            ->default_val(options.obligationRatio)
+            ->check(CLI::Range(0.0, 1.0));
+        app.add_option("--contradictions", options.contradictionRatio,
+            "Share of eventualities with an injected contradiction")
+            ->default_val(options.contradictionRatio)
+            ->check(CLI::Range(0.0, 1.0));
+        app.add_option("--seed", options.seed, "Random seed (same seed, same file)")
+            ->default_val(options.seed);
+        app.add_option("-k,--knowledge", knowledgeDir,
+            "Knowledge directory with eventuality.metta and role.metta");
+        app.add_option("-o,--output", output, "Output file (default: stdout)");
+        app.add_flag("--no-queries", noQueries, "Omit make-triples and detection queries");
+        app.add_flag("-q,--quiet", quiet, "Do not print generation statistics");
+
+        app.set_version_flag("--version", "1.0.0");
+        app.footer("EXAMPLES:\n"
+                  "  metta_scenario_gen -n 100 -e 1000 -o large.metta        # 100 vessels, 1000 eventualities\n"
+                  "  metta_scenario_gen -e 50 --contradictions 0.2 --seed 7  # Contradiction-heavy, to stdout\n"
+                  "  metta_scenario_gen -k /app/knowledge -n 10 -e 100       # Explicit ontology location");
+
+        CLI11_PARSE(app, argc, argv);
+
+        if (options.obligationRatio + options.contradictionRatio + options.negationRatio > 1.0) {
+            std::cerr << Color::RED << "Error: obligation, contradiction and negation ratios "
+                     << "must sum to at most 1" << Color::NC << "\n";
+            return 1;
+        }
+
+        options.includeQueries = !noQueries;
+
+        try {
+            auto ontology = mi::ScenarioGenerator::loadOntology(knowledgeDir);
+            mi::ScenarioGenerator generator(ontology, options);
+
+            mi::ScenarioGenerator::Stats stats;
+            if (output.empty()) {
+                stats = generator.generate(std::cout);
+            } else {
+                stats = generator.generateToFile(output);
+                if (!quiet) {
+                    std::cerr << Color::GREEN << "✓" << Color::NC
+                             << " Generated: " << output << "\n";
+                }
+            }
+
+            if (!quiet) {
+                printStats(stats);
+            }
+            return 0;
+
+        } catch (const std::exception& e) {
+            std::cerr << Color::RED << "Error: " << e.what() << Color::NC << "\n";
+            return 1;
+        }
+    }
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        ScenarioGenCLI cli;
+        return cli.run(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "Fatal error: " << e.what() << Color::NC << "\n";
+        return 1;
+    } catch (...) {
+        std::cerr << Color::RED << "Fatal error: Unknown exception" << Color::NC << "\n";
+        return 1;
+    }
+}
@@ -89,7 +89,7 @@ int main(int argc, char* argv[]) {
         
         // Test 8: Create new state of affairs programmatically
         printSeparator("Test 8: Creating New State of Affairs");
-        mi::StateOfAffairs newSoa;
+        mi::KnowledgeStateOfAffairs newSoa;
         newSoa.description = "Test state of affairs";
         
         mi::Triple fact1;
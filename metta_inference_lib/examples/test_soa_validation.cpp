@@ -11,7 +11,7 @@ int main() {
     
     // Test 1: Valid state of affairs
     std::cout << "Test 1: Valid State of Affairs\n";
-    StateOfAffairs validSoa;
+    KnowledgeStateOfAffairs validSoa;
     
     // Create a valid eventuality for ALEXANDRA MÆRSK mooring
     validSoa.facts.push_back(Triple{"soa_emam", "type", "soaMoor", "ct-triple"});
@@ -40,7 +40,7 @@ int main() {
     
     // Test 2: Invalid modality (not rexist)
     std::cout << "\nTest 2: Invalid Modality\n";
-    StateOfAffairs invalidModalitySoa;
+    KnowledgeStateOfAffairs invalidModalitySoa;
     
     Eventuality e2;
     e2.name = "soa_epv";
@@ -61,7 +61,7 @@ int main() {
     
     // Test 3: Invalid naming convention
     std::cout << "\nTest 3: Invalid Naming Convention\n";
-    StateOfAffairs invalidNameSoa;
+    KnowledgeStateOfAffairs invalidNameSoa;
     
     Eventuality e3;
     e3.name = "soa_wrongname";  // Should be soa_emam for Moor + ALEXANDRA_MAERSK
@@ -83,7 +83,7 @@ int main() {
     
     // Test 4: Invalid role predicate
     std::cout << "\nTest 4: Invalid Role Predicate\n";
-    StateOfAffairs invalidRoleSoa;
+    KnowledgeStateOfAffairs invalidRoleSoa;
     
     Eventuality e4;
     e4.name = "soa_elcs";
@@ -105,7 +105,7 @@ int main() {
     
     // Test 5: Missing required agent
     std::cout << "\nTest 5: Missing Required Agent\n";
-    StateOfAffairs missingAgentSoa;
+    KnowledgeStateOfAffairs missingAgentSoa;
     
     Eventuality e5;
     e5.name = "soa_ep";
@@ -174,10 +174,10 @@ void testConfigurationLoading() {
     }
     
     // Test configured resolver
-    auto& resolver = config.getEntityResolver();
+    auto resolver = config.getEntityResolver();
     std::cout << "\nConfigured entity resolution test:" << std::endl;
     std::cout << "  soa_ALEXANDRA_MAERSK -> " 
-              << resolver.resolveEntity("soa_ALEXANDRA_MAERSK") << std::endl;
+              << resolver->resolveEntity("soa_ALEXANDRA_MAERSK") << std::endl;
 }
 
 int main() {
@@ -0,0 +1,133 @@
+#ifndef METTA_INFERENCE_BATCH_EXPORT_HPP
+#define METTA_INFERENCE_BATCH_EXPORT_HPP
+
+#include "config.hpp"
+#include "output_sink.hpp"
+#include "buffer_writer.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+namespace metta_inference {
+
+// One finding of one example. Views only need to live for the addRow call.
+struct ExportRow {
+    std::string_view example;
+    std::string_view kind;         // "contradiction", "conflict", "violation", "inferred_fact", "error"
+    std::string_view subject;      // entity1 / violator / fact text / error message
+    std::string_view object;       // entity2 / violated rule
+    std::string_view description;
+};
+
+enum class BatchExportFormat {
+    Columnar,  // ".mtcb", read with ColumnarBatchReader
+    CSV
+};
+
+// Writes the findings of a whole batch run into one file as results
+// arrive, so nothing is held per example once it has been added
+class BatchExporter {
+public:
+    virtual ~BatchExporter() = default;
+
+    virtual void addRow(const ExportRow& row) = 0;
+
+    // One row per contradiction, conflict, violation and inferred fact
+    void addMetrics(std::string_view example, const Metrics& metrics);
+
+    // Writes buffered rows and any trailer, then flushes the sink; no
+    // rows may be added afterwards
+    virtual void finish() = 0;
+
+    virtual size_t rowCount() const = 0;
+
+    static std::unique_ptr<BatchExporter> create(BatchExportFormat format, OutputSink& sink);
+    static const char* extension(BatchExportFormat format);
+};
+
+// example,kind,subject,object,description with a header line
+class CsvBatchExporter : public BatchExporter {
+public:
+    explicit CsvBatchExporter(OutputSink& sink);
+
+    void addRow(const ExportRow& row) override;
+    void finish() override;
+    size_t rowCount() const override { return rows; }
+
+private:
+    OutputSink& sink;
+    BufferWriter writer;
+    size_t rows = 0;
+};
+
+// Column-major row groups over per-column dictionaries. Every string
+// column is dictionary-encoded: a row stores one u32 id per column, and
+// each distinct value of a row group is written once, in the dictionary
+// blocks preceding it. Dictionaries start over with every row group, so
+// the exporter holds at most one row group's values.
+//
+// Layout (all integers little-endian):
+//   header      magic "MTCB", u16 version, u16 column count
+//   dictionary  'D', u8 column, u32 entries, entries x (u32 length, bytes)
+//   row group   'R', u32 rows, then per column rows x u32 ids, counted
+//               from the column's first entry after the previous group
+//   trailer     'E', u64 total rows, u32 row groups
+class ColumnarBatchExporter : public BatchExporter {
+public:
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t COLUMN_COUNT = 5;
+    static constexpr std::array<const char*, COLUMN_COUNT> COLUMN_NAMES = {
+        "example", "kind", "subject", "object", "description"};
+
+    explicit ColumnarBatchExporter(OutputSink& sink, size_t rowGroupSize = 16384);
+    ~ColumnarBatchExporter() override;
+
+    void addRow(const ExportRow& row) override;
+    void finish() override;
+    size_t rowCount() const override { return totalRows; }
+
+private:
+    struct Column {
+        std::unordered_map<std::string, uint32_t> ids;
+        std::vector<std::string> pending;  // New values not yet written
+        std::vector<uint32_t> rows;        // Ids of the open row group
+    };
+
+    OutputSink& sink;
+    size_t rowGroupSize;
+    std::array<Column, COLUMN_COUNT> columns;
+    size_t totalRows = 0;
+    uint32_t rowGroups = 0;
+    bool finished = false;
+
+    void flushRowGroup();
+};
+
+// Reads a ColumnarBatchExporter file. The buffer must outlive the reader;
+// rows are views into it. Throws std::runtime_error on malformed input.
+class ColumnarBatchReader {
+public:
+    explicit ColumnarBatchReader(std::string_view data);
+
+    size_t rowCount() const { return rows; }
+    ExportRow row(size_t index) const;
+
+    // Dictionary entries of a column in file order: the distinct values of
+    // each row group in turn
+    const std::vector<std::string_view>& dictionary(size_t column) const { return dictionaries.at(column); }
+
+    static bool isColumnar(std::string_view data);
+
+private:
+    std::array<std::vector<std::string_view>, ColumnarBatchExporter::COLUMN_COUNT> dictionaries;
+    std::array<std::vector<uint32_t>, ColumnarBatchExporter::COLUMN_COUNT> ids;
+    size_t rows = 0;
+};
+
+}
+
+#endif
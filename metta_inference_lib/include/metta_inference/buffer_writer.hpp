@@ -0,0 +1,62 @@
+#ifndef METTA_INFERENCE_BUFFER_WRITER_HPP
+#define METTA_INFERENCE_BUFFER_WRITER_HPP
+
+#include "output_sink.hpp"
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace metta_inference {
+
+// Offset of the first byte that needs JSON escaping ('"', '\\' or a
+// control character), or text.size() when there is none
+size_t findJsonEscape(std::string_view text);
+
+// Offset of the first byte that forces a CSV field to be quoted
+// (',', '"', '\n' or '\r'), or text.size()
+size_t findCsvSpecial(std::string_view text);
+
+// Instruction set the scanners above dispatched to at startup:
+// "avx2", "sse2" or "scalar"
+const char* escapeScannerIsa();
+
+// Staging buffer for machine-readable formatters. Clean runs of a string
+// are found with the vectorized scanners and copied in one go; only the
+// bytes that need escaping take the slow path. Output reaches the sink in
+// chunks of about capacity bytes.
+class BufferWriter {
+public:
+    explicit BufferWriter(OutputSink& sink, size_t capacity = 16 * 1024);
+    ~BufferWriter();
+
+    BufferWriter(const BufferWriter&) = delete;
+    BufferWriter& operator=(const BufferWriter&) = delete;
+
+    void write(std::string_view text);
+    void put(char c);
+    void writeInt(int64_t value);
+    void writeUInt(uint64_t value);
+    void writeBool(bool value) { write(value ? "true" : "false"); }
+
+    // Quoted and escaped JSON string
+    void writeJsonString(std::string_view text);
+
+    // RFC 4180 field; quoted only when it contains a separator, quote or newline
+    void writeCsvField(std::string_view text);
+
+    // Hands staged bytes to the sink (does not flush the sink itself)
+    void flush();
+
+private:
+    OutputSink& sink;
+    std::string buffer;
+    size_t capacity;
+
+    void reserveFor(size_t bytes) {
+        if (buffer.size() + bytes > capacity) flush();
+    }
+};
+
+}
+
+#endif
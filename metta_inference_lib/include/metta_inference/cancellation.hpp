@@ -0,0 +1,131 @@
+#ifndef METTA_INFERENCE_CANCELLATION_HPP
+#define METTA_INFERENCE_CANCELLATION_HPP
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <stdexcept>
+#include <cstdint>
+
+namespace metta_inference {
+
+// Thrown by whatever notices a cancelled token: the executor after killing
+// the REPL, the analyzer between expressions, the engine between stages
+class CancelledError : public std::runtime_error {
+public:
+    CancelledError() : std::runtime_error("Inference cancelled") {}
+};
+
+// Cooperative cancellation for one request. Copies share state, so the
+// caller keeps one copy and hands the others down the pipeline; cancel()
+// is sticky and may be called from any thread.
+//
+// A default-constructed token can never be cancelled and costs nothing;
+// create() makes one that can. Header-only, so the daemon client can
+// forward cancellations without linking the engine.
+class CancellationToken {
+    struct State;
+
+public:
+    using Callback = std::function<void()>;
+
+    CancellationToken() = default;
+
+    static CancellationToken create() {
+        CancellationToken token;
+        token.state = std::make_shared<State>();
+        return token;
+    }
+
+    bool canBeCancelled() const { return state != nullptr; }
+
+    bool isCancelled() const {
+        return state && state->cancelled.load(std::memory_order_acquire);
+    }
+
+    void throwIfCancelled() const {
+        if (isCancelled()) {
+            throw CancelledError();
+        }
+    }
+
+    // Runs the callbacks registered so far, once, on this thread
+    void cancel() {
+        if (!state) return;
+        std::lock_guard<std::recursive_mutex> lock(state->mutex);
+        if (state->cancelled.exchange(true, std::memory_order_acq_rel)) return;
+        auto callbacks = std::move(state->callbacks);
+        state->callbacks.clear();
+        for (auto& [id, callback] : callbacks) {
+            callback();
+        }
+    }
+
+    // Keeps a callback registered for as long as it lives. Once it is
+    // destroyed or reset the callback is neither running nor will run.
+    class Registration {
+    public:
+        Registration() = default;
+        ~Registration() { reset(); }
+        Registration(Registration&& other) noexcept
+            : state(std::move(other.state)), id(other.id) {
+            other.state.reset();
+        }
+        Registration& operator=(Registration&& other) noexcept {
+            if (this != &other) {
+                reset();
+                state = std::move(other.state);
+                id = other.id;
+                other.state.reset();
+            }
+            return *this;
+        }
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+
+        void reset() {
+            if (!state) return;
+            std::lock_guard<std::recursive_mutex> lock(state->mutex);
+            state->callbacks.erase(id);
+            state.reset();
+        }
+
+    private:
+        friend class CancellationToken;
+        std::shared_ptr<State> state;
+        uint64_t id = 0;
+    };
+
+    // Calls callback when the token is cancelled, right away when it
+    // already is. Callbacks run under the token's lock and must not block.
+    Registration onCancel(Callback callback) const {
+        Registration registration;
+        if (!state) return registration;
+
+        std::lock_guard<std::recursive_mutex> lock(state->mutex);
+        if (state->cancelled.load(std::memory_order_acquire)) {
+            callback();
+            return registration;
+        }
+        registration.state = state;
+        registration.id = state->nextId++;
+        state->callbacks.emplace(registration.id, std::move(callback));
+        return registration;
+    }
+
+private:
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::recursive_mutex mutex;  // A callback may drop its own registration
+        std::map<uint64_t, Callback> callbacks;
+        uint64_t nextId = 0;
+    };
+
+    std::shared_ptr<State> state;
+};
+
+}
+
+#endif
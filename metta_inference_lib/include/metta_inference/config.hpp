@@ -1,21 +1,36 @@
 #ifndef METTA_INFERENCE_CONFIG_HPP
 #define METTA_INFERENCE_CONFIG_HPP
 
+#include "cancellation.hpp"
 #include <filesystem>
 #include <vector>
 #include <string>
 #include <atomic>
+#include <memory>
+#include <chrono>
+#include <optional>
 #include <cstdlib>  // for std::getenv
 
 namespace metta_inference {
 
 namespace fs = std::filesystem;
 
+struct ModuleSnapshot;
+struct ConfigSnapshot;
+
 enum class OutputFormat {
     Pretty,
     JSON,
     CSV,
-    Markdown
+    Markdown,
+    Binary  // ResultCodec encoding, for machine consumers
+};
+
+// How much per-finding detail analysis results carry into Metrics
+enum class MetricsDetail {
+    Full,       // Render every description up front
+    Lazy,       // Keep entities; render descriptions only when asked for
+    CountsOnly  // Counts only, no detail lists
 };
 
 // Configuration constants
@@ -36,6 +51,33 @@ struct Config {
     std::vector<fs::path> modulePaths;
     fs::path mettaReplPath;
     
+    // Pre-loaded modules (e.g. from a ModuleWatcher); when set, the engine
+    // uses it instead of rescanning modulePaths
+    std::shared_ptr<const ModuleSnapshot> moduleSnapshot;
+    
+    // Resolver and template tables to analyze with; when unset the engine
+    // captures InferenceConfiguration's current snapshot at construction
+    std::shared_ptr<const ConfigSnapshot> inferenceConfig;
+    
+    // JSON file (entity mappings, templates, ...) to build that snapshot from
+    // instead of looking for config/inference_config.json next to outputDir
+    fs::path inferenceConfigFile;
+    
+    MetricsDetail metricsDetail = MetricsDetail::Full;
+    
+    // Cancelling it stops a run wherever it is: the REPL's process group is
+    // killed, analysis stops, and the engine throws CancelledError
+    CancellationToken cancellation;
+    
+    // When set, the REPL is stopped at this point if it is still running,
+    // and the results it printed by then are analyzed (Metrics::partial)
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    
+    // Stop the REPL at the first result holding a contradiction, conflict
+    // or violation, for callers that only need to know whether there is
+    // one; what it printed up to there is analyzed (Metrics::partial)
+    bool stopOnFirst = false;
+    
     Config() {
         // Use environment variables with fallback defaults
         const char* mettaBase = std::getenv("METTA_BASE_PATH");
@@ -83,6 +125,16 @@ struct ContradictionDetail {
     std::string description;
 };
 
+// Renders descriptions for metrics built with MetricsDetail::Lazy;
+// indices refer to the detail vectors of the Metrics that owns it
+class DetailDescriber {
+public:
+    virtual ~DetailDescriber() = default;
+    virtual std::string describeContradiction(size_t index) const = 0;
+    virtual std::string describeConflict(size_t index) const = 0;
+    virtual std::string describeViolation(size_t index) const = 0;
+};
+
 struct Metrics {
     int contradictions = 0;
     int contradictionPairs = 0;  // Unique contradiction pairs
@@ -97,6 +149,46 @@ struct Metrics {
     std::vector<ViolationDetail> violationDetails;
     std::vector<ContradictionDetail> contradictionDetails;
     
+    // Set in Lazy mode. Read descriptions through the accessors below;
+    // copy details elsewhere only after materializeDescriptions().
+    std::shared_ptr<const DetailDescriber> describer;
+    
+    // Set when the REPL was stopped before it finished (Config::deadline,
+    // Config::stopOnFirst):
+    // the findings come from the results it printed, a share coverage of
+    // those the whole run prints (0 when that is unknown)
+    bool partial = false;
+    double coverage = 1.0;
+    
+    std::string contradictionDescription(size_t index) const {
+        const auto& text = contradictionDetails[index].description;
+        return (text.empty() && describer) ? describer->describeContradiction(index) : text;
+    }
+    
+    std::string conflictDescription(size_t index) const {
+        const auto& text = conflictDetails[index].description;
+        return (text.empty() && describer) ? describer->describeConflict(index) : text;
+    }
+    
+    std::string violationDescription(size_t index) const {
+        const auto& text = violationDetails[index].description;
+        return (text.empty() && describer) ? describer->describeViolation(index) : text;
+    }
+    
+    void materializeDescriptions() {
+        if (!describer) return;
+        for (size_t i = 0; i < contradictionDetails.size(); ++i) {
+            contradictionDetails[i].description = contradictionDescription(i);
+        }
+        for (size_t i = 0; i < conflictDetails.size(); ++i) {
+            conflictDetails[i].description = conflictDescription(i);
+        }
+        for (size_t i = 0; i < violationDetails.size(); ++i) {
+            violationDetails[i].description = violationDescription(i);
+        }
+        describer.reset();
+    }
+    
     int total() const {
         return contradictionPairs + compliances + conflicts + violations + inferredFacts;
     }
@@ -7,9 +7,41 @@
 #include <vector>
 #include <memory>
 #include <optional>
+#include <array>
+#include <string_view>
+#include <cstdint>
+#include <mutex>
+#include <chrono>
+#include <filesystem>
 
 namespace metta_inference {
 
+// Multi-pattern rewriter (Aho-Corasick). Rewrites every occurrence of any
+// pattern in one linear pass, independent of the number of patterns.
+// Overlaps resolve leftmost-longest: "MAERSK" wins over "AERSK".
+class PatternRewriter {
+public:
+    void build(const std::unordered_map<std::string, std::string>& replacements);
+    
+    std::string rewrite(std::string_view text) const;
+    bool empty() const { return patterns.empty(); }
+    
+private:
+    struct Node {
+        std::vector<std::pair<unsigned char, int32_t>> edges;  // Sorted by byte
+        int32_t fail = 0;
+        int32_t output = -1;  // Longest pattern that is a suffix of this node
+    };
+    
+    // Patterns are inserted reversed so a backward scan yields, for each
+    // position, the longest pattern starting there
+    std::vector<Node> nodes;
+    std::vector<std::pair<std::string, std::string>> patterns;
+    
+    int32_t child(int32_t node, unsigned char byte) const;
+    int32_t step(int32_t node, unsigned char byte) const;
+};
+
 // Configuration-driven entity resolver
 class EntityResolver {
 public:
@@ -32,7 +64,9 @@ public:
     void loadConfiguration(const std::string& jsonPath);
     void addEntityMapping(const std::string& entity, const std::string& displayName);
     void addSpecialCharMapping(const std::string& from, const std::string& to);
+    void addSpecialCharMappings(const std::map<std::string, std::string>& mappings);
     void addActionMapping(const std::string& soaAction, const ActionMapping& mapping);
+    void addInstrumentMapping(const std::string& instrument, const std::string& displayName);
     
     // Resolution methods
     std::string resolveEntity(const std::string& entity) const;
@@ -55,6 +89,27 @@ private:
     std::unordered_map<std::string, std::string> instrumentMappings;
     std::unordered_map<std::string, std::string> portMappings;
     
+    // Compiled from specialCharMappings whenever they change
+    PatternRewriter specialCharRewriter;
+    
+    // Memo of dynamically resolved entities; copies start empty
+    struct MemoCache {
+        static constexpr size_t MAX_ENTRIES = 4096;
+        
+        MemoCache() = default;
+        MemoCache(const MemoCache&) {}
+        MemoCache& operator=(const MemoCache&) { clear(); return *this; }
+        
+        std::optional<std::string> find(const std::string& key) const;
+        void store(const std::string& key, const std::string& value);
+        void clear();
+        
+    private:
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::string> entries;
+    };
+    mutable MemoCache resolvedEntities;
+    
     // Helper for applying special character replacements
     std::string applySpecialChars(const std::string& text) const;
     
@@ -62,6 +117,57 @@ private:
     void loadDefaultMappings();
 };
 
+// Placeholders a compiled template resolves to fixed slots
+enum class TemplateSlot : uint8_t {
+    Entity, Entity1, Entity2, Context,
+    Instrument1, Instrument2,
+    Action, Action1, Action2,
+    Regulation1, Regulation2,
+    Reason, Rule, Violator, Constraint,
+    Obligation, Requirement,
+    Count
+};
+
+// Per-render variable bindings; values are views, so binding allocates nothing
+class TemplateVars {
+public:
+    void set(TemplateSlot slot, std::string_view value) {
+        values[static_cast<size_t>(slot)] = value;
+        bound |= 1u << static_cast<size_t>(slot);
+    }
+    
+    bool has(TemplateSlot slot) const { return (bound >> static_cast<size_t>(slot)) & 1u; }
+    std::string_view get(TemplateSlot slot) const { return values[static_cast<size_t>(slot)]; }
+    
+private:
+    std::array<std::string_view, static_cast<size_t>(TemplateSlot::Count)> values{};
+    uint32_t bound = 0;
+};
+
+// A template pattern split once into literal and placeholder segments.
+// Unknown or unbound placeholders render as written, e.g. "{regulation1}".
+class CompiledTemplate {
+public:
+    CompiledTemplate() = default;
+    explicit CompiledTemplate(std::string pattern);
+    
+    void renderTo(std::string& out, const TemplateVars& vars) const;
+    const std::string& pattern() const { return text; }
+    
+    // Maps a placeholder name to its slot; TemplateSlot::Count if unknown
+    static TemplateSlot slotFor(std::string_view name);
+    
+private:
+    struct Segment {
+        uint32_t offset;     // Into text: the literal, or the raw "{name}"
+        uint32_t length;
+        TemplateSlot slot;   // Count for literals
+    };
+    
+    std::string text;
+    std::vector<Segment> segments;
+};
+
 // Template-driven description generator
 class DescriptionTemplates {
 public:
@@ -69,6 +175,7 @@ public:
         std::string id;
         std::string pattern;
         std::map<std::string, std::string> variables;
+        CompiledTemplate compiled;
     };
     
     DescriptionTemplates();
@@ -98,25 +205,38 @@ public:
         const std::string& rule,
         const std::string& action = "") const;
     
-    // Template variable substitution
+    // Render a template by id into a caller-owned buffer (appends);
+    // false when no template has that id
+    bool renderTo(const std::string& id, const TemplateVars& vars, std::string& out) const;
+    
+    // Template variable substitution for ad-hoc patterns (single pass)
     std::string substitute(const std::string& templateStr,
                           const std::map<std::string, std::string>& variables) const;
     
 private:
     std::map<std::string, Template> templates;
+    // Category ("contradiction", "conflict", ...) to its first template id
+    std::map<std::string, std::string> categoryIndex;
     
     void loadDefaultTemplates();
+    std::string render(const std::string& id, const TemplateVars& vars) const;
     std::string findBestTemplate(const std::string& category,
                                 const std::map<std::string, std::string>& context) const;
 };
 
-// Inference configuration manager
+struct ConfigSnapshot;
+
+// Inference configuration manager. Each load parses the JSON once and
+// builds a complete, immutable Snapshot (resolver and template tables
+// included) that replaces the previous one atomically; readers never see
+// a half-applied configuration.
 class InferenceConfiguration {
 public:
     struct Config {
         // Entity resolution settings
         std::map<std::string, std::string> entityMappings;
         std::map<std::string, std::string> specialCharacters;
+        std::map<std::string, std::string> instrumentMappings;
         
         // Action mappings
         std::map<std::string, EntityResolver::ActionMapping> actionMappings;
@@ -133,23 +253,84 @@ public:
         double fuzzyThreshold = 0.8;
     };
     
+    struct LoadStats {
+        std::string source;                       // File path, "<string>" or "<defaults>"
+        size_t bytes = 0;
+        size_t entries = 0;                       // Mappings and templates loaded
+        std::chrono::microseconds readTime{0};
+        std::chrono::microseconds parseTime{0};   // JSON to Config
+        std::chrono::microseconds buildTime{0};   // Config to resolver and template tables
+        uint64_t generation = 0;                  // Unique per snapshot, increasing
+        
+        // Identity of the loaded file, for change detection
+        std::filesystem::file_time_type fileTime{};
+        uintmax_t fileSize = 0;
+    };
+    
+    using Snapshot = ConfigSnapshot;
+    
     static InferenceConfiguration& getInstance();
     
+    // Parse a configuration document; throws std::runtime_error when the
+    // JSON is malformed or a known section has the wrong shape
+    static Config parse(std::string_view json);
+    
+    // A file that cannot be read or parsed keeps the current snapshot
+    // and logs a warning
     void loadFromFile(const std::string& path);
     void loadFromString(const std::string& json);
     
-    const Config& getConfig() const { return config; }
-    EntityResolver& getEntityResolver() { return entityResolver; }
-    DescriptionTemplates& getTemplates() { return descriptionTemplates; }
+    // Reloads only when the path differs from the loaded one or the file's
+    // size or modification time changed; true when a snapshot was published
+    bool loadIfChanged(const std::string& path);
+    bool reloadIfChanged();
+    
+    // A snapshot of the file at path, built apart from the published one,
+    // which it never replaces. Callers share it while the file's size and
+    // modification time stay the same. Throws std::runtime_error when the
+    // file cannot be read or parsed.
+    static std::shared_ptr<const Snapshot> loadSnapshot(const std::string& path);
+    
+    // Lock-free read of the published snapshot. Engines and analyzers
+    // capture one and keep using it, so a reload never changes the tables
+    // under a running analysis.
+    std::shared_ptr<const Snapshot> current() const;
+    LoadStats getLoadStats() const;
+    
+    // Parts of the current snapshot, kept alive by the pointers; prefer
+    // current() in new code
+    std::shared_ptr<const Config> getConfig() const;
+    std::shared_ptr<const EntityResolver> getEntityResolver() const;
+    std::shared_ptr<const DescriptionTemplates> getTemplates() const;
     
 private:
     InferenceConfiguration();
     
-    Config config;
-    EntityResolver entityResolver;
-    DescriptionTemplates descriptionTemplates;
+    std::shared_ptr<const Snapshot> snapshot;
+    
+    // Serializes loads; readers go through current() without locking
+    std::mutex loadMutex;
+    
+    // Last file that failed to load, so an unchanged broken file is not
+    // re-read (and re-reported) on every check
+    std::string failedSource;
+    std::filesystem::file_time_type failedTime{};
+    uintmax_t failedSize = 0;
     
-    void applyConfiguration();
+    bool loadFileLocked(const std::string& path);
+    void publish(Config config, LoadStats stats);
+    static std::shared_ptr<const Snapshot> readSnapshot(const std::string& path);
+    static std::shared_ptr<const Snapshot> buildSnapshot(Config config, LoadStats stats);
+    static void applyConfiguration(const Config& config, Snapshot& target);
+};
+
+// One immutable, fully built configuration. Shared by every engine and
+// result that captured it; never modified after publication.
+struct ConfigSnapshot {
+    InferenceConfiguration::Config config;
+    EntityResolver entityResolver;
+    DescriptionTemplates templates;
+    InferenceConfiguration::LoadStats stats;
 };
 
 }
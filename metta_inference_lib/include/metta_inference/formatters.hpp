@@ -2,56 +2,78 @@
 #define METTA_INFERENCE_FORMATTERS_HPP
 
 #include "config.hpp"
+#include "output_sink.hpp"
 #include <string>
 #include <memory>
+#include <ostream>
 
 namespace metta_inference {
 
 class ResultFormatter {
 public:
     virtual ~ResultFormatter() = default;
-    virtual std::string format(const Config& config, const Metrics& metrics, 
-                               const std::string& output, const std::string& exampleName) const = 0;
+    
+    // Writes the report incrementally; nothing is buffered beyond the sink
+    virtual void formatTo(const Config& config, const Metrics& metrics,
+                          const std::string& output, const std::string& exampleName,
+                          OutputSink& sink) const = 0;
+    
+    // Convenience wrapper collecting the whole report
+    std::string format(const Config& config, const Metrics& metrics, 
+                       const std::string& output, const std::string& exampleName) const;
     virtual std::string getExtension() const = 0;
 };
 
 class PrettyFormatter : public ResultFormatter {
 public:
-    std::string format(const Config& config, const Metrics& metrics, 
-                      const std::string& output, const std::string& exampleName) const override;
+    void formatTo(const Config& config, const Metrics& metrics,
+                  const std::string& output, const std::string& exampleName,
+                  OutputSink& sink) const override;
     std::string getExtension() const override { return ".txt"; }
     
 private:
     std::string getCurrentTimestamp() const;
-    std::string formatProcessingStatus() const;
-    std::string formatResultsSummary(const Metrics& metrics) const;
-    std::string formatDetailedFindings(const std::string& output, const Metrics& metrics) const;
-    std::string formatOverallAssessment(const Metrics& metrics) const;
+    void formatProcessingStatus(std::ostream& out) const;
+    void formatResultsSummary(std::ostream& out, const Metrics& metrics) const;
+    void formatDetailedFindings(std::ostream& out, const std::string& output, const Metrics& metrics) const;
+    void formatOverallAssessment(std::ostream& out, const Metrics& metrics) const;
 };
 
 class JSONFormatter : public ResultFormatter {
 public:
-    std::string format(const Config& config, const Metrics& metrics, 
-                      const std::string& output, const std::string& exampleName) const override;
+    void formatTo(const Config& config, const Metrics& metrics,
+                  const std::string& output, const std::string& exampleName,
+                  OutputSink& sink) const override;
     std::string getExtension() const override { return ".json"; }
 };
 
 class CSVFormatter : public ResultFormatter {
 public:
-    std::string format(const Config& config, const Metrics& metrics, 
-                      const std::string& output, const std::string& exampleName) const override;
+    void formatTo(const Config& config, const Metrics& metrics,
+                  const std::string& output, const std::string& exampleName,
+                  OutputSink& sink) const override;
     std::string getExtension() const override { return ".csv"; }
 };
 
 class MarkdownFormatter : public ResultFormatter {
 public:
-    std::string format(const Config& config, const Metrics& metrics, 
-                      const std::string& output, const std::string& exampleName) const override;
+    void formatTo(const Config& config, const Metrics& metrics,
+                  const std::string& output, const std::string& exampleName,
+                  OutputSink& sink) const override;
     std::string getExtension() const override { return ".md"; }
     
 private:
-    std::string formatDetailedResults(const Metrics& metrics) const;
-    std::string formatInterpretation(const Metrics& metrics) const;
+    void formatDetailedResults(std::ostream& out, const Metrics& metrics) const;
+    void formatInterpretation(std::ostream& out, const Metrics& metrics) const;
+};
+
+// Emits the ResultCodec encoding of the metrics; read it with ResultReader
+class BinaryFormatter : public ResultFormatter {
+public:
+    void formatTo(const Config& config, const Metrics& metrics,
+                  const std::string& output, const std::string& exampleName,
+                  OutputSink& sink) const override;
+    std::string getExtension() const override { return ".mtrb"; }
 };
 
 class FormatterFactory {
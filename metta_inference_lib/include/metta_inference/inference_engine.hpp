@@ -2,6 +2,8 @@
 #define METTA_INFERENCE_INFERENCE_ENGINE_HPP
 
 #include "config.hpp"
+#include "output_sink.hpp"
+#include "process_executor.hpp"
 #include <string>
 #include <filesystem>
 #include <future>
@@ -10,24 +12,82 @@
 
 namespace metta_inference {
 
+class StreamingAnalyzer;
+
 class InferenceEngine {
 public:
     InferenceEngine(const Config& config);
     virtual ~InferenceEngine() = default;
     
+    // Move-only: rawOutput can be hundreds of MB, so a copy is never implicit
     struct Result {
         std::string rawOutput;
         Metrics metrics;
         std::string formattedOutput;
-        bool hasLogicalIssues;
+        bool hasLogicalIssues = false;
+        
+        Result() = default;
+        Result(Result&&) = default;
+        Result& operator=(Result&&) = default;
+        Result(const Result&) = delete;
+        Result& operator=(const Result&) = delete;
     };
     
     virtual Result run(const std::filesystem::path& exampleFile);
     
+    // Streams the formatted report to sink as it is produced and leaves
+    // Result::formattedOutput empty
+    virtual Result run(const std::filesystem::path& exampleFile, OutputSink& sink);
+    
+    // run() split around the REPL process, for callers that execute the
+    // command themselves (e.g. on a ProcessReactor). Owns the combined
+    // input file and removes it when destroyed.
+    class PreparedRun {
+    public:
+        PreparedRun() = default;
+        ~PreparedRun();
+        PreparedRun(PreparedRun&& other) noexcept;
+        PreparedRun& operator=(PreparedRun&& other) noexcept;
+        PreparedRun(const PreparedRun&) = delete;
+        PreparedRun& operator=(const PreparedRun&) = delete;
+        
+        bool ok() const { return error.empty(); }
+        
+        std::filesystem::path exampleFile;
+        std::filesystem::path combinedFile;
+        std::string command;               // Shell command running the REPL
+        std::chrono::milliseconds timeout{0};
+        CancellationToken cancellation;    // Pass to the executor running command
+        // Also for the executor. With a deadline or stopOnFirst the observer
+        // feeds stream, which complete() analyzes instead of parsing the
+        // output again (when the observer saw all of it)
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        ProcessExecutor::OutputObserver observer;
+        std::shared_ptr<StreamingAnalyzer> stream;
+        std::string error;                 // Set when preparation failed
+    };
+    
+    // Validates modules and writes the combined input. Failures that run()
+    // reports in Result::rawOutput are returned in PreparedRun::error;
+    // anything else throws (CancelledError once config.cancellation is
+    // cancelled, here and in run() and complete()).
+    virtual PreparedRun prepare(const std::filesystem::path& exampleFile);
+    
+    // Analyzes the command's output and formats the report, into sink when
+    // given (as run(exampleFile, sink) does). Throws when the REPL failed;
+    // one stopped early gives a partial result (Metrics::partial).
+    virtual Result complete(PreparedRun& run, ProcessExecutor::ExecutionResult&& execution,
+                            OutputSink* sink = nullptr);
+    
 protected:
     Config config;
 };
 
+// The configuration snapshot an engine built from config analyzes with:
+// config.inferenceConfig when set, otherwise the current process-wide
+// snapshot after picking up changes to config/inference_config.json
+std::shared_ptr<const ConfigSnapshot> captureInferenceConfiguration(const Config& config);
+
 // Factory function to create the improved V2 inference engine with S-expression parsing
 std::unique_ptr<InferenceEngine> createInferenceEngineV2(const Config& config);
 
@@ -0,0 +1,132 @@
+#ifndef METTA_INFERENCE_INFERENCE_SCHEDULER_HPP
+#define METTA_INFERENCE_INFERENCE_SCHEDULER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+namespace metta_inference {
+
+// Admission control for REPL runs. Jobs wait in one FIFO queue per
+// priority class and are started highest class first, within a global
+// concurrency limit, a cap on concurrent batch jobs (so bulk work always
+// leaves room for interactive requests) and an optional per-tenant limit.
+// When the queue is full, a new job evicts the newest job of a lower
+// class, or is itself rejected.
+class InferenceScheduler : public std::enable_shared_from_this<InferenceScheduler> {
+public:
+    enum class Priority {
+        Interactive = 0,
+        Normal = 1,
+        Batch = 2
+    };
+    static constexpr size_t PRIORITY_COUNT = 3;
+
+    struct Options {
+        size_t maxConcurrent = 0;       // 0: one per core
+        size_t maxBatchConcurrent = 0;  // 0: half of maxConcurrent (at least one)
+        size_t maxPerTenant = 0;        // 0: unlimited; jobs without a tenant are exempt
+        size_t maxQueued = 1024;
+    };
+
+    struct Stats {
+        size_t running = 0;
+        size_t queued = 0;
+        uint64_t started = 0;
+        uint64_t rejected = 0;          // Shed on arrival or evicted from the queue
+    };
+
+    // Held for as long as a started job runs; destroying it frees the
+    // job's place and starts the next one
+    class Slot {
+    public:
+        Slot() = default;
+        ~Slot();
+        Slot(Slot&& other) noexcept;
+        Slot& operator=(Slot&& other) noexcept;
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+        std::chrono::milliseconds queueTime() const { return waited; }
+
+    private:
+        friend class InferenceScheduler;
+        void release();
+
+        std::shared_ptr<InferenceScheduler> owner;
+        std::string tenant;
+        Priority priority = Priority::Normal;
+        std::chrono::milliseconds waited{0};
+    };
+
+    using Start = std::function<void(Slot)>;
+    using Reject = std::function<void(const std::string& reason)>;
+
+    static std::shared_ptr<InferenceScheduler> create(Options options);
+
+    // Exactly one of start and reject is eventually called, on this thread
+    // or on one that releases a slot, unless the job is withdrawn first.
+    // Neither should block. Returns the job's ticket for withdraw().
+    uint64_t submit(Priority priority, const std::string& tenant, Start start, Reject reject);
+
+    // Removes a job that is still queued (e.g. its request was cancelled)
+    // without calling either callback; false when it already started or
+    // was rejected
+    bool withdraw(uint64_t ticket);
+
+    // Rejects everything queued and anything submitted later
+    void close();
+
+    Stats stats() const;
+    const Options& settings() const { return options; }
+
+    // "interactive" and "batch"; anything else is Normal
+    static Priority parsePriority(const std::string& name);
+
+private:
+    explicit InferenceScheduler(Options options);
+
+    struct Job {
+        uint64_t ticket = 0;
+        std::string tenant;
+        Start start;
+        Reject reject;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    struct Ready {
+        Slot slot;
+        Start start;
+        Reject reject;
+    };
+
+    Options options;
+
+    mutable std::mutex mutex;
+    std::array<std::deque<Job>, PRIORITY_COUNT> queues;
+    std::unordered_map<std::string, size_t> tenantRunning;
+    size_t running = 0;
+    size_t batchRunning = 0;
+    uint64_t startedCount = 0;
+    uint64_t rejectedCount = 0;
+    uint64_t nextTicket = 1;
+    bool closed = false;
+
+    bool admissible(Priority priority, const std::string& tenant) const;
+    Slot admit(Priority priority, const std::string& tenant, std::chrono::steady_clock::time_point queued);
+    // Takes every job that may start now; call with mutex held
+    std::vector<Ready> takeReady();
+    static void run(std::vector<Ready> ready);
+    void release(Priority priority, const std::string& tenant);
+};
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef METTA_INFERENCE_JSON_VALUE_HPP
+#define METTA_INFERENCE_JSON_VALUE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+namespace metta_inference {
+
+// Minimal JSON document model for configuration files. Parsing is a single
+// recursive-descent pass; object members keep document order, and
+// duplicate keys resolve to the last occurrence on lookup.
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    struct Member;
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<Member>;
+
+    JsonValue() = default;
+
+    // Throws std::runtime_error with the byte offset on malformed input
+    static JsonValue parse(std::string_view text);
+
+    Type type() const { return kind; }
+    bool isNull() const { return kind == Type::Null; }
+    bool isBool() const { return kind == Type::Bool; }
+    bool isNumber() const { return kind == Type::Number; }
+    bool isString() const { return kind == Type::String; }
+    bool isArray() const { return kind == Type::Array; }
+    bool isObject() const { return kind == Type::Object; }
+
+    // Typed accessors throw std::runtime_error on a type mismatch
+    bool asBool() const;
+    double asNumber() const;
+    const std::string& asString() const;
+    const Array& items() const;
+    const Object& members() const;
+
+    // Moves the string out, for building tables without copying
+    std::string takeString();
+    Object& members();
+
+    // nullptr when this is not an object or the key is absent
+    const JsonValue* find(std::string_view key) const;
+    JsonValue* find(std::string_view key);
+
+    static const char* typeName(Type type);
+
+private:
+    friend class JsonParser;
+
+    Type kind = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;
+    Array array;
+    Object object;
+};
+
+struct JsonValue::Member {
+    std::string key;
+    JsonValue value;
+};
+
+}
+
+#endif
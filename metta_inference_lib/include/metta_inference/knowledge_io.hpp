@@ -90,8 +90,9 @@ struct Negation {
     std::string toString() const;
 };
 
-// Structure to represent state of affairs
-struct StateOfAffairs {
+// State of affairs described by a knowledge document (not the analyzer's
+// StateOfAffairs, which is a single inferred fact)
+struct KnowledgeStateOfAffairs {
     std::vector<Triple> facts;             // Collection of fact triples
     std::map<std::string, Eventuality> eventualities; // Parsed eventualities
     std::map<std::string, Entity> entities; // Entity definitions
@@ -104,26 +105,66 @@ struct StateOfAffairs {
     bool validateEntities(std::vector<std::string>& errors) const;
 };
 
+// Differences between two documents (e.g. consecutive hourly exports)
+struct DocumentDiff {
+    struct FactChange {
+        Triple before;
+        Triple after;
+    };
+    
+    std::vector<Triple> addedFacts;
+    std::vector<Triple> removedFacts;
+    std::vector<FactChange> changedFacts;  // Same subject and predicate, new object
+    
+    std::vector<std::string> addedEventualities;
+    std::vector<std::string> removedEventualities;
+    std::vector<std::string> changedEventualities;
+    
+    std::vector<std::string> addedEntities;
+    std::vector<std::string> removedEntities;
+    std::vector<std::string> changedEntities;
+    
+    std::vector<std::string> addedConstraints;    // Negations and logical expressions
+    std::vector<std::string> removedConstraints;
+    
+    std::vector<std::string> addedNorms;
+    std::vector<std::string> removedNorms;
+    std::vector<std::string> changedNorms;
+    
+    bool empty() const { return totalChanges() == 0; }
+    size_t totalChanges() const;
+    
+    // Norm changes can affect any scenario; fact changes only their subjects
+    bool normsChanged() const;
+    std::set<std::string> affectedSubjects() const;
+    bool requiresReevaluation() const { return !empty(); }
+    bool requiresReevaluation(const KnowledgeStateOfAffairs& scenario) const;
+};
+
 // Main I/O class for knowledge (norms and state of affairs)
 class KnowledgeIO {
 public:
     // Reading functions
     static std::vector<Norm> readNormsFromFile(const fs::path& filepath);
-    static StateOfAffairs readStateOfAffairsFromFile(const fs::path& filepath);
+    static KnowledgeStateOfAffairs readStateOfAffairsFromFile(const fs::path& filepath);
     
     // Writing functions  
     static void writeNormsToFile(const std::vector<Norm>& norms, const fs::path& filepath);
-    static void writeStateOfAffairsToFile(const StateOfAffairs& soa, const fs::path& filepath);
+    static void writeStateOfAffairsToFile(const KnowledgeStateOfAffairs& soa, const fs::path& filepath);
     
     // Combined reading (reads both norms and state of affairs from one file)
     struct MettaDocument {
         std::vector<Norm> norms;
-        StateOfAffairs stateOfAffairs;
+        KnowledgeStateOfAffairs stateOfAffairs;
         std::string header;  // Optional header comments
     };
     static MettaDocument readMettaDocument(const fs::path& filepath);
     static void writeMettaDocument(const MettaDocument& doc, const fs::path& filepath);
     
+    // Diffing (hash-indexed, linear in the number of facts)
+    static DocumentDiff diffStateOfAffairs(const KnowledgeStateOfAffairs& before, const KnowledgeStateOfAffairs& after);
+    static DocumentDiff diffDocuments(const MettaDocument& before, const MettaDocument& after);
+    
     // Parsing utilities
     static std::optional<Norm> parseNorm(const std::string& mettaCode);
     static std::optional<Triple> parseTriple(const std::string& mettaCode);
@@ -134,7 +175,7 @@ public:
     
     // Extraction utilities (extract norms/soa from larger metta files)
     static std::vector<Norm> extractNormsFromMetta(const std::string& mettaContent);
-    static StateOfAffairs extractStateOfAffairsFromMetta(const std::string& mettaContent);
+    static KnowledgeStateOfAffairs extractStateOfAffairsFromMetta(const std::string& mettaContent);
     
     // Validation utilities
     static bool validateEventuality(const Eventuality& eventuality, std::string& error);
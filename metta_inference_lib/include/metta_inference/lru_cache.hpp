@@ -0,0 +1,97 @@
+#ifndef METTA_INFERENCE_LRU_CACHE_HPP
+#define METTA_INFERENCE_LRU_CACHE_HPP
+
+#include <list>
+#include <unordered_map>
+#include <optional>
+#include <mutex>
+#include <cstdint>
+
+namespace metta_inference {
+
+// Thread-safe least-recently-used cache. Values are returned by copy, so
+// large values are best held through a shared_ptr to const.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : maxEntries(capacity) {}
+
+    // Marks the entry as most recently used
+    std::optional<Value> get(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            ++missCount;
+            return std::nullopt;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        ++hitCount;
+        return it->second->second;
+    }
+
+    // Inserts or replaces; evicts the least recently used entry when full
+    void put(const Key& key, Value value) {
+        if (maxEntries == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it->second->second = std::move(value);
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+
+        if (entries.size() >= maxEntries) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        entries.emplace_front(key, std::move(value));
+        index.emplace(key, entries.begin());
+    }
+
+    bool erase(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end()) return false;
+        entries.erase(it->second);
+        index.erase(it);
+        return true;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    size_t capacity() const { return maxEntries; }
+
+    uint64_t hits() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hitCount;
+    }
+
+    uint64_t misses() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return missCount;
+    }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    size_t maxEntries;
+    mutable std::mutex mutex;
+    std::list<Entry> entries;  // Most recently used first
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+};
+
+}
+
+#endif
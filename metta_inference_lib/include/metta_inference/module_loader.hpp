@@ -4,11 +4,15 @@
 #include <filesystem>
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
 
 namespace metta_inference {
 
 namespace fs = std::filesystem;
 
+struct ModuleSnapshot;
+
 class ModuleLoader {
 public:
     struct ModuleInfo {
@@ -25,8 +29,44 @@ public:
         bool verbose = false
     );
     static std::vector<ModuleInfo> validateModules(const std::vector<fs::path>& modulePaths);
+
+    // Read all module files once into an immutable snapshot
+    static std::shared_ptr<const ModuleSnapshot> loadSnapshot(
+        const std::vector<fs::path>& modulePaths,
+        uint64_t version = 1
+    );
+
+    // Same as above, but reuses the pre-rendered module section of a snapshot
+    static fs::path createCombinedFile(
+        const ModuleSnapshot& snapshot,
+        const fs::path& exampleFile,
+        bool verbose = false
+    );
+};
+
+// In-memory, versioned copy of the module directories
+struct ModuleSnapshot {
+    struct File {
+        fs::path path;
+        size_t size = 0;
+        uint64_t contentHash = 0;
+    };
+
+    uint64_t version = 0;
+    std::vector<fs::path> modulePaths;
+    std::vector<ModuleLoader::ModuleInfo> modules;
+    std::vector<File> files;
+    std::string combinedModules;  // Module section of the combined file
+    size_t queries = 0;           // Queries ('!' expressions) in combinedModules
+
+    size_t totalFiles() const { return files.size(); }
+
+    // True when both snapshots describe byte-identical module contents.
+    // Hashes and sizes rule out most changes; equal ones are confirmed by
+    // comparing combinedModules.
+    bool sameContentAs(const ModuleSnapshot& other) const;
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
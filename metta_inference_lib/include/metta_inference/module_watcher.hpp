@@ -0,0 +1,73 @@
+#ifndef METTA_INFERENCE_MODULE_WATCHER_HPP
+#define METTA_INFERENCE_MODULE_WATCHER_HPP
+
+#include "module_loader.hpp"
+#include <filesystem>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <map>
+
+namespace metta_inference {
+
+namespace fs = std::filesystem;
+
+// Keeps an up-to-date ModuleSnapshot of the module directories.
+// On Linux changes are picked up through inotify; elsewhere the
+// directories are polled. A new snapshot is only published when
+// file contents actually changed.
+class ModuleWatcher {
+public:
+    using Listener = std::function<void(const std::shared_ptr<const ModuleSnapshot>&)>;
+
+    explicit ModuleWatcher(std::vector<fs::path> modulePaths,
+                           std::chrono::milliseconds debounce = std::chrono::milliseconds(50));
+    ~ModuleWatcher();
+
+    ModuleWatcher(const ModuleWatcher&) = delete;
+    ModuleWatcher& operator=(const ModuleWatcher&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const { return running.load(); }
+
+    // Lock-free read of the current snapshot
+    std::shared_ptr<const ModuleSnapshot> current() const;
+    uint64_t version() const;
+
+    // Rescan now, on the calling thread; returns true when a new snapshot
+    // was published
+    bool refresh();
+
+    // Listeners run after each swap (cache invalidation), on the thread
+    // that published it: the watcher thread, or a caller of refresh()
+    size_t addListener(Listener listener);
+    void removeListener(size_t id);
+
+    const std::vector<fs::path>& getModulePaths() const { return modulePaths; }
+
+private:
+    std::vector<fs::path> modulePaths;
+    std::chrono::milliseconds debounce;
+    std::shared_ptr<const ModuleSnapshot> snapshot;
+
+    std::mutex refreshMutex;
+    std::mutex listenerMutex;
+    std::map<size_t, Listener> listeners;
+    size_t nextListenerId = 1;
+
+    std::atomic<bool> running{false};
+    std::thread worker;
+    int wakeFd[2] = {-1, -1};
+
+    void watchLoop();
+    void publish(std::shared_ptr<const ModuleSnapshot> next);
+};
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef METTA_INFERENCE_OUTPUT_SINK_HPP
+#define METTA_INFERENCE_OUTPUT_SINK_HPP
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <streambuf>
+#include <functional>
+
+namespace metta_inference {
+
+// Destination for formatted reports. Formatters write incrementally, so a
+// report never has to exist as one string unless the sink collects it.
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+    virtual void write(std::string_view chunk) = 0;
+    virtual void flush() {}
+};
+
+// Collects everything into a caller-owned string
+class StringSink : public OutputSink {
+public:
+    explicit StringSink(std::string& target) : target(target) {}
+    void write(std::string_view chunk) override { target.append(chunk); }
+
+private:
+    std::string& target;
+};
+
+class StreamSink : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& stream) : stream(stream) {}
+    void write(std::string_view chunk) override;
+    void flush() override { stream.flush(); }
+
+private:
+    std::ostream& stream;
+};
+
+// Buffered writes to a file descriptor the caller keeps ownership of.
+// Throws std::runtime_error when the descriptor rejects a write.
+class FdSink : public OutputSink {
+public:
+    explicit FdSink(int fd, size_t bufferSize = 64 * 1024);
+    ~FdSink() override;
+    void write(std::string_view chunk) override;
+    void flush() override;
+
+private:
+    int fd;
+    size_t bufferSize;
+    std::string buffer;
+
+    void writeAll(std::string_view data);
+};
+
+// Hands the report to a callback in chunks of roughly chunkSize bytes;
+// the view is only valid for the duration of the call
+class CallbackSink : public OutputSink {
+public:
+    using Callback = std::function<void(std::string_view)>;
+
+    explicit CallbackSink(Callback callback, size_t chunkSize = 16 * 1024);
+    ~CallbackSink() override;
+    void write(std::string_view chunk) override;
+    void flush() override;
+
+private:
+    Callback callback;
+    size_t chunkSize;
+    std::string buffer;
+};
+
+// std::ostream adapter so formatting code can keep using operator<<
+class SinkStream : public std::ostream {
+public:
+    explicit SinkStream(OutputSink& sink);
+    ~SinkStream() override;
+
+private:
+    class Buffer : public std::streambuf {
+    public:
+        explicit Buffer(OutputSink& sink);
+        int sync() override;
+
+    protected:
+        int_type overflow(int_type ch) override;
+        std::streamsize xsputn(const char* data, std::streamsize count) override;
+
+    private:
+        OutputSink& sink;
+        char storage[4096];
+
+        void drain();
+    };
+
+    Buffer buffer;
+};
+
+}
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef METTA_INFERENCE_PROCESS_EXECUTOR_HPP
 #define METTA_INFERENCE_PROCESS_EXECUTOR_HPP
 
+#include "cancellation.hpp"
 #include <string>
+#include <string_view>
+#include <functional>
 #include <memory>
 #include <chrono>
 #include <optional>
@@ -17,15 +20,31 @@ public:
         std::string output;
         int exitCode;
         std::chrono::milliseconds duration;
+        // Killed before it finished, at its deadline or because the
+        // observer asked: output is what it printed until then and
+        // exitCode is -1
+        bool stoppedEarly = false;
     };
 
+    // Sees each piece of output as it is read, while the command runs;
+    // returning false stops the command as reaching its deadline does
+    using OutputObserver = std::function<bool(std::string_view chunk)>;
+
+    // Runs command under /bin/sh in its own process group and captures
+    // stdout. On timeout, or once cancel is cancelled, the whole group is
+    // killed and std::runtime_error (CancelledError) is thrown. Reaching
+    // deadline is not an error: the group is killed and the result comes
+    // back with stoppedEarly set.
     static ExecutionResult execute(
         const std::string& command, 
-        std::optional<std::chrono::milliseconds> timeout = std::nullopt
+        std::optional<std::chrono::milliseconds> timeout = std::nullopt,
+        const CancellationToken& cancel = {},
+        const OutputObserver& observer = {},
+        std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt
     );
 
-private:
-    static constexpr size_t BUFFER_SIZE = 16384;  // Increased buffer size for better performance
+    static constexpr size_t BUFFER_SIZE = 16384;        // Minimum free space per read()
+    static constexpr size_t INITIAL_CAPACITY = 65536;   // Output buffer before the first growth
 };
 
 }
@@ -0,0 +1,96 @@
+#ifndef METTA_INFERENCE_PROCESS_REACTOR_HPP
+#define METTA_INFERENCE_PROCESS_REACTOR_HPP
+
+#include "process_executor.hpp"
+#include <functional>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+namespace metta_inference {
+
+// Runs many commands at once without a thread per command. One reactor
+// thread multiplexes the output pipes of all running processes (epoll on
+// Linux) and enforces their timeouts; finished commands are handed to a
+// small pool of completion threads, which run the callbacks.
+//
+// Elsewhere each command runs through ProcessExecutor on a completion
+// thread, so concurrency is bounded by the pool size.
+class ProcessReactor {
+public:
+    // error is set when the command could not be run to completion
+    // (timeout, I/O error, reactor shutdown); result is then unspecified.
+    // A non-zero exit code is not an error.
+    using Completion = std::function<void(ProcessExecutor::ExecutionResult&& result,
+                                          std::exception_ptr error)>;
+
+    // completionThreads == 0 uses one per hardware thread
+    explicit ProcessReactor(size_t completionThreads = 0);
+    ~ProcessReactor();
+
+    ProcessReactor(const ProcessReactor&) = delete;
+    ProcessReactor& operator=(const ProcessReactor&) = delete;
+
+    // Starts command under /bin/sh and returns immediately; stdout is
+    // captured (redirect stderr in the command if it is wanted). Throws
+    // std::runtime_error when the process cannot be started. On timeout,
+    // or once cancel is cancelled, the command's whole process group is
+    // killed; the error is then CancelledError for a cancellation.
+    // observer and deadline work as for ProcessExecutor::execute. observer
+    // runs on the completion threads, one call at a time and in output
+    // order, so a slow one does not hold up other commands; completion
+    // runs once it has seen all output.
+    void submit(const std::string& command, std::chrono::milliseconds timeout, Completion completion,
+                const CancellationToken& cancel = {}, ProcessExecutor::OutputObserver observer = {},
+                std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt);
+
+    // Commands started and not yet handed to their completion
+    size_t inFlight() const { return running.load(); }
+
+    size_t completionThreadCount() const { return workers.size(); }
+
+    // Runs task on a completion thread (for work that follows a command,
+    // e.g. analysing its output)
+    void post(std::function<void()> task);
+
+    // True on the reactor thread or a completion thread of any reactor,
+    // where waiting for another command's completion may never return
+    static bool onReactorThread();
+
+private:
+    struct Job;
+    struct ObserverFeed;
+
+    std::atomic<size_t> running{0};
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    std::atomic<bool> closing{false};
+    std::mutex incomingMutex;
+    std::vector<std::unique_ptr<Job>> incoming;  // Started, not yet adopted by the loop
+    std::thread reactor;
+    int epollFd = -1;
+    int wakeFd = -1;
+
+    void workerLoop();
+    void reactorLoop();
+    void wake();
+    void finish(std::unique_ptr<Job> job);
+    void observe(const std::shared_ptr<ObserverFeed>& feed, std::string_view chunk);
+};
+
+}
+
+#endif
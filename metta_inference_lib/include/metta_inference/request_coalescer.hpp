@@ -0,0 +1,148 @@
+#ifndef METTA_INFERENCE_REQUEST_COALESCER_HPP
+#define METTA_INFERENCE_REQUEST_COALESCER_HPP
+
+#include "semantic_analyzer.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+namespace metta_inference {
+
+// Several examples as one runnable MeTTa text. Each example's eventualities
+// and agents get a namespace suffix so their facts cannot interact, and
+// definitions repeated verbatim are kept once; queries stay in example
+// order, so SemanticAnalyzer::demultiplex can hand each result back.
+struct CoalescedBatch {
+    std::string content;
+    CoalescedLayout layout;
+};
+
+CoalescedBatch coalesceExamples(const std::vector<std::string>& examples);
+
+// The example's definitions that mention none of its entities (rules and
+// the like), sorted and one per line. coalesceExamples keeps those once,
+// and they then apply to every example's facts, so only examples with
+// equal shared definitions may be coalesced.
+std::string sharedDefinitions(const std::string& example);
+
+// Groups tickets that arrive within a short window of each other. A group
+// is flushed when its window closes or it reaches maxBatch tickets; only
+// tickets with equal group keys (e.g. the same modules) share a flush.
+// Flushes run on the coalescer's timer thread, or on the thread whose
+// add() filled the group, and should neither block nor throw.
+template <typename Ticket>
+class RequestCoalescer {
+public:
+    struct Options {
+        std::chrono::milliseconds window{5};
+        size_t maxBatch = 16;
+    };
+
+    using Flush = std::function<void(std::vector<Ticket>)>;
+
+    RequestCoalescer(Options options, Flush flush)
+        : options(options), flush(std::move(flush)) {
+        if (this->options.maxBatch == 0) {
+            this->options.maxBatch = 1;
+        }
+        timer = std::thread(&RequestCoalescer::timerLoop, this);
+    }
+
+    // Flushes whatever is still waiting
+    ~RequestCoalescer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        timer.join();
+    }
+
+    RequestCoalescer(const RequestCoalescer&) = delete;
+    RequestCoalescer& operator=(const RequestCoalescer&) = delete;
+
+    void add(const std::string& groupKey, Ticket ticket) {
+        std::vector<Ticket> full;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& group = groups[groupKey];
+            if (group.tickets.empty()) {
+                group.deadline = Clock::now() + options.window;
+            }
+            group.tickets.push_back(std::move(ticket));
+            if (group.tickets.size() >= options.maxBatch) {
+                full.swap(group.tickets);
+                groups.erase(groupKey);
+            }
+        }
+
+        if (!full.empty()) {
+            flush(std::move(full));
+        } else {
+            changed.notify_one();
+        }
+    }
+
+    const Options& settings() const { return options; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Group {
+        std::vector<Ticket> tickets;
+        Clock::time_point deadline;
+    };
+
+    Options options;
+    Flush flush;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::unordered_map<std::string, Group> groups;
+    bool stopping = false;
+    std::thread timer;
+
+    void timerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            // Collect every group whose window closed (all of them when stopping)
+            std::vector<std::vector<Ticket>> due;
+            auto now = Clock::now();
+            auto next = Clock::time_point::max();
+            for (auto it = groups.begin(); it != groups.end(); ) {
+                if (stopping || it->second.deadline <= now) {
+                    due.push_back(std::move(it->second.tickets));
+                    it = groups.erase(it);
+                } else {
+                    next = std::min(next, it->second.deadline);
+                    ++it;
+                }
+            }
+
+            if (!due.empty()) {
+                lock.unlock();
+                for (auto& tickets : due) {
+                    flush(std::move(tickets));
+                }
+                lock.lock();
+                continue;
+            }
+
+            if (stopping) return;
+            if (next == Clock::time_point::max()) {
+                changed.wait(lock);
+            } else {
+                changed.wait_until(lock, next);
+            }
+        }
+    }
+};
+
+}
+
+#endif
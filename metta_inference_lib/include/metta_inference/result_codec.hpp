@@ -0,0 +1,130 @@
+#ifndef METTA_INFERENCE_RESULT_CODEC_HPP
+#define METTA_INFERENCE_RESULT_CODEC_HPP
+
+#include "config.hpp"
+#include "semantic_analyzer.hpp"
+#include "output_sink.hpp"
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace metta_inference {
+
+// Compact, versioned binary encoding of Metrics and analysis results.
+//
+// Layout (all integers little-endian):
+//   header   magic "MTRB", u16 version, u16 kind, u32 stringCount,
+//            u32 stringBytes, u32 recordCount, u32 flags, f64 coverage
+//   counts   6 x i32 (contradictions, contradictionPairs, compliances,
+//            conflicts, violations, inferredFacts)
+//   offsets  (stringCount + 1) x u32 into the string blob
+//   records  recordCount x 20 bytes: u8 type, u8 flags, u16 reserved,
+//            4 x u32 string indices (NO_STRING when absent)
+//   strings  deduplicated UTF-8 blob, not NUL terminated
+class ResultCodec {
+public:
+    static constexpr uint16_t VERSION = 2;
+    static constexpr uint32_t NO_STRING = 0xFFFFFFFFu;
+
+    // Header flags
+    static constexpr uint32_t FLAG_PARTIAL = 1u << 0;               // Metrics::partial
+    static constexpr uint32_t FLAG_DESCRIPTIONS_OMITTED = 1u << 1;  // lazy descriptions left out
+
+    enum class Kind : uint16_t {
+        Metrics = 1,
+        Analysis = 2
+    };
+
+    enum class RecordType : uint8_t {
+        InferredFact = 1,        // text
+        Contradiction = 2,       // entity1, entity2, description (Metrics)
+        Conflict = 3,            // entity1, entity2, description (Metrics)
+        Violation = 4,           // violator, violated rule, description (Metrics)
+        StateOfAffairs = 5,      // entity, action, agent, instrument; flags bit 0 = exists
+        Property = 6,            // key, value of the preceding StateOfAffairs
+        LogicalContradiction = 7,// type; followed by positive and negative StateOfAffairs
+        RegulatoryConflict = 8,  // regulation1, regulation2, requirement, affected entity
+        NecessaryViolation = 9,  // rule, violator, reason
+        Compliance = 10          // entity, obligation, fulfilled by
+    };
+
+    // Descriptions the metrics hold are always encoded. Those a lazy
+    // describer would render cost a template expansion each, so they are
+    // only rendered when the consumer asks for them
+    static std::string encode(const Metrics& metrics, bool renderDescriptions = true);
+    static std::string encode(const SemanticAnalyzer::AnalysisResult& result);
+    static void encodeTo(const Metrics& metrics, OutputSink& sink, bool renderDescriptions = true);
+    static void encodeTo(const SemanticAnalyzer::AnalysisResult& result, OutputSink& sink);
+
+    // True when the buffer starts with the magic of this encoding
+    static bool isEncoded(std::string_view data);
+};
+
+// Zero-copy view over an encoded buffer. The buffer must outlive the
+// reader; all returned string_views point into it. The constructor
+// validates bounds once and throws std::runtime_error on malformed input,
+// so accessors do not re-check.
+class ResultReader {
+public:
+    class Record {
+    public:
+        ResultCodec::RecordType type() const;
+        uint8_t flags() const;
+        std::string_view field(size_t index) const;  // index < 4; empty when absent
+
+    private:
+        friend class ResultReader;
+        Record(const ResultReader* reader, const char* data) : reader(reader), data(data) {}
+
+        const ResultReader* reader;
+        const char* data;
+    };
+
+    explicit ResultReader(std::string_view data);
+
+    ResultCodec::Kind kind() const { return dataKind; }
+    uint16_t version() const { return dataVersion; }
+
+    // The producer stopped early; coverage is the share of results analyzed
+    bool partial() const { return (dataFlags & ResultCodec::FLAG_PARTIAL) != 0; }
+    double coverage() const { return dataCoverage; }
+    // Lazy descriptions were not rendered; empty descriptions are not final
+    bool descriptionsOmitted() const { return (dataFlags & ResultCodec::FLAG_DESCRIPTIONS_OMITTED) != 0; }
+
+    int contradictions() const { return counts[0]; }
+    int contradictionPairs() const { return counts[1]; }
+    int compliances() const { return counts[2]; }
+    int conflicts() const { return counts[3]; }
+    int violations() const { return counts[4]; }
+    int inferredFacts() const { return counts[5]; }
+    int total() const {
+        return contradictionPairs() + compliances() + conflicts() + violations() + inferredFacts();
+    }
+
+    size_t recordCount() const { return records; }
+    Record record(size_t index) const;
+
+    size_t stringCount() const { return strings; }
+    std::string_view string(uint32_t index) const;
+
+    // Materialize owning structures when a consumer needs them
+    Metrics toMetrics() const;
+    SemanticAnalyzer::AnalysisResult toAnalysisResult() const;
+
+private:
+    std::string_view data;
+    ResultCodec::Kind dataKind = ResultCodec::Kind::Metrics;
+    uint16_t dataVersion = 0;
+    uint32_t dataFlags = 0;
+    double dataCoverage = 1.0;
+    int32_t counts[6] = {};
+    uint32_t strings = 0;
+    uint32_t records = 0;
+    const char* offsetTable = nullptr;
+    const char* recordTable = nullptr;
+    const char* stringBlob = nullptr;
+};
+
+}
+
+#endif
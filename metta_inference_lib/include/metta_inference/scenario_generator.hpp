@@ -0,0 +1,66 @@
+#ifndef METTA_INFERENCE_SCENARIO_GENERATOR_HPP
+#define METTA_INFERENCE_SCENARIO_GENERATOR_HPP
+
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace metta_inference {
+
+namespace fs = std::filesystem;
+
+// Synthesizes state of affairs files at arbitrary scale for benchmarking.
+// Output is deterministic for a given seed and is streamed, so memory
+// does not grow with the size of the generated file.
+class ScenarioGenerator {
+public:
+    struct Ontology {
+        std::vector<std::string> eventualityTypes;  // e.g. "soaMoor"
+        std::vector<std::string> roles;             // e.g. "soaHas_location"
+    };
+
+    struct Options {
+        size_t vessels = 10;
+        size_t eventualities = 100;
+        double negationRatio = 0.1;       // Negated, non-asserted eventualities
+        double disjunctionRatio = 0.05;   // ct-or pairs per asserted eventuality
+        double obligationRatio = 0.1;     // "obligatory" instead of "rexist"
+        double contradictionRatio = 0.05; // rexist eventuality plus rexist negation
+        uint64_t seed = 42;
+        bool includeQueries = true;       // Append make-triples and detection queries
+    };
+
+    struct Stats {
+        size_t vessels = 0;
+        size_t eventualities = 0;
+        size_t negations = 0;
+        size_t disjunctions = 0;
+        size_t obligations = 0;
+        size_t contradictions = 0;
+        size_t facts = 0;
+    };
+
+    // Reads (ct-Eventuality) and (ct-ThematicRole) definitions from
+    // eventuality.metta and role.metta; falls back to the built-in sets
+    static Ontology loadOntology(const fs::path& knowledgeDir);
+    static Ontology defaultOntology();
+
+    ScenarioGenerator(Ontology ontology, Options options);
+
+    // Throws std::invalid_argument when the options cannot be satisfied
+    Stats generate(std::ostream& out) const;
+    Stats generateToFile(const fs::path& filepath) const;
+
+    // Vessel names encode their index so eventuality names stay unique
+    static std::string vesselName(size_t index);
+
+private:
+    Ontology ontology;
+    Options options;
+};
+
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef METTA_INFERENCE_SCENARIO_PARTITIONER_HPP
+#define METTA_INFERENCE_SCENARIO_PARTITIONER_HPP
+
+#include "config.hpp"
+#include "inference_engine.hpp"
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <unordered_set>
+
+namespace metta_inference {
+
+namespace fs = std::filesystem;
+
+// Splits a scenario into independent sub-scenarios (connected components
+// of eventualities and their agents) that can be inferred in parallel.
+// Rules and queries are shared and copied into every shard; facts about
+// non-agent entities (berths, treasuries, instruments) are replicated.
+class ScenarioPartitioner {
+public:
+    struct Shard {
+        size_t index = 0;
+        std::vector<std::string> eventualities;  // Component members, sorted
+        size_t factCount = 0;                    // State of affairs expressions owned
+        std::string content;                     // Complete, runnable MeTTa text
+    };
+
+    // maxShards == 0 keeps one shard per component; otherwise components
+    // are packed into at most maxShards shards of similar size
+    static std::vector<Shard> partition(const std::string& mettaContent, size_t maxShards = 0);
+    static std::vector<Shard> partitionFile(const fs::path& exampleFile, size_t maxShards = 0);
+
+    // Top-level expressions of MeTTa source, verbatim; comments are dropped
+    struct Expression {
+        std::string text;
+        bool query = false;  // A "!" expression, evaluated when the file runs
+    };
+    static std::vector<Expression> splitExpressions(const std::string& mettaContent);
+
+    // Eventualities and agents: the names that tie a scenario's facts together
+    static std::unordered_set<std::string> linkingEntities(const std::string& mettaContent);
+
+    // Sum counts and drop details reported by more than one shard
+    static Metrics mergeMetrics(const std::vector<Metrics>& parts);
+
+    // Partition, run one engine per shard concurrently, and merge. Throws
+    // when any shard fails, so a partial merge never passes as a result.
+    static InferenceEngine::Result runParallel(const Config& config,
+                                               const fs::path& exampleFile,
+                                               size_t maxShards);
+};
+
+}
+
+#endif
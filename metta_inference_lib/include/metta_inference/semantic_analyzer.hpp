@@ -62,6 +62,14 @@ struct ComplianceRelation {
                               const DescriptionTemplates& templates) const;
 };
 
+// How the examples of one coalesced REPL run are laid out (see
+// coalesceExamples): request i's entities carry namespaces[i], a suffix
+// starting with "__", and its "!" queries follow those of requests 0..i-1
+struct CoalescedLayout {
+    std::vector<std::string> namespaces;
+    std::vector<size_t> queryCounts;
+};
+
 // Main semantic analyzer
 class SemanticAnalyzer {
 public:
@@ -72,14 +80,35 @@ public:
         std::vector<NecessaryViolation> violations;
         std::vector<ComplianceRelation> compliances;
         
-        Metrics toMetrics() const;
+        // Configuration the findings were resolved with; descriptions are
+        // rendered from it too (the current snapshot when unset)
+        std::shared_ptr<const ConfigSnapshot> configuration;
+        
+        Metrics toMetrics(MetricsDetail detail = MetricsDetail::Full) const&;
+        // Lazy metrics take ownership of the findings instead of copying them
+        Metrics toMetrics(MetricsDetail detail = MetricsDetail::Full) &&;
     };
     
+    // Captures InferenceConfiguration's current snapshot
     SemanticAnalyzer();
-    explicit SemanticAnalyzer(EntityResolver* resolver, DescriptionTemplates* templates);
+    explicit SemanticAnalyzer(std::shared_ptr<const ConfigSnapshot> snapshot);
+    explicit SemanticAnalyzer(const EntityResolver* resolver, const DescriptionTemplates* templates);
+    
+    // Main analysis method. Throws CancelledError once cancel is
+    // cancelled, checked between expressions and analysis passes.
+    AnalysisResult analyze(const std::string& mettaOutput, const CancellationToken& cancel = {});
+    
+    // The analysis passes of analyze() over output that is already parsed
+    AnalysisResult analyzeExpressions(const std::vector<std::shared_ptr<SExpr>>& expressions,
+                                      const CancellationToken& cancel = {});
     
-    // Main analysis method
-    AnalysisResult analyze(const std::string& mettaOutput);
+    // Splits the output of a coalesced run into one output per request, as
+    // if each had run alone: a result goes to the request whose query
+    // produced it, keeping only elements free of other requests' entities,
+    // with the request's own namespace stripped. Throws std::runtime_error
+    // when the output does not match the layout (e.g. the REPL stopped early).
+    static std::vector<std::string> demultiplex(const std::string& mettaOutput,
+                                                const CoalescedLayout& layout);
     
     // Individual analysis methods
     std::vector<StateOfAffairs> extractStateOfAffairs(
@@ -98,8 +127,9 @@ public:
         const std::vector<std::shared_ptr<SExpr>>& expressions);
     
 private:
-    EntityResolver* entityResolver;
-    DescriptionTemplates* descriptionTemplates;
+    std::shared_ptr<const ConfigSnapshot> configSnapshot;
+    const EntityResolver* entityResolver;
+    const DescriptionTemplates* descriptionTemplates;
     
     // Helper methods for parsing specific patterns
     std::optional<StateOfAffairs> parseTripleToSOA(const std::shared_ptr<SExpr>& triple);
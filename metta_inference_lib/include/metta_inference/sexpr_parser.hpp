@@ -1,24 +1,31 @@
 #ifndef METTA_INFERENCE_SEXPR_PARSER_HPP
 #define METTA_INFERENCE_SEXPR_PARSER_HPP
 
+#include "cancellation.hpp"
 #include <string>
 #include <vector>
 #include <memory>
 #include <optional>
 #include <variant>
 #include <stdexcept>
+#include <unordered_set>
+#include <unordered_map>
 
 namespace metta_inference {
 
-// S-Expression AST structure
+// S-Expression AST structure. Nodes are immutable once built and carry a
+// structural hash computed at construction, so equality checks can bail
+// out on a hash mismatch and interned nodes compare by pointer.
 class SExpr {
 public:
     using Atom = std::string;
     using List = std::vector<std::shared_ptr<SExpr>>;
     using Value = std::variant<Atom, List>;
 
-    explicit SExpr(const std::string& atom) : value(atom) {}
-    explicit SExpr(const List& list) : value(list) {}
+    explicit SExpr(const std::string& atom) : value(atom), hashCode(hashAtom(atom)) {}
+    explicit SExpr(std::string&& atom) : value(std::move(atom)), hashCode(hashAtom(std::get<Atom>(value))) {}
+    explicit SExpr(const List& list) : value(list), hashCode(hashList(list)) {}
+    explicit SExpr(List&& list) : value(std::move(list)), hashCode(hashList(std::get<List>(value))) {}
 
     bool isAtom() const { return std::holds_alternative<Atom>(value); }
     bool isList() const { return std::holds_alternative<List>(value); }
@@ -39,6 +46,12 @@ public:
     
     std::string toString() const;
     
+    // Structural hash, stable for the lifetime of the node
+    size_t hash() const { return hashCode; }
+    
+    // Structural equality; O(1) for nodes from the same SExprInterner
+    bool equals(const SExpr& other) const;
+    
     // Helper methods for common patterns
     std::optional<std::string> getSymbol() const {
         if (isAtom()) return asAtom();
@@ -59,6 +72,42 @@ public:
 
 private:
     Value value;
+    size_t hashCode;
+    
+    static size_t hashAtom(const Atom& atom);
+    static size_t hashList(const List& list);
+    void appendTo(std::string& out) const;
+    
+    friend class SExprInterner;
+};
+
+// Functors for keying unordered containers by structure
+struct SExprHash {
+    size_t operator()(const std::shared_ptr<SExpr>& expr) const { return expr->hash(); }
+};
+
+struct SExprEqual {
+    bool operator()(const std::shared_ptr<SExpr>& a, const std::shared_ptr<SExpr>& b) const {
+        return a == b || a->equals(*b);
+    }
+};
+
+// Hash-consing pool: structurally identical subtrees built through the same
+// interner share a single node. Lists are keyed by their children's
+// addresses, which is exact because children are interned first.
+class SExprInterner {
+public:
+    std::shared_ptr<SExpr> atom(std::string token);
+    std::shared_ptr<SExpr> list(SExpr::List elements);
+    
+    size_t size() const { return atoms.size() + lists.size(); }
+    size_t hits() const { return reused; }
+    
+private:
+    std::unordered_map<std::string, std::shared_ptr<SExpr>> atoms;
+    // Keyed by structural hash so a lookup needs only the children, not a node
+    std::unordered_multimap<size_t, std::shared_ptr<SExpr>> lists;
+    size_t reused = 0;
 };
 
 // S-Expression parser
@@ -67,6 +116,12 @@ public:
     static std::vector<std::shared_ptr<SExpr>> parseMultiple(const std::string& input);
     static std::shared_ptr<SExpr> parse(const std::string& input);
     
+    // Share one pool across calls so nodes from separate parses are interned together.
+    // cancel is checked between top-level expressions.
+    static std::vector<std::shared_ptr<SExpr>> parseMultiple(const std::string& input, SExprInterner& interner,
+                                                             const CancellationToken& cancel = {});
+    static std::shared_ptr<SExpr> parse(const std::string& input, SExprInterner& interner);
+    
 private:
     class Tokenizer {
     public:
@@ -85,8 +140,8 @@ private:
         bool isDelimiter(char c) const;
     };
     
-    static std::shared_ptr<SExpr> parseExpression(Tokenizer& tokenizer);
-    static std::shared_ptr<SExpr> parseList(Tokenizer& tokenizer);
+    static std::shared_ptr<SExpr> parseExpression(Tokenizer& tokenizer, SExprInterner& interner);
+    static std::shared_ptr<SExpr> parseList(Tokenizer& tokenizer, SExprInterner& interner);
 };
 
 // Triple representation for structured data
@@ -0,0 +1,86 @@
+#ifndef METTA_INFERENCE_STREAMING_ANALYZER_HPP
+#define METTA_INFERENCE_STREAMING_ANALYZER_HPP
+
+#include "semantic_analyzer.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+namespace metta_inference {
+
+// Parses REPL output while the process is still running, an expression
+// at a time, so a run that is stopped early (e.g. at its deadline) can be
+// analyzed from what it printed without waiting or re-reading it. An
+// expression may span lines: it is parsed once a newline follows it with
+// every bracket closed.
+//
+// Not synchronized: feed() from the thread reading the process, and use
+// the rest once the process is done.
+class StreamingAnalyzer {
+public:
+    // expectedResults is how many results the complete run prints (see
+    // countQueries); 0 when unknown
+    explicit StreamingAnalyzer(std::shared_ptr<const ConfigSnapshot> snapshot, size_t expectedResults = 0);
+
+    // Takes the next piece of output; expressions are parsed once complete
+    void feed(std::string_view chunk);
+
+    // The output ended: parses what follows the last newline
+    void finish();
+
+    // Bytes passed to feed() so far
+    size_t bytesFed() const { return fed; }
+
+    // From now on, check each result as it is parsed for a contradiction,
+    // conflict or violation. Only findings within one result are seen here;
+    // those SemanticAnalyzer pairs up across results show in analyze().
+    void watchForFindings() { watching = true; }
+
+    // A watched result held a finding
+    bool foundFinding() const { return found; }
+
+    // Results parsed so far
+    size_t results() const { return resultCount; }
+    size_t expectedResults() const { return expected; }
+
+    // Share of the expected results seen so far, in [0, 1]; 0 when the
+    // expected count is unknown
+    double coverage() const;
+
+    // False once the output holds a bracket that is never matched, or
+    // after finish() one never closed. SemanticAnalyzer::analyze then
+    // falls back to parsing the whole output line by line, which this
+    // does not repeat.
+    bool wellFormed() const { return !malformed; }
+
+    // SemanticAnalyzer's passes over the complete expressions fed so far;
+    // an unfinished last one is left out until finish(). Once all of a
+    // run's well-formed output was fed and finished, this is its analysis,
+    // the same as SemanticAnalyzer::analyze of the whole output.
+    SemanticAnalyzer::AnalysisResult analyze(const CancellationToken& cancel = {});
+
+    // Results a run of program prints: one per top-level "!" query
+    static size_t countQueries(const std::string& program);
+
+private:
+    SemanticAnalyzer analyzer;
+    SExprInterner interner;  // Shared by all expressions, as in SemanticAnalyzer::analyze
+    std::vector<std::shared_ptr<SExpr>> expressions;
+    std::string pending;     // Output since the last top-level newline
+    size_t depth = 0;        // Brackets open at the end of pending
+    size_t pendingResults = 0;  // Top-level "[" in pending
+    size_t expected;
+    size_t resultCount = 0;
+    size_t fed = 0;
+    bool watching = false;
+    bool found = false;
+    bool malformed = false;
+
+    void parseSegment(const std::string& text);
+    bool holdsFinding(const std::shared_ptr<SExpr>& expression);
+};
+
+}
+
+#endif
@@ -0,0 +1,308 @@
+#include "metta_inference/batch_export.hpp"
+#include <stdexcept>
+#include <limits>
+
+namespace metta_inference {
+
+namespace {
+
+constexpr char MAGIC[4] = {'M', 'T', 'C', 'B'};
+constexpr char DICTIONARY_BLOCK = 'D';
+constexpr char ROW_GROUP_BLOCK = 'R';
+constexpr char TRAILER_BLOCK = 'E';
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+uint32_t checkedSize(size_t size) {
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Batch export value exceeds 4 GiB");
+    }
+    return static_cast<uint32_t>(size);
+}
+
+// Bounds-checked little-endian cursor for the reader
+class Cursor {
+public:
+    explicit Cursor(std::string_view data) : data(data) {}
+
+    bool atEnd() const { return pos == data.size(); }
+    size_t remaining() const { return data.size() - pos; }
+
+    std::string_view take(size_t count) {
+        if (count > data.size() - pos) {
+            throw std::runtime_error("Truncated batch export at offset " + std::to_string(pos));
+        }
+        auto view = data.substr(pos, count);
+        pos += count;
+        return view;
+    }
+
+    uint8_t u8() { return static_cast<uint8_t>(take(1)[0]); }
+
+    uint16_t u16() {
+        auto b = reinterpret_cast<const unsigned char*>(take(2).data());
+        return static_cast<uint16_t>(b[0] | (b[1] << 8));
+    }
+
+    uint32_t u32() {
+        auto b = reinterpret_cast<const unsigned char*>(take(4).data());
+        return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+               (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+    }
+
+    uint64_t u64() {
+        uint64_t low = u32();
+        uint64_t high = u32();
+        return low | (high << 32);
+    }
+
+private:
+    std::string_view data;
+    size_t pos = 0;
+};
+
+}
+
+// BatchExporter implementation
+void BatchExporter::addMetrics(std::string_view example, const Metrics& metrics) {
+    for (size_t i = 0; i < metrics.contradictionDetails.size(); ++i) {
+        const auto& detail = metrics.contradictionDetails[i];
+        std::string description = metrics.contradictionDescription(i);
+        addRow({example, "contradiction", detail.entity1, detail.entity2, description});
+    }
+    for (size_t i = 0; i < metrics.conflictDetails.size(); ++i) {
+        const auto& detail = metrics.conflictDetails[i];
+        std::string description = metrics.conflictDescription(i);
+        addRow({example, "conflict", detail.entity1, detail.entity2, description});
+    }
+    for (size_t i = 0; i < metrics.violationDetails.size(); ++i) {
+        const auto& detail = metrics.violationDetails[i];
+        std::string description = metrics.violationDescription(i);
+        addRow({example, "violation", detail.violator, detail.violated_rule, description});
+    }
+    for (const auto& fact : metrics.inferredStateOfAffairs) {
+        addRow({example, "inferred_fact", fact, {}, {}});
+    }
+}
+
+std::unique_ptr<BatchExporter> BatchExporter::create(BatchExportFormat format, OutputSink& sink) {
+    switch (format) {
+        case BatchExportFormat::CSV:
+            return std::make_unique<CsvBatchExporter>(sink);
+        case BatchExportFormat::Columnar:
+        default:
+            return std::make_unique<ColumnarBatchExporter>(sink);
+    }
+}
+
+const char* BatchExporter::extension(BatchExportFormat format) {
+    return format == BatchExportFormat::CSV ? ".csv" : ".mtcb";
+}
+
+// CsvBatchExporter implementation
+CsvBatchExporter::CsvBatchExporter(OutputSink& sink) : sink(sink), writer(sink) {
+    writer.write("example,kind,subject,object,description\n");
+}
+
+void CsvBatchExporter::addRow(const ExportRow& row) {
+    writer.writeCsvField(row.example);
+    writer.put(',');
+    writer.writeCsvField(row.kind);
+    writer.put(',');
+    writer.writeCsvField(row.subject);
+    writer.put(',');
+    writer.writeCsvField(row.object);
+    writer.put(',');
+    writer.writeCsvField(row.description);
+    writer.put('\n');
+    ++rows;
+}
+
+void CsvBatchExporter::finish() {
+    writer.flush();
+    sink.flush();
+}
+
+// ColumnarBatchExporter implementation
+ColumnarBatchExporter::ColumnarBatchExporter(OutputSink& sink, size_t rowGroupSize)
+    : sink(sink), rowGroupSize(rowGroupSize == 0 ? 1 : rowGroupSize) {
+    std::string header(MAGIC, sizeof(MAGIC));
+    putU16(header, VERSION);
+    putU16(header, static_cast<uint16_t>(COLUMN_COUNT));
+    sink.write(header);
+
+    for (auto& column : columns) {
+        column.rows.reserve(this->rowGroupSize);
+    }
+}
+
+ColumnarBatchExporter::~ColumnarBatchExporter() {
+    try {
+        finish();
+    } catch (...) {
+        // Destructors must not throw; callers wanting errors call finish()
+    }
+}
+
+void ColumnarBatchExporter::addRow(const ExportRow& row) {
+    if (finished) {
+        throw std::logic_error("ColumnarBatchExporter: addRow after finish");
+    }
+
+    const std::string_view values[COLUMN_COUNT] = {row.example, row.kind, row.subject, row.object, row.description};
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+        auto& column = columns[c];
+        auto [it, inserted] = column.ids.try_emplace(std::string(values[c]),
+                                                     static_cast<uint32_t>(column.ids.size()));
+        if (inserted) {
+            column.pending.emplace_back(values[c]);
+        }
+        column.rows.push_back(it->second);
+    }
+
+    ++totalRows;
+    if (columns[0].rows.size() >= rowGroupSize) {
+        flushRowGroup();
+    }
+}
+
+void ColumnarBatchExporter::flushRowGroup() {
+    size_t count = columns[0].rows.size();
+    if (count == 0) return;
+
+    std::string block;
+
+    // Dictionary entries first, so a reader can resolve every id it meets
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+        auto& pending = columns[c].pending;
+        if (pending.empty()) continue;
+
+        block.push_back(DICTIONARY_BLOCK);
+        block.push_back(static_cast<char>(c));
+        putU32(block, checkedSize(pending.size()));
+        for (const auto& value : pending) {
+            putU32(block, checkedSize(value.size()));
+            block.append(value);
+        }
+        pending.clear();
+    }
+
+    block.push_back(ROW_GROUP_BLOCK);
+    putU32(block, checkedSize(count));
+    block.reserve(block.size() + count * 4 * COLUMN_COUNT);
+    for (auto& column : columns) {
+        for (uint32_t id : column.rows) {
+            putU32(block, id);
+        }
+        column.rows.clear();
+        // Descriptions are nearly unique; keeping every value for the
+        // whole export would grow with it
+        column.ids.clear();
+    }
+
+    sink.write(block);
+    ++rowGroups;
+}
+
+void ColumnarBatchExporter::finish() {
+    if (finished) return;
+    finished = true;
+
+    flushRowGroup();
+
+    std::string trailer(1, TRAILER_BLOCK);
+    putU64(trailer, totalRows);
+    putU32(trailer, rowGroups);
+    sink.write(trailer);
+    sink.flush();
+}
+
+// ColumnarBatchReader implementation
+bool ColumnarBatchReader::isColumnar(std::string_view data) {
+    return data.size() >= sizeof(MAGIC) && data.compare(0, sizeof(MAGIC), std::string_view(MAGIC, sizeof(MAGIC))) == 0;
+}
+
+ColumnarBatchReader::ColumnarBatchReader(std::string_view data) {
+    if (!isColumnar(data)) {
+        throw std::runtime_error("Not a columnar batch export");
+    }
+
+    Cursor cursor(data);
+    cursor.take(sizeof(MAGIC));
+    if (cursor.u16() != ColumnarBatchExporter::VERSION) {
+        throw std::runtime_error("Unsupported batch export version");
+    }
+    if (cursor.u16() != ColumnarBatchExporter::COLUMN_COUNT) {
+        throw std::runtime_error("Unexpected batch export column count");
+    }
+
+    uint32_t rowGroups = 0;
+    // Where each column's current row group dictionary starts
+    std::array<size_t, ColumnarBatchExporter::COLUMN_COUNT> groupStart{};
+    while (true) {
+        char block = static_cast<char>(cursor.u8());
+
+        if (block == DICTIONARY_BLOCK) {
+            uint8_t column = cursor.u8();
+            if (column >= ColumnarBatchExporter::COLUMN_COUNT) {
+                throw std::runtime_error("Batch export dictionary for unknown column");
+            }
+            uint32_t entries = cursor.u32();
+            for (uint32_t i = 0; i < entries; ++i) {
+                dictionaries[column].push_back(cursor.take(cursor.u32()));
+            }
+        } else if (block == ROW_GROUP_BLOCK) {
+            uint32_t count = cursor.u32();
+            // Checked before reserving, so a bad count cannot allocate
+            if (count > cursor.remaining() / (4 * ColumnarBatchExporter::COLUMN_COUNT)) {
+                throw std::runtime_error("Truncated batch export row group");
+            }
+            for (size_t c = 0; c < ColumnarBatchExporter::COLUMN_COUNT; ++c) {
+                auto& columnIds = ids[c];
+                columnIds.reserve(columnIds.size() + count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    size_t id = groupStart[c] + cursor.u32();
+                    if (id >= dictionaries[c].size()) {
+                        throw std::runtime_error("Batch export id outside its dictionary");
+                    }
+                    columnIds.push_back(static_cast<uint32_t>(id));
+                }
+                groupStart[c] = dictionaries[c].size();
+            }
+            rows += count;
+            ++rowGroups;
+        } else if (block == TRAILER_BLOCK) {
+            if (cursor.u64() != rows || cursor.u32() != rowGroups) {
+                throw std::runtime_error("Batch export trailer does not match its contents");
+            }
+            if (!cursor.atEnd()) {
+                throw std::runtime_error("Trailing data after batch export trailer");
+            }
+            return;
+        } else {
+            throw std::runtime_error("Unknown batch export block");
+        }
+    }
+}
+
+ExportRow ColumnarBatchReader::row(size_t index) const {
+    auto value = [&](size_t column) { return dictionaries[column][ids[column].at(index)]; };
+    return {value(0), value(1), value(2), value(3), value(4)};
+}
+
+}
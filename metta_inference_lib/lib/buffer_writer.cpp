@@ -0,0 +1,249 @@
+#include "metta_inference/buffer_writer.hpp"
+#include <charconv>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define METTA_ESCAPE_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace metta_inference {
+
+namespace {
+
+inline bool needsJsonEscape(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+inline bool needsCsvQuoting(unsigned char c) {
+    return c == ',' || c == '"' || c == '\n' || c == '\r';
+}
+
+size_t findJsonEscapeScalar(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (needsJsonEscape(static_cast<unsigned char>(data[i]))) return i;
+    }
+    return size;
+}
+
+size_t findCsvSpecialScalar(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (needsCsvQuoting(static_cast<unsigned char>(data[i]))) return i;
+    }
+    return size;
+}
+
+#ifdef METTA_ESCAPE_SIMD
+
+// A byte is a control character when min(byte, 0x1F) == byte (unsigned)
+
+__attribute__((target("sse2")))
+size_t findJsonEscapeSse2(const char* data, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i controlMax = _mm_set1_epi8(0x1F);
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(v, controlMax), v));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return i + findJsonEscapeScalar(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+size_t findJsonEscapeAvx2(const char* data, size_t size) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i controlMax = _mm256_set1_epi8(0x1F);
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(v, controlMax), v));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return i + findJsonEscapeSse2(data + i, size - i);
+}
+
+__attribute__((target("sse2")))
+size_t findCsvSpecialSse2(const char* data, size_t size) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriage = _mm_set1_epi8('\r');
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, carriage)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return i + findCsvSpecialScalar(data + i, size - i);
+}
+
+__attribute__((target("avx2")))
+size_t findCsvSpecialAvx2(const char* data, size_t size) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriage = _mm256_set1_epi8('\r');
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, quote)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, newline), _mm256_cmpeq_epi8(v, carriage)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return i + findCsvSpecialSse2(data + i, size - i);
+}
+
+#endif
+
+struct Scanners {
+    size_t (*json)(const char*, size_t);
+    size_t (*csv)(const char*, size_t);
+    const char* isa;
+};
+
+Scanners selectScanners() {
+#ifdef METTA_ESCAPE_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {findJsonEscapeAvx2, findCsvSpecialAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {findJsonEscapeSse2, findCsvSpecialSse2, "sse2"};
+    }
+#endif
+    return {findJsonEscapeScalar, findCsvSpecialScalar, "scalar"};
+}
+
+// Chosen once, on first use
+const Scanners& scanners() {
+    static const Scanners selected = selectScanners();
+    return selected;
+}
+
+}
+
+size_t findJsonEscape(std::string_view text) {
+    return scanners().json(text.data(), text.size());
+}
+
+size_t findCsvSpecial(std::string_view text) {
+    return scanners().csv(text.data(), text.size());
+}
+
+const char* escapeScannerIsa() {
+    return scanners().isa;
+}
+
+// BufferWriter implementation
+BufferWriter::BufferWriter(OutputSink& sink, size_t capacity) : sink(sink), capacity(capacity) {
+    buffer.reserve(capacity);
+}
+
+BufferWriter::~BufferWriter() {
+    try {
+        flush();
+    } catch (...) {
+        // Destructors must not throw; callers wanting errors call flush()
+    }
+}
+
+void BufferWriter::write(std::string_view text) {
+    reserveFor(text.size());
+    if (text.size() >= capacity) {
+        sink.write(text);  // Too big to stage; buffer is already drained
+        return;
+    }
+    buffer.append(text);
+}
+
+void BufferWriter::put(char c) {
+    reserveFor(1);
+    buffer.push_back(c);
+}
+
+void BufferWriter::writeInt(int64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    write(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+void BufferWriter::writeUInt(uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    write(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+void BufferWriter::writeJsonString(std::string_view text) {
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    put('"');
+    while (!text.empty()) {
+        size_t clean = findJsonEscape(text);
+        write(text.substr(0, clean));
+        if (clean == text.size()) break;
+
+        auto c = static_cast<unsigned char>(text[clean]);
+        switch (c) {
+            case '"': write("\\\""); break;
+            case '\\': write("\\\\"); break;
+            case '\b': write("\\b"); break;
+            case '\f': write("\\f"); break;
+            case '\n': write("\\n"); break;
+            case '\r': write("\\r"); break;
+            case '\t': write("\\t"); break;
+            default: {
+                char escaped[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+                write(std::string_view(escaped, sizeof(escaped)));
+                break;
+            }
+        }
+        text.remove_prefix(clean + 1);
+    }
+    put('"');
+}
+
+void BufferWriter::writeCsvField(std::string_view text) {
+    if (findCsvSpecial(text) == text.size()) {
+        write(text);
+        return;
+    }
+
+    // Quote the field and double any embedded quotes
+    put('"');
+    while (!text.empty()) {
+        size_t quote = text.find('"');
+        if (quote == std::string_view::npos) {
+            write(text);
+            break;
+        }
+        write(text.substr(0, quote + 1));
+        put('"');
+        text.remove_prefix(quote + 1);
+    }
+    put('"');
+}
+
+void BufferWriter::flush() {
+    if (buffer.empty()) return;
+    sink.write(buffer);
+    buffer.clear();
+}
+
+}
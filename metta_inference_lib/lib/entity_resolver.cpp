@@ -1,12 +1,215 @@
 #include "metta_inference/entity_resolver.hpp"
+#include "metta_inference/json_value.hpp"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
 #include <iostream>
+#include <stdexcept>
+#include <atomic>
 
 namespace metta_inference {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::chrono::microseconds elapsedSince(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+std::string readConfigFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open configuration file: " + path);
+    }
+    std::string content(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!file) {
+        throw std::runtime_error("Could not read configuration file: " + path);
+    }
+    return content;
+}
+
+// Section lookup; absent sections are fine, wrongly typed ones are not
+JsonValue::Object* section(JsonValue& root, std::string_view name) {
+    JsonValue* value = root.find(name);
+    if (!value) return nullptr;
+    if (!value->isObject()) {
+        throw std::runtime_error("Configuration section '" + std::string(name) + "' must be an object");
+    }
+    return &value->members();
+}
+
+std::string takeString(JsonValue& value, std::string_view sectionName, const std::string& key) {
+    if (!value.isString()) {
+        throw std::runtime_error("Configuration value '" + std::string(sectionName) + "." + key +
+                                 "' must be a string");
+    }
+    return value.takeString();
+}
+
+void readStringMap(JsonValue& root, std::string_view name, std::map<std::string, std::string>& out) {
+    auto* members = section(root, name);
+    if (!members) return;
+    for (auto& member : *members) {
+        out[member.key] = takeString(member.value, name, member.key);
+    }
+}
+
+void applyMappings(const InferenceConfiguration::Config& config, EntityResolver& resolver) {
+    for (const auto& [entity, displayName] : config.entityMappings) {
+        resolver.addEntityMapping(entity, displayName);
+    }
+    
+    resolver.addSpecialCharMappings(config.specialCharacters);
+    
+    for (const auto& [instrument, displayName] : config.instrumentMappings) {
+        resolver.addInstrumentMapping(instrument, displayName);
+    }
+    
+    for (const auto& [action, mapping] : config.actionMappings) {
+        resolver.addActionMapping(action, mapping);
+    }
+}
+
+void applyTemplates(const InferenceConfiguration::Config& config, DescriptionTemplates& templates) {
+    for (const auto& [id, pattern] : config.contradictionTemplates) {
+        templates.addTemplate("contradiction_" + id, pattern);
+    }
+    
+    for (const auto& [id, pattern] : config.conflictTemplates) {
+        templates.addTemplate("conflict_" + id, pattern);
+    }
+    
+    for (const auto& [id, pattern] : config.violationTemplates) {
+        templates.addTemplate("violation_" + id, pattern);
+    }
+    
+    for (const auto& [id, pattern] : config.complianceTemplates) {
+        templates.addTemplate("compliance_" + id, pattern);
+    }
+}
+
+size_t entryCount(const InferenceConfiguration::Config& config) {
+    return config.entityMappings.size() + config.specialCharacters.size() +
+           config.instrumentMappings.size() + config.actionMappings.size() +
+           config.contradictionTemplates.size() + config.conflictTemplates.size() +
+           config.violationTemplates.size() + config.complianceTemplates.size();
+}
+
+}
+
+// PatternRewriter implementation
+int32_t PatternRewriter::child(int32_t node, unsigned char byte) const {
+    const auto& edges = nodes[node].edges;
+    auto it = std::lower_bound(edges.begin(), edges.end(), byte,
+        [](const std::pair<unsigned char, int32_t>& edge, unsigned char b) { return edge.first < b; });
+    return (it != edges.end() && it->first == byte) ? it->second : -1;
+}
+
+int32_t PatternRewriter::step(int32_t node, unsigned char byte) const {
+    while (true) {
+        int32_t next = child(node, byte);
+        if (next >= 0) return next;
+        if (node == 0) return 0;
+        node = nodes[node].fail;
+    }
+}
+
+void PatternRewriter::build(const std::unordered_map<std::string, std::string>& replacements) {
+    nodes.assign(1, Node{});
+    patterns.clear();
+    
+    for (const auto& [from, to] : replacements) {
+        if (from.empty()) continue;
+        
+        int32_t node = 0;
+        for (auto it = from.rbegin(); it != from.rend(); ++it) {
+            auto byte = static_cast<unsigned char>(*it);
+            int32_t next = child(node, byte);
+            if (next < 0) {
+                next = static_cast<int32_t>(nodes.size());
+                nodes.emplace_back();
+                auto& edges = nodes[node].edges;
+                auto pos = std::lower_bound(edges.begin(), edges.end(), byte,
+                    [](const std::pair<unsigned char, int32_t>& edge, unsigned char b) { return edge.first < b; });
+                edges.insert(pos, {byte, next});
+            }
+            node = next;
+        }
+        nodes[node].output = static_cast<int32_t>(patterns.size());
+        patterns.emplace_back(from, to);
+    }
+    
+    // Breadth-first failure links; a node's own pattern is always longer
+    // than anything reachable through its failure link
+    std::vector<int32_t> queue;
+    for (const auto& [byte, next] : nodes[0].edges) {
+        nodes[next].fail = 0;
+        queue.push_back(next);
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int32_t node = queue[head];
+        if (nodes[node].output < 0) {
+            nodes[node].output = nodes[nodes[node].fail].output;
+        }
+        for (const auto& [byte, next] : nodes[node].edges) {
+            nodes[next].fail = step(nodes[node].fail, byte);
+            queue.push_back(next);
+        }
+    }
+}
+
+std::string PatternRewriter::rewrite(std::string_view text) const {
+    if (patterns.empty()) return std::string(text);
+    
+    // Backward pass: longest pattern starting at each position
+    std::vector<int32_t> startsHere(text.size(), -1);
+    int32_t state = 0;
+    for (size_t i = text.size(); i-- > 0;) {
+        state = step(state, static_cast<unsigned char>(text[i]));
+        startsHere[i] = nodes[state].output;
+    }
+    
+    // Forward pass: leftmost match wins, then continue after it
+    std::string result;
+    result.reserve(text.size() + 8);
+    for (size_t i = 0; i < text.size();) {
+        if (startsHere[i] >= 0) {
+            const auto& [from, to] = patterns[startsHere[i]];
+            result.append(to);
+            i += from.size();
+        } else {
+            result.push_back(text[i++]);
+        }
+    }
+    return result;
+}
+
+// EntityResolver::MemoCache implementation
+std::optional<std::string> EntityResolver::MemoCache::find(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) return std::nullopt;
+    return it->second;
+}
+
+void EntityResolver::MemoCache::store(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Bounded: start over rather than track recency
+    if (entries.size() >= MAX_ENTRIES) {
+        entries.clear();
+    }
+    entries.emplace(key, value);
+}
+
+void EntityResolver::MemoCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
+
 // EntityResolver implementation
 EntityResolver::EntityResolver() {
     loadDefaultMappings();
@@ -58,12 +261,12 @@ void EntityResolver::loadDefaultMappings() {
     actionMappings["soa_enlam"] = {"leave", "leave", "leaves", "left"};
     actionMappings["soa_epam"] = {"pay", "pay", "pays", "paid"};
     actionMappings["soa_enpam"] = {"pay", "pay", "pays", "paid"};
+    
+    specialCharRewriter.build(specialCharMappings);
 }
 
 void EntityResolver::loadConfiguration(const std::string& jsonPath) {
-    // In a full implementation, this would parse JSON
-    // For now, we'll keep the default mappings
-    std::cerr << "Loading configuration from: " << jsonPath << std::endl;
+    applyMappings(InferenceConfiguration::parse(readConfigFile(jsonPath)), *this);
 }
 
 void EntityResolver::addEntityMapping(const std::string& entity, const std::string& displayName) {
@@ -72,12 +275,28 @@ void EntityResolver::addEntityMapping(const std::string& entity, const std::stri
 
 void EntityResolver::addSpecialCharMapping(const std::string& from, const std::string& to) {
     specialCharMappings[from] = to;
+    specialCharRewriter.build(specialCharMappings);
+    resolvedEntities.clear();
+}
+
+void EntityResolver::addSpecialCharMappings(const std::map<std::string, std::string>& mappings) {
+    if (mappings.empty()) return;
+    for (const auto& [from, to] : mappings) {
+        specialCharMappings[from] = to;
+    }
+    // One rebuild for the whole table
+    specialCharRewriter.build(specialCharMappings);
+    resolvedEntities.clear();
 }
 
 void EntityResolver::addActionMapping(const std::string& soaAction, const ActionMapping& mapping) {
     actionMappings[soaAction] = mapping;
 }
 
+void EntityResolver::addInstrumentMapping(const std::string& instrument, const std::string& displayName) {
+    instrumentMappings[instrument] = displayName;
+}
+
 std::string EntityResolver::resolveEntity(const std::string& entity) const {
     // Check if we have a direct mapping
     auto it = entityMappings.find(entity);
@@ -145,10 +364,15 @@ std::string EntityResolver::resolvePort(const std::string& port) const {
 }
 
 std::string EntityResolver::entityToHumanReadable(const std::string& soaEntity) const {
-    if (soaEntity.substr(0, 4) != "soa_") {
+    if (soaEntity.compare(0, 4, "soa_") != 0) {
         return soaEntity;
     }
     
+    // The same vessels and berths recur across every detail of a run
+    if (auto cached = resolvedEntities.find(soaEntity)) {
+        return *cached;
+    }
+    
     std::string entity = soaEntity.substr(4);
     
     // Replace underscores with spaces
@@ -157,6 +381,7 @@ std::string EntityResolver::entityToHumanReadable(const std::string& soaEntity)
     // Apply special character mappings
     entity = applySpecialChars(entity);
     
+    resolvedEntities.store(soaEntity, entity);
     return entity;
 }
 
@@ -186,17 +411,80 @@ std::string EntityResolver::getBaseForm(const std::string& entity) const {
 }
 
 std::string EntityResolver::applySpecialChars(const std::string& text) const {
-    std::string result = text;
+    return specialCharRewriter.rewrite(text);
+}
+
+// CompiledTemplate implementation
+TemplateSlot CompiledTemplate::slotFor(std::string_view name) {
+    static constexpr std::pair<std::string_view, TemplateSlot> names[] = {
+        {"entity", TemplateSlot::Entity},
+        {"entity1", TemplateSlot::Entity1},
+        {"entity2", TemplateSlot::Entity2},
+        {"context", TemplateSlot::Context},
+        {"instrument1", TemplateSlot::Instrument1},
+        {"instrument2", TemplateSlot::Instrument2},
+        {"action", TemplateSlot::Action},
+        {"action1", TemplateSlot::Action1},
+        {"action2", TemplateSlot::Action2},
+        {"regulation1", TemplateSlot::Regulation1},
+        {"regulation2", TemplateSlot::Regulation2},
+        {"reason", TemplateSlot::Reason},
+        {"rule", TemplateSlot::Rule},
+        {"violator", TemplateSlot::Violator},
+        {"constraint", TemplateSlot::Constraint},
+        {"obligation", TemplateSlot::Obligation},
+        {"requirement", TemplateSlot::Requirement},
+    };
     
-    for (const auto& [from, to] : specialCharMappings) {
-        size_t pos = 0;
-        while ((pos = result.find(from, pos)) != std::string::npos) {
-            result.replace(pos, from.length(), to);
-            pos += to.length();
-        }
+    for (const auto& [key, slot] : names) {
+        if (key == name) return slot;
     }
+    return TemplateSlot::Count;
+}
+
+CompiledTemplate::CompiledTemplate(std::string pattern) : text(std::move(pattern)) {
+    size_t literalStart = 0;
+    size_t pos = 0;
+    
+    auto addLiteral = [this](size_t from, size_t to) {
+        if (to <= from) return;
+        // Merge with a preceding literal, e.g. after an unknown placeholder
+        if (!segments.empty() && segments.back().slot == TemplateSlot::Count &&
+            segments.back().offset + segments.back().length == from) {
+            segments.back().length += static_cast<uint32_t>(to - from);
+            return;
+        }
+        segments.push_back({static_cast<uint32_t>(from), static_cast<uint32_t>(to - from),
+                            TemplateSlot::Count});
+    };
     
-    return result;
+    while ((pos = text.find('{', pos)) != std::string::npos) {
+        size_t close = text.find('}', pos + 1);
+        if (close == std::string::npos) break;
+        
+        auto slot = slotFor(std::string_view(text).substr(pos + 1, close - pos - 1));
+        if (slot == TemplateSlot::Count) {
+            // Not a variable we know; keep it as text
+            pos = pos + 1;
+            continue;
+        }
+        
+        addLiteral(literalStart, pos);
+        segments.push_back({static_cast<uint32_t>(pos), static_cast<uint32_t>(close + 1 - pos), slot});
+        pos = close + 1;
+        literalStart = pos;
+    }
+    addLiteral(literalStart, text.size());
+}
+
+void CompiledTemplate::renderTo(std::string& out, const TemplateVars& vars) const {
+    for (const auto& segment : segments) {
+        if (segment.slot != TemplateSlot::Count && vars.has(segment.slot)) {
+            out.append(vars.get(segment.slot));
+        } else {
+            out.append(text, segment.offset, segment.length);
+        }
+    }
 }
 
 // DescriptionTemplates implementation
@@ -206,71 +494,63 @@ DescriptionTemplates::DescriptionTemplates() {
 
 void DescriptionTemplates::loadDefaultTemplates() {
     // Contradiction templates
-    templates["contradiction_existence"] = {
-        "contradiction_existence",
-        "Contradiction: {entity} cannot both {action1} and {action2}",
-        {}
-    };
-    
-    templates["contradiction_payment"] = {
-        "contradiction_payment",
-        "Contradiction: Payment declared in {instrument1} but {instrument2} is required",
-        {}
-    };
-    
-    templates["contradiction_action"] = {
-        "contradiction_action",
-        "Contradiction: {entity} cannot both {action} and not {action} at the same time",
-        {}
-    };
+    addTemplate("contradiction_existence",
+                "Contradiction: {entity} cannot both {action1} and {action2}");
+    addTemplate("contradiction_payment",
+                "Contradiction: Payment declared in {instrument1} but {instrument2} is required");
+    addTemplate("contradiction_action",
+                "Contradiction: {entity} cannot both {action} and not {action} at the same time");
     
     // Conflict templates
-    templates["conflict_regulation"] = {
-        "conflict_regulation",
-        "Regulatory conflict: {regulation1} prohibits {action} while {regulation2} requires it",
-        {}
-    };
-    
-    templates["conflict_payment"] = {
-        "conflict_payment",
-        "{entity} faces a conflict: {reason}",
-        {}
-    };
+    addTemplate("conflict_regulation",
+                "Regulatory conflict: {regulation1} prohibits {action} while {regulation2} requires it");
+    addTemplate("conflict_payment",
+                "{entity} faces a conflict: {reason}");
     
     // Violation templates
-    templates["violation_necessary"] = {
-        "violation_necessary",
-        "The {rule} must be violated due to {reason}",
-        {}
-    };
-    
-    templates["violation_constraint"] = {
-        "violation_constraint",
-        "{entity} violates {rule} because of {constraint}",
-        {}
-    };
+    addTemplate("violation_necessary",
+                "The {rule} must be violated due to {reason}");
+    addTemplate("violation_constraint",
+                "{entity} violates {rule} because of {constraint}");
     
     // Compliance templates
-    templates["compliance_fulfilled"] = {
-        "compliance_fulfilled",
-        "{entity} successfully fulfills {obligation} by {action}",
-        {}
-    };
-    
-    templates["compliance_met"] = {
-        "compliance_met",
-        "Requirement {requirement} is met by {entity}",
-        {}
-    };
+    addTemplate("compliance_fulfilled",
+                "{entity} successfully fulfills {obligation} by {action}");
+    addTemplate("compliance_met",
+                "Requirement {requirement} is met by {entity}");
 }
 
 void DescriptionTemplates::loadTemplates(const std::string& jsonPath) {
-    // In a full implementation, this would parse JSON
-    std::cerr << "Loading templates from: " << jsonPath << std::endl;
+    applyTemplates(InferenceConfiguration::parse(readConfigFile(jsonPath)), *this);
 }
 
 void DescriptionTemplates::addTemplate(const std::string& id, const std::string& pattern) {
-    templates[id] = {id, pattern, {}};
+    templates[id] = {id, pattern, {}, CompiledTemplate(pattern)};
+    
+    // Keep the index pointing at the lexicographically first id per category
+    std::string category = id.substr(0, id.find('_'));
+    auto it = categoryIndex.find(category);
+    if (it == categoryIndex.end() || id < it->second) {
+        categoryIndex[category] = id;
+    }
+}
+
+bool DescriptionTemplates::renderTo(const std::string& id, const TemplateVars& vars,
+                                    std::string& out) const {
+    auto it = templates.find(id);
+    if (it == templates.end()) return false;
+    it->second.compiled.renderTo(out, vars);
+    return true;
+}
+
+std::string DescriptionTemplates::render(const std::string& id, const TemplateVars& vars) const {
+    std::string out;
+    auto it = templates.find(id);
+    if (it != templates.end()) {
+        out.reserve(it->second.pattern.size() + 64);
+        it->second.compiled.renderTo(out, vars);
+    }
+    return out;
 }
 
 std::string DescriptionTemplates::generateContradictionDescription(
@@ -278,14 +558,17 @@ std::string DescriptionTemplates::generateContradictionDescription(
     const std::string& entity2,
     const std::string& context) const {
     
-    std::map<std::string, std::string> vars;
-    vars["entity1"] = entity1;
-    vars["entity2"] = entity2;
-    vars["context"] = context;
+    TemplateVars vars;
+    vars.set(TemplateSlot::Entity1, entity1);
+    vars.set(TemplateSlot::Entity2, entity2);
+    vars.set(TemplateSlot::Context, context);
     
     // Determine which template to use based on context
     std::string templateId = "contradiction_existence";
     
+    std::string_view e1(entity1);
+    std::string_view e2(entity2);
+    
     if (context == "payment_method" || 
         context.find("USDS") != std::string::npos ||
         context.find("INRS") != std::string::npos) {
@@ -293,11 +576,11 @@ std::string DescriptionTemplates::generateContradictionDescription(
         
         // Extract instruments from context if possible
         if (context.find("USDS") != std::string::npos) {
-            vars["instrument1"] = "USDS";
-            vars["instrument2"] = "INRS";
+            vars.set(TemplateSlot::Instrument1, "USDS");
+            vars.set(TemplateSlot::Instrument2, "INRS");
         } else if (context.find("INRS") != std::string::npos) {
-            vars["instrument1"] = "INRS";
-            vars["instrument2"] = "USDS";
+            vars.set(TemplateSlot::Instrument1, "INRS");
+            vars.set(TemplateSlot::Instrument2, "USDS");
         }
     } else if (context == "action") {
         templateId = "contradiction_action";
@@ -305,35 +588,34 @@ std::string DescriptionTemplates::generateContradictionDescription(
         // Extract entity and action from entity1 and entity2
         // entity1 should be like "ALEXANDRA MÆRSK moor"
         // entity2 should be like "ALEXANDRA MÆRSK does not moor"
-        size_t spacePos = entity1.rfind(' ');
-        if (spacePos != std::string::npos) {
-            vars["entity"] = entity1.substr(0, spacePos);
-            vars["action"] = entity1.substr(spacePos + 1);
+        size_t spacePos = e1.rfind(' ');
+        if (spacePos != std::string_view::npos) {
+            vars.set(TemplateSlot::Entity, e1.substr(0, spacePos));
+            vars.set(TemplateSlot::Action, e1.substr(spacePos + 1));
         } else {
-            vars["entity"] = entity1;
-            vars["action"] = "act";
+            vars.set(TemplateSlot::Entity, e1);
+            vars.set(TemplateSlot::Action, "act");
         }
     } else {
         // For other cases, extract action information for action1/action2 placeholders
-        vars["entity"] = entity1;
+        vars.set(TemplateSlot::Entity, e1);
         
         // Try to extract actions from entity descriptions
-        size_t space1 = entity1.rfind(' ');
-        size_t space2 = entity2.rfind(' ');
+        size_t space1 = e1.rfind(' ');
+        size_t space2 = e2.rfind(' ');
         
-        if (space1 != std::string::npos && space2 != std::string::npos) {
-            vars["action1"] = entity1.substr(space1 + 1);
-            vars["action2"] = entity2.substr(space2 + 1);
-            vars["entity"] = entity1.substr(0, space1);
+        if (space1 != std::string_view::npos && space2 != std::string_view::npos) {
+            vars.set(TemplateSlot::Action1, e1.substr(space1 + 1));
+            vars.set(TemplateSlot::Action2, e2.substr(space2 + 1));
+            vars.set(TemplateSlot::Entity, e1.substr(0, space1));
         } else {
-            vars["action1"] = entity1;
-            vars["action2"] = entity2;
+            vars.set(TemplateSlot::Action1, e1);
+            vars.set(TemplateSlot::Action2, e2);
         }
     }
     
-    auto it = templates.find(templateId);
-    if (it != templates.end()) {
-        return substitute(it->second.pattern, vars);
+    if (templates.count(templateId)) {
+        return render(templateId, vars);
     }
     
     return "Contradiction between " + entity1 + " and " + entity2;
@@ -344,20 +626,19 @@ std::string DescriptionTemplates::generateConflictDescription(
     const std::string& entity2,
     const std::string& reason) const {
     
-    std::map<std::string, std::string> vars;
-    vars["entity"] = entity1;
-    vars["entity1"] = entity1;
-    vars["entity2"] = entity2;
-    vars["reason"] = reason;
+    TemplateVars vars;
+    vars.set(TemplateSlot::Entity, entity1);
+    vars.set(TemplateSlot::Entity1, entity1);
+    vars.set(TemplateSlot::Entity2, entity2);
+    vars.set(TemplateSlot::Reason, reason);
     
     std::string templateId = "conflict_regulation";
     if (reason.find("payment") != std::string::npos) {
         templateId = "conflict_payment";
     }
     
-    auto it = templates.find(templateId);
-    if (it != templates.end()) {
-        return substitute(it->second.pattern, vars);
+    if (templates.count(templateId)) {
+        return render(templateId, vars);
     }
     
     return "Conflict between " + entity1 + " and " + entity2 + ": " + reason;
@@ -368,18 +649,17 @@ std::string DescriptionTemplates::generateViolationDescription(
     const std::string& violatedRule,
     const std::string& context) const {
     
-    std::map<std::string, std::string> vars;
-    vars["entity"] = violator;
-    vars["violator"] = violator;
-    vars["rule"] = violatedRule;
-    vars["reason"] = context;
-    vars["constraint"] = context;
+    TemplateVars vars;
+    vars.set(TemplateSlot::Entity, violator);
+    vars.set(TemplateSlot::Violator, violator);
+    vars.set(TemplateSlot::Rule, violatedRule);
+    vars.set(TemplateSlot::Reason, context);
+    vars.set(TemplateSlot::Constraint, context);
     
     std::string templateId = "violation_necessary";
     
-    auto it = templates.find(templateId);
-    if (it != templates.end()) {
-        return substitute(it->second.pattern, vars);
+    if (templates.count(templateId)) {
+        return render(templateId, vars);
     }
     
     return violatedRule + " violated by " + violator;
@@ -390,17 +670,16 @@ std::string DescriptionTemplates::generateComplianceDescription(
     const std::string& rule,
     const std::string& action) const {
     
-    std::map<std::string, std::string> vars;
-    vars["entity"] = entity;
-    vars["obligation"] = rule;
-    vars["requirement"] = rule;
-    vars["action"] = action;
+    TemplateVars vars;
+    vars.set(TemplateSlot::Entity, entity);
+    vars.set(TemplateSlot::Obligation, rule);
+    vars.set(TemplateSlot::Requirement, rule);
+    vars.set(TemplateSlot::Action, action);
     
     std::string templateId = "compliance_fulfilled";
     
-    auto it = templates.find(templateId);
-    if (it != templates.end()) {
-        return substitute(it->second.pattern, vars);
+    if (templates.count(templateId)) {
+        return render(templateId, vars);
     }
     
     return entity + " complies with " + rule;
@@ -408,28 +687,43 @@ std::string DescriptionTemplates::generateComplianceDescription(
 
 std::string DescriptionTemplates::substitute(const std::string& templateStr,
                                             const std::map<std::string, std::string>& variables) const {
-    std::string result = templateStr;
-    
-    for (const auto& [key, value] : variables) {
-        std::string placeholder = "{" + key + "}";
-        size_t pos = 0;
-        while ((pos = result.find(placeholder, pos)) != std::string::npos) {
-            result.replace(pos, placeholder.length(), value);
-            pos += value.length();
+    std::string result;
+    result.reserve(templateStr.size());
+    
+    size_t pos = 0;
+    while (pos < templateStr.size()) {
+        size_t open = templateStr.find('{', pos);
+        size_t close = open == std::string::npos ? open : templateStr.find('}', open + 1);
+        if (close == std::string::npos) break;
+        
+        result.append(templateStr, pos, open - pos);
+        auto it = variables.find(templateStr.substr(open + 1, close - open - 1));
+        if (it != variables.end()) {
+            result.append(it->second);
+            pos = close + 1;
+        } else {
+            // Unknown name: emit the brace and rescan after it
+            result.push_back('{');
+            pos = open + 1;
         }
     }
+    result.append(templateStr, std::min(pos, templateStr.size()), std::string::npos);
     
     return result;
 }
 
 std::string DescriptionTemplates::findBestTemplate(const std::string& category,
                                                   const std::map<std::string, std::string>& /* context */) const {
-    // Logic to find the best matching template based on context
-    // For now, return the first template in the category
-    for (const auto& [id, tmpl] : templates) {
-        if (id.find(category) == 0) {
-            return id;
-        }
+    // Whole categories resolve through the index built by addTemplate
+    auto it = categoryIndex.find(category);
+    if (it != categoryIndex.end()) {
+        return it->second;
+    }
+    
+    // Arbitrary prefixes such as "contradiction_pay" still scan
+    for (auto tmpl = templates.lower_bound(category); tmpl != templates.end(); ++tmpl) {
+        if (tmpl->first.compare(0, category.size(), category) != 0) break;
+        return tmpl->first;
     }
     return "";
 }
@@ -442,59 +736,213 @@ InferenceConfiguration& InferenceConfiguration::getInstance() {
 
 InferenceConfiguration::InferenceConfiguration() {
     // Initialize with defaults
-    applyConfiguration();
+    LoadStats stats;
+    stats.source = "<defaults>";
+    publish(Config{}, std::move(stats));
 }
 
-void InferenceConfiguration::loadFromFile(const std::string& path) {
-    // In a full implementation, this would parse JSON from file
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cerr << "Warning: Could not open configuration file: " << path << std::endl;
-        return;
+InferenceConfiguration::Config InferenceConfiguration::parse(std::string_view json) {
+    JsonValue root = JsonValue::parse(json);
+    if (!root.isObject()) {
+        throw std::runtime_error("Configuration root must be an object");
+    }
+    
+    Config config;
+    readStringMap(root, "entityMappings", config.entityMappings);
+    readStringMap(root, "specialCharacters", config.specialCharacters);
+    readStringMap(root, "instrumentMappings", config.instrumentMappings);
+    readStringMap(root, "contradictionTemplates", config.contradictionTemplates);
+    readStringMap(root, "conflictTemplates", config.conflictTemplates);
+    readStringMap(root, "violationTemplates", config.violationTemplates);
+    readStringMap(root, "complianceTemplates", config.complianceTemplates);
+    
+    if (auto* actions = section(root, "actionMappings")) {
+        for (auto& [id, value] : *actions) {
+            if (!value.isObject()) {
+                throw std::runtime_error("Configuration value 'actionMappings." + id + "' must be an object");
+            }
+            EntityResolver::ActionMapping mapping;
+            std::string name = "actionMappings." + id;
+            auto field = [&](std::string_view key, std::string& out) {
+                if (JsonValue* fieldValue = value.find(key)) {
+                    out = takeString(*fieldValue, name, std::string(key));
+                }
+            };
+            field("pattern", mapping.pattern);
+            field("baseForm", mapping.baseForm);
+            field("presentTense", mapping.presentTense);
+            field("pastTense", mapping.pastTense);
+            config.actionMappings[id] = std::move(mapping);
+        }
     }
     
-    // For now, we'll use the default configuration
-    applyConfiguration();
+    if (section(root, "patternRecognition")) {
+        const JsonValue& recognition = *root.find("patternRecognition");
+        if (const auto* value = recognition.find("useStrictMatching")) {
+            config.useStrictMatching = value->asBool();
+        }
+        if (const auto* value = recognition.find("enableFuzzyMatching")) {
+            config.enableFuzzyMatching = value->asBool();
+        }
+        if (const auto* value = recognition.find("fuzzyThreshold")) {
+            config.fuzzyThreshold = value->asNumber();
+        }
+    }
+    
+    return config;
 }
 
-void InferenceConfiguration::loadFromString(const std::string& /* json */) {
-    // In a full implementation, this would parse JSON string
-    // For now, we'll use the default configuration
-    applyConfiguration();
+std::shared_ptr<const InferenceConfiguration::Snapshot> InferenceConfiguration::current() const {
+    return std::atomic_load(&snapshot);
 }
 
-void InferenceConfiguration::applyConfiguration() {
-    // Apply entity mappings
-    for (const auto& [entity, displayName] : config.entityMappings) {
-        entityResolver.addEntityMapping(entity, displayName);
-    }
+InferenceConfiguration::LoadStats InferenceConfiguration::getLoadStats() const {
+    return current()->stats;
+}
+
+std::shared_ptr<const InferenceConfiguration::Config> InferenceConfiguration::getConfig() const {
+    auto loaded = current();
+    return std::shared_ptr<const Config>(loaded, &loaded->config);
+}
+
+std::shared_ptr<const EntityResolver> InferenceConfiguration::getEntityResolver() const {
+    auto loaded = current();
+    return std::shared_ptr<const EntityResolver>(loaded, &loaded->entityResolver);
+}
+
+std::shared_ptr<const DescriptionTemplates> InferenceConfiguration::getTemplates() const {
+    auto loaded = current();
+    return std::shared_ptr<const DescriptionTemplates>(loaded, &loaded->templates);
+}
+
+void InferenceConfiguration::loadFromFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    loadFileLocked(path);
+}
+
+void InferenceConfiguration::loadFromString(const std::string& json) {
+    auto start = Clock::now();
+    Config config = parse(json);
     
-    // Apply special characters
-    for (const auto& [from, to] : config.specialCharacters) {
-        entityResolver.addSpecialCharMapping(from, to);
-    }
+    LoadStats stats;
+    stats.source = "<string>";
+    stats.bytes = json.size();
+    stats.parseTime = elapsedSince(start);
     
-    // Apply action mappings
-    for (const auto& [action, mapping] : config.actionMappings) {
-        entityResolver.addActionMapping(action, mapping);
+    std::lock_guard<std::mutex> lock(loadMutex);
+    publish(std::move(config), std::move(stats));
+}
+
+bool InferenceConfiguration::loadIfChanged(const std::string& path) {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    
+    std::error_code ec;
+    auto fileTime = std::filesystem::last_write_time(path, ec);
+    uintmax_t fileSize = ec ? 0 : std::filesystem::file_size(path, ec);
+    if (!ec) {
+        auto loaded = current();
+        const auto& stats = loaded->stats;
+        if (stats.source == path && stats.fileTime == fileTime && stats.fileSize == fileSize) {
+            return false;
+        }
+        if (failedSource == path && failedTime == fileTime && failedSize == fileSize) {
+            return false;
+        }
     }
     
-    // Apply templates
-    for (const auto& [id, pattern] : config.contradictionTemplates) {
-        descriptionTemplates.addTemplate("contradiction_" + id, pattern);
+    return loadFileLocked(path);
+}
+
+bool InferenceConfiguration::reloadIfChanged() {
+    std::string source = current()->stats.source;
+    if (source.empty() || source.front() == '<') {
+        return false;  // Defaults or an in-memory document; nothing to watch
     }
-    
-    for (const auto& [id, pattern] : config.conflictTemplates) {
-        descriptionTemplates.addTemplate("conflict_" + id, pattern);
+    return loadIfChanged(source);
+}
+
+bool InferenceConfiguration::loadFileLocked(const std::string& path) {
+    try {
+        std::atomic_store(&snapshot, readSnapshot(path));
+        failedSource.clear();
+        return true;
+    } catch (const std::exception& e) {
+        std::error_code ec;
+        failedSource = path;
+        failedTime = std::filesystem::last_write_time(path, ec);
+        failedSize = ec ? 0 : std::filesystem::file_size(path, ec);
+        std::cerr << "Warning: " << e.what() << "; keeping previous configuration" << std::endl;
+        return false;
     }
+}
+
+std::shared_ptr<const InferenceConfiguration::Snapshot> InferenceConfiguration::loadSnapshot(
+    const std::string& path) {
+    // One entry per file ever asked for, replaced when the file changes
+    static std::mutex cacheMutex;
+    static std::map<std::string, std::shared_ptr<const Snapshot>> cache;
     
-    for (const auto& [id, pattern] : config.violationTemplates) {
-        descriptionTemplates.addTemplate("violation_" + id, pattern);
-    }
+    std::error_code ec;
+    auto fileTime = std::filesystem::last_write_time(path, ec);
+    uintmax_t fileSize = ec ? 0 : std::filesystem::file_size(path, ec);
     
-    for (const auto& [id, pattern] : config.complianceTemplates) {
-        descriptionTemplates.addTemplate("compliance_" + id, pattern);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto& cached = cache[path];
+    if (!ec && cached && cached->stats.fileTime == fileTime && cached->stats.fileSize == fileSize) {
+        return cached;
     }
+    cached = readSnapshot(path);
+    return cached;
+}
+
+std::shared_ptr<const InferenceConfiguration::Snapshot> InferenceConfiguration::readSnapshot(
+    const std::string& path) {
+    LoadStats stats;
+    stats.source = path;
+    
+    std::error_code ec;
+    stats.fileTime = std::filesystem::last_write_time(path, ec);
+    stats.fileSize = ec ? 0 : std::filesystem::file_size(path, ec);
+    
+    auto start = Clock::now();
+    std::string json = readConfigFile(path);
+    stats.bytes = json.size();
+    stats.readTime = elapsedSince(start);
+    
+    start = Clock::now();
+    Config config = parse(json);
+    stats.parseTime = elapsedSince(start);
+    
+    return buildSnapshot(std::move(config), std::move(stats));
+}
+
+void InferenceConfiguration::publish(Config config, LoadStats stats) {
+    std::atomic_store(&snapshot, buildSnapshot(std::move(config), std::move(stats)));
+}
+
+std::shared_ptr<const InferenceConfiguration::Snapshot> InferenceConfiguration::buildSnapshot(
+    Config config, LoadStats stats) {
+    // Shared by the published snapshots and loadSnapshot's
+    static std::atomic<uint64_t> generations{0};
+    
+    auto start = Clock::now();
+    
+    // Build the complete set of tables before anyone can see them
+    auto next = std::make_shared<Snapshot>();
+    next->config = std::move(config);
+    applyConfiguration(next->config, *next);
+    
+    stats.entries = entryCount(next->config);
+    stats.buildTime = elapsedSince(start);
+    stats.generation = ++generations;
+    next->stats = std::move(stats);
+    return next;
 }
 
-}
\ No newline at end of file
+void InferenceConfiguration::applyConfiguration(const Config& config, Snapshot& target) {
+    // Snapshots start from the built-in defaults; the document overrides them
+    applyMappings(config, target.entityResolver);
+    applyTemplates(config, target.templates);
+}
+
+}
@@ -1,5 +1,10 @@
 #include "metta_inference/formatters.hpp"
+#include "metta_inference/output_sink.hpp"
+#include "metta_inference/result_codec.hpp"
+#include "metta_inference/buffer_writer.hpp"
 #include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <iomanip>
 #include <sstream>
 
@@ -16,6 +21,14 @@ namespace Color {
     inline constexpr std::string_view BOLD = "\033[1m";
 }
 
+std::string ResultFormatter::format(const Config& config, const Metrics& metrics,
+                                   const std::string& output, const std::string& exampleName) const {
+    std::string report;
+    StringSink sink(report);
+    formatTo(config, metrics, output, exampleName, sink);
+    return report;
+}
+
 std::string PrettyFormatter::getCurrentTimestamp() const {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -24,17 +37,14 @@ std::string PrettyFormatter::getCurrentTimestamp() const {
     return ss.str();
 }
 
-std::string PrettyFormatter::formatProcessingStatus() const {
-    std::ostringstream result;
+void PrettyFormatter::formatProcessingStatus(std::ostream& result) const {
     result << "  " << Color::BOLD << "Processing Status:" << Color::NC << "\n";
     result << "    File parsing: " << Color::GREEN << "✓" << Color::NC << "\n";
     result << "    Inference engine: " << Color::GREEN << "✓" << Color::NC << "\n";
     result << "    Results extraction: " << Color::GREEN << "✓" << Color::NC << "\n\n";
-    return result.str();
 }
 
-std::string PrettyFormatter::formatResultsSummary(const Metrics& metrics) const {
-    std::ostringstream result;
+void PrettyFormatter::formatResultsSummary(std::ostream& result, const Metrics& metrics) const {
     result << "  " << Color::BOLD << "Results Summary:" << Color::NC << "\n";
 
     // Show inferred state of affairs if present
@@ -57,12 +67,15 @@ std::string PrettyFormatter::formatResultsSummary(const Metrics& metrics) const
     result << "    • Compliance relations: " << Color::GREEN << metrics.compliances << Color::NC << "\n";
     result << "    • Conflicts:           " << Color::YELLOW << metrics.conflicts << Color::NC << "\n";
     result << "    • Necessary violations: " << Color::PURPLE << metrics.violations << Color::NC << "\n";
-    result << "    • " << Color::BOLD << "Total relationships:  " << metrics.total() << Color::NC << "\n\n";
-    return result.str();
+    result << "    • " << Color::BOLD << "Total relationships:  " << metrics.total() << Color::NC << "\n";
+    if (metrics.partial) {
+        result << "    • " << Color::YELLOW << "Partial: inference stopped early, "
+               << static_cast<int>(metrics.coverage * 100) << "% of results analyzed" << Color::NC << "\n";
+    }
+    result << "\n";
 }
 
-std::string PrettyFormatter::formatDetailedFindings(const std::string&, const Metrics& metrics) const {
-    std::ostringstream result;
+void PrettyFormatter::formatDetailedFindings(std::ostream& result, const std::string&, const Metrics& metrics) const {
 
     if (metrics.inferredFacts > 0 || metrics.total() > 0) {
         result << "  " << Color::BOLD << "Detailed Findings:" << Color::NC << "\n";
@@ -80,42 +93,42 @@ std::string PrettyFormatter::formatDetailedFindings(const std::string&, const Me
         // Display contradiction details
         if (!metrics.contradictionDetails.empty()) {
             result << "  " << Color::RED << "Contradictions Found:" << Color::NC << "\n";
-            for (const auto& contradiction : metrics.contradictionDetails) {
+            for (size_t i = 0; i < metrics.contradictionDetails.size(); ++i) {
+                const auto& contradiction = metrics.contradictionDetails[i];
                 result << "    ❌ " << Color::BOLD << "Contradiction between:" << Color::NC << "\n";
                 result << "       • " << contradiction.entity1 << "\n";
                 result << "       • " << contradiction.entity2 << "\n";
-                result << "       " << Color::CYAN << "→ " << contradiction.description << Color::NC << "\n\n";
+                result << "       " << Color::CYAN << "→ " << metrics.contradictionDescription(i) << Color::NC << "\n\n";
             }
         }
 
         // Display conflict details
         if (!metrics.conflictDetails.empty()) {
             result << "  " << Color::YELLOW << "Conflicts Found:" << Color::NC << "\n";
-            for (const auto& conflict : metrics.conflictDetails) {
+            for (size_t i = 0; i < metrics.conflictDetails.size(); ++i) {
+                const auto& conflict = metrics.conflictDetails[i];
                 result << "    ⚠️  " << Color::BOLD << "Conflict between:" << Color::NC << "\n";
                 result << "       • " << conflict.entity1 << "\n";
                 result << "       • " << conflict.entity2 << "\n";
-                result << "       " << Color::CYAN << "→ " << conflict.description << Color::NC << "\n\n";
+                result << "       " << Color::CYAN << "→ " << metrics.conflictDescription(i) << Color::NC << "\n\n";
             }
         }
 
         // Display violation details
         if (!metrics.violationDetails.empty()) {
             result << "  " << Color::PURPLE << "Necessary Violations:" << Color::NC << "\n";
-            for (const auto& violation : metrics.violationDetails) {
+            for (size_t i = 0; i < metrics.violationDetails.size(); ++i) {
+                const auto& violation = metrics.violationDetails[i];
                 result << "    ❗ " << Color::BOLD << "Violation:" << Color::NC << "\n";
                 result << "       • " << Color::BOLD << "Rule violated:" << Color::NC << " " << violation.violated_rule << "\n";
                 result << "       • " << Color::BOLD << "Due to:" << Color::NC << " " << violation.violator << "\n";
-                result << "       " << Color::CYAN << "→ " << violation.description << Color::NC << "\n\n";
+                result << "       " << Color::CYAN << "→ " << metrics.violationDescription(i) << Color::NC << "\n\n";
             }
         }
     }
-
-    return result.str();
 }
 
-std::string PrettyFormatter::formatOverallAssessment(const Metrics& metrics) const {
-    std::ostringstream result;
+void PrettyFormatter::formatOverallAssessment(std::ostream& result, const Metrics& metrics) const {
     result << "  " << Color::BOLD << "Overall Assessment:" << Color::NC << "\n";
     result << "  ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
 
@@ -150,13 +163,12 @@ std::string PrettyFormatter::formatOverallAssessment(const Metrics& metrics) con
         result << "     • The example appears to be logically consistent\n";
         result << "     • No rule conflicts or violations detected\n";
     }
-
-    return result.str();
 }
 
-std::string PrettyFormatter::format(const Config& config, const Metrics& metrics,
-                                    const std::string& output, const std::string& exampleName) const {
-    std::ostringstream result;
+void PrettyFormatter::formatTo(const Config& config, const Metrics& metrics,
+                               const std::string& output, const std::string& exampleName,
+                               OutputSink& sink) const {
+    SinkStream result(sink);
 
     result << "  " << Color::CYAN << "╔════════════════════════════════════════════╗" << Color::NC << "\n";
     result << "  " << Color::CYAN << "║              Governance Inference          ║" << Color::NC << "\n";
@@ -166,63 +178,92 @@ std::string PrettyFormatter::format(const Config& config, const Metrics& metrics
     result << "  " << Color::BOLD << "Timestamp:" << Color::NC << " " << getCurrentTimestamp() << "\n\n";
 
     if (config.verbose) {
-        result << formatProcessingStatus();
+        formatProcessingStatus(result);
     }
 
-    result << formatResultsSummary(metrics);
+    formatResultsSummary(result, metrics);
 
     if (metrics.total() > 0) {
-        result << formatDetailedFindings(output, metrics);
+        formatDetailedFindings(result, output, metrics);
     }
 
-    result << formatOverallAssessment(metrics);
-
-    return result.str();
+    formatOverallAssessment(result, metrics);
+    result.flush();
 }
 
-std::string JSONFormatter::format(const Config&, const Metrics& metrics,
-                                  const std::string&, const std::string& exampleName) const {
-    std::ostringstream json;
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+namespace {
 
-    json << "{\n";
-    json << "  \"example\": \"" << exampleName << "\",\n";
-    json << "  \"timestamp\": \"" << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ") << "\",\n";
-    json << "  \"results\": {\n";
-    json << "    \"contradictions\": " << metrics.contradictions << ",\n";
-    json << "    \"compliances\": " << metrics.compliances << ",\n";
-    json << "    \"conflicts\": " << metrics.conflicts << ",\n";
-    json << "    \"necessary_violations\": " << metrics.violations << ",\n";
-    json << "    \"total\": " << metrics.total() << "\n";
-    json << "  },\n";
-    json << "  \"interpretation\": {\n";
-    json << "    \"has_logical_issues\": " << (metrics.conflicts > 0 || metrics.violations > 0 ? "true" : "false") << ",\n";
-    json << "    \"is_consistent\": " << (metrics.contradictions == 0 ? "true" : "false") << ",\n";
-    json << "    \"has_fulfilled_obligations\": " << (metrics.compliances > 0 ? "true" : "false") << "\n";
-    json << "  }\n";
-    json << "}";
-
-    return json.str();
+// ISO 8601 UTC timestamp of the current time
+std::string_view utcTimestamp(char (&storage)[32]) {
+    auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc{};
+    gmtime_r(&time_t, &utc);
+    size_t length = std::strftime(storage, sizeof(storage), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return std::string_view(storage, length);
 }
 
-std::string CSVFormatter::format(const Config&, const Metrics& metrics,
-                                 const std::string&, const std::string& exampleName) const {
-    std::ostringstream csv;
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+}
 
-    csv << "Example,Timestamp,Contradictions,Compliances,Conflicts,Violations,Total\n";
-    csv << exampleName << "," << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ") << ",";
-    csv << metrics.contradictions << "," << metrics.compliances << ",";
-    csv << metrics.conflicts << "," << metrics.violations << "," << metrics.total();
+void JSONFormatter::formatTo(const Config&, const Metrics& metrics,
+                             const std::string&, const std::string& exampleName,
+                             OutputSink& sink) const {
+    BufferWriter json(sink);
+    char timestamp[32];
+
+    json.write("{\n  \"example\": ");
+    json.writeJsonString(exampleName);
+    json.write(",\n  \"timestamp\": \"");
+    json.write(utcTimestamp(timestamp));
+    json.write("\",\n  \"results\": {\n");
+    json.write("    \"contradictions\": "); json.writeInt(metrics.contradictions); json.write(",\n");
+    json.write("    \"compliances\": "); json.writeInt(metrics.compliances); json.write(",\n");
+    json.write("    \"conflicts\": "); json.writeInt(metrics.conflicts); json.write(",\n");
+    json.write("    \"necessary_violations\": "); json.writeInt(metrics.violations); json.write(",\n");
+    json.write("    \"total\": "); json.writeInt(metrics.total());
+    if (metrics.partial) {
+        // Only in partial reports, so complete ones keep their shape
+        char coverage[16];
+        int length = std::snprintf(coverage, sizeof(coverage), "%.3f", metrics.coverage);
+        json.write(",\n    \"partial\": true,\n    \"coverage\": ");
+        json.write(std::string_view(coverage, static_cast<size_t>(length)));
+    }
+    json.write("\n");
+    json.write("  },\n  \"interpretation\": {\n");
+    json.write("    \"has_logical_issues\": "); json.writeBool(metrics.conflicts > 0 || metrics.violations > 0); json.write(",\n");
+    json.write("    \"is_consistent\": "); json.writeBool(metrics.contradictions == 0); json.write(",\n");
+    json.write("    \"has_fulfilled_obligations\": "); json.writeBool(metrics.compliances > 0); json.write("\n");
+    json.write("  }\n}");
+    json.flush();
+}
 
-    return csv.str();
+void CSVFormatter::formatTo(const Config&, const Metrics& metrics,
+                            const std::string&, const std::string& exampleName,
+                            OutputSink& sink) const {
+    BufferWriter csv(sink);
+    char timestamp[32];
+
+    csv.write("Example,Timestamp,Contradictions,Compliances,Conflicts,Violations,Total");
+    // Only in partial reports, so complete ones keep their shape
+    csv.write(metrics.partial ? ",Partial,Coverage\n" : "\n");
+    csv.writeCsvField(exampleName);
+    csv.put(',');
+    csv.write(utcTimestamp(timestamp));
+    csv.put(','); csv.writeInt(metrics.contradictions);
+    csv.put(','); csv.writeInt(metrics.compliances);
+    csv.put(','); csv.writeInt(metrics.conflicts);
+    csv.put(','); csv.writeInt(metrics.violations);
+    csv.put(','); csv.writeInt(metrics.total());
+    if (metrics.partial) {
+        char coverage[16];
+        int length = std::snprintf(coverage, sizeof(coverage), "%.3f", metrics.coverage);
+        csv.write(",true,");
+        csv.write(std::string_view(coverage, static_cast<size_t>(length)));
+    }
+    csv.flush();
 }
 
 
-std::string MarkdownFormatter::formatDetailedResults(const Metrics& metrics) const {
-    std::ostringstream md;
+void MarkdownFormatter::formatDetailedResults(std::ostream& md, const Metrics& metrics) const {
     md << "## Detailed Results\n\n";
     
     // Display inferred state of affairs
@@ -237,9 +278,10 @@ std::string MarkdownFormatter::formatDetailedResults(const Metrics& metrics) con
     // Display contradiction details
     if (!metrics.contradictionDetails.empty()) {
         md << "### Contradictions Found\n";
-        for (const auto& contradiction : metrics.contradictionDetails) {
+        for (size_t i = 0; i < metrics.contradictionDetails.size(); ++i) {
+            const auto& contradiction = metrics.contradictionDetails[i];
             md << "- **Between:** " << contradiction.entity1 << " and " << contradiction.entity2 << "\n";
-            md << "  - " << contradiction.description << "\n";
+            md << "  - " << metrics.contradictionDescription(i) << "\n";
         }
         md << "\n";
     }
@@ -247,9 +289,10 @@ std::string MarkdownFormatter::formatDetailedResults(const Metrics& metrics) con
     // Display conflict details
     if (!metrics.conflictDetails.empty()) {
         md << "### Conflicts Found\n";
-        for (const auto& conflict : metrics.conflictDetails) {
+        for (size_t i = 0; i < metrics.conflictDetails.size(); ++i) {
+            const auto& conflict = metrics.conflictDetails[i];
             md << "- **Between:** " << conflict.entity1 << " and " << conflict.entity2 << "\n";
-            md << "  - " << conflict.description << "\n";
+            md << "  - " << metrics.conflictDescription(i) << "\n";
         }
         md << "\n";
     }
@@ -257,19 +300,18 @@ std::string MarkdownFormatter::formatDetailedResults(const Metrics& metrics) con
     // Display violation details
     if (!metrics.violationDetails.empty()) {
         md << "### Necessary Violations\n";
-        for (const auto& violation : metrics.violationDetails) {
+        for (size_t i = 0; i < metrics.violationDetails.size(); ++i) {
+            const auto& violation = metrics.violationDetails[i];
             md << "- **Rule violated:** " << violation.violated_rule << "\n";
             md << "  - **By:** " << violation.violator << "\n";
-            md << "  - " << violation.description << "\n";
+            md << "  - " << metrics.violationDescription(i) << "\n";
         }
         md << "\n";
     }
     
-    return md.str();
 }
 
-std::string MarkdownFormatter::formatInterpretation(const Metrics& metrics) const {
-    std::ostringstream md;
+void MarkdownFormatter::formatInterpretation(std::ostream& md, const Metrics& metrics) const {
     md << "## Interpretation\n\n";
 
     if (metrics.conflicts > 0 || metrics.violations > 0) {
@@ -284,13 +326,12 @@ std::string MarkdownFormatter::formatInterpretation(const Metrics& metrics) cons
     if (metrics.contradictions > 0) {
         md << "❌ **Contradictions present!** Direct logical inconsistencies found in the system.\n\n";
     }
-
-    return md.str();
 }
 
-std::string MarkdownFormatter::format(const Config&, const Metrics& metrics,
-                                      const std::string&, const std::string& exampleName) const {
-    std::ostringstream md;
+void MarkdownFormatter::formatTo(const Config&, const Metrics& metrics,
+                                 const std::string&, const std::string& exampleName,
+                                 OutputSink& sink) const {
+    SinkStream md(sink);
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
 
@@ -308,11 +349,20 @@ std::string MarkdownFormatter::format(const Config&, const Metrics& metrics,
     md << "| Necessary Violations | " << metrics.violations << " | "
        << (metrics.violations == 0 ? "✅" : "⚠️") << " |\n";
     md << "| **Total** | **" << metrics.total() << "** | - |\n\n";
+    if (metrics.partial) {
+        md << "> ⏱️ **Partial results** - inference stopped early; "
+           << static_cast<int>(metrics.coverage * 100) << "% of results analyzed.\n\n";
+    }
 
-    md << formatDetailedResults(metrics);
-    md << formatInterpretation(metrics);
+    formatDetailedResults(md, metrics);
+    formatInterpretation(md, metrics);
+    md.flush();
+}
 
-    return md.str();
+void BinaryFormatter::formatTo(const Config&, const Metrics& metrics,
+                               const std::string&, const std::string&,
+                               OutputSink& sink) const {
+    ResultCodec::encodeTo(metrics, sink);
 }
 
 std::unique_ptr<ResultFormatter> FormatterFactory::create(OutputFormat format) {
@@ -325,6 +375,8 @@ std::unique_ptr<ResultFormatter> FormatterFactory::create(OutputFormat format) {
             return std::make_unique<CSVFormatter>();
         case OutputFormat::Markdown:
             return std::make_unique<MarkdownFormatter>();
+        case OutputFormat::Binary:
+            return std::make_unique<BinaryFormatter>();
         default:
             return std::make_unique<PrettyFormatter>();
     }
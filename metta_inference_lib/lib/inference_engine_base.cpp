@@ -11,4 +11,54 @@ InferenceEngine::Result InferenceEngine::run(const std::filesystem::path&) {
     return result;
 }
 
+InferenceEngine::PreparedRun InferenceEngine::prepare(const std::filesystem::path& exampleFile) {
+    PreparedRun run;
+    run.exampleFile = exampleFile;
+    run.error = "Error: Engine does not support split execution";
+    return run;
+}
+
+InferenceEngine::Result InferenceEngine::complete(PreparedRun&, ProcessExecutor::ExecutionResult&&, OutputSink*) {
+    throw std::logic_error("Engine does not support split execution");
+}
+
+InferenceEngine::PreparedRun::~PreparedRun() {
+    if (!combinedFile.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(combinedFile, ec);
+    }
+}
+
+InferenceEngine::PreparedRun::PreparedRun(PreparedRun&& other) noexcept {
+    *this = std::move(other);
+}
+
+InferenceEngine::PreparedRun& InferenceEngine::PreparedRun::operator=(PreparedRun&& other) noexcept {
+    if (this != &other) {
+        if (!combinedFile.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(combinedFile, ec);
+        }
+        exampleFile = std::move(other.exampleFile);
+        combinedFile = std::move(other.combinedFile);
+        command = std::move(other.command);
+        timeout = other.timeout;
+        cancellation = std::move(other.cancellation);
+        deadline = other.deadline;
+        observer = std::move(other.observer);
+        stream = std::move(other.stream);
+        error = std::move(other.error);
+        other.combinedFile.clear();
+    }
+    return *this;
+}
+
+InferenceEngine::Result InferenceEngine::run(const std::filesystem::path& exampleFile, OutputSink& sink) {
+    Result result = run(exampleFile);
+    sink.write(result.formattedOutput);
+    sink.flush();
+    result.formattedOutput.clear();
+    return result;
+}
+
 }
\ No newline at end of file
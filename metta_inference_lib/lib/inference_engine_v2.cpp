@@ -2,11 +2,14 @@
 #include "metta_inference/process_executor.hpp"
 #include "metta_inference/module_loader.hpp"
 #include "metta_inference/formatters.hpp"
+#include "metta_inference/output_sink.hpp"
 #include "metta_inference/semantic_analyzer.hpp"
+#include "metta_inference/streaming_analyzer.hpp"
 #include "metta_inference/sexpr_parser.hpp"
 #include "metta_inference/entity_resolver.hpp"
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <chrono>
 #include <unistd.h>
 #include <optional>
@@ -22,60 +25,127 @@ public:
     }
     
     InferenceEngine::Result run(const fs::path& exampleFile) override {
-        InferenceEngine::Result result;
+        auto prepared = prepare(exampleFile);
+        if (!prepared.ok()) {
+            return failedPreparation(prepared);
+        }
+        return complete(prepared, executeMettaInference(prepared), nullptr);
+    }
+    
+    InferenceEngine::Result run(const fs::path& exampleFile, OutputSink& sink) override {
+        auto prepared = prepare(exampleFile);
+        if (!prepared.ok()) {
+            return failedPreparation(prepared);
+        }
+        return complete(prepared, executeMettaInference(prepared), &sink);
+    }
+    
+    PreparedRun prepare(const fs::path& exampleFile) override {
+        config.cancellation.throwIfCancelled();
         
-        try {
-            // Validate and prepare
-            result = prepareExecution(exampleFile);
-            if (!result.rawOutput.empty()) {
-                return result;  // Early return on preparation failure
-            }
-            
-            // Execute MeTTa inference
-            auto execResult = executeMettaInference(exampleFile);
-            result.rawOutput = execResult.output;
-            
-            // Perform semantic analysis instead of regex parsing
-            result.metrics = analyzeOutput(result.rawOutput);
-            result.hasLogicalIssues = (result.metrics.conflicts > 0 || result.metrics.violations > 0);
-            
-            // Format results
-            result.formattedOutput = formatResults(result.metrics, result.rawOutput, exampleFile);
+        PreparedRun prepared;
+        prepared.exampleFile = exampleFile;
+        prepared.cancellation = config.cancellation;
+        
+        if (!prepareExecution()) {
+            prepared.error = "Error: Failed to validate modules";
+            return prepared;
+        }
+        
+        if (config.verbose) {
+            std::cout << "  [V2] Creating combined file... ";
+        }
+        
+        // Watching the output needs the number of queries; a snapshot has
+        // the modules' counted already, so only the example is counted
+        const bool watching = config.deadline || config.stopOnFirst;
+        auto modules = config.moduleSnapshot;
+        if (watching && !modules) {
+            modules = ModuleLoader::loadSnapshot(config.modulePaths);
+        }
+        
+        prepared.combinedFile = createCombinedFileWithValidation(exampleFile, modules.get());
+        prepared.command = "\"" + config.mettaReplPath.string() + "\" \"" +
+                           prepared.combinedFile.string() + "\" 2>&1";
+        prepared.timeout = std::chrono::milliseconds(Constants::DEFAULT_TIMEOUT_SECONDS * 1000);
+        prepared.deadline = config.deadline;
+        if (watching) {
+            watchOutput(prepared, modules->queries + countExampleQueries(exampleFile));
+        }
+        
+        if (config.verbose) {
+            std::cout << "✓\n";
+        }
+        
+        return prepared;
+    }
+    
+    InferenceEngine::Result complete(PreparedRun& prepared, ProcessExecutor::ExecutionResult&& execution,
+                                     OutputSink* sink) override {
+        std::error_code ec;
+        fs::remove(prepared.combinedFile, ec);
+        prepared.combinedFile.clear();
+        
+        config.cancellation.throwIfCancelled();
+        InferenceEngine::Result result;
+        if (execution.stoppedEarly) {
+            result.rawOutput = std::move(execution.output);
+            result.metrics = analyzePartialOutput(prepared, result.rawOutput);
+        } else {
+            validateExecutionResult(execution);
+            result.rawOutput = std::move(execution.output);
             
-        } catch (const std::exception& e) {
-            cleanupTempFiles();
-            throw;
+            // Perform semantic analysis instead of regex parsing. Output
+            // that was streamed in full has been parsed already, unless it
+            // needs SemanticAnalyzer's line-by-line fallback.
+            bool streamed = prepared.stream && prepared.stream->bytesFed() == result.rawOutput.size();
+            if (streamed) {
+                prepared.stream->finish();
+                streamed = prepared.stream->wellFormed();
+            }
+            result.metrics = streamed ? analyzeStreamedOutput(*prepared.stream)
+                                      : analyzeOutput(result.rawOutput);
         }
+        result.hasLogicalIssues = (result.metrics.conflicts > 0 || result.metrics.violations > 0);
         
+        config.cancellation.throwIfCancelled();
+        if (sink) {
+            auto formatter = FormatterFactory::create(config.outputFormat);
+            formatter->formatTo(config, result.metrics, result.rawOutput,
+                                prepared.exampleFile.stem().string(), *sink);
+            sink->flush();
+        } else {
+            result.formattedOutput = formatResults(result.metrics, result.rawOutput, prepared.exampleFile);
+        }
         return result;
     }
     
 private:
     std::unique_ptr<SemanticAnalyzer> analyzer;
-    std::unique_ptr<EntityResolver> resolver;
-    std::unique_ptr<DescriptionTemplates> templates;
+    std::shared_ptr<const ConfigSnapshot> configSnapshot;  // Fixed for the engine's lifetime
     InferencePatternDetector patternDetector;
     
     void initializeConfiguration() {
-        // Load configuration from file if exists
-        fs::path configPath = config.outputDir / ".." / "config" / "inference_config.json";
-        if (fs::exists(configPath)) {
-            auto& inferConfig = InferenceConfiguration::getInstance();
-            inferConfig.loadFromFile(configPath.string());
-            
-            resolver = std::make_unique<EntityResolver>(inferConfig.getEntityResolver());
-            templates = std::make_unique<DescriptionTemplates>(inferConfig.getTemplates());
-        } else {
-            // Use defaults
-            resolver = std::make_unique<EntityResolver>();
-            templates = std::make_unique<DescriptionTemplates>();
-        }
-        
-        analyzer = std::make_unique<SemanticAnalyzer>(resolver.get(), templates.get());
+        configSnapshot = captureInferenceConfiguration(config);
+        analyzer = std::make_unique<SemanticAnalyzer>(configSnapshot);
     }
     
-    InferenceEngine::Result prepareExecution(const fs::path& /* exampleFile */) {
+    // Preparation failures are reported in rawOutput, not thrown
+    static InferenceEngine::Result failedPreparation(const PreparedRun& prepared) {
         InferenceEngine::Result result;
+        result.rawOutput = prepared.error;
+        return result;
+    }
+    
+    bool prepareExecution() {
+        // Snapshot was validated when it was loaded; skip the directory scan
+        if (config.moduleSnapshot) {
+            if (config.verbose) {
+                std::cout << "  [V2] Using module snapshot v" << config.moduleSnapshot->version << "\n";
+                displayModuleSummary(config.moduleSnapshot->modules);
+            }
+            return true;
+        }
         
         if (config.verbose) {
             std::cout << "  [V2] Validating module directories... ";
@@ -83,8 +153,7 @@ private:
         
         auto modules = validateModulesWithErrorHandling();
         if (!modules) {
-            result.rawOutput = "Error: Failed to validate modules";
-            return result;
+            return false;
         }
         
         if (config.verbose) {
@@ -92,7 +161,7 @@ private:
             displayModuleSummary(*modules);
         }
         
-        return result;
+        return true;
     }
     
     std::optional<std::vector<ModuleLoader::ModuleInfo>> validateModulesWithErrorHandling() {
@@ -113,46 +182,35 @@ private:
         }
     }
     
-    ProcessExecutor::ExecutionResult executeMettaInference(const fs::path& exampleFile) {
+    ProcessExecutor::ExecutionResult executeMettaInference(const PreparedRun& prepared) {
         if (config.verbose) {
-            std::cout << "  [V2] Creating combined file... ";
-        }
-        
-        fs::path tempFile = createCombinedFileWithValidation(exampleFile);
-        
-        if (config.verbose) {
-            std::cout << "✓\n";
             std::cout << "  [V2] Running MeTTa inference engine... ";
         }
         
-        std::string runCmd = "\"" + config.mettaReplPath.string() + "\" \"" + 
-                           tempFile.string() + "\" 2>&1";
-        
-        auto execResult = ProcessExecutor::execute(runCmd,
-            std::chrono::milliseconds(Constants::DEFAULT_TIMEOUT_SECONDS * 1000));
-        
-        validateExecutionResult(execResult, tempFile);
-        
-        fs::remove(tempFile);
+        auto execResult = ProcessExecutor::execute(prepared.command, prepared.timeout, prepared.cancellation,
+                                                   prepared.observer, prepared.deadline);
         
         if (config.verbose) {
-            std::cout << "✓ (" << execResult.duration.count() << "ms)\n";
+            std::cout << (execResult.stoppedEarly ? "stopped early" : "✓")
+                      << " (" << execResult.duration.count() << "ms)\n";
         }
         
         return execResult;
     }
     
-    fs::path createCombinedFileWithValidation(const fs::path& exampleFile) {
+    fs::path createCombinedFileWithValidation(const fs::path& exampleFile, const ModuleSnapshot* modules) {
         try {
+            if (modules) {
+                return ModuleLoader::createCombinedFile(*modules, exampleFile, config.verbose);
+            }
             return ModuleLoader::createCombinedFile(config.modulePaths, exampleFile, config.verbose);
         } catch (const std::exception& e) {
             throw std::runtime_error("Failed to create combined file: " + std::string(e.what()));
         }
     }
     
-    void validateExecutionResult(const ProcessExecutor::ExecutionResult& execResult, const fs::path& tempFile) {
+    void validateExecutionResult(const ProcessExecutor::ExecutionResult& execResult) {
         if (execResult.exitCode != 0) {
-            fs::remove(tempFile);
             throw std::runtime_error("Inference engine failed with exit code: " +
                                    std::to_string(execResult.exitCode) + 
                                    "\nOutput: " + execResult.output);
@@ -165,14 +223,71 @@ private:
         }
         
         // Use semantic analyzer instead of regex patterns
-        auto analysisResult = analyzer->analyze(output);
+        auto analysisResult = analyzer->analyze(output, config.cancellation);
         
         if (config.verbose) {
             std::cout << "✓\n";
             displayAnalysisPreview(analysisResult);
         }
         
-        return analysisResult.toMetrics();
+        return std::move(analysisResult).toMetrics(config.metricsDetail);
+    }
+    
+    // A complete run whose output went through the stream as it arrived,
+    // finished and well-formed
+    Metrics analyzeStreamedOutput(StreamingAnalyzer& stream) {
+        if (config.verbose) {
+            std::cout << "  [V2] Performing semantic analysis (streamed)... ";
+        }
+        
+        auto analysisResult = stream.analyze(config.cancellation);
+        
+        if (config.verbose) {
+            std::cout << "✓\n";
+            displayAnalysisPreview(analysisResult);
+        }
+        
+        return std::move(analysisResult).toMetrics(config.metricsDetail);
+    }
+    
+    // Parses the REPL output as it arrives, so that a run stopped early is
+    // analyzed from what it printed and a completed one is not parsed again;
+    // with stopOnFirst the first finding stops it
+    void watchOutput(PreparedRun& prepared, size_t queries) {
+        auto stream = std::make_shared<StreamingAnalyzer>(configSnapshot, queries);
+        prepared.stream = stream;
+        if (config.stopOnFirst) {
+            stream->watchForFindings();
+        }
+        prepared.observer = [stream](std::string_view chunk) {
+            stream->feed(chunk);
+            return !stream->foundFinding();
+        };
+    }
+    
+    static size_t countExampleQueries(const fs::path& exampleFile) {
+        std::ifstream example(exampleFile, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(example)), std::istreambuf_iterator<char>());
+        return StreamingAnalyzer::countQueries(content);
+    }
+    
+    Metrics analyzePartialOutput(PreparedRun& prepared, const std::string& output) {
+        if (config.verbose) {
+            std::cout << "  [V2] Analyzing partial output... ";
+        }
+        
+        // Without a stream (the executor was given a deadline directly)
+        // how much is missing is unknown
+        auto analysisResult = prepared.stream ? prepared.stream->analyze(config.cancellation)
+                                              : analyzer->analyze(output, config.cancellation);
+        auto metrics = std::move(analysisResult).toMetrics(config.metricsDetail);
+        metrics.partial = true;
+        metrics.coverage = prepared.stream ? prepared.stream->coverage() : 0.0;
+        
+        if (config.verbose) {
+            std::cout << "✓ (" << static_cast<int>(metrics.coverage * 100) << "% of results)\n";
+        }
+        return metrics;
     }
     
     void displayAnalysisPreview(const SemanticAnalyzer::AnalysisResult& result) {
@@ -200,18 +315,6 @@ private:
         return formatter->format(config, metrics, rawOutput, exampleFile.stem().string());
     }
     
-    void cleanupTempFiles() {
-        fs::path tempFile = fs::temp_directory_path() /
-                          ("metta_combined_" + std::to_string(getpid()) + ".metta");
-        if (fs::exists(tempFile)) {
-            try {
-                fs::remove(tempFile);
-            } catch (...) {
-                // Ignore cleanup errors
-            }
-        }
-    }
-    
     // Enhanced error handling methods
     class InferenceError : public std::runtime_error {
     public:
@@ -256,6 +359,26 @@ private:
 };
 
 // Factory method to create the improved inference engine
+std::shared_ptr<const ConfigSnapshot> captureInferenceConfiguration(const Config& config) {
+    if (config.inferenceConfig) {
+        return config.inferenceConfig;
+    }
+    
+    // Asked for by name, so a file that cannot be used is an error. Kept
+    // apart from the shared instance, which other engines read.
+    if (!config.inferenceConfigFile.empty()) {
+        return InferenceConfiguration::loadSnapshot(config.inferenceConfigFile.string());
+    }
+    
+    // Only re-parsed when the file changed since it was last loaded
+    auto& inferConfig = InferenceConfiguration::getInstance();
+    fs::path configPath = config.outputDir / ".." / "config" / "inference_config.json";
+    if (fs::exists(configPath)) {
+        inferConfig.loadIfChanged(configPath.string());
+    }
+    return inferConfig.current();
+}
+
 std::unique_ptr<InferenceEngine> createInferenceEngineV2(const Config& config) {
     return std::make_unique<InferenceEngineV2>(config);
 }
@@ -0,0 +1,231 @@
+#include "metta_inference/inference_scheduler.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace metta_inference {
+
+using Clock = std::chrono::steady_clock;
+
+InferenceScheduler::Slot::~Slot() {
+    release();
+}
+
+InferenceScheduler::Slot::Slot(Slot&& other) noexcept
+    : owner(std::move(other.owner)), tenant(std::move(other.tenant)),
+      priority(other.priority), waited(other.waited) {
+    other.owner.reset();
+}
+
+InferenceScheduler::Slot& InferenceScheduler::Slot::operator=(Slot&& other) noexcept {
+    if (this != &other) {
+        release();
+        owner = std::move(other.owner);
+        tenant = std::move(other.tenant);
+        priority = other.priority;
+        waited = other.waited;
+        other.owner.reset();
+    }
+    return *this;
+}
+
+void InferenceScheduler::Slot::release() {
+    if (!owner) return;
+    auto scheduler = std::move(owner);
+    owner.reset();
+    scheduler->release(priority, tenant);
+}
+
+InferenceScheduler::InferenceScheduler(Options options) : options(options) {
+    if (this->options.maxConcurrent == 0) {
+        this->options.maxConcurrent = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (this->options.maxBatchConcurrent == 0) {
+        this->options.maxBatchConcurrent = std::max<size_t>(1, this->options.maxConcurrent / 2);
+    }
+    this->options.maxBatchConcurrent = std::min(this->options.maxBatchConcurrent, this->options.maxConcurrent);
+}
+
+std::shared_ptr<InferenceScheduler> InferenceScheduler::create(Options options) {
+    // Slots keep their scheduler alive, so it must be owned by a shared_ptr
+    return std::shared_ptr<InferenceScheduler>(new InferenceScheduler(options));
+}
+
+InferenceScheduler::Priority InferenceScheduler::parsePriority(const std::string& name) {
+    if (name == "interactive") return Priority::Interactive;
+    if (name == "batch") return Priority::Batch;
+    return Priority::Normal;
+}
+
+bool InferenceScheduler::admissible(Priority priority, const std::string& tenant) const {
+    if (running >= options.maxConcurrent) return false;
+    if (priority == Priority::Batch && batchRunning >= options.maxBatchConcurrent) return false;
+    if (options.maxPerTenant > 0 && !tenant.empty()) {
+        auto it = tenantRunning.find(tenant);
+        if (it != tenantRunning.end() && it->second >= options.maxPerTenant) return false;
+    }
+    return true;
+}
+
+InferenceScheduler::Slot InferenceScheduler::admit(Priority priority, const std::string& tenant,
+                                                   Clock::time_point queued) {
+    ++running;
+    ++startedCount;
+    if (priority == Priority::Batch) ++batchRunning;
+    if (!tenant.empty()) ++tenantRunning[tenant];
+
+    Slot slot;
+    slot.owner = shared_from_this();
+    slot.tenant = tenant;
+    slot.priority = priority;
+    slot.waited = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - queued);
+    return slot;
+}
+
+std::vector<InferenceScheduler::Ready> InferenceScheduler::takeReady() {
+    std::vector<Ready> ready;
+    for (size_t p = 0; p < PRIORITY_COUNT && running < options.maxConcurrent; ++p) {
+        auto priority = static_cast<Priority>(p);
+        auto& queue = queues[p];
+        // Skip over tenants at their limit; they keep their place
+        for (auto it = queue.begin(); it != queue.end() && running < options.maxConcurrent; ) {
+            if (priority == Priority::Batch && batchRunning >= options.maxBatchConcurrent) break;
+            if (!admissible(priority, it->tenant)) {
+                ++it;
+                continue;
+            }
+            ready.push_back({admit(priority, it->tenant, it->queued), std::move(it->start), std::move(it->reject)});
+            it = queue.erase(it);
+        }
+    }
+    return ready;
+}
+
+void InferenceScheduler::run(std::vector<Ready> ready) {
+    for (auto& job : ready) {
+        try {
+            job.start(std::move(job.slot));
+        } catch (const std::exception& e) {
+            job.reject(e.what());
+        }
+    }
+}
+
+uint64_t InferenceScheduler::submit(Priority priority, const std::string& tenant, Start start, Reject reject) {
+    std::vector<Ready> ready;
+    Reject evicted;
+    std::string reason;
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto p = static_cast<size_t>(priority);
+        ticket = nextTicket++;
+
+        if (closed) {
+            reason = "Inference scheduler shut down";
+        } else if (admissible(priority, tenant)) {
+            // Whatever still waits is blocked by a limit this job is not
+            // subject to, so starting it overtakes nobody
+            ready.push_back({admit(priority, tenant, Clock::now()), std::move(start), std::move(reject)});
+        } else {
+            size_t queued = 0;
+            for (const auto& queue : queues) queued += queue.size();
+
+            if (queued >= options.maxQueued) {
+                // Make room by shedding the newest job of the lowest class below this one
+                for (size_t lower = PRIORITY_COUNT - 1; lower > p; --lower) {
+                    if (!queues[lower].empty()) {
+                        evicted = std::move(queues[lower].back().reject);
+                        queues[lower].pop_back();
+                        ++rejectedCount;
+                        break;
+                    }
+                }
+                if (!evicted) {
+                    reason = "Server overloaded: " + std::to_string(queued) + " requests queued";
+                }
+            }
+            if (reason.empty()) {
+                queues[p].push_back({ticket, tenant, std::move(start), std::move(reject), Clock::now()});
+            }
+        }
+        if (!reason.empty()) {
+            ++rejectedCount;
+        }
+    }
+
+    if (evicted) {
+        evicted("Server overloaded: request shed for higher priority work");
+    }
+    if (!reason.empty()) {
+        reject(reason);
+    }
+    run(std::move(ready));
+    return ticket;
+}
+
+bool InferenceScheduler::withdraw(uint64_t ticket) {
+    Job withdrawn;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& queue : queues) {
+            auto it = std::find_if(queue.begin(), queue.end(),
+                                   [ticket](const Job& job) { return job.ticket == ticket; });
+            if (it != queue.end()) {
+                // Callbacks are destroyed outside the lock
+                withdrawn = std::move(*it);
+                queue.erase(it);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void InferenceScheduler::release(Priority priority, const std::string& tenant) {
+    std::vector<Ready> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --running;
+        if (priority == Priority::Batch) --batchRunning;
+        if (!tenant.empty()) {
+            auto it = tenantRunning.find(tenant);
+            if (it != tenantRunning.end() && --it->second == 0) {
+                tenantRunning.erase(it);
+            }
+        }
+        if (!closed) {
+            ready = takeReady();
+        }
+    }
+    run(std::move(ready));
+}
+
+void InferenceScheduler::close() {
+    std::vector<Job> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        for (auto& queue : queues) {
+            for (auto& job : queue) {
+                dropped.push_back(std::move(job));
+            }
+            queue.clear();
+        }
+        rejectedCount += dropped.size();
+    }
+    for (auto& job : dropped) {
+        job.reject("Inference scheduler shut down");
+    }
+}
+
+InferenceScheduler::Stats InferenceScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats stats;
+    stats.running = running;
+    for (const auto& queue : queues) stats.queued += queue.size();
+    stats.started = startedCount;
+    stats.rejected = rejectedCount;
+    return stats;
+}
+
+}
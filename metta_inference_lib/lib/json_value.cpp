@@ -0,0 +1,329 @@
+#include "metta_inference/json_value.hpp"
+#include <stdexcept>
+#include <charconv>
+#include <cstdint>
+
+namespace metta_inference {
+
+// Recursive-descent parser over a borrowed buffer
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view input) : input(input) {}
+
+    JsonValue parseDocument() {
+        JsonValue value;
+        skipWhitespace();
+        parseValue(value, 0);
+        skipWhitespace();
+        if (pos != input.size()) {
+            fail("unexpected trailing characters");
+        }
+        return value;
+    }
+
+private:
+    static constexpr size_t MAX_DEPTH = 256;
+
+    std::string_view input;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("JSON parse error at offset " + std::to_string(pos) + ": " + message);
+    }
+
+    void skipWhitespace() {
+        while (pos < input.size()) {
+            char c = input[pos];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+            ++pos;
+        }
+    }
+
+    void expectLiteral(std::string_view literal) {
+        if (input.compare(pos, literal.size(), literal) != 0) {
+            fail("invalid literal");
+        }
+        pos += literal.size();
+    }
+
+    void parseValue(JsonValue& value, size_t depth) {
+        if (depth > MAX_DEPTH) fail("nesting too deep");
+        if (pos >= input.size()) fail("unexpected end of input");
+
+        switch (input[pos]) {
+            case '{': parseObject(value, depth); break;
+            case '[': parseArray(value, depth); break;
+            case '"':
+                value.kind = JsonValue::Type::String;
+                parseString(value.text);
+                break;
+            case 't':
+                expectLiteral("true");
+                value.kind = JsonValue::Type::Bool;
+                value.boolean = true;
+                break;
+            case 'f':
+                expectLiteral("false");
+                value.kind = JsonValue::Type::Bool;
+                value.boolean = false;
+                break;
+            case 'n':
+                expectLiteral("null");
+                value.kind = JsonValue::Type::Null;
+                break;
+            default:
+                parseNumber(value);
+                break;
+        }
+    }
+
+    void parseObject(JsonValue& value, size_t depth) {
+        value.kind = JsonValue::Type::Object;
+        ++pos;  // '{'
+        skipWhitespace();
+        if (pos < input.size() && input[pos] == '}') {
+            ++pos;
+            return;
+        }
+
+        while (true) {
+            skipWhitespace();
+            if (pos >= input.size() || input[pos] != '"') fail("expected object key");
+
+            value.object.emplace_back();
+            parseString(value.object.back().key);
+
+            skipWhitespace();
+            if (pos >= input.size() || input[pos] != ':') fail("expected ':'");
+            ++pos;
+            skipWhitespace();
+            parseValue(value.object.back().value, depth + 1);
+            skipWhitespace();
+
+            if (pos >= input.size()) fail("unterminated object");
+            if (input[pos] == ',') { ++pos; continue; }
+            if (input[pos] == '}') { ++pos; return; }
+            fail("expected ',' or '}'");
+        }
+    }
+
+    void parseArray(JsonValue& value, size_t depth) {
+        value.kind = JsonValue::Type::Array;
+        ++pos;  // '['
+        skipWhitespace();
+        if (pos < input.size() && input[pos] == ']') {
+            ++pos;
+            return;
+        }
+
+        while (true) {
+            skipWhitespace();
+            value.array.emplace_back();
+            parseValue(value.array.back(), depth + 1);
+            skipWhitespace();
+
+            if (pos >= input.size()) fail("unterminated array");
+            if (input[pos] == ',') { ++pos; continue; }
+            if (input[pos] == ']') { ++pos; return; }
+            fail("expected ',' or ']'");
+        }
+    }
+
+    void parseNumber(JsonValue& value) {
+        size_t start = pos;
+        if (pos < input.size() && input[pos] == '-') ++pos;
+
+        auto digits = [this]() {
+            size_t first = pos;
+            while (pos < input.size() && input[pos] >= '0' && input[pos] <= '9') ++pos;
+            return pos - first;
+        };
+
+        size_t intDigits = digits();
+        if (intDigits == 0) fail("invalid value");
+        if (intDigits > 1 && input[start + (input[start] == '-' ? 1 : 0)] == '0') {
+            fail("leading zero in number");
+        }
+        if (pos < input.size() && input[pos] == '.') {
+            ++pos;
+            if (digits() == 0) fail("expected digits after '.'");
+        }
+        if (pos < input.size() && (input[pos] == 'e' || input[pos] == 'E')) {
+            ++pos;
+            if (pos < input.size() && (input[pos] == '+' || input[pos] == '-')) ++pos;
+            if (digits() == 0) fail("expected exponent digits");
+        }
+
+        value.kind = JsonValue::Type::Number;
+        auto [end, ec] = std::from_chars(input.data() + start, input.data() + pos, value.number);
+        if (ec != std::errc() || end != input.data() + pos) {
+            pos = start;
+            fail("number out of range");
+        }
+    }
+
+    unsigned parseHex4() {
+        if (pos + 4 > input.size()) fail("truncated \\u escape");
+        unsigned code = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            char c = input[pos++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= static_cast<unsigned>(c - '0');
+            else if (c >= 'a' && c <= 'f') code |= static_cast<unsigned>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') code |= static_cast<unsigned>(c - 'A' + 10);
+            else fail("invalid \\u escape");
+        }
+        return code;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    void parseString(std::string& out) {
+        ++pos;  // opening quote
+
+        while (true) {
+            // Copy the run up to the next quote or escape in one go
+            size_t runEnd = pos;
+            while (runEnd < input.size()) {
+                char c = input[runEnd];
+                if (c == '"' || c == '\\') break;
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    pos = runEnd;
+                    fail("control character in string");
+                }
+                ++runEnd;
+            }
+            out.append(input, pos, runEnd - pos);
+            pos = runEnd;
+
+            if (pos >= input.size()) fail("unterminated string");
+            if (input[pos] == '"') {
+                ++pos;
+                return;
+            }
+
+            // Escape sequence
+            ++pos;
+            if (pos >= input.size()) fail("unterminated escape");
+            char escape = input[pos++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t code = parseHex4();
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        // High surrogate; must pair with a low one
+                        if (input.compare(pos, 2, "\\u") != 0) fail("unpaired surrogate");
+                        pos += 2;
+                        uint32_t low = parseHex4();
+                        if (low < 0xDC00 || low > 0xDFFF) fail("invalid low surrogate");
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                        fail("unpaired surrogate");
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default:
+                    fail("invalid escape character");
+            }
+        }
+    }
+};
+
+JsonValue JsonValue::parse(std::string_view text) {
+    return JsonParser(text).parseDocument();
+}
+
+const char* JsonValue::typeName(Type type) {
+    switch (type) {
+        case Type::Null: return "null";
+        case Type::Bool: return "boolean";
+        case Type::Number: return "number";
+        case Type::String: return "string";
+        case Type::Array: return "array";
+        case Type::Object: return "object";
+    }
+    return "unknown";
+}
+
+namespace {
+
+[[noreturn]] void typeMismatch(JsonValue::Type expected, JsonValue::Type actual) {
+    throw std::runtime_error(std::string("JSON value is ") + JsonValue::typeName(actual) +
+                             ", expected " + JsonValue::typeName(expected));
+}
+
+}
+
+bool JsonValue::asBool() const {
+    if (kind != Type::Bool) typeMismatch(Type::Bool, kind);
+    return boolean;
+}
+
+double JsonValue::asNumber() const {
+    if (kind != Type::Number) typeMismatch(Type::Number, kind);
+    return number;
+}
+
+const std::string& JsonValue::asString() const {
+    if (kind != Type::String) typeMismatch(Type::String, kind);
+    return text;
+}
+
+std::string JsonValue::takeString() {
+    if (kind != Type::String) typeMismatch(Type::String, kind);
+    return std::move(text);
+}
+
+const JsonValue::Array& JsonValue::items() const {
+    if (kind != Type::Array) typeMismatch(Type::Array, kind);
+    return array;
+}
+
+const JsonValue::Object& JsonValue::members() const {
+    if (kind != Type::Object) typeMismatch(Type::Object, kind);
+    return object;
+}
+
+JsonValue::Object& JsonValue::members() {
+    if (kind != Type::Object) typeMismatch(Type::Object, kind);
+    return object;
+}
+
+const JsonValue* JsonValue::find(std::string_view key) const {
+    if (kind != Type::Object) return nullptr;
+    // Last occurrence wins, matching common parsers
+    for (auto it = object.rbegin(); it != object.rend(); ++it) {
+        if (it->key == key) return &it->value;
+    }
+    return nullptr;
+}
+
+JsonValue* JsonValue::find(std::string_view key) {
+    return const_cast<JsonValue*>(static_cast<const JsonValue*>(this)->find(key));
+}
+
+}
@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cctype>
+#include <cstdint>
+#include <unordered_map>
 
 namespace metta_inference {
 
@@ -176,8 +178,8 @@ std::string Negation::toString() const {
     return oss.str();
 }
 
-// StateOfAffairs implementation
-std::string StateOfAffairs::toString() const {
+// KnowledgeStateOfAffairs implementation
+std::string KnowledgeStateOfAffairs::toString() const {
     std::ostringstream oss;
     
     if (!description.empty()) {
@@ -207,7 +209,7 @@ std::string StateOfAffairs::toString() const {
     return oss.str();
 }
 
-bool StateOfAffairs::validateEventualities(std::vector<std::string>& errors) const {
+bool KnowledgeStateOfAffairs::validateEventualities(std::vector<std::string>& errors) const {
     bool valid = true;
     
     for (const auto& [name, eventuality] : eventualities) {
@@ -242,7 +244,7 @@ bool StateOfAffairs::validateEventualities(std::vector<std::string>& errors) con
     return valid;
 }
 
-bool StateOfAffairs::validateEntities(std::vector<std::string>& errors) const {
+bool KnowledgeStateOfAffairs::validateEntities(std::vector<std::string>& errors) const {
     bool valid = true;
     
     for (const auto& [name, entity] : entities) {
@@ -586,8 +588,8 @@ std::vector<Norm> KnowledgeIO::extractNormsFromMetta(const std::string& mettaCon
 }
 
 // Extract state of affairs from MeTTa content
-StateOfAffairs KnowledgeIO::extractStateOfAffairsFromMetta(const std::string& mettaContent) {
-    StateOfAffairs soa;
+KnowledgeStateOfAffairs KnowledgeIO::extractStateOfAffairsFromMetta(const std::string& mettaContent) {
+    KnowledgeStateOfAffairs soa;
     
     // Parse all expressions from the content
     std::vector<std::shared_ptr<SExpr>> expressions;
@@ -746,7 +748,7 @@ std::vector<Norm> KnowledgeIO::readNormsFromFile(const fs::path& filepath) {
 }
 
 // Read state of affairs from file
-StateOfAffairs KnowledgeIO::readStateOfAffairsFromFile(const fs::path& filepath) {
+KnowledgeStateOfAffairs KnowledgeIO::readStateOfAffairsFromFile(const fs::path& filepath) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file: " + filepath.string());
@@ -773,7 +775,7 @@ void KnowledgeIO::writeNormsToFile(const std::vector<Norm>& norms, const fs::pat
 }
 
 // Write state of affairs to file
-void KnowledgeIO::writeStateOfAffairsToFile(const StateOfAffairs& soa, const fs::path& filepath) {
+void KnowledgeIO::writeStateOfAffairsToFile(const KnowledgeStateOfAffairs& soa, const fs::path& filepath) {
     std::ofstream file(filepath);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot create file: " + filepath.string());
@@ -839,6 +841,273 @@ void KnowledgeIO::writeMettaDocument(const MettaDocument& doc, const fs::path& f
     }
 }
 
+// Diff implementation
+namespace {
+
+uint64_t hashCombine(uint64_t hash, const std::string& value) {
+    for (unsigned char c : value) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    // Field separator so ("ab","c") and ("a","bc") hash differently
+    hash ^= 0x1f;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+// Collapse whitespace so reformatted nested objects compare equal
+std::string canonicalObject(const std::string& object) {
+    std::string result;
+    result.reserve(object.size());
+    bool pendingSpace = false;
+    for (char c : object) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = !result.empty();
+        } else {
+            if (pendingSpace && c != ')' && result.back() != '(') result += ' ';
+            pendingSpace = false;
+            result += c;
+        }
+    }
+    return result;
+}
+
+struct CanonicalFact {
+    const Triple* triple;
+    std::string object;
+    uint64_t hash;      // Whole triple
+    uint64_t slotHash;  // Type, subject and predicate only
+};
+
+std::vector<CanonicalFact> canonicalizeFacts(const std::vector<Triple>& facts) {
+    std::vector<CanonicalFact> result;
+    result.reserve(facts.size());
+    for (const auto& fact : facts) {
+        CanonicalFact canon{&fact, canonicalObject(fact.object), 0, 0};
+        uint64_t hash = 14695981039346656037ULL;
+        hash = hashCombine(hash, fact.tripleType);
+        hash = hashCombine(hash, fact.subject);
+        hash = hashCombine(hash, fact.predicate);
+        canon.slotHash = hash;
+        canon.hash = hashCombine(hash, canon.object);
+        result.push_back(std::move(canon));
+    }
+    return result;
+}
+
+bool sameFact(const CanonicalFact& a, const CanonicalFact& b) {
+    return a.hash == b.hash && a.object == b.object &&
+           a.triple->subject == b.triple->subject &&
+           a.triple->predicate == b.triple->predicate &&
+           a.triple->tripleType == b.triple->tripleType;
+}
+
+bool sameSlot(const CanonicalFact& a, const CanonicalFact& b) {
+    return a.slotHash == b.slotHash &&
+           a.triple->subject == b.triple->subject &&
+           a.triple->predicate == b.triple->predicate &&
+           a.triple->tripleType == b.triple->tripleType;
+}
+
+// Facts are a multiset: each fact in `after` consumes one equal fact in `before`
+void diffFacts(const std::vector<Triple>& before, const std::vector<Triple>& after, DocumentDiff& diff) {
+    auto oldFacts = canonicalizeFacts(before);
+    auto newFacts = canonicalizeFacts(after);
+    
+    std::unordered_map<uint64_t, std::vector<size_t>> index;
+    index.reserve(oldFacts.size());
+    for (size_t i = 0; i < oldFacts.size(); ++i) {
+        index[oldFacts[i].hash].push_back(i);
+    }
+    
+    std::vector<bool> matched(oldFacts.size(), false);
+    std::vector<size_t> added;
+    
+    for (size_t i = 0; i < newFacts.size(); ++i) {
+        bool found = false;
+        auto it = index.find(newFacts[i].hash);
+        if (it != index.end()) {
+            for (size_t candidate : it->second) {
+                if (!matched[candidate] && sameFact(oldFacts[candidate], newFacts[i])) {
+                    matched[candidate] = true;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (!found) added.push_back(i);
+    }
+    
+    std::vector<size_t> removed;
+    for (size_t i = 0; i < oldFacts.size(); ++i) {
+        if (!matched[i]) removed.push_back(i);
+    }
+    
+    // A slot (subject, predicate) with exactly one removal and one addition is a change
+    std::unordered_map<uint64_t, std::pair<std::vector<size_t>, std::vector<size_t>>> slots;
+    for (size_t i : removed) slots[oldFacts[i].slotHash].first.push_back(i);
+    for (size_t i : added) slots[newFacts[i].slotHash].second.push_back(i);
+    
+    std::vector<bool> removedPaired(oldFacts.size(), false);
+    std::vector<bool> addedPaired(newFacts.size(), false);
+    
+    for (size_t i : added) {
+        const auto& [olds, news] = slots[newFacts[i].slotHash];
+        if (olds.size() == 1 && news.size() == 1 && sameSlot(oldFacts[olds[0]], newFacts[i])) {
+            diff.changedFacts.push_back({*oldFacts[olds[0]].triple, *newFacts[i].triple});
+            removedPaired[olds[0]] = true;
+            addedPaired[i] = true;
+        }
+    }
+    
+    for (size_t i : added) {
+        if (!addedPaired[i]) diff.addedFacts.push_back(*newFacts[i].triple);
+    }
+    for (size_t i : removed) {
+        if (!removedPaired[i]) diff.removedFacts.push_back(*oldFacts[i].triple);
+    }
+}
+
+bool sameEventuality(const Eventuality& a, const Eventuality& b) {
+    return a.type == b.type && a.modality == b.modality &&
+           a.agent == b.agent && a.roles == b.roles;
+}
+
+bool sameEntity(const Entity& a, const Entity& b) {
+    return a.type == b.type && a.properties == b.properties;
+}
+
+// Both inputs are std::maps, so a merge walk is linear
+template <typename Map, typename Equal>
+void diffNamed(const Map& before, const Map& after, Equal equal,
+               std::vector<std::string>& added, std::vector<std::string>& removed,
+               std::vector<std::string>& changed) {
+    auto oldIt = before.begin();
+    auto newIt = after.begin();
+    while (oldIt != before.end() || newIt != after.end()) {
+        if (newIt == after.end() || (oldIt != before.end() && oldIt->first < newIt->first)) {
+            removed.push_back(oldIt->first);
+            ++oldIt;
+        } else if (oldIt == before.end() || newIt->first < oldIt->first) {
+            added.push_back(newIt->first);
+            ++newIt;
+        } else {
+            if (!equal(oldIt->second, newIt->second)) {
+                changed.push_back(newIt->first);
+            }
+            ++oldIt;
+            ++newIt;
+        }
+    }
+}
+
+// Negations and logical expressions compared by their rendered form
+void diffConstraints(const KnowledgeStateOfAffairs& before, const KnowledgeStateOfAffairs& after, DocumentDiff& diff) {
+    auto render = [](const KnowledgeStateOfAffairs& soa) {
+        std::vector<std::string> rendered;
+        rendered.reserve(soa.negations.size() + soa.logicalExpressions.size());
+        for (const auto& negation : soa.negations) rendered.push_back(negation.toString());
+        for (const auto& logExpr : soa.logicalExpressions) rendered.push_back(logExpr.toString());
+        return rendered;
+    };
+    
+    auto oldRendered = render(before);
+    auto newRendered = render(after);
+    
+    std::unordered_map<std::string, int> remaining;
+    remaining.reserve(oldRendered.size());
+    for (const auto& constraint : oldRendered) remaining[constraint]++;
+    
+    for (const auto& constraint : newRendered) {
+        auto it = remaining.find(constraint);
+        if (it != remaining.end() && it->second > 0) {
+            it->second--;
+        } else {
+            diff.addedConstraints.push_back(constraint);
+        }
+    }
+    
+    // Whatever was not consumed is gone; walk in document order
+    for (const auto& constraint : oldRendered) {
+        auto& count = remaining[constraint];
+        if (count > 0) {
+            count--;
+            diff.removedConstraints.push_back(constraint);
+        }
+    }
+}
+}
+
+size_t DocumentDiff::totalChanges() const {
+    return addedFacts.size() + removedFacts.size() + changedFacts.size() +
+           addedEventualities.size() + removedEventualities.size() + changedEventualities.size() +
+           addedEntities.size() + removedEntities.size() + changedEntities.size() +
+           addedConstraints.size() + removedConstraints.size() +
+           addedNorms.size() + removedNorms.size() + changedNorms.size();
+}
+
+bool DocumentDiff::normsChanged() const {
+    return !addedNorms.empty() || !removedNorms.empty() || !changedNorms.empty();
+}
+
+std::set<std::string> DocumentDiff::affectedSubjects() const {
+    std::set<std::string> subjects;
+    for (const auto& fact : addedFacts) subjects.insert(fact.subject);
+    for (const auto& fact : removedFacts) subjects.insert(fact.subject);
+    for (const auto& change : changedFacts) subjects.insert(change.after.subject);
+    subjects.insert(addedEventualities.begin(), addedEventualities.end());
+    subjects.insert(removedEventualities.begin(), removedEventualities.end());
+    subjects.insert(changedEventualities.begin(), changedEventualities.end());
+    subjects.insert(addedEntities.begin(), addedEntities.end());
+    subjects.insert(removedEntities.begin(), removedEntities.end());
+    subjects.insert(changedEntities.begin(), changedEntities.end());
+    return subjects;
+}
+
+bool DocumentDiff::requiresReevaluation(const KnowledgeStateOfAffairs& scenario) const {
+    if (normsChanged() || !addedConstraints.empty() || !removedConstraints.empty()) {
+        return true;
+    }
+    
+    auto subjects = affectedSubjects();
+    if (subjects.empty()) return false;
+    
+    // A scenario is affected if it mentions any changed subject
+    for (const auto& fact : scenario.facts) {
+        if (subjects.count(fact.subject) || subjects.count(fact.object)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DocumentDiff KnowledgeIO::diffStateOfAffairs(const KnowledgeStateOfAffairs& before, const KnowledgeStateOfAffairs& after) {
+    DocumentDiff diff;
+    
+    diffFacts(before.facts, after.facts, diff);
+    diffNamed(before.eventualities, after.eventualities, sameEventuality,
+              diff.addedEventualities, diff.removedEventualities, diff.changedEventualities);
+    diffNamed(before.entities, after.entities, sameEntity,
+              diff.addedEntities, diff.removedEntities, diff.changedEntities);
+    diffConstraints(before, after, diff);
+    
+    return diff;
+}
+
+DocumentDiff KnowledgeIO::diffDocuments(const MettaDocument& before, const MettaDocument& after) {
+    DocumentDiff diff = diffStateOfAffairs(before.stateOfAffairs, after.stateOfAffairs);
+    
+    std::map<std::string, std::string> oldNorms;
+    std::map<std::string, std::string> newNorms;
+    for (const auto& norm : before.norms) oldNorms[norm.name] = norm.toString();
+    for (const auto& norm : after.norms) newNorms[norm.name] = norm.toString();
+    
+    diffNamed(oldNorms, newNorms, std::equal_to<std::string>(),
+              diff.addedNorms, diff.removedNorms, diff.changedNorms);
+    
+    return diff;
+}
+
 // Validation implementations
 bool KnowledgeIO::validateEventuality(const Eventuality& eventuality, std::string& error) {
     // More flexible validation - only check for critical fields
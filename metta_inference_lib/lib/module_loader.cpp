@@ -1,8 +1,12 @@
 #include "metta_inference/module_loader.hpp"
 #include "metta_inference/config.hpp"  // For Constants
+#include "metta_inference/streaming_analyzer.hpp"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <sstream>
+#include <atomic>
+#include <iterator>
 #include <chrono>
 #include <unistd.h>
 
@@ -61,28 +65,41 @@ ModuleLoader::ModuleInfo ModuleLoader::analyzeModule(const fs::path& directory)
     return info;
 }
 
-fs::path ModuleLoader::createCombinedFile(
-    const std::vector<fs::path>& modulePaths,
-    const fs::path& exampleFile,
-    bool verbose) {
-    
-    fs::path tempFile = fs::temp_directory_path() / 
-                       ("metta_combined_" + std::to_string(getpid()) + ".metta");
-    
-    std::ofstream outFile(tempFile);
-    if (!outFile.is_open()) {
-        throw std::runtime_error("Failed to create combined file: " + tempFile.string());
+namespace {
+
+uint64_t hashContent(const std::string& content) {
+    // FNV-1a, good enough to detect edits between snapshots
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
     }
-    
-    size_t totalFiles = 0;
-    size_t totalSize = 0;
-    
+    return hash;
+}
+
+// Unique per call so concurrent engines in one process don't share a file
+fs::path makeCombinedFilePath() {
+    static std::atomic<uint64_t> counter{0};
+    return fs::temp_directory_path() /
+           ("metta_combined_" + std::to_string(getpid()) + "_" +
+            std::to_string(counter.fetch_add(1)) + ".metta");
+}
+
+void writeCombinedHeader(std::ostream& outFile) {
     outFile << ";; Combined MeTTa file generated by inference runner\n";
     outFile << ";; Generated: " << std::chrono::system_clock::now().time_since_epoch().count() << "\n\n";
-    
+}
+
+// Writes every module file in load order; records each file when requested
+void writeModuleSection(std::ostream& outFile,
+                        const std::vector<fs::path>& modulePaths,
+                        bool verbose,
+                        size_t& totalFiles,
+                        size_t& totalSize,
+                        std::vector<ModuleSnapshot::File>* files = nullptr) {
     for (size_t i = 0; i < modulePaths.size(); ++i) {
         const auto& modulePath = modulePaths[i];
-        auto moduleInfo = analyzeModule(modulePath);
+        auto moduleInfo = ModuleLoader::analyzeModule(modulePath);
         
         if (moduleInfo.files.empty()) {
             if (verbose) {
@@ -97,7 +114,7 @@ fs::path ModuleLoader::createCombinedFile(
         for (const auto& file : moduleInfo.files) {
             outFile << ";; -- File: " << file.filename() << " --\n";
             
-            std::ifstream inFile(file);
+            std::ifstream inFile(file, std::ios::binary);
             if (!inFile.is_open()) {
                 std::cerr << "Warning: Failed to read module file: " << file << "\n";
                 continue;
@@ -112,20 +129,26 @@ fs::path ModuleLoader::createCombinedFile(
                 continue;
             }
             
-            outFile << inFile.rdbuf();
+            std::string content((std::istreambuf_iterator<char>(inFile)),
+                                std::istreambuf_iterator<char>());
+            outFile << content;
             outFile << "\n\n";
             
             totalFiles++;
-            std::error_code ec;
-            auto size = fs::file_size(file, ec);
-            if (!ec) totalSize += size;
+            totalSize += content.size();
+            
+            if (files) {
+                files->push_back({file, content.size(), hashContent(content)});
+            }
             
             if (verbose) {
-                std::cout << "    Added: " << file.filename() << " (" << size << " bytes)\n";
+                std::cout << "    Added: " << file.filename() << " (" << content.size() << " bytes)\n";
             }
         }
     }
-    
+}
+
+void writeExampleSection(std::ostream& outFile, const fs::path& exampleFile) {
     outFile << ";; ========== Example File ==========\n\n";
     outFile << ";; -- File: " << exampleFile.filename() << " --\n";
     
@@ -143,6 +166,28 @@ fs::path ModuleLoader::createCombinedFile(
     
     outFile << exampleIn.rdbuf();
     outFile << "\n";
+}
+
+}
+
+fs::path ModuleLoader::createCombinedFile(
+    const std::vector<fs::path>& modulePaths,
+    const fs::path& exampleFile,
+    bool verbose) {
+    
+    fs::path tempFile = makeCombinedFilePath();
+    
+    std::ofstream outFile(tempFile);
+    if (!outFile.is_open()) {
+        throw std::runtime_error("Failed to create combined file: " + tempFile.string());
+    }
+    
+    size_t totalFiles = 0;
+    size_t totalSize = 0;
+    
+    writeCombinedHeader(outFile);
+    writeModuleSection(outFile, modulePaths, verbose, totalFiles, totalSize);
+    writeExampleSection(outFile, exampleFile);
     
     outFile.close();
     
@@ -154,6 +199,69 @@ fs::path ModuleLoader::createCombinedFile(
     return tempFile;
 }
 
+fs::path ModuleLoader::createCombinedFile(
+    const ModuleSnapshot& snapshot,
+    const fs::path& exampleFile,
+    bool verbose) {
+    
+    fs::path tempFile = makeCombinedFilePath();
+    
+    std::ofstream outFile(tempFile);
+    if (!outFile.is_open()) {
+        throw std::runtime_error("Failed to create combined file: " + tempFile.string());
+    }
+    
+    writeCombinedHeader(outFile);
+    outFile << snapshot.combinedModules;
+    writeExampleSection(outFile, exampleFile);
+    
+    outFile.close();
+    
+    if (verbose) {
+        std::cout << "  Combined " << snapshot.totalFiles() << " module files (snapshot v"
+                 << snapshot.version << ") + example (" 
+                 << snapshot.combinedModules.size() << " bytes of modules)\n";
+    }
+    
+    return tempFile;
+}
+
+std::shared_ptr<const ModuleSnapshot> ModuleLoader::loadSnapshot(
+    const std::vector<fs::path>& modulePaths,
+    uint64_t version) {
+    
+    auto snapshot = std::make_shared<ModuleSnapshot>();
+    snapshot->version = version;
+    snapshot->modulePaths = modulePaths;
+    snapshot->modules = validateModules(modulePaths);
+    
+    std::ostringstream section;
+    size_t totalFiles = 0;
+    size_t totalSize = 0;
+    writeModuleSection(section, modulePaths, false, totalFiles, totalSize, &snapshot->files);
+    snapshot->combinedModules = section.str();
+    snapshot->queries = StreamingAnalyzer::countQueries(snapshot->combinedModules);
+    
+    return snapshot;
+}
+
+bool ModuleSnapshot::sameContentAs(const ModuleSnapshot& other) const {
+    if (modulePaths != other.modulePaths || files.size() != other.files.size()) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (files[i].path != other.files[i].path ||
+            files[i].size != other.files[i].size ||
+            files[i].contentHash != other.files[i].contentHash) {
+            return false;
+        }
+    }
+    
+    // Hashes can collide; only the bytes themselves are conclusive
+    return combinedModules == other.combinedModules;
+}
+
 std::vector<ModuleLoader::ModuleInfo> ModuleLoader::validateModules(
     const std::vector<fs::path>& modulePaths) {
     
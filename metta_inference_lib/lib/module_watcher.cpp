@@ -0,0 +1,226 @@
+#include "metta_inference/module_watcher.hpp"
+#include <iostream>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace metta_inference {
+
+ModuleWatcher::ModuleWatcher(std::vector<fs::path> paths, std::chrono::milliseconds debounceInterval)
+    : modulePaths(std::move(paths)), debounce(debounceInterval) {
+    // Initial load validates the directories and throws like validateModules
+    snapshot = ModuleLoader::loadSnapshot(modulePaths, 1);
+}
+
+ModuleWatcher::~ModuleWatcher() {
+    stop();
+}
+
+void ModuleWatcher::start() {
+    if (running.exchange(true)) return;
+
+    if (pipe(wakeFd) != 0) {
+        running = false;
+        throw std::runtime_error("Failed to create watcher wake pipe: " + std::string(strerror(errno)));
+    }
+    fcntl(wakeFd[0], F_SETFD, FD_CLOEXEC);
+    fcntl(wakeFd[1], F_SETFD, FD_CLOEXEC);
+
+    worker = std::thread(&ModuleWatcher::watchLoop, this);
+}
+
+void ModuleWatcher::stop() {
+    if (!running.exchange(false)) return;
+
+    char byte = 0;
+    ssize_t ignored = write(wakeFd[1], &byte, 1);
+    (void)ignored;
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    close(wakeFd[0]);
+    close(wakeFd[1]);
+    wakeFd[0] = wakeFd[1] = -1;
+}
+
+std::shared_ptr<const ModuleSnapshot> ModuleWatcher::current() const {
+    return std::atomic_load(&snapshot);
+}
+
+uint64_t ModuleWatcher::version() const {
+    auto snap = current();
+    return snap ? snap->version : 0;
+}
+
+bool ModuleWatcher::refresh() {
+    std::lock_guard<std::mutex> lock(refreshMutex);
+
+    auto previous = current();
+    uint64_t nextVersion = previous ? previous->version + 1 : 1;
+
+    std::shared_ptr<const ModuleSnapshot> next;
+    try {
+        next = ModuleLoader::loadSnapshot(modulePaths, nextVersion);
+    } catch (const std::exception& e) {
+        // Keep serving the last good snapshot (e.g. directory briefly missing during a deploy)
+        std::cerr << "Warning: Module reload failed, keeping snapshot v"
+                  << (previous ? previous->version : 0) << ": " << e.what() << "\n";
+        return false;
+    }
+
+    if (previous && previous->sameContentAs(*next)) {
+        return false;
+    }
+
+    publish(std::move(next));
+    return true;
+}
+
+size_t ModuleWatcher::addListener(Listener listener) {
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    size_t id = nextListenerId++;
+    listeners[id] = std::move(listener);
+    return id;
+}
+
+void ModuleWatcher::removeListener(size_t id) {
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    listeners.erase(id);
+}
+
+void ModuleWatcher::publish(std::shared_ptr<const ModuleSnapshot> next) {
+    std::atomic_store(&snapshot, next);
+
+    std::vector<Listener> toNotify;
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        for (const auto& [id, listener] : listeners) {
+            toNotify.push_back(listener);
+        }
+    }
+
+    for (const auto& listener : toNotify) {
+        try {
+            listener(next);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Module snapshot listener failed: " << e.what() << "\n";
+        }
+    }
+}
+
+#ifdef __linux__
+
+void ModuleWatcher::watchLoop() {
+    int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        std::cerr << "Warning: inotify unavailable (" << strerror(errno)
+                  << "), module hot reload disabled\n";
+        return;
+    }
+
+    const uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                          IN_MOVED_TO | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+    std::map<int, fs::path> watches;
+
+    // (Re-)register directories; a deleted and recreated directory needs a new watch
+    auto addWatches = [&]() {
+        bool added = false;
+        for (const auto& path : modulePaths) {
+            bool watched = false;
+            for (const auto& [wd, watchedPath] : watches) {
+                if (watchedPath == path) { watched = true; break; }
+            }
+            if (watched) continue;
+
+            int wd = inotify_add_watch(inotifyFd, path.c_str(), mask | IN_ONLYDIR);
+            if (wd >= 0) {
+                watches[wd] = path;
+                added = true;
+            }
+        }
+        return added;
+    };
+
+    addWatches();
+
+    // Catch edits made between the initial load and watch registration
+    refresh();
+
+    alignas(struct inotify_event) char buffer[8192];
+    bool pending = false;
+
+    while (running.load()) {
+        int timeoutMs = -1;
+        if (pending) {
+            timeoutMs = static_cast<int>(debounce.count());
+        } else if (watches.size() < modulePaths.size()) {
+            timeoutMs = 1000;  // Retry missing directories
+        }
+
+        struct pollfd fds[2];
+        fds[0] = {inotifyFd, POLLIN, 0};
+        fds[1] = {wakeFd[0], POLLIN, 0};
+
+        int ready = poll(fds, 2, timeoutMs);
+        if (!running.load() || (ready > 0 && (fds[1].revents & POLLIN))) {
+            break;
+        }
+
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Warning: Module watcher poll failed: " << strerror(errno) << "\n";
+            break;
+        }
+
+        if (ready == 0) {
+            // Quiet period elapsed: editors emit bursts of events per save
+            bool reattached = addWatches();
+            if (pending || reattached) {
+                refresh();
+                pending = false;
+            }
+            continue;
+        }
+
+        while (true) {
+            ssize_t len = read(inotifyFd, buffer, sizeof(buffer));
+            if (len <= 0) break;
+
+            for (char* ptr = buffer; ptr < buffer + len; ) {
+                auto* event = reinterpret_cast<struct inotify_event*>(ptr);
+                if (event->mask & IN_IGNORED) {
+                    watches.erase(event->wd);
+                }
+                pending = true;
+                ptr += sizeof(struct inotify_event) + event->len;
+            }
+        }
+    }
+
+    close(inotifyFd);
+}
+
+#else
+
+void ModuleWatcher::watchLoop() {
+    // Portable fallback: rescan once per second, still only swapping on change
+    while (running.load()) {
+        struct pollfd wake = {wakeFd[0], POLLIN, 0};
+        int ready = poll(&wake, 1, 1000);
+        if (!running.load() || ready > 0) break;
+        refresh();
+    }
+}
+
+#endif
+
+}
@@ -0,0 +1,137 @@
+#include "metta_inference/output_sink.hpp"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace metta_inference {
+
+// StreamSink implementation
+void StreamSink::write(std::string_view chunk) {
+    stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+}
+
+// FdSink implementation
+FdSink::FdSink(int fd, size_t bufferSize) : fd(fd), bufferSize(bufferSize) {
+    buffer.reserve(bufferSize);
+}
+
+FdSink::~FdSink() {
+    try {
+        flush();
+    } catch (...) {
+        // Destructors must not throw; callers wanting errors call flush()
+    }
+}
+
+void FdSink::write(std::string_view chunk) {
+    if (buffer.size() + chunk.size() > bufferSize) {
+        flush();
+        if (chunk.size() >= bufferSize) {
+            writeAll(chunk);
+            return;
+        }
+    }
+    buffer.append(chunk);
+}
+
+void FdSink::flush() {
+    if (buffer.empty()) return;
+    writeAll(buffer);
+    buffer.clear();
+}
+
+void FdSink::writeAll(std::string_view data) {
+    while (!data.empty()) {
+        ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write output: " + std::string(std::strerror(errno)));
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+// CallbackSink implementation
+CallbackSink::CallbackSink(Callback callback, size_t chunkSize)
+    : callback(std::move(callback)), chunkSize(chunkSize) {
+    buffer.reserve(chunkSize);
+}
+
+CallbackSink::~CallbackSink() {
+    try {
+        flush();
+    } catch (...) {
+        // Exceptions from the callback are only reported through flush()
+    }
+}
+
+void CallbackSink::write(std::string_view chunk) {
+    buffer.append(chunk);
+    if (buffer.size() >= chunkSize) {
+        flush();
+    }
+}
+
+void CallbackSink::flush() {
+    if (buffer.empty()) return;
+    std::string pending;
+    pending.swap(buffer);
+    buffer.reserve(chunkSize);
+    callback(pending);
+}
+
+// SinkStream implementation
+SinkStream::Buffer::Buffer(OutputSink& sink) : sink(sink) {
+    setp(storage, storage + sizeof(storage));
+}
+
+void SinkStream::Buffer::drain() {
+    if (pptr() > pbase()) {
+        sink.write(std::string_view(pbase(), static_cast<size_t>(pptr() - pbase())));
+        setp(storage, storage + sizeof(storage));
+    }
+}
+
+int SinkStream::Buffer::sync() {
+    drain();
+    sink.flush();
+    return 0;
+}
+
+SinkStream::Buffer::int_type SinkStream::Buffer::overflow(int_type ch) {
+    drain();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize SinkStream::Buffer::xsputn(const char* data, std::streamsize count) {
+    if (count <= epptr() - pptr()) {
+        traits_type::copy(pptr(), data, static_cast<size_t>(count));
+        pbump(static_cast<int>(count));
+        return count;
+    }
+    // Large pieces bypass the staging buffer
+    drain();
+    sink.write(std::string_view(data, static_cast<size_t>(count)));
+    return count;
+}
+
+SinkStream::SinkStream(OutputSink& sink) : std::ostream(nullptr), buffer(sink) {
+    rdbuf(&buffer);
+    // Surface sink failures instead of silently setting badbit
+    exceptions(std::ios::badbit);
+}
+
+SinkStream::~SinkStream() {
+    try {
+        buffer.pubsync();
+    } catch (...) {
+        // Writers flush explicitly when they need to see sink errors
+    }
+}
+
+}
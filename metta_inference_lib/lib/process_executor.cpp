@@ -1,111 +1,215 @@
 #include "metta_inference/process_executor.hpp"
-#include <sys/wait.h>  // For WEXITSTATUS
+#include "spawn_shell.hpp"
+#include <sys/wait.h>  // For waitpid()
 #include <sys/select.h> // For select()
 #include <fcntl.h>      // For fcntl()
-#include <unistd.h>     // For fileno()
+#include <unistd.h>     // For pipe(), read()
 #include <signal.h>     // For kill()
+#include <algorithm>
+#include <cerrno>
 #include <cstring>      // For strerror()
 
 namespace metta_inference {
 
+namespace {
+
+int reap(pid_t pid) {
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return status;
+}
+
+// Kills the command's process group and waits for the shell
+void stop(pid_t pid, int outputFd) {
+    kill(-pid, SIGKILL);
+    close(outputFd);
+    reap(pid);
+}
+
+}
+
 ProcessExecutor::ExecutionResult ProcessExecutor::execute(
     const std::string& command,
-    std::optional<std::chrono::milliseconds> timeout) {
-    
+    std::optional<std::chrono::milliseconds> timeout,
+    const CancellationToken& cancel,
+    const OutputObserver& observer,
+    std::optional<std::chrono::steady_clock::time_point> deadline) {
+
+    cancel.throwIfCancelled();
+
     auto startTime = std::chrono::steady_clock::now();
     ExecutionResult result;
-    
-    // Pre-allocate space for output to reduce allocations
-    result.output.reserve(65536);  // Reserve 64KB initially
-    
-    FILE* rawPipe = popen(command.c_str(), "r");
-    if (!rawPipe) {
-        throw std::runtime_error("Failed to execute command: " + command);
+
+    // Output is read straight into result.output; grow it geometrically
+    // so large REPL outputs cost O(log n) reallocations and no extra copy
+    std::string& output = result.output;
+    size_t used = 0;
+    output.resize(INITIAL_CAPACITY);
+
+    // cancel() wakes the select below through this pipe
+    int wakeFds[2] = {-1, -1};
+    CancellationToken::Registration onCancel;
+    if (cancel.canBeCancelled()) {
+        // Close-on-exec from the start, as in spawnShellCommand
+#ifdef __linux__
+        int created = pipe2(wakeFds, O_CLOEXEC | O_NONBLOCK);
+#else
+        int created = pipe(wakeFds);
+        if (created == 0) {
+            for (int wakeFd : wakeFds) {
+                fcntl(wakeFd, F_SETFD, FD_CLOEXEC);
+                fcntl(wakeFd, F_SETFL, fcntl(wakeFd, F_GETFL, 0) | O_NONBLOCK);
+            }
+        }
+#endif
+        if (created != 0) {
+            throw std::runtime_error("Failed to create cancellation pipe: " + std::string(strerror(errno)));
+        }
+        onCancel = cancel.onCancel([wakeFd = wakeFds[1]]() {
+            ssize_t ignored = write(wakeFd, "x", 1);
+            (void)ignored;
+        });
+    }
+    auto closeWake = [&]() {
+        onCancel.reset();
+        for (int& wakeFd : wakeFds) {
+            if (wakeFd >= 0) close(wakeFd);
+            wakeFd = -1;
+        }
+    };
+
+    int fd = -1;
+    pid_t pid;
+    try {
+        pid = detail::spawnShellCommand(command, fd);
+    } catch (...) {
+        closeWake();
+        throw;
     }
-    
-    // Get file descriptor and set to non-blocking mode
-    int fd = fileno(rawPipe);
+
+    // Set to non-blocking mode
     int flags = fcntl(fd, F_GETFL, 0);
     fcntl(fd, F_SETFL, flags | O_NONBLOCK);
-    
-    std::array<char, BUFFER_SIZE> buffer;
+
     fd_set readfds;
     struct timeval tv;
     bool timedOut = false;
-    
+    bool cancelled = false;
+    bool stoppedEarly = false;  // At the deadline or by the observer
+
     while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (timeout && now - startTime > *timeout) {
+            timedOut = true;
+            break;
+        }
+        if (deadline && now >= *deadline) {
+            stoppedEarly = true;
+            break;
+        }
+
+        // Wake for whichever limit comes first; check every minute anyway
+        std::chrono::steady_clock::duration wait = std::chrono::seconds(60);
         if (timeout) {
-            auto elapsed = std::chrono::steady_clock::now() - startTime;
-            if (elapsed > *timeout) {
-                timedOut = true;
-                break;
-            }
-            
-            // Calculate remaining timeout for select
-            auto remaining = *timeout - elapsed;
-            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining).count();
-            auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
-                remaining - std::chrono::seconds(seconds)).count();
-            
-            tv.tv_sec = seconds;
-            tv.tv_usec = microseconds;
-        } else {
-            // No timeout, wait indefinitely
-            tv.tv_sec = 60;  // Check every minute anyway
-            tv.tv_usec = 0;
+            wait = std::min(wait, *timeout - (now - startTime));
+        }
+        if (deadline) {
+            wait = std::min(wait, *deadline - now);
         }
-        
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(wait);
+        tv.tv_sec = seconds.count();
+        tv.tv_usec = std::chrono::duration_cast<std::chrono::microseconds>(wait - seconds).count();
+
         FD_ZERO(&readfds);
         FD_SET(fd, &readfds);
-        
-        int selectResult = select(fd + 1, &readfds, nullptr, nullptr, &tv);
-        
+        int maxFd = fd;
+        if (wakeFds[0] >= 0) {
+            FD_SET(wakeFds[0], &readfds);
+            maxFd = std::max(maxFd, wakeFds[0]);
+        }
+
+        int selectResult = select(maxFd + 1, &readfds, nullptr, nullptr, &tv);
+
+        if (cancel.isCancelled()) {
+            cancelled = true;
+            break;
+        }
+
         if (selectResult < 0) {
+            if (errno == EINTR) continue;
             // Error in select
-            pclose(rawPipe);
-            throw std::runtime_error("Error waiting for command output: " + std::string(strerror(errno)));
+            std::string error = strerror(errno);
+            stop(pid, fd);
+            closeWake();
+            throw std::runtime_error("Error waiting for command output: " + error);
         } else if (selectResult == 0) {
-            // Timeout occurred in select
-            if (timeout) {
-                auto elapsed = std::chrono::steady_clock::now() - startTime;
-                if (elapsed > *timeout) {
-                    timedOut = true;
-                    break;
-                }
-            }
-            continue;  // Continue waiting
-        } else {
+            continue;  // A limit may have passed; checked above
+        } else if (FD_ISSET(fd, &readfds)) {
             // Data is available to read
-            ssize_t bytesRead = read(fd, buffer.data(), buffer.size() - 1);
+            if (output.size() - used < BUFFER_SIZE) {
+                output.resize(output.size() * 2);
+            }
+            ssize_t bytesRead = read(fd, output.data() + used, output.size() - used);
             if (bytesRead > 0) {
-                buffer[bytesRead] = '\0';
-                result.output += buffer.data();
+                bool proceed = true;
+                if (observer) {
+                    try {
+                        proceed = observer(std::string_view(output.data() + used, static_cast<size_t>(bytesRead)));
+                    } catch (...) {
+                        stop(pid, fd);
+                        closeWake();
+                        throw;
+                    }
+                }
+                used += static_cast<size_t>(bytesRead);
+                if (!proceed) {
+                    stoppedEarly = true;
+                    break;
+                }
             } else if (bytesRead == 0) {
                 // EOF reached
                 break;
-            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
                 // Real error occurred
-                pclose(rawPipe);
-                throw std::runtime_error("Error reading command output: " + std::string(strerror(errno)));
+                std::string error = strerror(errno);
+                stop(pid, fd);
+                closeWake();
+                throw std::runtime_error("Error reading command output: " + error);
             }
         }
     }
-    
-    if (timedOut) {
-        // Kill the process if it timed out
-        // Note: This is a best-effort attempt, popen doesn't give us the PID directly
-        pclose(rawPipe);
+
+    output.resize(used);
+    closeWake();
+
+    if (stoppedEarly) {
+        stop(pid, fd);
+        result.exitCode = -1;
+        result.stoppedEarly = true;
+        result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime
+        );
+        return result;
+    }
+
+    if (timedOut || cancelled) {
+        stop(pid, fd);
+        if (cancelled) {
+            throw CancelledError();
+        }
         throw std::runtime_error("Command timed out");
     }
-    
+
     // Get exit code
-    int status = pclose(rawPipe);
+    close(fd);
+    int status = reap(pid);
     result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
     result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::steady_clock::now() - startTime
     );
-    
+
     return result;
 }
 
-}
\ No newline at end of file
+}
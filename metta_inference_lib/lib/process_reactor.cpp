@@ -0,0 +1,446 @@
+#include "metta_inference/process_reactor.hpp"
+#include "spawn_shell.hpp"
+#include <iostream>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace metta_inference {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How often processes that closed their output are checked for exit
+constexpr int REAP_POLL_MS = 10;
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + strerror(errno));
+}
+
+thread_local bool reactorThread = false;
+
+}
+
+// Output on its way from the reactor thread to a job's observer. One
+// completion thread at a time drains it; the job's completion is held
+// back until it is empty.
+struct ProcessReactor::ObserverFeed {
+    ProcessExecutor::OutputObserver observer;
+    std::mutex mutex;
+    std::string pending;
+    bool draining = false;
+    std::function<void()> then;  // The completion, once pending is drained
+    std::atomic<bool> stop{false};  // The observer returned false or threw
+    std::exception_ptr error;
+};
+
+struct ProcessReactor::Job {
+    Completion completion;
+    ProcessExecutor::ExecutionResult result{};
+    std::exception_ptr error;
+    Clock::time_point started;
+    Clock::time_point deadline;
+    std::optional<Clock::time_point> stopAt;  // Soft deadline: stop, keep the output
+    std::shared_ptr<ObserverFeed> feed;  // Set when there is an observer
+    pid_t pid = -1;
+    int fd = -1;      // Read end of the output pipe; -1 once closed
+    size_t used = 0;  // Bytes of result.output filled so far
+    CancellationToken cancel;
+    CancellationToken::Registration onCancel;  // Wakes the reactor
+};
+
+ProcessReactor::ProcessReactor(size_t completionThreads) {
+    if (completionThreads == 0) {
+        completionThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+#ifdef __linux__
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        auto error = systemError("Failed to create process reactor");
+        if (epollFd >= 0) close(epollFd);
+        if (wakeFd >= 0) close(wakeFd);
+        throw error;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;  // Marks the wake-up descriptor
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    reactor = std::thread(&ProcessReactor::reactorLoop, this);
+#endif
+
+    for (size_t i = 0; i < completionThreads; ++i) {
+        workers.emplace_back(&ProcessReactor::workerLoop, this);
+    }
+}
+
+ProcessReactor::~ProcessReactor() {
+    // The reactor fails whatever is still running, then the workers drain
+    // the completions it posted
+    closing = true;
+    wake();
+    if (reactor.joinable()) {
+        reactor.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+#ifdef __linux__
+    close(epollFd);
+    close(wakeFd);
+#endif
+}
+
+void ProcessReactor::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push_back(std::move(task));
+    }
+    queueReady.notify_one();
+}
+
+bool ProcessReactor::onReactorThread() {
+    return reactorThread;
+}
+
+void ProcessReactor::workerLoop() {
+    reactorThread = true;
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Process completion failed: " << e.what() << "\n";
+        } catch (...) {
+            std::cerr << "Warning: Process completion failed\n";
+        }
+    }
+}
+
+void ProcessReactor::finish(std::unique_ptr<Job> job) {
+    job->onCancel.reset();
+    job->result.output.resize(job->used);
+    job->result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - job->started);
+
+    // std::function needs a copyable callable
+    std::shared_ptr<Job> finished(std::move(job));
+    auto complete = [this, finished]() {
+        // The feed is drained by now, so its error is final
+        if (finished->feed && finished->feed->error && !finished->error) {
+            finished->error = finished->feed->error;
+        }
+        --running;
+        finished->completion(std::move(finished->result), finished->error);
+    };
+
+    if (finished->feed) {
+        std::lock_guard<std::mutex> lock(finished->feed->mutex);
+        if (finished->feed->draining) {
+            finished->feed->then = std::move(complete);
+            return;
+        }
+    }
+    post(std::move(complete));
+}
+
+void ProcessReactor::observe(const std::shared_ptr<ObserverFeed>& feed, std::string_view chunk) {
+    if (feed->stop.load()) return;
+    {
+        std::lock_guard<std::mutex> lock(feed->mutex);
+        feed->pending.append(chunk);
+        if (feed->draining) return;
+        feed->draining = true;
+    }
+
+    post([this, feed]() {
+        while (true) {
+            std::string chunk;
+            {
+                std::lock_guard<std::mutex> lock(feed->mutex);
+                if (feed->pending.empty()) {
+                    feed->draining = false;
+                    if (feed->then) {
+                        post(std::exchange(feed->then, nullptr));
+                    }
+                    return;
+                }
+                chunk.swap(feed->pending);
+            }
+            if (feed->stop.load()) continue;
+
+            bool proceed = false;
+            try {
+                proceed = feed->observer(chunk);
+            } catch (...) {
+                feed->error = std::current_exception();
+            }
+            if (!proceed) {
+                // The reactor stops the command on its next pass
+                feed->stop = true;
+                wake();
+            }
+        }
+    });
+}
+
+#ifdef __linux__
+
+void ProcessReactor::submit(const std::string& command, std::chrono::milliseconds timeout,
+                            Completion completion, const CancellationToken& cancel,
+                            ProcessExecutor::OutputObserver observer,
+                            std::optional<Clock::time_point> deadline) {
+    // A completion resubmitting during shutdown would never be picked up
+    if (closing.load()) {
+        throw std::runtime_error("Process reactor shut down");
+    }
+
+    auto job = std::make_unique<Job>();
+    job->completion = std::move(completion);
+    job->started = Clock::now();
+    job->deadline = job->started + timeout;
+    job->cancel = cancel;
+    if (observer) {
+        job->feed = std::make_shared<ObserverFeed>();
+        job->feed->observer = std::move(observer);
+    }
+    job->stopAt = deadline;
+
+    // Own process group, so a timeout also kills what the shell started
+    int fd = -1;
+    job->pid = detail::spawnShellCommand(command, fd);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    job->fd = fd;
+    job->result.output.resize(ProcessExecutor::INITIAL_CAPACITY);
+
+    // Registered last: a cancellation from here on is seen by the loop
+    job->onCancel = cancel.onCancel([this]() { wake(); });
+
+    ++running;
+    {
+        std::lock_guard<std::mutex> lock(incomingMutex);
+        incoming.push_back(std::move(job));
+    }
+    wake();
+}
+
+void ProcessReactor::wake() {
+    if (wakeFd < 0) return;
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void ProcessReactor::reactorLoop() {
+    reactorThread = true;
+    std::unordered_map<Job*, std::unique_ptr<Job>> active;
+
+    auto closeOutput = [&](Job& job) {
+        if (job.fd < 0) return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, job.fd, nullptr);
+        close(job.fd);
+        job.fd = -1;
+    };
+
+    auto failWith = [&](Job& job, std::exception_ptr error) {
+        kill(-job.pid, SIGKILL);
+        if (!job.error) {
+            job.error = error;
+        }
+        closeOutput(job);
+    };
+
+    auto fail = [&](Job& job, const std::string& message) {
+        failWith(job, std::make_exception_ptr(std::runtime_error(message)));
+    };
+
+    auto adopt = [&]() {
+        std::vector<std::unique_ptr<Job>> adopted;
+        {
+            std::lock_guard<std::mutex> lock(incomingMutex);
+            adopted.swap(incoming);
+        }
+        for (auto& job : adopted) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = job.get();
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, job->fd, &event) != 0) {
+                fail(*job, "Failed to watch command output: " + std::string(strerror(errno)));
+            }
+            Job* key = job.get();
+            active.emplace(key, std::move(job));
+        }
+    };
+
+    // One read per readiness event; epoll is level-triggered, so a chatty
+    // process cannot starve the others. False at EOF or on error.
+    auto drain = [&](Job& job) {
+        auto& output = job.result.output;
+        if (output.size() - job.used < ProcessExecutor::BUFFER_SIZE) {
+            output.resize(output.size() * 2);
+        }
+        while (true) {
+            ssize_t bytesRead = read(job.fd, output.data() + job.used, output.size() - job.used);
+            if (bytesRead > 0) {
+                if (job.feed) {
+                    observe(job.feed, std::string_view(output.data() + job.used,
+                                                       static_cast<size_t>(bytesRead)));
+                }
+                job.used += static_cast<size_t>(bytesRead);
+                return true;
+            }
+            if (bytesRead == 0) return false;
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            fail(job, "Error reading command output: " + std::string(strerror(errno)));
+            return false;
+        }
+    };
+
+    auto reap = [](Job& job, bool block) {
+        int status = 0;
+        pid_t pid;
+        do {
+            pid = waitpid(job.pid, &status, block ? 0 : WNOHANG);
+        } while (pid < 0 && errno == EINTR);
+
+        if (pid == 0) return false;
+        job.result.exitCode = (pid > 0 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+        return true;
+    };
+
+    epoll_event events[64];
+    while (!closing.load()) {
+        // Sleep until the nearest deadline, or briefly while waiting on exits
+        auto now = Clock::now();
+        int timeoutMs = -1;
+        for (const auto& [key, job] : active) {
+            auto until = job->deadline;
+            if (job->stopAt && job->fd >= 0) until = std::min(until, *job->stopAt);
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(until - now).count();
+            int wait = static_cast<int>(std::clamp<long long>(remaining, 0, 60000));
+            if (job->fd < 0) wait = std::min(wait, REAP_POLL_MS);
+            timeoutMs = timeoutMs < 0 ? wait : std::min(timeoutMs, wait);
+        }
+
+        int ready = epoll_wait(epollFd, events, 64, timeoutMs);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Warning: Process reactor wait failed: " << strerror(errno) << "\n";
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            auto* job = static_cast<Job*>(events[i].data.ptr);
+            if (!job) {
+                uint64_t count;
+                ssize_t ignored = read(wakeFd, &count, sizeof(count));
+                (void)ignored;
+                continue;
+            }
+            if (job->fd >= 0 && !drain(*job)) {
+                closeOutput(*job);
+            }
+        }
+
+        adopt();
+
+        now = Clock::now();
+        for (auto it = active.begin(); it != active.end(); ) {
+            Job& job = *it->second;
+            if (job.fd < 0 && reap(job, false)) {
+                auto finished = std::move(it->second);
+                it = active.erase(it);
+                finish(std::move(finished));
+                continue;
+            }
+            if (job.cancel.isCancelled() && !job.error) {
+                failWith(job, std::make_exception_ptr(CancelledError()));
+            } else if (job.feed && job.feed->stop.load() && job.fd >= 0 && !job.error) {
+                // Closed and reaped like a deadline stop; an observer
+                // error reaches the completion through the feed
+                kill(-job.pid, SIGKILL);
+                closeOutput(job);
+                job.result.stoppedEarly = !job.feed->error;
+            } else if (job.stopAt && now >= *job.stopAt && job.fd >= 0 && !job.error) {
+                // Reaped on a later pass, like any other exit
+                kill(-job.pid, SIGKILL);
+                closeOutput(job);
+                job.result.stoppedEarly = true;
+            } else if (now >= job.deadline && !job.error) {
+                fail(job, "Command timed out");
+            }
+            ++it;
+        }
+    }
+
+    // Shutting down: nothing may outlive the reactor
+    adopt();
+    for (auto& [key, job] : active) {
+        if (job->fd >= 0 || !reap(*job, false)) {
+            fail(*job, "Process reactor shut down");
+            reap(*job, true);
+        }
+        finish(std::move(job));
+    }
+}
+
+#else
+
+void ProcessReactor::submit(const std::string& command, std::chrono::milliseconds timeout,
+                            Completion completion, const CancellationToken& cancel,
+                            ProcessExecutor::OutputObserver observer,
+                            std::optional<Clock::time_point> deadline) {
+    ++running;
+    post([this, command, timeout, completion = std::move(completion), cancel,
+          observer = std::move(observer), deadline]() {
+        ProcessExecutor::ExecutionResult result{};
+        std::exception_ptr error;
+        try {
+            result = ProcessExecutor::execute(command, timeout, cancel, observer, deadline);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        --running;
+        completion(std::move(result), error);
+    });
+}
+
+void ProcessReactor::wake() {}
+
+void ProcessReactor::reactorLoop() {}
+
+#endif
+
+}
@@ -0,0 +1,120 @@
+#include "metta_inference/request_coalescer.hpp"
+#include "metta_inference/scenario_partitioner.hpp"
+#include <unordered_set>
+#include <set>
+#include <cctype>
+
+namespace metta_inference {
+
+namespace {
+
+bool isAtomDelimiter(char c) {
+    return c == '(' || c == ')' || c == '[' || c == ']' || c == '"' ||
+           std::isspace(static_cast<unsigned char>(c));
+}
+
+// Appends suffix to every atom of expression that is in names; sets
+// renamed when there was one
+std::string renameAtoms(const std::string& expression, const std::unordered_set<std::string>& names,
+                        const std::string& suffix, bool* renamed = nullptr) {
+    std::string result;
+    result.reserve(expression.size() + 64);
+    size_t i = 0;
+    while (i < expression.size()) {
+        char c = expression[i];
+        if (c == '"') {
+            size_t end = i + 1;
+            while (end < expression.size() && expression[end] != '"') {
+                end += expression[end] == '\\' ? 2 : 1;
+            }
+            end = std::min(end + 1, expression.size());
+            result.append(expression, i, end - i);
+            i = end;
+            continue;
+        }
+        if (c == ';') {
+            // Rule bodies keep commented-out lines
+            size_t end = expression.find('\n', i);
+            if (end == std::string::npos) end = expression.size();
+            result.append(expression, i, end - i);
+            i = end;
+            continue;
+        }
+        if (isAtomDelimiter(c)) {
+            result.push_back(c);
+            ++i;
+            continue;
+        }
+
+        size_t end = i;
+        while (end < expression.size() && !isAtomDelimiter(expression[end]) && expression[end] != ';') ++end;
+        std::string atom = expression.substr(i, end - i);
+        result += atom;
+        if (names.count(atom)) {
+            result += suffix;
+            if (renamed) *renamed = true;
+        }
+        i = end;
+    }
+    return result;
+}
+
+}
+
+std::string sharedDefinitions(const std::string& example) {
+    auto entities = ScenarioPartitioner::linkingEntities(example);
+    std::set<std::string> shared;
+    for (const auto& expression : ScenarioPartitioner::splitExpressions(example)) {
+        if (expression.query) continue;
+        bool renamed = false;
+        renameAtoms(expression.text, entities, "", &renamed);
+        if (!renamed) {
+            shared.insert(expression.text);
+        }
+    }
+
+    std::string key;
+    for (const auto& text : shared) {
+        key += text;
+        key += '\n';
+    }
+    return key;
+}
+
+CoalescedBatch coalesceExamples(const std::vector<std::string>& examples) {
+    CoalescedBatch batch;
+    size_t totalSize = 0;
+    for (const auto& example : examples) {
+        totalSize += example.size() + 64;
+    }
+    batch.content.reserve(totalSize);
+
+    // Examples usually repeat each other's rules; a definition added twice
+    // would make every later query answer twice
+    std::unordered_set<std::string> definitions;
+
+    for (size_t i = 0; i < examples.size(); ++i) {
+        std::string suffix = "__cq" + std::to_string(i);
+        auto entities = ScenarioPartitioner::linkingEntities(examples[i]);
+
+        size_t queries = 0;
+        batch.content += "; Coalesced request " + std::to_string(i + 1) + "\n";
+        for (const auto& expression : ScenarioPartitioner::splitExpressions(examples[i])) {
+            std::string text = renameAtoms(expression.text, entities, suffix);
+            if (expression.query) {
+                ++queries;
+            } else if (!definitions.insert(text).second) {
+                continue;
+            }
+            batch.content += text;
+            batch.content += '\n';
+        }
+        batch.content += '\n';
+
+        batch.layout.namespaces.push_back(std::move(suffix));
+        batch.layout.queryCounts.push_back(queries);
+    }
+    return batch;
+}
+
+}
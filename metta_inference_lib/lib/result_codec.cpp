@@ -0,0 +1,435 @@
+#include "metta_inference/result_codec.hpp"
+#include <unordered_map>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+
+namespace metta_inference {
+
+namespace {
+
+constexpr char MAGIC[4] = {'M', 'T', 'R', 'B'};
+constexpr size_t HEADER_SIZE = 32;
+constexpr size_t COUNTS_SIZE = 6 * 4;
+constexpr size_t RECORD_SIZE = 20;
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void putF64(std::string& out, double value) {
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value));
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU32(out, static_cast<uint32_t>(bits));
+    putU32(out, static_cast<uint32_t>(bits >> 32));
+}
+
+uint16_t getU16(const char* p) {
+    auto b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint16_t>(b[0] | (b[1] << 8));
+}
+
+uint32_t getU32(const char* p) {
+    auto b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+           (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+double getF64(const char* p) {
+    uint64_t bits = static_cast<uint64_t>(getU32(p)) | (static_cast<uint64_t>(getU32(p + 4)) << 32);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Builds the string table and record list, then lays them out in one pass
+class Encoder {
+public:
+    explicit Encoder(ResultCodec::Kind kind) : kind(kind) {}
+
+    uint32_t intern(const std::string& text) {
+        if (text.empty()) return ResultCodec::NO_STRING;
+        auto it = index.find(text);
+        if (it != index.end()) return it->second;
+
+        uint32_t id = static_cast<uint32_t>(offsets.size());
+        offsets.push_back(static_cast<uint32_t>(blob.size()));
+        blob.append(text);
+        // Key views into the blob would dangle on reallocation; own the key
+        index.emplace(text, id);
+        return id;
+    }
+
+    void add(ResultCodec::RecordType type, uint8_t flags,
+             const std::string& a = {}, const std::string& b = {},
+             const std::string& c = {}, const std::string& d = {}) {
+        records.push_back({static_cast<uint8_t>(type), flags,
+                           {intern(a), intern(b), intern(c), intern(d)}});
+    }
+
+    void setCounts(const Metrics& metrics) {
+        counts[0] = metrics.contradictions;
+        counts[1] = metrics.contradictionPairs;
+        counts[2] = metrics.compliances;
+        counts[3] = metrics.conflicts;
+        counts[4] = metrics.violations;
+        counts[5] = metrics.inferredFacts;
+        if (metrics.partial) {
+            flags |= ResultCodec::FLAG_PARTIAL;
+            coverage = metrics.coverage;
+        }
+    }
+
+    void setFlag(uint32_t flag) { flags |= flag; }
+
+    void write(OutputSink& sink) const {
+        std::string head;
+        head.reserve(HEADER_SIZE + COUNTS_SIZE + (offsets.size() + 1) * 4);
+        head.append(MAGIC, sizeof(MAGIC));
+        putU16(head, ResultCodec::VERSION);
+        putU16(head, static_cast<uint16_t>(kind));
+        putU32(head, static_cast<uint32_t>(offsets.size()));
+        putU32(head, static_cast<uint32_t>(blob.size()));
+        putU32(head, static_cast<uint32_t>(records.size()));
+        putU32(head, flags);
+        putF64(head, coverage);
+        for (int32_t count : counts) {
+            putU32(head, static_cast<uint32_t>(count));
+        }
+        for (uint32_t offset : offsets) {
+            putU32(head, offset);
+        }
+        putU32(head, static_cast<uint32_t>(blob.size()));
+        sink.write(head);
+
+        std::string table;
+        table.reserve(records.size() * RECORD_SIZE);
+        for (const auto& record : records) {
+            table.push_back(static_cast<char>(record.type));
+            table.push_back(static_cast<char>(record.flags));
+            putU16(table, 0);
+            for (uint32_t field : record.fields) {
+                putU32(table, field);
+            }
+        }
+        sink.write(table);
+        sink.write(blob);
+    }
+
+private:
+    struct PendingRecord {
+        uint8_t type;
+        uint8_t flags;
+        uint32_t fields[4];
+    };
+
+    ResultCodec::Kind kind;
+    int32_t counts[6] = {};
+    uint32_t flags = 0;
+    double coverage = 1.0;
+    std::unordered_map<std::string, uint32_t> index;
+    std::vector<uint32_t> offsets;
+    std::string blob;
+    std::vector<PendingRecord> records;
+};
+
+void addStateOfAffairs(Encoder& encoder, const StateOfAffairs& soa) {
+    encoder.add(ResultCodec::RecordType::StateOfAffairs, soa.exists ? 1 : 0,
+                soa.entity, soa.action, soa.agent, soa.instrument);
+    for (const auto& [key, value] : soa.properties) {
+        encoder.add(ResultCodec::RecordType::Property, 0, key, value);
+    }
+}
+
+}
+
+// ResultCodec implementation
+void ResultCodec::encodeTo(const Metrics& metrics, OutputSink& sink, bool renderDescriptions) {
+    Encoder encoder(Kind::Metrics);
+    encoder.setCounts(metrics);
+
+    // Without rendering only the stored text is encoded
+    const bool render = renderDescriptions || !metrics.describer;
+    if (!render) {
+        encoder.setFlag(FLAG_DESCRIPTIONS_OMITTED);
+    }
+
+    for (const auto& fact : metrics.inferredStateOfAffairs) {
+        encoder.add(RecordType::InferredFact, 0, fact);
+    }
+    for (size_t i = 0; i < metrics.contradictionDetails.size(); ++i) {
+        const auto& detail = metrics.contradictionDetails[i];
+        encoder.add(RecordType::Contradiction, 0, detail.entity1, detail.entity2,
+                    render ? metrics.contradictionDescription(i) : detail.description);
+    }
+    for (size_t i = 0; i < metrics.conflictDetails.size(); ++i) {
+        const auto& detail = metrics.conflictDetails[i];
+        encoder.add(RecordType::Conflict, 0, detail.entity1, detail.entity2,
+                    render ? metrics.conflictDescription(i) : detail.description);
+    }
+    for (size_t i = 0; i < metrics.violationDetails.size(); ++i) {
+        const auto& detail = metrics.violationDetails[i];
+        encoder.add(RecordType::Violation, 0, detail.violator, detail.violated_rule,
+                    render ? metrics.violationDescription(i) : detail.description);
+    }
+
+    encoder.write(sink);
+}
+
+void ResultCodec::encodeTo(const SemanticAnalyzer::AnalysisResult& result, OutputSink& sink) {
+    Encoder encoder(Kind::Analysis);
+
+    // Counts follow toMetrics() so readers can summarize without a walk
+    Metrics counts;
+    counts.inferredFacts = static_cast<int>(result.inferredFacts.size());
+    counts.contradictions = static_cast<int>(result.contradictions.size());
+    counts.contradictionPairs = counts.contradictions;
+    counts.conflicts = static_cast<int>(result.conflicts.size());
+    counts.violations = static_cast<int>(result.violations.size());
+    counts.compliances = static_cast<int>(result.compliances.size());
+    encoder.setCounts(counts);
+
+    for (const auto& fact : result.inferredFacts) {
+        addStateOfAffairs(encoder, fact);
+    }
+    for (const auto& contradiction : result.contradictions) {
+        encoder.add(RecordType::LogicalContradiction, 0, contradiction.type);
+        addStateOfAffairs(encoder, contradiction.positive);
+        addStateOfAffairs(encoder, contradiction.negative);
+    }
+    for (const auto& conflict : result.conflicts) {
+        encoder.add(RecordType::RegulatoryConflict, 0, conflict.regulation1, conflict.regulation2,
+                    conflict.conflictingRequirement, conflict.affectedEntity);
+    }
+    for (const auto& violation : result.violations) {
+        encoder.add(RecordType::NecessaryViolation, 0, violation.violatedRule,
+                    violation.violator, violation.reason);
+    }
+    for (const auto& compliance : result.compliances) {
+        encoder.add(RecordType::Compliance, 0, compliance.entity, compliance.obligation,
+                    compliance.fulfilledBy);
+    }
+
+    encoder.write(sink);
+}
+
+std::string ResultCodec::encode(const Metrics& metrics, bool renderDescriptions) {
+    std::string out;
+    StringSink sink(out);
+    encodeTo(metrics, sink, renderDescriptions);
+    return out;
+}
+
+std::string ResultCodec::encode(const SemanticAnalyzer::AnalysisResult& result) {
+    std::string out;
+    StringSink sink(out);
+    encodeTo(result, sink);
+    return out;
+}
+
+bool ResultCodec::isEncoded(std::string_view data) {
+    return data.size() >= sizeof(MAGIC) && std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// ResultReader implementation
+ResultReader::ResultReader(std::string_view buffer) : data(buffer) {
+    if (!ResultCodec::isEncoded(data) || data.size() < HEADER_SIZE + COUNTS_SIZE) {
+        throw std::runtime_error("Not an encoded inference result");
+    }
+
+    const char* p = data.data();
+    dataVersion = getU16(p + 4);
+    if (dataVersion != ResultCodec::VERSION) {
+        throw std::runtime_error("Unsupported result encoding version: " + std::to_string(dataVersion));
+    }
+
+    uint16_t kindValue = getU16(p + 6);
+    if (kindValue != static_cast<uint16_t>(ResultCodec::Kind::Metrics) &&
+        kindValue != static_cast<uint16_t>(ResultCodec::Kind::Analysis)) {
+        throw std::runtime_error("Unknown result kind: " + std::to_string(kindValue));
+    }
+    dataKind = static_cast<ResultCodec::Kind>(kindValue);
+
+    strings = getU32(p + 8);
+    uint32_t stringBytes = getU32(p + 12);
+    records = getU32(p + 16);
+    dataFlags = getU32(p + 20);
+    dataCoverage = getF64(p + 24);
+
+    for (size_t i = 0; i < 6; ++i) {
+        counts[i] = static_cast<int32_t>(getU32(p + HEADER_SIZE + i * 4));
+    }
+
+    // 64-bit arithmetic so hostile counts cannot wrap the size check
+    uint64_t expected = HEADER_SIZE + COUNTS_SIZE +
+                        (static_cast<uint64_t>(strings) + 1) * 4 +
+                        static_cast<uint64_t>(records) * RECORD_SIZE + stringBytes;
+    if (expected != data.size()) {
+        throw std::runtime_error("Truncated or oversized result encoding");
+    }
+
+    offsetTable = p + HEADER_SIZE + COUNTS_SIZE;
+    recordTable = offsetTable + (static_cast<size_t>(strings) + 1) * 4;
+    stringBlob = recordTable + static_cast<size_t>(records) * RECORD_SIZE;
+
+    // Offsets must be monotonic and end at the blob size
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i <= strings; ++i) {
+        uint32_t offset = getU32(offsetTable + i * 4);
+        if (offset < previous || offset > stringBytes) {
+            throw std::runtime_error("Corrupt string table in result encoding");
+        }
+        previous = offset;
+    }
+    if (previous != stringBytes) {
+        throw std::runtime_error("Corrupt string table in result encoding");
+    }
+
+    for (uint32_t i = 0; i < records; ++i) {
+        const char* record = recordTable + static_cast<size_t>(i) * RECORD_SIZE;
+        for (size_t f = 0; f < 4; ++f) {
+            uint32_t ref = getU32(record + 4 + f * 4);
+            if (ref != ResultCodec::NO_STRING && ref >= strings) {
+                throw std::runtime_error("Record references a missing string");
+            }
+        }
+    }
+}
+
+std::string_view ResultReader::string(uint32_t index) const {
+    if (index == ResultCodec::NO_STRING || index >= strings) return {};
+    uint32_t begin = getU32(offsetTable + index * 4);
+    uint32_t end = getU32(offsetTable + (index + 1) * 4);
+    return std::string_view(stringBlob + begin, end - begin);
+}
+
+ResultReader::Record ResultReader::record(size_t index) const {
+    if (index >= records) {
+        throw std::out_of_range("Record index out of range");
+    }
+    return Record(this, recordTable + index * RECORD_SIZE);
+}
+
+ResultCodec::RecordType ResultReader::Record::type() const {
+    return static_cast<ResultCodec::RecordType>(static_cast<uint8_t>(data[0]));
+}
+
+uint8_t ResultReader::Record::flags() const {
+    return static_cast<uint8_t>(data[1]);
+}
+
+std::string_view ResultReader::Record::field(size_t index) const {
+    if (index >= 4) return {};
+    return reader->string(getU32(data + 4 + index * 4));
+}
+
+Metrics ResultReader::toMetrics() const {
+    Metrics metrics;
+    metrics.contradictions = contradictions();
+    metrics.contradictionPairs = contradictionPairs();
+    metrics.compliances = compliances();
+    metrics.conflicts = conflicts();
+    metrics.violations = violations();
+    metrics.inferredFacts = inferredFacts();
+    metrics.partial = partial();
+    metrics.coverage = partial() ? coverage() : 1.0;
+
+    for (size_t i = 0; i < records; ++i) {
+        auto rec = record(i);
+        switch (rec.type()) {
+            case ResultCodec::RecordType::InferredFact:
+                metrics.inferredStateOfAffairs.emplace_back(rec.field(0));
+                break;
+            case ResultCodec::RecordType::Contradiction:
+                metrics.contradictionDetails.push_back({std::string(rec.field(0)),
+                    std::string(rec.field(1)), std::string(rec.field(2))});
+                break;
+            case ResultCodec::RecordType::Conflict:
+                metrics.conflictDetails.push_back({std::string(rec.field(0)),
+                    std::string(rec.field(1)), std::string(rec.field(2))});
+                break;
+            case ResultCodec::RecordType::Violation:
+                metrics.violationDetails.push_back({std::string(rec.field(0)),
+                    std::string(rec.field(1)), std::string(rec.field(2))});
+                break;
+            default:
+                // Analysis records carry no Metrics details of their own
+                break;
+        }
+    }
+
+    return metrics;
+}
+
+SemanticAnalyzer::AnalysisResult ResultReader::toAnalysisResult() const {
+    if (dataKind != ResultCodec::Kind::Analysis) {
+        throw std::runtime_error("Encoded result holds Metrics, not an analysis result");
+    }
+
+    SemanticAnalyzer::AnalysisResult result;
+
+    auto readStateOfAffairs = [this](size_t& i, StateOfAffairs& soa) {
+        if (i >= records || record(i).type() != ResultCodec::RecordType::StateOfAffairs) {
+            throw std::runtime_error("Expected a state of affairs record");
+        }
+        auto rec = record(i++);
+        soa.entity = rec.field(0);
+        soa.action = rec.field(1);
+        soa.agent = rec.field(2);
+        soa.instrument = rec.field(3);
+        soa.exists = (rec.flags() & 1) != 0;
+        while (i < records && record(i).type() == ResultCodec::RecordType::Property) {
+            auto prop = record(i++);
+            soa.properties.emplace(std::string(prop.field(0)), std::string(prop.field(1)));
+        }
+    };
+
+    size_t i = 0;
+    while (i < records) {
+        auto rec = record(i);
+        switch (rec.type()) {
+            case ResultCodec::RecordType::StateOfAffairs: {
+                StateOfAffairs soa;
+                readStateOfAffairs(i, soa);
+                result.inferredFacts.push_back(std::move(soa));
+                continue;
+            }
+            case ResultCodec::RecordType::LogicalContradiction: {
+                LogicalContradiction contradiction;
+                contradiction.type = rec.field(0);
+                ++i;
+                readStateOfAffairs(i, contradiction.positive);
+                readStateOfAffairs(i, contradiction.negative);
+                result.contradictions.push_back(std::move(contradiction));
+                continue;
+            }
+            case ResultCodec::RecordType::RegulatoryConflict:
+                result.conflicts.push_back({std::string(rec.field(0)), std::string(rec.field(1)),
+                                            std::string(rec.field(2)), std::string(rec.field(3))});
+                break;
+            case ResultCodec::RecordType::NecessaryViolation:
+                result.violations.push_back({std::string(rec.field(0)), std::string(rec.field(1)),
+                                             std::string(rec.field(2))});
+                break;
+            case ResultCodec::RecordType::Compliance:
+                result.compliances.push_back({std::string(rec.field(0)), std::string(rec.field(1)),
+                                              std::string(rec.field(2))});
+                break;
+            default:
+                throw std::runtime_error("Unexpected record in analysis result");
+        }
+        ++i;
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,314 @@
+#include "metta_inference/scenario_generator.hpp"
+#include "metta_inference/knowledge_io.hpp"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+#include <map>
+#include <unordered_map>
+#include <iterator>
+
+namespace metta_inference {
+
+namespace {
+
+// Vessel name words; VICTOR is left out because every agent's initials
+// already start with 'v' (VESSEL), which keeps negation names unambiguous
+const char* const VESSEL_WORDS[] = {
+    "ALPHA", "BRAVO", "CHARLIE", "DELTA", "ECHO", "FOXTROT", "GOLF", "HOTEL",
+    "INDIA", "JULIETT", "KILO", "LIMA", "MIKE", "NOVEMBER", "OSCAR", "PAPA",
+    "QUEBEC", "ROMEO", "SIERRA", "TANGO", "UNIFORM", "WHISKEY", "XRAY",
+    "YANKEE", "ZULU"
+};
+constexpr size_t VESSEL_WORD_COUNT = sizeof(VESSEL_WORDS) / sizeof(VESSEL_WORDS[0]);
+
+// Role fillers that are not vessels
+const char* const BERTHS[] = {"soa_berthMICT", "soa_berthJNPT", "soa_berthCHEN", "soa_berthKOLK"};
+const char* const TREASURIES[] = {"soa_sptMICT", "soa_sptJNPT", "soa_sptCHEN", "soa_sptKOLK"};
+const char* const INSTRUMENTS[] = {"soa_INRS", "soa_EURS", "soa_USDS", "soa_AEDS"};
+
+// Portable, seed-stable uniform double in [0, 1); std::uniform_real_distribution
+// output differs between standard library implementations
+double uniform(std::mt19937_64& rng) {
+    return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+size_t uniformIndex(std::mt19937_64& rng, size_t bound) {
+    return static_cast<size_t>(rng() % bound);
+}
+
+std::string letters(size_t index) {
+    std::string result;
+    do {
+        result.insert(result.begin(), static_cast<char>('a' + index % 26));
+        index /= 26;
+    } while (index > 0);
+    return result;
+}
+
+std::string typeInitial(const std::string& type) {
+    if (type.size() > 3 && type.compare(0, 3, "soa") == 0) {
+        return std::string(1, static_cast<char>(std::tolower(type[3])));
+    }
+    return type.empty() ? "x" : std::string(1, static_cast<char>(std::tolower(type[0])));
+}
+
+// Agent initials per Eventuality::getExpectedName: first letter of each word
+std::string agentInitials(size_t vesselIndex) {
+    std::string result = "v";
+    std::string digits;
+    do {
+        digits.insert(digits.begin(),
+                      static_cast<char>(std::tolower(VESSEL_WORDS[vesselIndex % VESSEL_WORD_COUNT][0])));
+        vesselIndex /= VESSEL_WORD_COUNT;
+    } while (vesselIndex > 0);
+    return result + digits;
+}
+
+std::vector<std::string> readDefinitions(const fs::path& file, const std::string& head) {
+    std::vector<std::string> values;
+    std::ifstream in(file);
+    if (!in.is_open()) return values;
+
+    // Matches lines of the form "(= (ct-Eventuality) soaMoor)"
+    std::string prefix = "(= (" + head + ")";
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, prefix.size(), prefix) != 0) continue;
+
+        std::istringstream rest(line.substr(start + prefix.size()));
+        std::string value;
+        rest >> value;
+        while (!value.empty() && value.back() == ')') value.pop_back();
+        if (!value.empty() && std::find(values.begin(), values.end(), value) == values.end()) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+}
+
+ScenarioGenerator::Ontology ScenarioGenerator::defaultOntology() {
+    Ontology ontology;
+
+    // Only eventuality types proper, not the entity types mixed into the validation set
+    for (const auto& type : KnowledgeIO::getValidEventualityTypes()) {
+        if (type.size() > 3 && type.compare(0, 3, "soa") == 0 && type[3] != '_' &&
+            type != "soaContainerVessel") {
+            ontology.eventualityTypes.push_back(type);
+        }
+    }
+    ontology.roles.assign(KnowledgeIO::getValidRoles().begin(), KnowledgeIO::getValidRoles().end());
+    return ontology;
+}
+
+ScenarioGenerator::Ontology ScenarioGenerator::loadOntology(const fs::path& knowledgeDir) {
+    Ontology ontology;
+    ontology.eventualityTypes = readDefinitions(knowledgeDir / "eventuality.metta", "ct-Eventuality");
+    ontology.roles = readDefinitions(knowledgeDir / "role.metta", "ct-ThematicRole");
+
+    if (ontology.eventualityTypes.empty() || ontology.roles.empty()) {
+        std::cerr << "Warning: Ontology not found in " << knowledgeDir
+                  << ", using built-in eventuality types and roles\n";
+        auto fallback = defaultOntology();
+        if (ontology.eventualityTypes.empty()) ontology.eventualityTypes = fallback.eventualityTypes;
+        if (ontology.roles.empty()) ontology.roles = fallback.roles;
+    }
+    return ontology;
+}
+
+ScenarioGenerator::ScenarioGenerator(Ontology ontology, Options options)
+    : ontology(std::move(ontology)), options(options) {}
+
+std::string ScenarioGenerator::vesselName(size_t index) {
+    std::string digits;
+    do {
+        std::string word = VESSEL_WORDS[index % VESSEL_WORD_COUNT];
+        digits = digits.empty() ? word : word + "_" + digits;
+        index /= VESSEL_WORD_COUNT;
+    } while (index > 0);
+    return "soa_VESSEL_" + digits;
+}
+
+ScenarioGenerator::Stats ScenarioGenerator::generate(std::ostream& out) const {
+    if (options.vessels == 0) {
+        throw std::invalid_argument("At least one vessel is required");
+    }
+    if (ontology.eventualityTypes.empty()) {
+        throw std::invalid_argument("Ontology has no eventuality types");
+    }
+    for (double ratio : {options.negationRatio, options.disjunctionRatio,
+                         options.obligationRatio, options.contradictionRatio}) {
+        if (ratio < 0.0 || ratio > 1.0) {
+            throw std::invalid_argument("Ratios must be between 0 and 1");
+        }
+    }
+
+    // Eventuality names follow soa_e<type initial><agent initials>, so each
+    // (initial, vessel) pair can be used once
+    std::map<std::string, std::vector<std::string>> typesByInitial;
+    for (const auto& type : ontology.eventualityTypes) {
+        typesByInitial[typeInitial(type)].push_back(type);
+    }
+    std::vector<std::string> initials;
+    for (const auto& [initial, types] : typesByInitial) {
+        initials.push_back(initial);
+    }
+
+    size_t capacity = initials.size() * options.vessels;
+    if (options.eventualities > capacity) {
+        throw std::invalid_argument("Cannot name " + std::to_string(options.eventualities) +
+                                    " eventualities uniquely with " + std::to_string(options.vessels) +
+                                    " vessels (max " + std::to_string(capacity) + "); add vessels");
+    }
+
+    std::vector<std::string> roles;
+    for (const auto& role : ontology.roles) {
+        if (role != "soaHas_agent") roles.push_back(role);
+    }
+
+    std::mt19937_64 rng(options.seed);
+    Stats stats;
+    stats.vessels = options.vessels;
+
+    auto fact = [&](const std::string& subject, const std::string& predicate, const std::string& object) {
+        out << "(ct-triple " << subject << " " << predicate << " " << object << ")\n";
+        stats.facts++;
+    };
+
+    out << "; Synthetic state of affairs generated by metta_scenario_gen\n"
+        << "; vessels=" << options.vessels << " eventualities=" << options.eventualities
+        << " negations=" << options.negationRatio << " disjunctions=" << options.disjunctionRatio
+        << " obligations=" << options.obligationRatio << " contradictions=" << options.contradictionRatio
+        << " seed=" << options.seed << "\n\n";
+
+    out << "; Vessels\n";
+    for (size_t v = 0; v < options.vessels; ++v) {
+        fact(vesselName(v), "type", "soaContainerVessel");
+    }
+    out << "\n";
+
+    out << "; Port infrastructure\n";
+    for (size_t i = 0; i < std::size(BERTHS); ++i) {
+        fact(BERTHS[i], "type", "soa_mooringBerth");
+        fact(TREASURIES[i], "soa_associated-with", BERTHS[i]);
+    }
+    out << "\n";
+
+    // Sparse Fisher-Yates over the slot space: memory is O(M), not O(capacity)
+    std::unordered_map<size_t, size_t> swapped;
+    auto slotAt = [&](size_t i) {
+        auto it = swapped.find(i);
+        return it == swapped.end() ? i : it->second;
+    };
+
+    std::vector<std::string> disjunctionCandidates;
+    out << "; Eventualities\n";
+
+    for (size_t i = 0; i < options.eventualities; ++i) {
+        size_t j = i + uniformIndex(rng, capacity - i);
+        size_t slot = slotAt(j);
+        swapped[j] = slotAt(i);
+
+        size_t initialIndex = slot % initials.size();
+        size_t vessel = slot / initials.size();
+        const auto& initial = initials[initialIndex];
+        const auto& candidates = typesByInitial[initial];
+        const auto& type = candidates[uniformIndex(rng, candidates.size())];
+
+        std::string suffix = initial + agentInitials(vessel);
+        std::string name = "soa_e" + suffix;
+        std::string negationName = "soa_en" + suffix;
+
+        // Each eventuality is exactly one of: obligation, contradiction, plain negation, fact
+        double draw = uniform(rng);
+        bool obligation = draw < options.obligationRatio;
+        bool contradiction = !obligation && draw < options.obligationRatio + options.contradictionRatio;
+        bool negated = !obligation && !contradiction &&
+                       draw < options.obligationRatio + options.contradictionRatio + options.negationRatio;
+
+        fact(name, "type", type);
+        if (obligation) {
+            fact(name, "type", "obligatory");
+            stats.obligations++;
+        } else if (!negated) {
+            fact(name, "type", "rexist");
+        }
+        fact(name, "soaHas_agent", vesselName(vessel));
+
+        // Distinct roles: a partial shuffle moves the picks to the front
+        size_t roleCount = roles.empty() ? 0 : std::min(uniformIndex(rng, 3), roles.size());
+        for (size_t r = 0; r < roleCount; ++r) {
+            std::swap(roles[r], roles[r + uniformIndex(rng, roles.size() - r)]);
+            const auto& role = roles[r];
+            size_t pick = uniformIndex(rng, std::size(BERTHS));
+            if (role == "soaHas_amount") {
+                fact(name, role, "(" + std::to_string(1000 * (1 + uniformIndex(rng, 50))) + "USD)");
+            } else if (role == "soaHas_instrument") {
+                fact(name, role, INSTRUMENTS[pick]);
+            } else if (role.find("time") != std::string::npos || role == "soaHas_duration") {
+                fact(name, role, "(" + std::to_string(1 + uniformIndex(rng, 72)) + "h)");
+            } else if (role == "soaHas_goal" || role == "soaHas_beneficiary") {
+                fact(name, role, TREASURIES[pick]);
+            } else {
+                fact(name, role, BERTHS[pick]);
+            }
+        }
+
+        if (contradiction || negated) {
+            out << "(ct-simple-not " << negationName << " " << name << ")\n";
+            fact(negationName, "type", "rexist");
+            if (contradiction) {
+                stats.contradictions++;
+            } else {
+                stats.negations++;
+            }
+        }
+
+        if (!obligation && !negated && uniform(rng) < options.disjunctionRatio * 2) {
+            disjunctionCandidates.push_back(name);
+        }
+
+        stats.eventualities++;
+        out << "\n";
+    }
+
+    // Pair up asserted eventualities; "x" after "soa_eo" keeps names apart
+    // from eventualities of an o-initial type (whose agent part starts with 'v')
+    if (disjunctionCandidates.size() >= 2) {
+        out << "; Disjunctions\n";
+        for (size_t i = 0; i + 1 < disjunctionCandidates.size(); i += 2) {
+            std::string name = "soa_eox" + letters(stats.disjunctions);
+            fact(name, "type", "rexist");
+            out << "(= (ct-or " << name << ") (" << disjunctionCandidates[i] << " "
+                << disjunctionCandidates[i + 1] << "))\n";
+            stats.disjunctions++;
+        }
+        out << "\n";
+    }
+
+    if (options.includeQueries) {
+        out << "; Init\n"
+            << "!(make-triples)\n\n"
+            << "; check\n"
+            << "!(is_in_contradiction_with $a $b)\n"
+            << "!(let $r (is-in-conflict-with $a $b) $r)\n";
+    }
+
+    return stats;
+}
+
+ScenarioGenerator::Stats ScenarioGenerator::generateToFile(const fs::path& filepath) const {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot create file: " + filepath.string());
+    }
+    return generate(file);
+}
+
+}
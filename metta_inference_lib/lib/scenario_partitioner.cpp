@@ -0,0 +1,509 @@
+#include "metta_inference/scenario_partitioner.hpp"
+#include "metta_inference/knowledge_io.hpp"
+#include "metta_inference/sexpr_parser.hpp"
+#include "metta_inference/formatters.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <numeric>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <exception>
+#include <unistd.h>
+
+namespace metta_inference {
+
+namespace {
+
+// One top-level expression of the source file, kept verbatim
+struct Item {
+    std::string text;
+    bool query = false;
+
+    enum class Kind { Shared, Fact, Negation, Logical } kind = Kind::Shared;
+    std::vector<std::string> atoms;  // Names the expression refers to
+    std::string predicate;           // Facts only
+    std::string object;              // Facts only, when the object is an atom
+};
+
+std::vector<Item> splitTopLevel(const std::string& content) {
+    std::vector<Item> items;
+    size_t i = 0;
+    const size_t n = content.size();
+
+    auto skipComment = [&]() {
+        while (i < n && content[i] != '\n') ++i;
+    };
+
+    while (i < n) {
+        char c = content[i];
+        if (std::isspace(static_cast<unsigned char>(c))) { ++i; continue; }
+        if (c == ';') { skipComment(); continue; }
+
+        Item item;
+        size_t start = i;
+        if (c == '!') {
+            item.query = true;
+            ++i;
+            while (i < n && std::isspace(static_cast<unsigned char>(content[i]))) ++i;
+        }
+
+        if (i < n && content[i] == '(') {
+            // Rule bodies contain commented-out lines with parentheses
+            int depth = 0;
+            bool inString = false;
+            while (i < n) {
+                char ch = content[i];
+                if (inString) {
+                    if (ch == '\\') ++i;
+                    else if (ch == '"') inString = false;
+                } else if (ch == '"') {
+                    inString = true;
+                } else if (ch == ';') {
+                    skipComment();
+                    continue;
+                } else if (ch == '(') {
+                    ++depth;
+                } else if (ch == ')') {
+                    if (--depth == 0) { ++i; break; }
+                }
+                ++i;
+            }
+        } else {
+            while (i < n && !std::isspace(static_cast<unsigned char>(content[i]))) ++i;
+        }
+
+        item.text = content.substr(start, i - start);
+        items.push_back(std::move(item));
+    }
+    return items;
+}
+
+void classify(Item& item) {
+    if (item.query) return;
+
+    std::shared_ptr<SExpr> expr;
+    try {
+        expr = SExprParser::parse(item.text);
+    } catch (const std::exception&) {
+        return;  // Leave anything unparseable in every shard
+    }
+    if (!expr || !expr->isList() || expr->asList().empty()) return;
+
+    const auto& list = expr->asList();
+    auto head = list[0]->getSymbol();
+    if (!head) return;
+
+    if ((*head == "ct-triple" || *head == "meta-triple") && list.size() >= 4) {
+        item.kind = Item::Kind::Fact;
+        for (size_t k = 1; k < list.size(); ++k) {
+            if (auto atom = list[k]->getSymbol()) item.atoms.push_back(*atom);
+        }
+        if (auto predicate = list[list.size() - 2]->getSymbol()) item.predicate = *predicate;
+        if (auto object = list.back()->getSymbol()) item.object = *object;
+    } else if (*head == "ct-simple-not" && list.size() == 3) {
+        item.kind = Item::Kind::Negation;
+        for (size_t k = 1; k < list.size(); ++k) {
+            if (auto atom = list[k]->getSymbol()) item.atoms.push_back(*atom);
+        }
+    } else if (*head == "=" && list.size() == 3 && list[1]->isList() && list[2]->isList()) {
+        // (= (ct-or soa_eo) (soa_elam soa_ea))
+        const auto& op = list[1]->asList();
+        auto opName = op.empty() ? std::nullopt : op[0]->getSymbol();
+        if (opName && (*opName == "ct-or" || *opName == "ct-and") && op.size() == 2) {
+            item.kind = Item::Kind::Logical;
+            if (auto name = op[1]->getSymbol()) item.atoms.push_back(*name);
+            for (const auto& operand : list[2]->asList()) {
+                if (auto atom = operand->getSymbol()) item.atoms.push_back(*atom);
+            }
+        }
+    }
+}
+
+class UnionFind {
+public:
+    size_t add(const std::string& name) {
+        auto [it, inserted] = ids.emplace(name, parent.size());
+        if (inserted) parent.push_back(parent.size());
+        return it->second;
+    }
+
+    std::optional<size_t> lookup(const std::string& name) const {
+        auto it = ids.find(name);
+        if (it == ids.end()) return std::nullopt;
+        return it->second;
+    }
+
+    size_t find(size_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(size_t a, size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+
+    const std::unordered_map<std::string, size_t>& names() const { return ids; }
+
+private:
+    std::unordered_map<std::string, size_t> ids;
+    std::vector<size_t> parent;
+};
+
+// The validation set also lists entity types, which must not link components
+bool isEventualityType(const std::string& type) {
+    return KnowledgeIO::isValidEventualityType(type) && type != "soaContainerVessel" &&
+           type != "soa_mooringBerth" && type != "smartport";
+}
+
+struct LinkingNames {
+    std::unordered_set<std::string> eventualities;
+    std::unordered_set<std::string> agents;
+};
+
+LinkingNames findLinkingNames(const std::vector<Item>& items) {
+    LinkingNames names;
+    for (const auto& item : items) {
+        if (item.kind == Item::Kind::Negation || item.kind == Item::Kind::Logical) {
+            names.eventualities.insert(item.atoms.begin(), item.atoms.end());
+        } else if (item.kind == Item::Kind::Fact && !item.atoms.empty()) {
+            const auto& subject = item.atoms.front();
+            if (item.predicate == "soaHas_agent") {
+                names.eventualities.insert(subject);
+                if (!item.object.empty()) names.agents.insert(item.object);
+            } else if (item.predicate == "type" &&
+                       (KnowledgeIO::isValidModality(item.object) || isEventualityType(item.object))) {
+                names.eventualities.insert(subject);
+            }
+        }
+    }
+    return names;
+}
+
+std::string detailKey(const std::string& a, const std::string& b) {
+    return a + '\x1f' + b;
+}
+
+fs::path makeShardDirectory() {
+    static std::atomic<uint64_t> counter{0};
+    return fs::temp_directory_path() /
+           ("metta_shards_" + std::to_string(getpid()) + "_" + std::to_string(counter.fetch_add(1)));
+}
+
+}
+
+std::vector<ScenarioPartitioner::Shard> ScenarioPartitioner::partition(
+    const std::string& mettaContent, size_t maxShards) {
+
+    auto items = splitTopLevel(mettaContent);
+    for (auto& item : items) classify(item);
+
+    // Pass 1: which names are eventualities and which are agents
+    auto names = findLinkingNames(items);
+    const auto& eventualities = names.eventualities;
+    const auto& agents = names.agents;
+
+    auto linking = [&](const std::string& name) {
+        return eventualities.count(name) > 0 || agents.count(name) > 0;
+    };
+
+    // Pass 2: eventualities joined through agents, references, negations and ct-or/ct-and
+    UnionFind components;
+    for (const auto& item : items) {
+        if (item.kind == Item::Kind::Shared) continue;
+        std::optional<size_t> first;
+        for (const auto& atom : item.atoms) {
+            if (!linking(atom)) continue;
+            size_t id = components.add(atom);
+            if (first) components.unite(*first, id);
+            else first = id;
+        }
+    }
+
+    // Pass 3: owner component of each state of affairs item (none = replicate)
+    std::vector<std::optional<size_t>> owner(items.size());
+    std::unordered_map<size_t, size_t> componentIndex;  // root -> order of first appearance
+    std::vector<size_t> componentSizes;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].kind == Item::Kind::Shared) continue;
+        for (const auto& atom : items[i].atoms) {
+            if (auto id = components.lookup(atom)) {
+                size_t root = components.find(*id);
+                auto [it, inserted] = componentIndex.emplace(root, componentSizes.size());
+                if (inserted) componentSizes.push_back(0);
+                componentSizes[it->second]++;
+                owner[i] = it->second;
+                break;
+            }
+        }
+    }
+
+    size_t componentCount = componentSizes.size();
+    size_t shardCount = componentCount == 0 ? 1 : componentCount;
+    if (maxShards > 0) shardCount = std::min(shardCount, maxShards);
+
+    // Longest-processing-time packing: biggest component to the lightest shard
+    std::vector<size_t> shardOf(componentCount);
+    std::vector<size_t> load(shardCount, 0);
+    if (shardCount == componentCount) {
+        std::iota(shardOf.begin(), shardOf.end(), 0);
+        load = componentSizes;
+    } else {
+        std::vector<size_t> order(componentCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return componentSizes[a] > componentSizes[b];
+        });
+        for (size_t component : order) {
+            size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+            shardOf[component] = target;
+            load[target] += componentSizes[component];
+        }
+    }
+
+    std::vector<Shard> shards(shardCount);
+    for (size_t s = 0; s < shardCount; ++s) {
+        shards[s].index = s;
+        shards[s].factCount = load[s];
+    }
+
+    for (const auto& [name, id] : components.names()) {
+        if (!eventualities.count(name)) continue;
+        auto it = componentIndex.find(components.find(id));
+        if (it != componentIndex.end()) {
+            shards[shardOf[it->second]].eventualities.push_back(name);
+        }
+    }
+
+    for (auto& shard : shards) {
+        std::sort(shard.eventualities.begin(), shard.eventualities.end());
+
+        std::ostringstream out;
+        out << "; Shard " << (shard.index + 1) << "/" << shardCount << " ("
+            << shard.eventualities.size() << " eventualities)\n\n";
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (owner[i] && shardOf[*owner[i]] != shard.index) continue;
+            out << items[i].text << "\n";
+        }
+        shard.content = out.str();
+    }
+
+    return shards;
+}
+
+std::vector<ScenarioPartitioner::Expression> ScenarioPartitioner::splitExpressions(
+    const std::string& mettaContent) {
+    std::vector<Expression> expressions;
+    for (auto& item : splitTopLevel(mettaContent)) {
+        expressions.push_back({std::move(item.text), item.query});
+    }
+    return expressions;
+}
+
+std::unordered_set<std::string> ScenarioPartitioner::linkingEntities(const std::string& mettaContent) {
+    auto items = splitTopLevel(mettaContent);
+    for (auto& item : items) classify(item);
+
+    auto names = findLinkingNames(items);
+    names.eventualities.insert(names.agents.begin(), names.agents.end());
+    return std::move(names.eventualities);
+}
+
+std::vector<ScenarioPartitioner::Shard> ScenarioPartitioner::partitionFile(
+    const fs::path& exampleFile, size_t maxShards) {
+    std::ifstream file(exampleFile);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + exampleFile.string());
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return partition(buffer.str(), maxShards);
+}
+
+Metrics ScenarioPartitioner::mergeMetrics(const std::vector<Metrics>& parts) {
+    Metrics merged;
+    std::unordered_set<std::string> seenInferred;
+    std::unordered_set<std::string> seenContradictions;
+    std::unordered_set<std::string> seenConflicts;
+    std::unordered_set<std::string> seenViolations;
+
+    // Replicated entity facts can make several shards report the same finding
+    for (const auto& part : parts) {
+        merged.compliances += part.compliances;
+        merged.inferredFacts += part.inferredFacts;
+        merged.contradictions += part.contradictions;
+        merged.contradictionPairs += part.contradictionPairs;
+        merged.conflicts += part.conflicts;
+        merged.violations += part.violations;
+
+        for (const auto& fact : part.inferredStateOfAffairs) {
+            if (seenInferred.insert(fact).second) {
+                merged.inferredStateOfAffairs.push_back(fact);
+            } else {
+                merged.inferredFacts--;
+            }
+        }
+        // Lazy descriptions are indexed per part, so render them on the way over
+        for (size_t i = 0; i < part.contradictionDetails.size(); ++i) {
+            const auto& detail = part.contradictionDetails[i];
+            if (seenContradictions.insert(detailKey(detail.entity1, detail.entity2)).second) {
+                merged.contradictionDetails.push_back(detail);
+                merged.contradictionDetails.back().description = part.contradictionDescription(i);
+            } else {
+                merged.contradictions--;
+                merged.contradictionPairs--;
+            }
+        }
+        for (size_t i = 0; i < part.conflictDetails.size(); ++i) {
+            const auto& detail = part.conflictDetails[i];
+            if (seenConflicts.insert(detailKey(detail.entity1, detail.entity2)).second) {
+                merged.conflictDetails.push_back(detail);
+                merged.conflictDetails.back().description = part.conflictDescription(i);
+            } else {
+                merged.conflicts--;
+            }
+        }
+        for (size_t i = 0; i < part.violationDetails.size(); ++i) {
+            const auto& detail = part.violationDetails[i];
+            if (seenViolations.insert(detailKey(detail.violator, detail.violated_rule)).second) {
+                merged.violationDetails.push_back(detail);
+                merged.violationDetails.back().description = part.violationDescription(i);
+            } else {
+                merged.violations--;
+            }
+        }
+
+        // Shards stopped early leave the whole partial; complete ones count fully
+        merged.partial = merged.partial || part.partial;
+    }
+    if (merged.partial) {
+        double covered = 0.0;
+        for (const auto& part : parts) {
+            covered += part.coverage;
+        }
+        merged.coverage = covered / static_cast<double>(parts.size());
+    }
+
+    return merged;
+}
+
+InferenceEngine::Result ScenarioPartitioner::runParallel(const Config& config,
+                                                         const fs::path& exampleFile,
+                                                         size_t maxShards) {
+    auto shards = partitionFile(exampleFile, maxShards);
+    if (shards.size() <= 1) {
+        return createInferenceEngineV2(config)->run(exampleFile);
+    }
+
+    fs::path shardDir = makeShardDirectory();
+    fs::create_directories(shardDir);
+
+    std::vector<fs::path> shardFiles;
+    std::vector<std::unique_ptr<InferenceEngine>> engines;
+    // Every shard resolves and describes with the same configuration
+    auto inferenceConfig = captureInferenceConfiguration(config);
+    try {
+        for (const auto& shard : shards) {
+            fs::path shardFile = shardDir /
+                (exampleFile.stem().string() + "_shard" + std::to_string(shard.index + 1) + ".metta");
+            std::ofstream out(shardFile);
+            if (!out.is_open()) {
+                throw std::runtime_error("Cannot create file: " + shardFile.string());
+            }
+            out << shard.content;
+            out.close();
+            shardFiles.push_back(shardFile);
+
+            Config shardConfig = config;
+            shardConfig.exampleFile = shardFile;
+            shardConfig.verbose = false;  // Interleaved progress output is unreadable
+            shardConfig.inferenceConfig = inferenceConfig;
+            engines.push_back(createInferenceEngineV2(shardConfig));
+        }
+    } catch (...) {
+        std::error_code ec;
+        fs::remove_all(shardDir, ec);
+        throw;
+    }
+
+    if (config.verbose) {
+        std::cout << "  [Shards] Running " << shards.size() << " shards of "
+                  << exampleFile.filename() << "\n";
+    }
+
+    // A REPL process per shard; cap concurrency at the core count
+    size_t workers = std::min<size_t>(shards.size(),
+                                      std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<InferenceEngine::Result> results(shards.size());
+    std::vector<std::exception_ptr> errors(shards.size());
+    std::atomic<size_t> next{0};
+
+    std::vector<std::future<void>> pool;
+    for (size_t w = 0; w < workers; ++w) {
+        pool.push_back(std::async(std::launch::async, [&]() {
+            for (size_t i = next.fetch_add(1); i < shards.size(); i = next.fetch_add(1)) {
+                try {
+                    // run() would report a failed preparation as an empty
+                    // result, which merges like a clean shard
+                    auto prepared = engines[i]->prepare(shardFiles[i]);
+                    if (!prepared.ok()) {
+                        throw std::runtime_error("Shard " + std::to_string(i + 1) + ": " + prepared.error);
+                    }
+                    auto execution = ProcessExecutor::execute(prepared.command, prepared.timeout,
+                                                              prepared.cancellation, prepared.observer,
+                                                              prepared.deadline);
+                    results[i] = engines[i]->complete(prepared, std::move(execution));
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        }));
+    }
+    for (auto& worker : pool) worker.get();
+
+    std::error_code ec;
+    fs::remove_all(shardDir, ec);
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    InferenceEngine::Result merged;
+    std::vector<Metrics> parts;
+    parts.reserve(results.size());
+
+    // Size the merged output once; shard outputs can be large
+    size_t rawSize = 0;
+    for (const auto& result : results) {
+        rawSize += result.rawOutput.size() + 32;
+    }
+    merged.rawOutput.reserve(rawSize);
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        parts.push_back(std::move(results[i].metrics));
+        merged.rawOutput += "; === Shard " + std::to_string(i + 1) + " ===\n";
+        merged.rawOutput += results[i].rawOutput;
+        merged.rawOutput += "\n";
+        std::string().swap(results[i].rawOutput);  // Release the shard copy early
+    }
+
+    merged.metrics = mergeMetrics(parts);
+    merged.hasLogicalIssues = (merged.metrics.conflicts > 0 || merged.metrics.violations > 0);
+
+    auto formatter = FormatterFactory::create(config.outputFormat);
+    merged.formattedOutput = formatter->format(config, merged.metrics, merged.rawOutput,
+                                               exampleFile.stem().string());
+    return merged;
+}
+
+}
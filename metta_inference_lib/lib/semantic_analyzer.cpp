@@ -4,6 +4,7 @@
 #include <iostream>
 #include <cctype>
 #include <map>
+#include <string_view>
 
 namespace metta_inference {
 
@@ -80,103 +81,201 @@ std::string ComplianceRelation::getDescription(const EntityResolver& resolver,
 }
 
 // AnalysisResult implementation
-Metrics SemanticAnalyzer::AnalysisResult::toMetrics() const {
+namespace {
+
+// Keeps the findings a Lazy Metrics refers to and renders on request
+class AnalysisDescriber : public DetailDescriber {
+public:
+    AnalysisDescriber(std::vector<LogicalContradiction> contradictions,
+                      std::vector<RegulatoryConflict> conflicts,
+                      std::vector<NecessaryViolation> violations,
+                      std::shared_ptr<const ConfigSnapshot> snapshot)
+        : contradictions(std::move(contradictions)),
+          conflicts(std::move(conflicts)),
+          violations(std::move(violations)),
+          snapshot(std::move(snapshot)) {}
+    
+    std::string describeContradiction(size_t index) const override {
+        return contradictions.at(index).getDescription(snapshot->entityResolver, snapshot->templates);
+    }
+    
+    std::string describeConflict(size_t index) const override {
+        return conflicts.at(index).getDescription(snapshot->entityResolver, snapshot->templates);
+    }
+    
+    std::string describeViolation(size_t index) const override {
+        return violations.at(index).getDescription(snapshot->entityResolver, snapshot->templates);
+    }
+    
+private:
+    std::vector<LogicalContradiction> contradictions;
+    std::vector<RegulatoryConflict> conflicts;
+    std::vector<NecessaryViolation> violations;
+    std::shared_ptr<const ConfigSnapshot> snapshot;
+};
+
+std::shared_ptr<const ConfigSnapshot> snapshotFor(const SemanticAnalyzer::AnalysisResult& result) {
+    return result.configuration ? result.configuration : InferenceConfiguration::getInstance().current();
+}
+
+// Counts and detail lists; descriptions only when rendering eagerly
+Metrics buildMetrics(const SemanticAnalyzer::AnalysisResult& result, MetricsDetail level,
+                     const ConfigSnapshot& config) {
+    const auto& inferredFacts = result.inferredFacts;
+    const auto& contradictions = result.contradictions;
+    const auto& conflicts = result.conflicts;
+    const auto& violations = result.violations;
+    const auto& compliances = result.compliances;
     Metrics metrics;
     
-    // Convert inferred facts
     metrics.inferredFacts = static_cast<int>(inferredFacts.size());
+    metrics.contradictions = static_cast<int>(contradictions.size());
+    metrics.contradictionPairs = static_cast<int>(contradictions.size());
+    metrics.conflicts = static_cast<int>(conflicts.size());
+    metrics.violations = static_cast<int>(violations.size());
+    metrics.compliances = static_cast<int>(compliances.size());
+    
+    if (level == MetricsDetail::CountsOnly) {
+        return metrics;
+    }
+    
+    const bool eager = (level == MetricsDetail::Full);
+    
+    // Convert inferred facts
+    metrics.inferredStateOfAffairs.reserve(inferredFacts.size());
     for (const auto& fact : inferredFacts) {
         metrics.inferredStateOfAffairs.push_back(fact.toString());
     }
     
     // Convert contradictions
-    metrics.contradictions = static_cast<int>(contradictions.size());
-    metrics.contradictionPairs = static_cast<int>(contradictions.size());
-    
-    auto& config = InferenceConfiguration::getInstance();
+    metrics.contradictionDetails.reserve(contradictions.size());
     for (const auto& contradiction : contradictions) {
         ContradictionDetail detail;
         detail.entity1 = contradiction.positive.toString();
         detail.entity2 = contradiction.negative.toString();
-        detail.description = contradiction.getDescription(
-            config.getEntityResolver(),
-            config.getTemplates()
-        );
-        metrics.contradictionDetails.push_back(detail);
+        if (eager) {
+            detail.description = contradiction.getDescription(
+                config.entityResolver,
+                config.templates
+            );
+        }
+        metrics.contradictionDetails.push_back(std::move(detail));
     }
     
     // Convert conflicts
-    metrics.conflicts = static_cast<int>(conflicts.size());
+    metrics.conflictDetails.reserve(conflicts.size());
     for (const auto& conflict : conflicts) {
         ConflictDetail detail;
         detail.entity1 = conflict.regulation1;
         detail.entity2 = conflict.regulation2;
-        detail.description = conflict.getDescription(
-            config.getEntityResolver(),
-            config.getTemplates()
-        );
-        metrics.conflictDetails.push_back(detail);
+        if (eager) {
+            detail.description = conflict.getDescription(
+                config.entityResolver,
+                config.templates
+            );
+        }
+        metrics.conflictDetails.push_back(std::move(detail));
     }
     
     // Convert violations
-    metrics.violations = static_cast<int>(violations.size());
+    metrics.violationDetails.reserve(violations.size());
     for (const auto& violation : violations) {
         ViolationDetail detail;
         detail.violator = violation.violator;
         detail.violated_rule = violation.violatedRule;
-        detail.description = violation.getDescription(
-            config.getEntityResolver(),
-            config.getTemplates()
-        );
-        metrics.violationDetails.push_back(detail);
+        if (eager) {
+            detail.description = violation.getDescription(
+                config.entityResolver,
+                config.templates
+            );
+        }
+        metrics.violationDetails.push_back(std::move(detail));
     }
     
-    // Convert compliances
-    metrics.compliances = static_cast<int>(compliances.size());
-    
     return metrics;
 }
 
-// SemanticAnalyzer implementation
-SemanticAnalyzer::SemanticAnalyzer() {
-    auto& config = InferenceConfiguration::getInstance();
-    entityResolver = &config.getEntityResolver();
-    descriptionTemplates = &config.getTemplates();
 }
 
-SemanticAnalyzer::SemanticAnalyzer(EntityResolver* resolver, DescriptionTemplates* templates)
+Metrics SemanticAnalyzer::AnalysisResult::toMetrics(MetricsDetail level) const& {
+    auto snapshot = snapshotFor(*this);
+    Metrics metrics = buildMetrics(*this, level, *snapshot);
+    if (level == MetricsDetail::Lazy) {
+        metrics.describer = std::make_shared<AnalysisDescriber>(
+            contradictions, conflicts, violations, std::move(snapshot));
+    }
+    return metrics;
+}
+
+Metrics SemanticAnalyzer::AnalysisResult::toMetrics(MetricsDetail level) && {
+    auto snapshot = snapshotFor(*this);
+    Metrics metrics = buildMetrics(*this, level, *snapshot);
+    if (level == MetricsDetail::Lazy) {
+        metrics.describer = std::make_shared<AnalysisDescriber>(
+            std::move(contradictions), std::move(conflicts), std::move(violations),
+            std::move(snapshot));
+    }
+    return metrics;
+}
+
+// SemanticAnalyzer implementation
+SemanticAnalyzer::SemanticAnalyzer()
+    : SemanticAnalyzer(InferenceConfiguration::getInstance().current()) {}
+
+SemanticAnalyzer::SemanticAnalyzer(std::shared_ptr<const ConfigSnapshot> snapshot)
+    : configSnapshot(std::move(snapshot)),
+      entityResolver(&configSnapshot->entityResolver),
+      descriptionTemplates(&configSnapshot->templates) {}
+
+SemanticAnalyzer::SemanticAnalyzer(const EntityResolver* resolver, const DescriptionTemplates* templates)
     : entityResolver(resolver), descriptionTemplates(templates) {
     if (!entityResolver || !descriptionTemplates) {
-        auto& config = InferenceConfiguration::getInstance();
-        if (!entityResolver) entityResolver = &config.getEntityResolver();
-        if (!descriptionTemplates) descriptionTemplates = &config.getTemplates();
+        configSnapshot = InferenceConfiguration::getInstance().current();
+        if (!entityResolver) entityResolver = &configSnapshot->entityResolver;
+        if (!descriptionTemplates) descriptionTemplates = &configSnapshot->templates;
     }
 }
 
-SemanticAnalyzer::AnalysisResult SemanticAnalyzer::analyze(const std::string& mettaOutput) {
-    AnalysisResult result;
-    
+SemanticAnalyzer::AnalysisResult SemanticAnalyzer::analyze(const std::string& mettaOutput,
+                                                           const CancellationToken& cancel) {
     // Parse the output into S-expressions
+    // One interner for the whole output: repeated meta-id and triple terms
+    // collapse to shared nodes, including across the line-by-line fallback
     std::vector<std::shared_ptr<SExpr>> expressions;
+    SExprInterner interner;
     try {
-        expressions = SExprParser::parseMultiple(mettaOutput);
+        expressions = SExprParser::parseMultiple(mettaOutput, interner, cancel);
+    } catch (const CancelledError&) {
+        throw;
     } catch (const std::exception& e) {
         // If parsing fails, fall back to line-by-line parsing
         std::istringstream iss(mettaOutput);
         std::string line;
         while (std::getline(iss, line)) {
+            cancel.throwIfCancelled();
             if (line.empty() || (line[0] != '(' && line[0] != '[')) continue;
             try {
-                expressions.push_back(SExprParser::parse(line));
+                expressions.push_back(SExprParser::parse(line, interner));
             } catch (...) {
                 // Skip unparseable lines
             }
         }
     }
     
+    return analyzeExpressions(expressions, cancel);
+}
+
+SemanticAnalyzer::AnalysisResult SemanticAnalyzer::analyzeExpressions(
+    const std::vector<std::shared_ptr<SExpr>>& expressions, const CancellationToken& cancel) {
+    AnalysisResult result;
+    result.configuration = configSnapshot;
+    
     // Extract different types of semantic information
+    cancel.throwIfCancelled();
     result.inferredFacts = extractStateOfAffairs(expressions);
+    cancel.throwIfCancelled();
     result.contradictions = findContradictions(expressions);
+    cancel.throwIfCancelled();
     result.conflicts = findConflicts(expressions);
     result.violations = findViolations(expressions);
     result.compliances = findCompliances(expressions);
@@ -184,6 +283,181 @@ SemanticAnalyzer::AnalysisResult SemanticAnalyzer::analyze(const std::string& me
     return result;
 }
 
+namespace {
+
+bool isAtomDelimiter(char c) {
+    return c == '(' || c == ')' || c == '[' || c == ']' || c == ',' || c == '"' ||
+           std::isspace(static_cast<unsigned char>(c));
+}
+
+// One past the bracket closing the one at start; npos when unbalanced
+size_t matchingClose(std::string_view text, size_t start) {
+    int depth = 0;
+    bool inString = false;
+    for (size_t i = start; i < text.size(); ++i) {
+        char c = text[i];
+        if (inString) {
+            if (c == '\\') ++i;
+            else if (c == '"') inString = false;
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '(' || c == '[') {
+            ++depth;
+        } else if ((c == ')' || c == ']') && --depth == 0) {
+            return i + 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// The element with owner's namespace stripped, or nullopt when it names
+// another request's entities
+std::optional<std::string> claimElement(std::string_view element, size_t owner,
+                                        const std::unordered_map<std::string_view, size_t>& namespaces) {
+    std::string claimed;
+    claimed.reserve(element.size());
+    size_t i = 0;
+    while (i < element.size()) {
+        char c = element[i];
+        if (c == '"') {
+            size_t end = i + 1;
+            while (end < element.size() && element[end] != '"') {
+                end += element[end] == '\\' ? 2 : 1;
+            }
+            end = std::min(end + 1, element.size());
+            claimed.append(element, i, end - i);
+            i = end;
+            continue;
+        }
+        if (isAtomDelimiter(c)) {
+            claimed.push_back(c);
+            ++i;
+            continue;
+        }
+
+        size_t end = i;
+        while (end < element.size() && !isAtomDelimiter(element[end])) ++end;
+        std::string_view atom = element.substr(i, end - i);
+        i = end;
+
+        size_t suffix = atom.rfind("__");
+        if (suffix != std::string_view::npos && suffix > 0) {
+            auto it = namespaces.find(atom.substr(suffix));
+            if (it != namespaces.end()) {
+                if (it->second != owner) return std::nullopt;
+                atom = atom.substr(0, suffix);
+            }
+        }
+        claimed.append(atom);
+    }
+    return claimed;
+}
+
+}
+
+std::vector<std::string> SemanticAnalyzer::demultiplex(const std::string& mettaOutput,
+                                                       const CoalescedLayout& layout) {
+    const size_t requests = layout.queryCounts.size();
+    if (layout.namespaces.size() != requests) {
+        throw std::runtime_error("Coalesced layout has " + std::to_string(layout.namespaces.size()) +
+                                 " namespaces for " + std::to_string(requests) + " requests");
+    }
+
+    std::unordered_map<std::string_view, size_t> namespaces;
+    for (size_t r = 0; r < requests; ++r) {
+        namespaces.emplace(layout.namespaces[r], r);
+    }
+
+    // Result k belongs to the first request whose queries end after k
+    std::vector<size_t> queryEnd(requests);
+    size_t totalQueries = 0;
+    for (size_t r = 0; r < requests; ++r) {
+        totalQueries += layout.queryCounts[r];
+        queryEnd[r] = totalQueries;
+    }
+
+    std::vector<std::string> outputs(requests);
+    size_t resultIndex = 0;
+    size_t owner = 0;
+    auto advanceOwner = [&]() {
+        while (owner + 1 < requests && resultIndex >= queryEnd[owner]) ++owner;
+    };
+    advanceOwner();
+
+    size_t i = 0;
+    while (i < mettaOutput.size() && requests > 0) {
+        char c = mettaOutput[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+
+        if (c != '[') {
+            // Printed text and errors go to the request about to be answered
+            size_t end = mettaOutput.find('\n', i);
+            if (end == std::string::npos) end = mettaOutput.size();
+            if (auto line = claimElement(std::string_view(mettaOutput).substr(i, end - i), owner, namespaces)) {
+                outputs[owner] += *line;
+                outputs[owner] += '\n';
+            }
+            i = end;
+            continue;
+        }
+
+        if (resultIndex >= totalQueries) {
+            throw std::runtime_error("Coalesced output has more results than queries (" +
+                                     std::to_string(totalQueries) + ")");
+        }
+
+        size_t end = matchingClose(mettaOutput, i);
+        if (end == std::string_view::npos) {
+            throw std::runtime_error("Coalesced output ends inside a result");
+        }
+        std::string_view result = std::string_view(mettaOutput).substr(i + 1, end - i - 2);
+
+        // Elements of the result list, separated by commas or whitespace
+        std::string kept = "[";
+        size_t pos = 0;
+        bool first = true;
+        while (pos < result.size()) {
+            char e = result[pos];
+            if (e == ',' || std::isspace(static_cast<unsigned char>(e))) {
+                ++pos;
+                continue;
+            }
+            size_t elementEnd;
+            if (e == '(' || e == '[') {
+                elementEnd = matchingClose(result, pos);
+                if (elementEnd == std::string_view::npos) elementEnd = result.size();
+            } else {
+                elementEnd = pos;
+                while (elementEnd < result.size() && result[elementEnd] != ',' &&
+                       !std::isspace(static_cast<unsigned char>(result[elementEnd]))) {
+                    ++elementEnd;
+                }
+            }
+            if (auto element = claimElement(result.substr(pos, elementEnd - pos), owner, namespaces)) {
+                if (!first) kept += ", ";
+                kept += *element;
+                first = false;
+            }
+            pos = elementEnd;
+        }
+        kept += "]\n";
+        outputs[owner] += kept;
+
+        i = end;
+        ++resultIndex;
+        advanceOwner();
+    }
+
+    if (resultIndex != totalQueries) {
+        throw std::runtime_error("Coalesced output has " + std::to_string(resultIndex) +
+                                 " results for " + std::to_string(totalQueries) + " queries");
+    }
+    return outputs;
+}
+
 std::vector<StateOfAffairs> SemanticAnalyzer::extractStateOfAffairs(
     const std::vector<std::shared_ptr<SExpr>>& expressions) {
     
@@ -192,6 +466,8 @@ std::vector<StateOfAffairs> SemanticAnalyzer::extractStateOfAffairs(
     
     // Group all triples by entity
     std::map<std::string, std::vector<std::shared_ptr<SExpr>>> entityTriples;
+    // Parsed nodes are hash-consed, so a repeated triple is the same node
+    std::unordered_set<const SExpr*> seenTriples;
     
     // Collect all triples
     for (const auto& expr : expressions) {
@@ -205,7 +481,8 @@ std::vector<StateOfAffairs> SemanticAnalyzer::extractStateOfAffairs(
                 if (subList.size() >= 4 && subList[0]->getSymbol() && 
                     *subList[0]->getSymbol() == "triple") {
                     auto subject = subList[1]->getSymbol();
-                    if (subject && subject->find("soa_") == 0) {
+                    if (subject && subject->find("soa_") == 0 &&
+                        seenTriples.insert(elem.get()).second) {
                         entityTriples[*subject].push_back(elem);
                     }
                 }
@@ -1,25 +1,93 @@
 #include "metta_inference/sexpr_parser.hpp"
-#include <sstream>
 #include <cctype>
 #include <algorithm>
 
 namespace metta_inference {
 
 // SExpr implementation
+size_t SExpr::hashAtom(const Atom& atom) {
+    return std::hash<std::string>{}(atom);
+}
+
+size_t SExpr::hashList(const List& list) {
+    // Seed differs from any atom hash path so "a" and "(a)" rarely collide
+    size_t h = 0x9e3779b97f4a7c15ULL ^ list.size();
+    for (const auto& elem : list) {
+        h ^= elem->hash() + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+bool SExpr::equals(const SExpr& other) const {
+    if (this == &other) return true;
+    if (hashCode != other.hashCode || isAtom() != other.isAtom()) return false;
+    
+    if (isAtom()) {
+        return asAtom() == other.asAtom();
+    }
+    
+    const auto& list = asList();
+    const auto& otherList = other.asList();
+    if (list.size() != otherList.size()) return false;
+    
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (list[i] != otherList[i] && !list[i]->equals(*otherList[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::string SExpr::toString() const {
     if (isAtom()) {
         return asAtom();
-    } else {
-        std::ostringstream oss;
-        oss << "(";
-        const auto& list = asList();
-        for (size_t i = 0; i < list.size(); ++i) {
-            if (i > 0) oss << " ";
-            oss << list[i]->toString();
+    }
+    std::string out;
+    appendTo(out);
+    return out;
+}
+
+void SExpr::appendTo(std::string& out) const {
+    if (isAtom()) {
+        out += asAtom();
+        return;
+    }
+    
+    out += '(';
+    const auto& list = asList();
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (i > 0) out += ' ';
+        list[i]->appendTo(out);
+    }
+    out += ')';
+}
+
+// SExprInterner implementation
+std::shared_ptr<SExpr> SExprInterner::atom(std::string token) {
+    auto it = atoms.find(token);
+    if (it != atoms.end()) {
+        ++reused;
+        return it->second;
+    }
+    
+    auto node = std::make_shared<SExpr>(token);
+    atoms.emplace(std::move(token), node);
+    return node;
+}
+
+std::shared_ptr<SExpr> SExprInterner::list(SExpr::List elements) {
+    size_t hash = SExpr::hashList(elements);
+    auto [begin, end] = lists.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second->asList() == elements) {  // Element-wise shared_ptr comparison, i.e. by address
+            ++reused;
+            return it->second;
         }
-        oss << ")";
-        return oss.str();
     }
+    
+    auto node = std::make_shared<SExpr>(std::move(elements));
+    lists.emplace(hash, node);
+    return node;
 }
 
 // Tokenizer implementation
@@ -84,25 +152,38 @@ bool SExprParser::Tokenizer::isDelimiter(char c) const {
 
 // Parser implementation
 std::shared_ptr<SExpr> SExprParser::parse(const std::string& input) {
+    SExprInterner interner;
+    return parse(input, interner);
+}
+
+std::shared_ptr<SExpr> SExprParser::parse(const std::string& input, SExprInterner& interner) {
     Tokenizer tokenizer(input);
     if (!tokenizer.hasNext()) {
         throw std::runtime_error("Empty input");
     }
-    return parseExpression(tokenizer);
+    return parseExpression(tokenizer, interner);
 }
 
 std::vector<std::shared_ptr<SExpr>> SExprParser::parseMultiple(const std::string& input) {
+    SExprInterner interner;
+    return parseMultiple(input, interner);
+}
+
+std::vector<std::shared_ptr<SExpr>> SExprParser::parseMultiple(const std::string& input,
+                                                               SExprInterner& interner,
+                                                               const CancellationToken& cancel) {
     std::vector<std::shared_ptr<SExpr>> results;
     Tokenizer tokenizer(input);
     
     while (tokenizer.hasNext()) {
-        results.push_back(parseExpression(tokenizer));
+        cancel.throwIfCancelled();
+        results.push_back(parseExpression(tokenizer, interner));
     }
     
     return results;
 }
 
-std::shared_ptr<SExpr> SExprParser::parseExpression(Tokenizer& tokenizer) {
+std::shared_ptr<SExpr> SExprParser::parseExpression(Tokenizer& tokenizer, SExprInterner& interner) {
     if (!tokenizer.hasNext()) {
         throw std::runtime_error("Unexpected end of input");
     }
@@ -110,16 +191,16 @@ std::shared_ptr<SExpr> SExprParser::parseExpression(Tokenizer& tokenizer) {
     std::string token = tokenizer.peek();
     
     if (token == "(" || token == "[") {
-        return parseList(tokenizer);
+        return parseList(tokenizer, interner);
     } else if (token == ")" || token == "]") {
         throw std::runtime_error("Unexpected closing bracket");
     } else {
         tokenizer.consume();
-        return std::make_shared<SExpr>(token);
+        return interner.atom(std::move(token));
     }
 }
 
-std::shared_ptr<SExpr> SExprParser::parseList(Tokenizer& tokenizer) {
+std::shared_ptr<SExpr> SExprParser::parseList(Tokenizer& tokenizer, SExprInterner& interner) {
     std::string open = tokenizer.next();
     if (open != "(" && open != "[") {
         throw std::runtime_error("Expected '(' or '['");
@@ -130,14 +211,14 @@ std::shared_ptr<SExpr> SExprParser::parseList(Tokenizer& tokenizer) {
     std::string expectedClose = (open == "(") ? ")" : "]";
     
     while (tokenizer.hasNext() && tokenizer.peek() != expectedClose) {
-        elements.push_back(parseExpression(tokenizer));
+        elements.push_back(parseExpression(tokenizer, interner));
     }
     
     if (!tokenizer.hasNext() || tokenizer.next() != expectedClose) {
         throw std::runtime_error("Expected '" + expectedClose + "'");
     }
     
-    return std::make_shared<SExpr>(elements);
+    return interner.list(std::move(elements));
 }
 
 // SExprTriple implementation
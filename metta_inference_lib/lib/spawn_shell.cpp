@@ -0,0 +1,62 @@
+#include "spawn_shell.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <spawn.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+extern char** environ;
+
+namespace metta_inference {
+namespace detail {
+
+pid_t spawnShellCommand(const std::string& command, int& outputFd) {
+    // Close-on-exec from the start where possible, so a command started by
+    // another thread at the same moment cannot inherit the pipe
+    int fds[2];
+#ifdef __linux__
+    int created = pipe2(fds, O_CLOEXEC);
+#else
+    int created = pipe(fds);
+    if (created == 0) {
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (created != 0) {
+        throw std::runtime_error("Failed to create command output pipe: " + std::string(strerror(errno)));
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    sigset_t noSignals;
+    sigemptyset(&noSignals);
+    posix_spawnattr_setsigmask(&attributes, &noSignals);
+
+    pid_t pid = -1;
+    const char* argv[] = {"sh", "-c", command.c_str(), nullptr};
+    int rc = posix_spawn(&pid, "/bin/sh", &actions, &attributes,
+                         const_cast<char* const*>(argv), environ);
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+    close(fds[1]);
+
+    if (rc != 0) {
+        close(fds[0]);
+        throw std::runtime_error("Failed to execute command: " + command + " (" + strerror(rc) + ")");
+    }
+    outputFd = fds[0];
+    return pid;
+}
+
+}
+}
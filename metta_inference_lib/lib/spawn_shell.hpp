@@ -0,0 +1,23 @@
+#ifndef METTA_INFERENCE_SPAWN_SHELL_HPP
+#define METTA_INFERENCE_SPAWN_SHELL_HPP
+
+// Internal to the library: process start-up shared by ProcessExecutor and
+// ProcessReactor
+
+#include <string>
+#include <sys/types.h>
+
+namespace metta_inference {
+namespace detail {
+
+// Starts command under /bin/sh in its own process group, so a timeout or
+// cancellation can kill everything it started, with the signal mask the
+// host may have set (e.g. a daemon's sigwait) cleared again. Sets
+// outputFd to the read end of its stdout (close-on-exec, blocking) and
+// returns its pid; throws std::runtime_error when it cannot be started.
+pid_t spawnShellCommand(const std::string& command, int& outputFd);
+
+}
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include "metta_inference/streaming_analyzer.hpp"
+#include "metta_inference/scenario_partitioner.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace metta_inference {
+
+StreamingAnalyzer::StreamingAnalyzer(std::shared_ptr<const ConfigSnapshot> snapshot, size_t expectedResults)
+    : analyzer(std::move(snapshot)), expected(expectedResults) {}
+
+void StreamingAnalyzer::feed(std::string_view chunk) {
+    fed += chunk.size();
+    size_t start = 0;
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        char c = chunk[i];
+        if (c == '(' || c == '[') {
+            if (depth++ == 0 && c == '[') {
+                ++pendingResults;
+            }
+        } else if (c == ')' || c == ']') {
+            if (depth == 0) {
+                malformed = true;  // Parsing the whole output would fail here
+            } else {
+                --depth;
+            }
+        } else if (c == '\n' && depth == 0) {
+            // Everything before is complete expressions
+            pending.append(chunk, start, i - start);
+            parseSegment(pending);
+            pending.clear();
+            start = i + 1;
+        }
+    }
+    pending.append(chunk, start, std::string_view::npos);
+}
+
+void StreamingAnalyzer::finish() {
+    if (depth > 0) {
+        malformed = true;
+        return;
+    }
+    if (!pending.empty()) {
+        std::string last;
+        last.swap(pending);
+        parseSegment(last);
+    }
+}
+
+void StreamingAnalyzer::parseSegment(const std::string& text) {
+    // The REPL prints each query's results as one bracketed expression
+    resultCount += pendingResults;
+    pendingResults = 0;
+    if (text.find_first_not_of(" \t\r\f\v") == std::string::npos) return;
+
+    size_t first = expressions.size();
+    try {
+        // Split only between expressions, so these are the expressions
+        // SExprParser::parseMultiple finds in the whole output
+        auto parsed = SExprParser::parseMultiple(text, interner);
+        expressions.insert(expressions.end(), std::make_move_iterator(parsed.begin()),
+                           std::make_move_iterator(parsed.end()));
+    } catch (...) {
+        malformed = true;
+        return;
+    }
+    for (size_t i = first; watching && !found && i < expressions.size(); ++i) {
+        found = holdsFinding(expressions[i]);
+    }
+}
+
+bool StreamingAnalyzer::holdsFinding(const std::shared_ptr<SExpr>& expression) {
+    // The per-expression passes, cheapest first
+    std::vector<std::shared_ptr<SExpr>> single{expression};
+    return !analyzer.findViolations(single).empty() ||
+           !analyzer.findConflicts(single).empty() ||
+           !analyzer.findContradictions(single).empty();
+}
+
+double StreamingAnalyzer::coverage() const {
+    if (expected == 0) return 0.0;
+    return std::min(1.0, static_cast<double>(resultCount) / static_cast<double>(expected));
+}
+
+SemanticAnalyzer::AnalysisResult StreamingAnalyzer::analyze(const CancellationToken& cancel) {
+    return analyzer.analyzeExpressions(expressions, cancel);
+}
+
+size_t StreamingAnalyzer::countQueries(const std::string& program) {
+    auto expressions = ScenarioPartitioner::splitExpressions(program);
+    return static_cast<size_t>(std::count_if(expressions.begin(), expressions.end(),
+                                             [](const auto& expression) { return expression.query; }));
+}
+
+}
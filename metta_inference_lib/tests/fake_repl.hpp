@@ -0,0 +1,57 @@
+#ifndef METTA_INFERENCE_TESTS_FAKE_REPL_HPP
+#define METTA_INFERENCE_TESTS_FAKE_REPL_HPP
+
+#include "metta_inference/config.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Scratch directory with a fake REPL that runs a shell script, and one
+// stub module in each of base/, knowledge/ and reason/. The directory
+// is removed when the fixture goes.
+struct FakeRepl {
+    std::filesystem::path root;
+    std::string repl;
+    std::vector<std::string> modules;
+
+    FakeRepl(const std::string& name, const std::string& script) {
+        namespace fs = std::filesystem;
+        root = fs::temp_directory_path() / ("metta_" + name + "_" + std::to_string(getpid()));
+        fs::create_directories(root);
+
+        repl = (root / "fake-repl").string();
+        setScript(script);
+
+        for (const char* module : {"base", "knowledge", "reason"}) {
+            fs::create_directories(root / module);
+            std::ofstream(root / module / (std::string(module) + ".metta")) << "; " << module << "\n";
+            modules.push_back((root / module).string());
+        }
+    }
+
+    ~FakeRepl() {
+        std::error_code ec;
+        std::filesystem::remove_all(root, ec);
+    }
+
+    FakeRepl(const FakeRepl&) = delete;
+    FakeRepl& operator=(const FakeRepl&) = delete;
+
+    // Replaces what the REPL does from the next run on
+    void setScript(const std::string& script) const {
+        std::ofstream(repl, std::ios::trunc) << "#!/bin/sh\n" << script << "\n";
+        std::filesystem::permissions(repl, std::filesystem::perms::owner_all);
+    }
+
+    // Engine configuration running this REPL on the stub modules
+    metta_inference::Config config() const {
+        metta_inference::Config config;
+        config.mettaReplPath = repl;
+        config.modulePaths.assign(modules.begin(), modules.end());
+        return config;
+    }
+};
+
+#endif
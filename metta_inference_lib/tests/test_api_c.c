@@ -0,0 +1,283 @@
+/* Written in C on purpose: it checks the header and the shared library
+   from the side the ABI is for */
+#include "metta_api_c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static char root[256];
+static char repl[320];
+static char hangingRepl[320];
+static char modules[3][320];
+
+static void fail(const char* message) {
+    fprintf(stderr, "Test failed: %s (%s)\n", message, metta_last_error());
+    exit(1);
+}
+
+static void writeFile(const char* path, const char* content) {
+    FILE* file = fopen(path, "w");
+    if (!file) fail("Cannot write fixture");
+    fputs(content, file);
+    fclose(file);
+}
+
+static void setUp(void) {
+    const char* names[] = {"base", "knowledge", "reason"};
+    char path[1024];
+
+    snprintf(root, sizeof(root), "/tmp/metta_c_api_test_%d", (int)getpid());
+    mkdir(root, 0700);
+
+    snprintf(repl, sizeof(repl), "%s/fake-repl", root);
+    writeFile(repl, "#!/bin/sh\necho '[()]'\n");
+    chmod(repl, 0700);
+
+    snprintf(hangingRepl, sizeof(hangingRepl), "%s/hanging-repl", root);
+    writeFile(hangingRepl, "#!/bin/sh\nsleep 30\n");
+    chmod(hangingRepl, 0700);
+
+    for (int i = 0; i < 3; ++i) {
+        snprintf(modules[i], sizeof(modules[i]), "%s/%s", root, names[i]);
+        mkdir(modules[i], 0700);
+        snprintf(path, sizeof(path), "%s/%s.metta", modules[i], names[i]);
+        writeFile(path, "; module\n");
+    }
+}
+
+static void tearDown(void) {
+    char command[400];
+    snprintf(command, sizeof(command), "rm -rf '%s'", root);
+    if (system(command) != 0) {
+        fprintf(stderr, "Warning: could not remove %s\n", root);
+    }
+}
+
+static metta_engine* createEngine(const char* replPath) {
+    const char* paths[] = {modules[0], modules[1], modules[2]};
+    metta_engine* engine = metta_engine_create();
+    if (!engine) fail("metta_engine_create");
+    if (metta_engine_set_repl_path(engine, replPath) != METTA_OK ||
+        metta_engine_set_module_paths(engine, paths, 3) != METTA_OK) {
+        fail("Configuring the engine");
+    }
+    return engine;
+}
+
+static void testArguments(void) {
+    metta_request* request = metta_request_create();
+    assert(metta_abi_version() == METTA_ABI_VERSION);
+
+    if (metta_run(NULL, request, NULL) != METTA_ERROR_INVALID_ARGUMENT || metta_last_error()[0] == '\0') {
+        fail("NULL arguments not rejected");
+    }
+    if (metta_request_set_option(request, "no_such_option", "x") != METTA_ERROR_INVALID_ARGUMENT ||
+        metta_request_set_option(request, "verbose", "maybe") != METTA_ERROR_INVALID_ARGUMENT ||
+        metta_request_set_option(request, "raw_output", "sometimes") != METTA_ERROR_INVALID_ARGUMENT ||
+        metta_request_set_option(request, "output_format", "yaml") != METTA_ERROR_INVALID_ARGUMENT ||
+        metta_request_set_option(request, "metrics_detail", "some") != METTA_ERROR_INVALID_ARGUMENT) {
+        fail("Bad options accepted");
+    }
+    if (metta_request_set_option(request, "raw_output", "shared") != METTA_OK ||
+        metta_request_set_option(request, "include_findings", "true") != METTA_OK) {
+        fail("Good options rejected");
+    }
+
+    metta_request_destroy(request);
+    printf("✓ Argument checking test passed\n");
+}
+
+static size_t streamed = 0;
+
+static void countChunk(void* user_data, const char* chunk, size_t size) {
+    (void)user_data;
+    (void)chunk;
+    streamed += size;
+}
+
+static void testBlocking(void) {
+    metta_engine* engine = createEngine(repl);
+    metta_request* request = metta_request_create();
+    metta_response* response = NULL;
+    const char* content = "(= (fact) (soa))\n";
+
+    metta_request_set_content(request, content, strlen(content));
+    metta_request_set_option(request, "output_format", "json");
+    if (metta_run(engine, request, &response) != METTA_OK || !response) {
+        fail("Blocking run failed");
+    }
+    assert(metta_response_status(response) == METTA_OK);
+
+    metta_metrics metrics;
+    metta_response_metrics(response, &metrics);
+    if (metrics.contradictions != 0 || metrics.processing_time_ms < 0) {
+        fail("Unexpected metrics");
+    }
+
+    /* Views point into the response; copies need room for all of it */
+    metta_string output = metta_response_output(response);
+    metta_string raw = metta_response_raw_output(response);
+    if (output.size == 0 || output.data[0] != '{' || raw.size == 0) {
+        fail("Missing output");
+    }
+    if (metta_response_output(response).data != output.data) {
+        fail("Output view is not stable");
+    }
+
+    size_t needed = 0;
+    if (metta_response_copy_output(response, NULL, 0, &needed) != METTA_ERROR_BUFFER_TOO_SMALL ||
+        needed != output.size) {
+        fail("Size query did not report the output size");
+    }
+    char* buffer = malloc(needed);
+    size_t written = 0;
+    if (metta_response_copy_output(response, buffer, needed, &written) != METTA_OK || written != needed ||
+        memcmp(buffer, output.data, needed) != 0) {
+        fail("Copy does not match the view");
+    }
+    free(buffer);
+    metta_response_destroy(response);
+
+    /* Streaming leaves the formatted output to the callback */
+    metta_request_set_output_callback(request, countChunk, NULL);
+    if (metta_run(engine, request, &response) != METTA_OK) {
+        fail("Streaming run failed");
+    }
+    if (streamed == 0 || metta_response_output(response).size != 0) {
+        fail("Output not streamed");
+    }
+    metta_response_destroy(response);
+
+    /* Failed requests still come back with a response */
+    if (metta_run_file(engine, "/nonexistent/example.metta", request, &response) != METTA_ERROR_INFERENCE ||
+        !response || metta_response_error(response).size == 0) {
+        fail("Missing file not reported");
+    }
+    metta_response_destroy(response);
+
+    metta_request_destroy(request);
+    metta_engine_destroy(engine);
+    printf("✓ Blocking run test passed\n");
+}
+
+struct Outcome {
+    pthread_mutex_t mutex;
+    pthread_cond_t done;
+    metta_response* response;
+};
+
+static void deliver(void* user_data, metta_response* response) {
+    struct Outcome* outcome = user_data;
+    pthread_mutex_lock(&outcome->mutex);
+    outcome->response = response;
+    pthread_cond_signal(&outcome->done);
+    pthread_mutex_unlock(&outcome->mutex);
+}
+
+static metta_response* await(struct Outcome* outcome) {
+    pthread_mutex_lock(&outcome->mutex);
+    while (!outcome->response) {
+        pthread_cond_wait(&outcome->done, &outcome->mutex);
+    }
+    metta_response* response = outcome->response;
+    outcome->response = NULL;
+    pthread_mutex_unlock(&outcome->mutex);
+    return response;
+}
+
+static void testAsync(void) {
+    metta_engine* engine = createEngine(repl);
+    metta_request* request = metta_request_create();
+    struct Outcome outcome = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL};
+    const char* content = "; async\n";
+
+    metta_request_set_content(request, content, strlen(content));
+    if (metta_run_async(engine, request, deliver, &outcome) != METTA_OK) {
+        fail("Async submit failed");
+    }
+    /* The request is copied on submit */
+    metta_request_destroy(request);
+
+    metta_response* response = await(&outcome);
+    if (metta_response_status(response) != METTA_OK || metta_response_output(response).size == 0) {
+        fail("Async run failed");
+    }
+    metta_response_destroy(response);
+
+    metta_engine_destroy(engine);
+    printf("✓ Async run test passed\n");
+}
+
+static void testCancel(void) {
+    metta_engine* engine = createEngine(hangingRepl);
+    metta_request* request = metta_request_create();
+    struct Outcome outcome = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, NULL};
+    const char* content = "; hangs\n";
+
+    metta_request_set_content(request, content, strlen(content));
+    if (metta_run_async(engine, request, deliver, &outcome) != METTA_OK) {
+        fail("Async submit failed");
+    }
+    usleep(100 * 1000);
+    metta_request_cancel(request);
+
+    metta_response* response = await(&outcome);
+    if (metta_response_status(response) != METTA_ERROR_CANCELLED) {
+        fail("Request not cancelled");
+    }
+    metta_response_destroy(response);
+
+    metta_request_destroy(request);
+    metta_engine_destroy(engine);
+    printf("✓ Cancellation test passed\n");
+}
+
+static void testDeadline(void) {
+    metta_engine* engine = createEngine(hangingRepl);
+    metta_request* request = metta_request_create();
+    metta_response* response = NULL;
+    const char* content = "!(never-answered)\n";
+    double coverage = -1.0;
+
+    metta_request_set_content(request, content, strlen(content));
+    if (metta_request_set_option(request, "deadline_ms", "soon") != METTA_ERROR_INVALID_ARGUMENT ||
+        metta_request_set_option(request, "deadline_ms", "200") != METTA_OK) {
+        fail("deadline_ms not parsed");
+    }
+    if (metta_request_set_option(request, "stop_on_first", "maybe") != METTA_ERROR_INVALID_ARGUMENT ||
+        metta_request_set_option(request, "stop_on_first", "true") != METTA_OK) {
+        fail("stop_on_first not parsed");
+    }
+
+    /* A run stopped at its deadline still succeeds, marked partial */
+    if (metta_run(engine, request, &response) != METTA_OK) {
+        fail("Run with a deadline failed");
+    }
+    if (!metta_response_is_partial(response, &coverage) || coverage != 0.0) {
+        fail("Response not marked partial");
+    }
+    metta_response_destroy(response);
+
+    metta_request_destroy(request);
+    metta_engine_destroy(engine);
+    printf("✓ Deadline test passed\n");
+}
+
+int main(void) {
+    printf("Running C API tests...\n");
+    setUp();
+
+    testArguments();
+    testBlocking();
+    testAsync();
+    testCancel();
+    testDeadline();
+
+    tearDown();
+    printf("\nAll tests passed! ✅\n");
+    return 0;
+}
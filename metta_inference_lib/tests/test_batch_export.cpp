@@ -0,0 +1,148 @@
+#include "metta_inference/batch_export.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+void testColumnarRoundTrip() {
+    std::string out;
+    mi::StringSink sink(out);
+
+    // A small row group size so the export spans several groups
+    std::vector<std::string> examples;
+    {
+        mi::ColumnarBatchExporter exporter(sink, 4);
+        for (int i = 0; i < 10; ++i) {
+            examples.push_back("ex" + std::to_string(i % 3) + ".metta");
+            exporter.addRow({examples.back(), i % 2 ? "conflict" : "violation",
+                             "soa_" + std::to_string(i), "", "row " + std::to_string(i)});
+        }
+        exporter.finish();
+        assert(exporter.rowCount() == 10);
+    }
+
+    mi::ColumnarBatchReader reader(out);
+    if (reader.rowCount() != 10) {
+        throw std::runtime_error("Columnar export lost rows");
+    }
+    for (size_t i = 0; i < reader.rowCount(); ++i) {
+        auto row = reader.row(i);
+        if (row.example != examples[i] || row.subject != "soa_" + std::to_string(i) ||
+            row.description != "row " + std::to_string(i)) {
+            throw std::runtime_error("Columnar row " + std::to_string(i) + " differs");
+        }
+        assert(row.kind == (i % 2 ? "conflict" : "violation"));
+        assert(row.object.empty());
+    }
+
+    // Repeated values are stored once per row group (of 4, 4 and 2 rows)
+    if (reader.dictionary(0).size() != 8 || reader.dictionary(1).size() != 6 ||
+        reader.dictionary(3).size() != 3) {
+        throw std::runtime_error("Dictionaries not kept per row group");
+    }
+
+    std::cout << "✓ Columnar round trip test passed\n";
+}
+
+void testMalformedColumnar() {
+    std::string out;
+    mi::StringSink sink(out);
+    {
+        mi::ColumnarBatchExporter exporter(sink);
+        exporter.addRow({"a.metta", "inferred_fact", "vessel moored", "", ""});
+    }  // Destructor writes the trailer
+
+    mi::ColumnarBatchReader complete(out);
+    assert(complete.rowCount() == 1);
+
+    auto rejects = [](std::string_view data) {
+        try {
+            mi::ColumnarBatchReader reader(data);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+
+    for (size_t length = 0; length < out.size(); ++length) {
+        if (!rejects(std::string_view(out).substr(0, length))) {
+            throw std::runtime_error("Truncated export of " + std::to_string(length) + " bytes accepted");
+        }
+    }
+
+    std::string trailing = out + "x";
+    assert(rejects(trailing));
+
+    // A row count larger than the file is rejected before anything is
+    // allocated for it
+    std::string header = out.substr(0, 8);
+    std::string huge = header + "R" + std::string("\xff\xff\xff\xff", 4) + std::string(64, '\0');
+    if (!rejects(huge)) {
+        throw std::runtime_error("Oversized row group accepted");
+    }
+
+    std::string wrongVersion = out;
+    wrongVersion[4] = 9;
+    assert(rejects(wrongVersion));
+    assert(rejects("example,kind\n"));
+
+    std::cout << "✓ Malformed columnar test passed\n";
+}
+
+void testCsvExport() {
+    std::string out;
+    mi::StringSink sink(out);
+    auto exporter = mi::BatchExporter::create(mi::BatchExportFormat::CSV, sink);
+    exporter->addRow({"a,b.metta", "error", "parse \"failed\"", "", ""});
+    exporter->finish();
+
+    assert(exporter->rowCount() == 1);
+    assert(out == "example,kind,subject,object,description\n"
+                  "\"a,b.metta\",error,\"parse \"\"failed\"\"\",,\n");
+    assert(std::string(mi::BatchExporter::extension(mi::BatchExportFormat::CSV)) == ".csv");
+
+    std::cout << "✓ CSV export test passed\n";
+}
+
+void testMetricsRows() {
+    mi::Metrics metrics;
+    metrics.contradictionDetails.push_back({"soa_a", "soa_b", "a contradicts b"});
+    metrics.violationDetails.push_back({"soa_elam", "must_not_leave", "elam left"});
+    metrics.inferredStateOfAffairs = {"vessel moored", "cargo released"};
+
+    std::string out;
+    mi::StringSink sink(out);
+    auto exporter = mi::BatchExporter::create(mi::BatchExportFormat::Columnar, sink);
+    exporter->addMetrics("ex.metta", metrics);
+    exporter->finish();
+
+    mi::ColumnarBatchReader reader(out);
+    assert(reader.rowCount() == 4);
+    assert(reader.row(0).kind == "contradiction");
+    assert(reader.row(0).description == "a contradicts b");
+    assert(reader.row(1).kind == "violation");
+    assert(reader.row(1).object == "must_not_leave");
+    assert(reader.row(3).subject == "cargo released");
+    if (reader.row(3).example != "ex.metta") {
+        throw std::runtime_error("Metrics rows lost their example name");
+    }
+
+    std::cout << "✓ Metrics rows test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running batch export tests...\n";
+
+        testColumnarRoundTrip();
+        testMalformedColumnar();
+        testCsvExport();
+        testMetricsRows();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,169 @@
+#include "metta_inference/buffer_writer.hpp"
+#include "metta_inference/formatters.hpp"
+#include "metta_inference/json_value.hpp"
+#include <iostream>
+#include <random>
+#include <limits>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+// Byte-at-a-time reference escaper
+std::string referenceJson(std::string_view text) {
+    static const char* HEX = "0123456789abcdef";
+    std::string out = "\"";
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out += HEX[c >> 4];
+                    out += HEX[c & 0xF];
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    return out + "\"";
+}
+
+template <typename WriteFn>
+std::string capture(WriteFn writeFn, size_t capacity = 64) {
+    std::string out;
+    mi::StringSink sink(out);
+    {
+        mi::BufferWriter writer(sink, capacity);
+        writeFn(writer);
+    }
+    return out;
+}
+
+void testJsonEscaping() {
+    std::mt19937 rng(42);
+
+    // Every byte value, at every offset within a vector register
+    for (size_t offset = 0; offset < 40; ++offset) {
+        for (int byte = 0; byte < 256; ++byte) {
+            std::string text(offset, 'a');
+            text += static_cast<char>(byte);
+            text += std::string(35, 'b');
+
+            size_t expected = (byte == '"' || byte == '\\' || byte < 0x20) ? offset : text.size();
+            if (mi::findJsonEscape(text) != expected) {
+                throw std::runtime_error("findJsonEscape mismatch at byte " + std::to_string(byte));
+            }
+        }
+    }
+
+    // Random strings, mostly clean with occasional specials, through a small buffer
+    for (int round = 0; round < 500; ++round) {
+        std::string text(rng() % 300, 'x');
+        for (auto& c : text) {
+            unsigned roll = rng() % 20;
+            c = roll == 0 ? static_cast<char>(rng() % 256) : static_cast<char>('a' + roll);
+        }
+        std::string written = capture([&](mi::BufferWriter& w) { w.writeJsonString(text); });
+        if (written != referenceJson(text)) {
+            throw std::runtime_error("JSON escaping differs from the reference");
+        }
+    }
+
+    std::cout << "✓ JSON escaping test passed (" << mi::escapeScannerIsa() << ")\n";
+}
+
+void testCsvFields() {
+    assert(capture([](mi::BufferWriter& w) { w.writeCsvField("plain field"); }) == "plain field");
+    assert(capture([](mi::BufferWriter& w) { w.writeCsvField("a,b"); }) == "\"a,b\"");
+    assert(capture([](mi::BufferWriter& w) { w.writeCsvField("say \"hi\""); }) == "\"say \"\"hi\"\"\"");
+    assert(capture([](mi::BufferWriter& w) { w.writeCsvField("line\nbreak"); }) == "\"line\nbreak\"");
+
+    std::string longField(100, 'z');
+    longField[70] = ',';
+    assert(mi::findCsvSpecial(longField) == 70);
+    assert(mi::findCsvSpecial(std::string(100, 'z')) == 100);
+
+    std::cout << "✓ CSV field test passed\n";
+}
+
+void testIntegersAndChunking() {
+    std::string out = capture([](mi::BufferWriter& w) {
+        w.writeInt(0);
+        w.put(' ');
+        w.writeInt(-42);
+        w.put(' ');
+        w.writeInt(std::numeric_limits<int64_t>::min());
+        w.put(' ');
+        w.writeUInt(std::numeric_limits<uint64_t>::max());
+    });
+    assert(out == "0 -42 -9223372036854775808 18446744073709551615");
+
+    // Writes larger than the staging buffer go straight through, in order
+    std::string big(1000, 'q');
+    out = capture([&](mi::BufferWriter& w) {
+        w.write("head ");
+        w.write(big);
+        w.write(" tail");
+    }, 16);
+    assert(out == "head " + big + " tail");
+
+    std::cout << "✓ Integer and chunking test passed\n";
+}
+
+void testJsonFormatterOutput() {
+    mi::Metrics metrics;
+    metrics.contradictions = 1;
+    metrics.contradictionPairs = 1;
+    metrics.violations = 1;
+    metrics.contradictionDetails.push_back({"soa_a", "soa_b", "pays in \"INRS\"\nand USDS"});
+    metrics.violationDetails.push_back({"soa_elam", "must_not_leave", "tab\there"});
+    metrics.inferredStateOfAffairs = {"ALEXANDRA MÆRSK moor"};
+
+    mi::Config config;
+    auto formatter = mi::FormatterFactory::create(mi::OutputFormat::JSON);
+    std::string output = formatter->format(config, metrics, "", "ex\"ample");
+
+    auto doc = mi::JsonValue::parse(output);
+    assert(doc.find("example")->asString() == "ex\"ample");
+    assert(doc.find("results")->find("total")->asNumber() == metrics.total());
+
+    // Same shape as the stream-based formatter it replaced: counts only, so
+    // lazily described findings are never rendered here
+    std::string timestamp = doc.find("timestamp")->asString();
+    std::string expected = "{\n  \"example\": \"ex\\\"ample\",\n  \"timestamp\": \"" + timestamp + "\",\n"
+                           "  \"results\": {\n    \"contradictions\": 1,\n    \"compliances\": 0,\n"
+                           "    \"conflicts\": 0,\n    \"necessary_violations\": 1,\n    \"total\": 2\n  },\n"
+                           "  \"interpretation\": {\n    \"has_logical_issues\": true,\n"
+                           "    \"is_consistent\": false,\n    \"has_fulfilled_obligations\": false\n  }\n}";
+    if (output != expected) {
+        throw std::runtime_error("JSON report changed shape:\n" + output);
+    }
+
+    std::string csv = mi::FormatterFactory::create(mi::OutputFormat::CSV)->format(config, metrics, "", "a,b");
+    assert(csv.find("\n\"a,b\",") != std::string::npos);
+
+    std::cout << "✓ JSON formatter output test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running BufferWriter tests...\n";
+
+        testJsonEscaping();
+        testCsvFields();
+        testIntegersAndChunking();
+        testJsonFormatterOutput();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
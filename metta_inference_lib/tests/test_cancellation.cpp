@@ -0,0 +1,356 @@
+#include "metta_api.hpp"
+#include "metta_server.hpp"
+#include "metta_client.hpp"
+#include "metta_inference/cancellation.hpp"
+#include "metta_inference/process_executor.hpp"
+#include "metta_inference/process_reactor.hpp"
+#include "metta_inference/semantic_analyzer.hpp"
+#include "metta_inference/inference_scheduler.hpp"
+#include "fake_repl.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <cassert>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+namespace mi = metta_inference;
+using namespace metta_api;
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+// Fake REPL that hangs, leaving a child behind
+struct HangingRepl : FakeRepl {
+    HangingRepl()
+        : FakeRepl("cancel_test", "sleep 30 &\necho $! > \"$(dirname \"$0\")/child.pid\"\nwait") {}
+
+    // The REPL's background child is gone (not merely orphaned)
+    bool childKilled() const {
+        pid_t child = 0;
+        std::ifstream(root / "child.pid") >> child;
+        if (child <= 0) return false;
+        for (int i = 0; i < 100; ++i) {
+            std::ifstream stat("/proc/" + std::to_string(child) + "/stat");
+            std::string pid, name, state;
+            if (!(stat >> pid >> name >> state) || state == "Z") return true;
+            std::this_thread::sleep_for(10ms);
+        }
+        return false;
+    }
+};
+
+// Cancels token after delay, on another thread
+std::thread cancelLater(mi::CancellationToken token, std::chrono::milliseconds delay) {
+    return std::thread([token, delay]() mutable {
+        std::this_thread::sleep_for(delay);
+        token.cancel();
+    });
+}
+
+void testToken() {
+    mi::CancellationToken inert;
+    inert.cancel();
+    assert(!inert.canBeCancelled());
+    if (inert.isCancelled()) {
+        throw std::runtime_error("Default token was cancelled");
+    }
+
+    auto token = mi::CancellationToken::create();
+    auto copy = token;
+    int calls = 0;
+    auto registration = token.onCancel([&calls]() { ++calls; });
+    auto dropped = token.onCancel([&calls]() { calls += 100; });
+    dropped.reset();
+
+    copy.cancel();
+    copy.cancel();
+    if (!token.isCancelled() || calls != 1) {
+        throw std::runtime_error("Cancellation not shared or callbacks not run exactly once");
+    }
+
+    // Late registrations run right away
+    token.onCancel([&calls]() { ++calls; });
+    assert(calls == 2);
+
+    bool threw = false;
+    try {
+        token.throwIfCancelled();
+    } catch (const mi::CancelledError&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Cancelled token did not throw");
+    }
+
+    std::cout << "✓ Token test passed\n";
+}
+
+void testExecutor() {
+    HangingRepl fixture;
+    auto token = mi::CancellationToken::create();
+    auto canceller = cancelLater(token, 100ms);
+
+    auto start = Clock::now();
+    bool cancelled = false;
+    try {
+        mi::ProcessExecutor::execute("\"" + fixture.repl + "\"", std::nullopt, token);
+    } catch (const mi::CancelledError&) {
+        cancelled = true;
+    }
+    canceller.join();
+
+    if (!cancelled || Clock::now() - start > 5s) {
+        throw std::runtime_error("Executor did not stop promptly on cancellation");
+    }
+    if (!fixture.childKilled()) {
+        throw std::runtime_error("Command's process group survived cancellation");
+    }
+
+    std::cout << "✓ Executor cancellation test passed\n";
+}
+
+void testReactor() {
+    HangingRepl fixture;
+    mi::ProcessReactor reactor(1);
+    auto token = mi::CancellationToken::create();
+
+    std::promise<bool> outcome;
+    reactor.submit("\"" + fixture.repl + "\"", 60s,
+                   [&outcome](mi::ProcessExecutor::ExecutionResult&&, std::exception_ptr error) {
+                       try {
+                           if (error) std::rethrow_exception(error);
+                           outcome.set_value(false);
+                       } catch (const mi::CancelledError&) {
+                           outcome.set_value(true);
+                       } catch (...) {
+                           outcome.set_value(false);
+                       }
+                   }, token);
+
+    std::this_thread::sleep_for(100ms);
+    token.cancel();
+    auto future = outcome.get_future();
+    if (future.wait_for(5s) != std::future_status::ready || !future.get()) {
+        throw std::runtime_error("Reactor did not fail the command as cancelled");
+    }
+    assert(fixture.childKilled());
+
+    std::cout << "✓ Reactor cancellation test passed\n";
+}
+
+void testAnalyzer() {
+    mi::SemanticAnalyzer analyzer;
+    auto token = mi::CancellationToken::create();
+    std::string output = "[(triple soa_a type soaPay)]\n[()]\n";
+
+    // Untouched tokens change nothing
+    analyzer.analyze(output, token);
+
+    token.cancel();
+    bool threw = false;
+    try {
+        analyzer.analyze(output, token);
+    } catch (const mi::CancelledError&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Analyzer ignored a cancelled token");
+    }
+
+    std::cout << "✓ Analyzer cancellation test passed\n";
+}
+
+void testSchedulerWithdraw() {
+    auto scheduler = mi::InferenceScheduler::create({1, 1, 0, 16});
+    std::vector<mi::InferenceScheduler::Slot> slots;
+    int started = 0;
+    int rejected = 0;
+    auto start = [&](mi::InferenceScheduler::Slot slot) {
+        ++started;
+        slots.push_back(std::move(slot));
+    };
+    auto reject = [&](const std::string&) { ++rejected; };
+
+    auto running = scheduler->submit(mi::InferenceScheduler::Priority::Normal, {}, start, reject);
+    auto queued = scheduler->submit(mi::InferenceScheduler::Priority::Normal, {}, start, reject);
+
+    if (scheduler->withdraw(running) || !scheduler->withdraw(queued) || scheduler->withdraw(queued)) {
+        throw std::runtime_error("Only a queued job may be withdrawn, once");
+    }
+    slots.clear();
+    if (started != 1 || rejected != 0 || scheduler->stats().queued != 0) {
+        throw std::runtime_error("Withdrawn job was started or rejected");
+    }
+
+    std::cout << "✓ Scheduler withdraw test passed\n";
+}
+
+void testApi() {
+    HangingRepl fixture;
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+    api.enableScheduling(true, {1, 1, 0, 16});
+
+    // One request runs, the other waits for its slot
+    InferenceRequest first;
+    first.exampleContent = "; first\n";
+    first.cancellation = CancellationToken::create();
+    InferenceRequest second;
+    second.exampleContent = "; second\n";
+    second.cancellation = CancellationToken::create();
+
+    auto start = Clock::now();
+    auto running = api.runInferenceAsync(first);
+    auto queued = api.runInferenceAsync(second);
+    std::this_thread::sleep_for(100ms);
+    assert(api.schedulingStats().queued == 1);
+
+    // The queued request leaves the queue without ever starting
+    second.cancellation.cancel();
+    if (queued.wait_for(2s) != std::future_status::ready) {
+        throw std::runtime_error("Queued request not answered when cancelled");
+    }
+    auto response = queued.get();
+    if (!response.cancelled || response.success || api.schedulingStats().started != 1) {
+        throw std::runtime_error("Queued request not withdrawn");
+    }
+
+    // The running one has its REPL killed
+    first.cancellation.cancel();
+    if (running.wait_for(5s) != std::future_status::ready) {
+        throw std::runtime_error("Running request not answered when cancelled");
+    }
+    response = running.get();
+    if (!response.cancelled || Clock::now() - start > 10s) {
+        throw std::runtime_error("Running request not cancelled: " + response.error);
+    }
+    assert(fixture.childKilled());
+
+    // Blocking calls return as cancelled too, and an already-cancelled
+    // request never starts
+    api.enableScheduling(false);
+    InferenceRequest blocking;
+    blocking.exampleContent = "; blocking\n";
+    blocking.cancellation = CancellationToken::create();
+    auto canceller = cancelLater(blocking.cancellation, 100ms);
+    auto blocked = api.runInference(blocking);
+    canceller.join();
+    if (!blocked.cancelled) {
+        throw std::runtime_error("Blocking request not cancelled: " + blocked.error);
+    }
+    assert(api.runInference(blocking).cancelled);
+
+    std::cout << "✓ API cancellation test passed\n";
+}
+
+void testDaemon() {
+    HangingRepl fixture;
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+
+    std::string socketPath = (fixture.root / "daemon.sock").string();
+    MettaServer server(api, {socketPath});
+    server.start();
+
+    {
+        MettaClient client(socketPath);
+        InferenceRequest request;
+        request.exampleContent = "; remote\n";
+        request.cancellation = CancellationToken::create();
+
+        auto pending = client.runInferenceAsync(request);
+        std::this_thread::sleep_for(100ms);
+        request.cancellation.cancel();
+        if (pending.wait_for(5s) != std::future_status::ready) {
+            throw std::runtime_error("Daemon did not answer the cancelled request");
+        }
+        auto response = pending.get();
+        if (!response.cancelled) {
+            throw std::runtime_error("Cancellation not forwarded to the daemon: " + response.error);
+        }
+        assert(fixture.childKilled());
+
+        // A client that goes away cancels what it left running
+        auto abandoned = std::make_unique<MettaClient>(socketPath);
+        InferenceRequest orphan;
+        orphan.exampleContent = "; orphan\n";
+        abandoned->runInferenceAsync(orphan, [](InferenceResponse) {});
+        std::this_thread::sleep_for(100ms);
+        assert(api.asyncInFlight() == 1);
+        abandoned.reset();
+
+        for (int i = 0; i < 500 && api.asyncInFlight() != 0; ++i) {
+            std::this_thread::sleep_for(10ms);
+        }
+        if (api.asyncInFlight() != 0) {
+            throw std::runtime_error("Disconnected client's request kept running");
+        }
+    }
+
+    if (server.stats().cancelled != 2) {
+        throw std::runtime_error("Unexpected cancellation count");
+    }
+    server.stop();
+
+    std::cout << "✓ Daemon cancellation test passed\n";
+}
+
+void testApiShutdown() {
+    HangingRepl fixture;
+    std::vector<std::future<InferenceResponse>> futures;
+    auto start = Clock::now();
+    {
+        MettaAPI api;
+        api.setMettaReplPath(fixture.repl);
+        api.setDefaultModulePaths(fixture.modules);
+        api.enableScheduling(true, {1, 1, 0, 16});
+        api.enableRequestCoalescing(true);
+
+        // One running, the rest queued or waiting to be grouped
+        for (int i = 0; i < 4; ++i) {
+            InferenceRequest request;
+            request.exampleContent = "; shutdown " + std::to_string(i) + "\n";
+            futures.push_back(api.runInferenceAsync(request));
+        }
+        std::this_thread::sleep_for(100ms);
+    }
+
+    // Destroying the API answers every request instead of crashing
+    for (auto& future : futures) {
+        if (future.wait_for(5s) != std::future_status::ready) {
+            throw std::runtime_error("Request not answered when the API was destroyed");
+        }
+        if (future.get().success) {
+            throw std::runtime_error("Hanging request reported success");
+        }
+    }
+    if (Clock::now() - start > 10s) {
+        throw std::runtime_error("API shutdown waited for hanging requests");
+    }
+
+    std::cout << "✓ API shutdown test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running cancellation tests...\n";
+
+        testToken();
+        testExecutor();
+        testReactor();
+        testAnalyzer();
+        testSchedulerWithdraw();
+        testApi();
+        testApiShutdown();
+        testDaemon();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
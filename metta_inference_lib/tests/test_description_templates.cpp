@@ -0,0 +1,107 @@
+#include "metta_inference/entity_resolver.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+// The find/replace substitution templates used before compilation
+std::string legacySubstitute(const std::string& templateStr,
+                             const std::map<std::string, std::string>& variables) {
+    std::string result = templateStr;
+    for (const auto& [key, value] : variables) {
+        std::string placeholder = "{" + key + "}";
+        size_t pos = 0;
+        while ((pos = result.find(placeholder, pos)) != std::string::npos) {
+            result.replace(pos, placeholder.length(), value);
+            pos += value.length();
+        }
+    }
+    return result;
+}
+
+void testGeneratedDescriptions() {
+    mi::DescriptionTemplates templates;
+
+    assert(templates.generateContradictionDescription(
+               "ALEXANDRA MÆRSK moor", "ALEXANDRA MÆRSK does not moor", "action") ==
+           "Contradiction: ALEXANDRA MÆRSK cannot both moor and not moor at the same time");
+
+    assert(templates.generateContradictionDescription("a pays", "a refuses", "payment_method") ==
+           "Contradiction: Payment declared in {instrument1} but {instrument2} is required");
+
+    assert(templates.generateContradictionDescription("x pays in USDS", "x pays", "USDS") ==
+           "Contradiction: Payment declared in USDS but INRS is required");
+
+    assert(templates.generateContradictionDescription("ship leave", "ship stay", "existence") ==
+           "Contradiction: ship cannot both leave and stay");
+
+    // Unbound placeholders stay visible, as before
+    assert(templates.generateConflictDescription("R1", "R2", "R1 conflicts with R2") ==
+           "Regulatory conflict: {regulation1} prohibits {action} while {regulation2} requires it");
+
+    assert(templates.generateConflictDescription("Port", "Bank", "payment currency") ==
+           "Port faces a conflict: payment currency");
+
+    assert(templates.generateViolationDescription("ship", "berth rule", "late arrival") ==
+           "The berth rule must be violated due to late arrival");
+
+    assert(templates.generateComplianceDescription("ship", "fee", "paying") ==
+           "ship successfully fulfills fee by paying");
+
+    std::cout << "✓ Generated descriptions test passed\n";
+}
+
+void testOverrideAndRenderTo() {
+    mi::DescriptionTemplates templates;
+    templates.addTemplate("violation_necessary", "{violator} breaks {rule} ({unknown} {reason})");
+
+    assert(templates.generateViolationDescription("ship", "rule 7", "fog") ==
+           "ship breaks rule 7 ({unknown} fog)");
+
+    mi::TemplateVars vars;
+    vars.set(mi::TemplateSlot::Entity, "ship");
+    vars.set(mi::TemplateSlot::Requirement, "pilotage");
+
+    std::string buffer = "> ";
+    assert(templates.renderTo("compliance_met", vars, buffer));
+    assert(buffer == "> Requirement pilotage is met by ship");
+    assert(!templates.renderTo("no_such_template", vars, buffer));
+
+    std::cout << "✓ Override and renderTo test passed\n";
+}
+
+void testSubstituteMatchesLegacy() {
+    mi::DescriptionTemplates templates;
+    std::map<std::string, std::string> vars = {
+        {"entity", "ALEXANDRA MÆRSK"}, {"action", "moor"}, {"reason", "tide"}, {"empty", ""}};
+
+    for (const std::string pattern : {
+             "{entity} cannot {action} because of {reason}",
+             "{action}{action}{{entity}}",
+             "no placeholders at all",
+             "{missing} and {entity",
+             "}{entity}{",
+             "{empty}|{reason}|{}",
+         }) {
+        assert(templates.substitute(pattern, vars) == legacySubstitute(pattern, vars));
+    }
+
+    std::cout << "✓ substitute legacy equivalence test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running DescriptionTemplates tests...\n";
+
+        testGeneratedDescriptions();
+        testOverrideAndRenderTo();
+        testSubstituteMatchesLegacy();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,83 @@
+#include "metta_inference/entity_resolver.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+void testDefaultRewrites() {
+    mi::EntityResolver resolver;
+
+    assert(resolver.resolveEntity("soa_ALEXANDRA_MAERSK") == "ALEXANDRA MÆRSK");
+    assert(resolver.entityToHumanReadable("soa_GERDA_MAERSK") == "GERDA MÆRSK");
+    // Overlapping patterns: the longer "MAERSK" wins over "AERSK" at the same spot
+    assert(resolver.entityToHumanReadable("soa_MAERSK_AERSKX") == "MÆRSK ÆRSKX");
+    assert(resolver.entityToHumanReadable("berth_7") == "berth_7");
+    // Repeated lookups come from the memo and must not change
+    assert(resolver.entityToHumanReadable("soa_GERDA_MAERSK") == "GERDA MÆRSK");
+
+    std::cout << "✓ Default rewrite test passed\n";
+}
+
+void testPatternRewriter() {
+    mi::PatternRewriter rewriter;
+    rewriter.build({{"he", "HE"}, {"she", "SHE"}, {"hers", "HERS"}, {"his", "HIS"}, {"", "x"}});
+
+    assert(rewriter.rewrite("ushers") == "uSHErs");
+    assert(rewriter.rewrite("hishers") == "HISHERS");
+    assert(rewriter.rewrite("") == "");
+    assert(rewriter.rewrite("nothing here") == "nothing HEre");
+
+    // Replacements are not rescanned
+    mi::PatternRewriter cyclic;
+    cyclic.build({{"a", "ab"}, {"b", "a"}});
+    assert(cyclic.rewrite("ab") == "aba");
+
+    std::cout << "✓ PatternRewriter test passed\n";
+}
+
+void testLargeMappingTable() {
+    mi::EntityResolver resolver;
+
+    std::map<std::string, std::string> fleet;
+    for (int i = 0; i < 2000; ++i) {
+        fleet["VESSEL" + std::to_string(i) + "X"] = "Vessel " + std::to_string(i);
+    }
+    resolver.addSpecialCharMappings(fleet);
+
+    assert(resolver.entityToHumanReadable("soa_VESSEL1234X_MAERSK") == "Vessel 1234 MÆRSK");
+    assert(resolver.entityToHumanReadable("soa_VESSEL12X") == "Vessel 12");
+
+    std::cout << "✓ Large mapping table test passed\n";
+}
+
+void testMemoInvalidation() {
+    mi::EntityResolver resolver;
+    assert(resolver.entityToHumanReadable("soa_PORT_OF_NHAVA") == "PORT OF NHAVA");
+
+    resolver.addSpecialCharMapping("NHAVA", "Nhava Sheva");
+    assert(resolver.entityToHumanReadable("soa_PORT_OF_NHAVA") == "PORT OF Nhava Sheva");
+
+    // Copies get their own (empty) memo but the same mappings
+    mi::EntityResolver copy = resolver;
+    assert(copy.entityToHumanReadable("soa_PORT_OF_NHAVA") == "PORT OF Nhava Sheva");
+
+    std::cout << "✓ Memo invalidation test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running EntityResolver tests...\n";
+
+        testDefaultRewrites();
+        testPatternRewriter();
+        testLargeMappingTable();
+        testMemoInvalidation();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
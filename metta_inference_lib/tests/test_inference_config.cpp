@@ -0,0 +1,326 @@
+#include "metta_inference/entity_resolver.hpp"
+#include "metta_inference/json_value.hpp"
+#include "metta_inference/semantic_analyzer.hpp"
+#include "metta_inference/inference_engine.hpp"
+#include "fake_repl.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cassert>
+#include <unistd.h>
+
+namespace mi = metta_inference;
+namespace fs = std::filesystem;
+
+const char* SAMPLE_CONFIG = R"json({
+  "entityMappings": {
+    "soa_ALEXANDRA_MAERSK": "ALEXANDRA M\u00c6RSK",
+    "soa_ZBG": "Port of Zeebrugge"
+  },
+  "specialCharacters": { "MOLLER": "MØLLER" },
+  "instrumentMappings": { "soa_USDS": "USDS (US Dollar Stablecoin)" },
+  "actionMappings": {
+    "soaDock": { "pattern": "dock", "baseForm": "dock", "presentTense": "docks", "pastTense": "docked" }
+  },
+  "violationTemplates": { "necessary": "Rule {rule} breaks because {reason}" },
+  "patternRecognition": { "enableFuzzyMatching": true, "fuzzyThreshold": 0.85 },
+  "outputSettings": { "showInferenceChain": true }
+})json";
+
+void writeFile(const fs::path& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+void testJsonParser() {
+    auto value = mi::JsonValue::parse(R"( {"a": [1, -2.5e1, true, null], "b": "x\"\\\n\u00e9\ud83d\ude00", "a": {}} )");
+    assert(value.isObject());
+    assert(value.members().size() == 3);
+    assert(value.find("a")->isObject());  // Last duplicate wins
+    assert(value.members()[0].value.items()[1].asNumber() == -25.0);
+    assert(value.members()[0].value.items()[3].isNull());
+    assert(value.find("b")->asString() == "x\"\\\n\xC3\xA9\xF0\x9F\x98\x80");
+    assert(value.find("missing") == nullptr);
+
+    [[maybe_unused]] auto rejects = [](const char* text) {
+        try {
+            mi::JsonValue::parse(text);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(rejects(""));
+    assert(rejects("{\"a\": 1,}"));
+    assert(rejects("[01]"));
+    assert(rejects("\"unterminated"));
+    assert(rejects("\"\\ud800\""));
+    assert(rejects("{} extra"));
+    assert(rejects(std::string(1000, '[').c_str()));
+
+    std::cout << "✓ JSON parser test passed\n";
+}
+
+void testParseConfig() {
+    auto config = mi::InferenceConfiguration::parse(SAMPLE_CONFIG);
+    assert(config.entityMappings.at("soa_ALEXANDRA_MAERSK") == "ALEXANDRA MÆRSK");
+    assert(config.specialCharacters.at("MOLLER") == "MØLLER");
+    assert(config.instrumentMappings.size() == 1);
+    assert(config.actionMappings.at("soaDock").pastTense == "docked");
+    assert(config.violationTemplates.at("necessary") == "Rule {rule} breaks because {reason}");
+    assert(config.enableFuzzyMatching);
+    assert(config.fuzzyThreshold == 0.85);
+
+    bool threw = false;
+    try {
+        mi::InferenceConfiguration::parse(R"({"entityMappings": {"soa_X": 3}})");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) throw std::runtime_error("non-string mapping was accepted");
+
+    std::cout << "✓ Config parse test passed\n";
+}
+
+void testSnapshotSwap() {
+    auto& config = mi::InferenceConfiguration::getInstance();
+    auto before = config.current();
+
+    config.loadFromString(SAMPLE_CONFIG);
+    auto after = config.current();
+    assert(after != before);
+    assert(after->stats.generation == before->stats.generation + 1);
+    assert(after->stats.source == "<string>");
+    assert(after->stats.entries == 6);
+
+    // The old snapshot is untouched; the new one layers the document over defaults
+    assert(before->entityResolver.resolveEntity("soa_ZBG") != "Port of Zeebrugge");
+    assert(after->entityResolver.resolveEntity("soa_ZBG") == "Port of Zeebrugge");
+    assert(after->entityResolver.resolveInstrument("soa_USDS") == "USDS (US Dollar Stablecoin)");
+    assert(after->templates.generateViolationDescription("ship", "must_pay", "fees")
+           == "Rule must_pay breaks because fees");
+    assert(after->templates.generateConflictDescription("a", "b", "payment due")
+           == before->templates.generateConflictDescription("a", "b", "payment due"));
+
+    std::cout << "✓ Snapshot swap test passed\n";
+}
+
+void testReloadOnChange() {
+    auto& config = mi::InferenceConfiguration::getInstance();
+    fs::path path = fs::temp_directory_path() / ("metta_config_test_" + std::to_string(getpid()) + ".json");
+    writeFile(path, SAMPLE_CONFIG);
+
+    if (!config.loadIfChanged(path.string())) throw std::runtime_error("initial load not published");
+    auto loaded = config.current();
+    assert(loaded->stats.source == path.string());
+    assert(loaded->stats.bytes == std::string(SAMPLE_CONFIG).size());
+
+    // Unchanged file: no re-parse, same snapshot
+    if (config.loadIfChanged(path.string())) throw std::runtime_error("unchanged file reloaded");
+    assert(config.current() == loaded);
+
+    writeFile(path, R"({"entityMappings": {"soa_MICT": "Manila International Container Terminal"}})");
+    if (!config.reloadIfChanged()) throw std::runtime_error("changed file not reloaded");
+    if (config.getEntityResolver()->resolveEntity("soa_MICT") != "Manila International Container Terminal") {
+        throw std::runtime_error("changed mapping not used");
+    }
+
+    // A broken edit keeps the last good snapshot
+    auto good = config.current();
+    writeFile(path, "{\"entityMappings\": ");
+    if (config.reloadIfChanged()) throw std::runtime_error("broken file published");
+    assert(config.current() == good);
+
+    fs::remove(path);
+    std::cout << "✓ Reload on change test passed\n";
+}
+
+void testSupersededSnapshotsReleased() {
+    auto& config = mi::InferenceConfiguration::getInstance();
+    fs::path path = fs::temp_directory_path() / ("metta_config_release_" + std::to_string(getpid()) + ".json");
+    writeFile(path, R"({"entityMappings": {"soa_MICT": "Manila International Container Terminal"}})");
+    config.loadFromFile(path.string());
+
+    // A part handed out keeps its snapshot alive, and only until released
+    std::weak_ptr<const mi::ConfigSnapshot> superseded = config.current();
+    auto held = config.getEntityResolver();
+    writeFile(path, R"({"entityMappings": {"soa_MICT": "MICT"}})");
+    config.loadFromFile(path.string());
+    if (superseded.expired() || held->resolveEntity("soa_MICT") != "Manila International Container Terminal") {
+        throw std::runtime_error("Snapshot released while in use");
+    }
+    held.reset();
+    if (!superseded.expired()) {
+        throw std::runtime_error("Superseded snapshot kept alive");
+    }
+
+    fs::remove(path);
+    std::cout << "✓ Superseded snapshots released test passed\n";
+}
+
+void testResolverLoadConfiguration() {
+    fs::path path = fs::temp_directory_path() / ("metta_resolver_test_" + std::to_string(getpid()) + ".json");
+    writeFile(path, SAMPLE_CONFIG);
+
+    mi::EntityResolver resolver;
+    resolver.loadConfiguration(path.string());
+    assert(resolver.resolveEntity("soa_ZBG") == "Port of Zeebrugge");
+
+    mi::DescriptionTemplates templates;
+    templates.loadTemplates(path.string());
+    assert(templates.generateViolationDescription("ship", "must_pay", "fees")
+           == "Rule must_pay breaks because fees");
+
+    fs::remove(path);
+    std::cout << "✓ Resolver load configuration test passed\n";
+}
+
+std::string violationConfig(int revision) {
+    return R"({"violationTemplates": {"necessary": "Revision )" + std::to_string(revision) +
+           R"(: {rule} breaks because {reason}"}})";
+}
+
+void testCapturedSnapshotIsStable() {
+    auto& config = mi::InferenceConfiguration::getInstance();
+    config.loadFromString(violationConfig(1));
+
+    mi::SemanticAnalyzer analyzer;
+    auto result = analyzer.analyze("");
+    assert(result.configuration == config.current());
+    result.violations.push_back({"must_pay", "ship", "fees"});
+
+    auto metrics = std::move(result).toMetrics(mi::MetricsDetail::Lazy);
+    config.loadFromString(violationConfig(2));
+
+    // Rendered after the reload, but with the tables the analysis used
+    if (metrics.violationDescription(0) != "Revision 1: must_pay breaks because fees") {
+        throw std::runtime_error("lazy description used a newer snapshot");
+    }
+    assert(mi::SemanticAnalyzer().analyze("").configuration == config.current());
+
+    std::cout << "✓ Captured snapshot test passed\n";
+}
+
+void testConcurrentReaders() {
+    auto& config = mi::InferenceConfiguration::getInstance();
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                mi::SemanticAnalyzer analyzer;
+                auto result = analyzer.analyze("");
+                auto snapshot = result.configuration;
+                result.violations.push_back({"must_pay", "ship", "fees"});
+
+                auto metrics = std::move(result).toMetrics(mi::MetricsDetail::Lazy);
+                std::string expected = snapshot->templates.generateViolationDescription("ship", "must_pay", "fees");
+                if (metrics.violationDescription(0) != expected) {
+                    mismatches.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (int revision = 3; revision < 200; ++revision) {
+        config.loadFromString(violationConfig(revision));
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    if (mismatches.load() != 0) {
+        throw std::runtime_error("readers saw a mixed configuration");
+    }
+    std::cout << "✓ Concurrent readers test passed\n";
+}
+
+void testExplicitConfigFile() {
+    FakeRepl repl("config_file_test", "echo '[(conflict not_opt soa_elam)]'");
+    fs::path path = repl.root / "custom.json";
+    writeFile(path, R"({"entityMappings": {"soa_elam": "East Lamma Anchorage"}})");
+
+    // What metta_cli -c sets
+    mi::Config config = repl.config();
+    config.inferenceConfigFile = path;
+    auto snapshot = mi::captureInferenceConfiguration(config);
+    if (snapshot->entityResolver.resolveEntity("soa_elam") != "East Lamma Anchorage") {
+        throw std::runtime_error("Configuration file not used");
+    }
+
+    // and the reports of an engine built from it
+    writeFile(repl.root / "example.metta", "!(conflicts)\n");
+    config.outputFormat = mi::OutputFormat::Pretty;
+    auto result = mi::createInferenceEngineV2(config)->run(repl.root / "example.metta");
+    if (result.formattedOutput.find("East Lamma Anchorage") == std::string::npos) {
+        throw std::runtime_error("Report does not use the configured mapping:\n" + result.formattedOutput);
+    }
+
+    // Engines with different files, at once, each get their own; the
+    // shared instance is left alone
+    fs::path other = repl.root / "other.json";
+    writeFile(other, R"({"entityMappings": {"soa_elam": "Elam Terminal"}})");
+    auto shared = mi::InferenceConfiguration::getInstance().current();
+    std::vector<std::thread> threads;
+    std::atomic<int> mixed{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            mi::Config own;
+            own.inferenceConfigFile = t % 2 ? other : path;
+            const char* expected = t % 2 ? "Elam Terminal" : "East Lamma Anchorage";
+            for (int i = 0; i < 200; ++i) {
+                if (mi::captureInferenceConfiguration(own)->entityResolver.resolveEntity("soa_elam") != expected) {
+                    ++mixed;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (mixed > 0 || mi::InferenceConfiguration::getInstance().current() != shared) {
+        throw std::runtime_error("Configuration files of different engines mixed up");
+    }
+
+    mi::Config missing;
+    missing.inferenceConfigFile = repl.root / "missing.json";
+    bool threw = false;
+    try {
+        mi::captureInferenceConfiguration(missing);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Missing configuration file ignored");
+    }
+
+    std::cout << "✓ Explicit configuration file test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running inference configuration tests...\n";
+
+        testJsonParser();
+        testParseConfig();
+        testSnapshotSwap();
+        testReloadOnChange();
+        testSupersededSnapshotsReleased();
+        testResolverLoadConfiguration();
+        testCapturedSnapshotIsStable();
+        testConcurrentReaders();
+        testExplicitConfigFile();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,586 @@
+#include "metta_protocol.hpp"
+#include "metta_server.hpp"
+#include "metta_client.hpp"
+#include "metta_inference/lru_cache.hpp"
+#include "fake_repl.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <thread>
+#include <cassert>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+namespace mi = metta_inference;
+using namespace metta_api;
+
+// Fake REPL answering every query with an empty result
+struct DaemonFixture : FakeRepl {
+    DaemonFixture() : FakeRepl("daemon_test", "echo '[()]'") {}
+
+    std::string socketPath() const {
+        return (root / "daemon.sock").string();
+    }
+};
+
+void testProtocolRoundTrip() {
+    InferenceRequest request;
+    request.exampleContent = "(= (rule) (fact))";
+    request.modulePaths = {"/a", "/b"};
+    request.outputFormat = "text";
+    request.includeFindings = true;
+    request.rawOutputMode = "omit";
+    request.priority = "interactive";
+    request.tenant = "port-operator";
+    request.deadline = std::chrono::milliseconds(2500);
+    request.stopOnFirst = true;
+
+    std::string frame = WireProtocol::encodeRequest(42, request, "/tmp/example.metta");
+
+    FrameBuffer buffer;
+    std::string payload;
+    // Split mid-header: nothing is complete until the last byte arrives
+    buffer.append(frame.data(), 3);
+    bool early = buffer.next(payload);
+    buffer.append(frame.data() + 3, frame.size() - 4);
+    early = early || buffer.next(payload);
+    buffer.append(frame.data() + frame.size() - 1, 1);
+    if (early || !buffer.next(payload)) {
+        throw std::runtime_error("Frame boundaries not respected");
+    }
+    assert(buffer.buffered() == 0);
+
+    assert(WireProtocol::messageType(payload) == WireProtocol::MessageType::Request);
+    auto decoded = WireProtocol::decodeRequest(payload);
+    if (decoded.id != 42 || decoded.filePath != "/tmp/example.metta" ||
+        decoded.request.exampleContent != request.exampleContent ||
+        decoded.request.modulePaths != request.modulePaths) {
+        throw std::runtime_error("Request did not survive the round trip");
+    }
+    assert(decoded.request.outputFormat == "text");
+    assert(decoded.request.includeFindings);
+    assert(decoded.request.rawOutputMode == "omit");
+    assert(decoded.request.priority == "interactive" && decoded.request.tenant == "port-operator");
+    if (decoded.request.deadline != request.deadline || !decoded.request.stopOnFirst) {
+        throw std::runtime_error("Deadline or stop on first lost in the round trip");
+    }
+
+    // Equal requests share a key whatever their ids
+    std::string other = WireProtocol::encodeRequest(7, request, "/tmp/example.metta");
+    FrameBuffer otherBuffer;
+    std::string otherPayload;
+    otherBuffer.append(other.data(), other.size());
+    if (!otherBuffer.next(otherPayload) || WireProtocol::requestKey(payload) != WireProtocol::requestKey(otherPayload)) {
+        throw std::runtime_error("Request key depends on the request id");
+    }
+
+    InferenceResponse response;
+    response.success = true;
+    response.metrics.violations = 2;
+    response.findings.push_back({"violation", "alice", "rule-7", "Alice violates rule 7"});
+    response.formattedOutput = "{\"violations\": 2}";
+    response.rawOutput = std::string("[()]\0tail", 9);
+    response.hasLogicalIssues = true;
+    response.queueTimeMs = 12.5;
+    response.overloaded = true;
+    response.partial = true;
+    response.coverage = 0.75;
+
+    frame = WireProtocol::encodeResponse(5, response);
+    WireProtocol::setRequestId(frame, 9);
+    buffer.append(frame.data(), frame.size());
+    if (!buffer.next(payload)) {
+        throw std::runtime_error("Response frame not returned");
+    }
+
+    uint32_t id = 0;
+    auto back = WireProtocol::decodeResponse(payload, id);
+    if (id != 9 || !back.success || back.metrics.violations != 2 || back.rawOutput != response.rawOutput) {
+        throw std::runtime_error("Response did not survive the round trip");
+    }
+    assert(back.findings.size() == 1 && back.findings[0].subject == "alice");
+    assert(back.formattedOutput == response.formattedOutput);
+    assert(back.hasLogicalIssues);
+    if (back.queueTimeMs != 12.5 || !back.overloaded) {
+        throw std::runtime_error("Scheduling fields lost in the round trip");
+    }
+    if (!back.partial || back.coverage != 0.75) {
+        throw std::runtime_error("Partial result lost in the round trip");
+    }
+
+    std::cout << "✓ Protocol round trip test passed\n";
+}
+
+void testMalformedFrames() {
+    // A length beyond MAX_PAYLOAD is rejected before anything is buffered
+    FrameBuffer buffer;
+    const char oversized[] = {'\xff', '\xff', '\xff', '\xff'};
+    buffer.append(oversized, sizeof(oversized));
+    std::string payload;
+    bool threw = false;
+    try {
+        buffer.next(payload);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Oversized frame accepted");
+    }
+
+    // Truncated bodies and wrong versions are errors, not crashes
+    std::string frame = WireProtocol::encodeRequest(1, InferenceRequest{});
+    std::string truncated = frame.substr(WireProtocol::LENGTH_SIZE, frame.size() - WireProtocol::LENGTH_SIZE - 2);
+    threw = false;
+    try {
+        WireProtocol::decodeRequest(truncated);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::string wrongVersion = frame.substr(WireProtocol::LENGTH_SIZE);
+    wrongVersion[1] = '\x7f';
+    threw = false;
+    try {
+        WireProtocol::decodeRequest(wrongVersion);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Unknown protocol version accepted");
+    }
+
+    std::cout << "✓ Malformed frame test passed\n";
+}
+
+void testLruCache() {
+    mi::LruCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    [[maybe_unused]] auto touched = cache.get("a");  // "b" is now least recently used
+    assert(touched == 1);
+    cache.put("c", 3);
+
+    if (cache.get("b").has_value()) {
+        throw std::runtime_error("Least recently used entry not evicted");
+    }
+    if (cache.get("a") != 1 || cache.get("c") != 3 || cache.size() != 2) {
+        throw std::runtime_error("Recently used entries evicted");
+    }
+    assert(cache.hits() == 3 && cache.misses() == 1);
+
+    cache.put("a", 10);
+    [[maybe_unused]] auto replaced = cache.get("a");
+    assert(replaced == 10);
+    bool erased = cache.erase("a");
+    if (!erased || cache.erase("a")) {
+        throw std::runtime_error("Erase did not remove exactly one entry");
+    }
+    cache.clear();
+    assert(cache.size() == 0);
+
+    mi::LruCache<std::string, int> disabled(0);
+    disabled.put("a", 1);
+    assert(!disabled.get("a").has_value());
+
+    std::cout << "✓ LRU cache test passed\n";
+}
+
+void testServeAndCache() {
+    DaemonFixture fixture;
+
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+    api.enableModuleWatching();
+
+    MettaServer server(api, {fixture.socketPath(), 16, 8});
+    server.start();
+    assert(server.isRunning());
+    if (fs::status(fixture.socketPath()).permissions() != (fs::perms::owner_read | fs::perms::owner_write)) {
+        throw std::runtime_error("Socket not restricted to its owner");
+    }
+
+    {
+        MettaClient client(fixture.socketPath());
+        assert(client.isConnected());
+
+        // Pipelined on one connection; responses are matched back by id
+        std::vector<std::future<InferenceResponse>> futures;
+        for (int i = 0; i < 8; ++i) {
+            InferenceRequest request;
+            request.exampleContent = "; example " + std::to_string(i) + "\n";
+            futures.push_back(client.runInferenceAsync(request));
+        }
+        for (auto& future : futures) {
+            auto response = future.get();
+            if (!response.success) {
+                throw std::runtime_error("Daemon request failed: " + response.error);
+            }
+            assert(response.rawOutput.find("[()]") != std::string::npos);
+        }
+
+        // A repeat is served from the cache, output and all
+        InferenceRequest repeat;
+        repeat.exampleContent = "; example 3\n";
+        repeat.rawOutputMode = "shared";
+        std::string streamed;
+        repeat.outputCallback = [&streamed](std::string_view chunk) { streamed.append(chunk); };
+
+        auto cached = client.runInference(repeat);
+        assert(cached.success);
+        if (server.stats().cacheHits != 1) {
+            throw std::runtime_error("Repeated request was not served from the cache");
+        }
+        assert(cached.sharedRawOutput && cached.raw().find("[()]") != std::string_view::npos);
+        assert(!streamed.empty() && cached.formattedOutput.empty());
+
+        // Errors come back as responses
+        auto missing = client.runInferenceFromFile((fixture.root / "missing.metta").string());
+        if (missing.success || missing.error.empty()) {
+            throw std::runtime_error("Missing file not reported");
+        }
+
+        auto fromFile = fixture.root / "example.metta";
+        std::ofstream(fromFile) << "; from a file\n";
+        auto fileResponse = client.runInferenceFromFile(fromFile.string());
+        assert(fileResponse.success);
+    }
+
+    auto stats = server.stats();
+    if (stats.connections != 1 || stats.requests != 11 || stats.protocolErrors != 0) {
+        throw std::runtime_error("Unexpected server statistics");
+    }
+
+    server.stop();
+    assert(!server.isRunning());
+    if (fs::exists(fixture.socketPath())) {
+        throw std::runtime_error("Socket left behind after stop");
+    }
+
+    std::cout << "✓ Serve and cache test passed\n";
+}
+
+void testDisconnect() {
+    DaemonFixture fixture;
+
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+
+    auto server = std::make_unique<MettaServer>(api, MettaServer::Options{fixture.socketPath()});
+    server->start();
+
+    // A second server may not steal a live socket
+    bool threw = false;
+    try {
+        MettaServer(api, {fixture.socketPath()}).start();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Second server bound a socket in use");
+    }
+
+    MettaClient client(fixture.socketPath());
+    InferenceRequest request;
+    request.exampleContent = "; before\n";
+    if (!client.runInference(request).success) {
+        throw std::runtime_error("Request before shutdown failed");
+    }
+
+    server.reset();
+
+    // The reader notices the closed connection; later requests fail fast
+    for (int i = 0; i < 200 && client.isConnected(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (client.isConnected()) {
+        throw std::runtime_error("Client did not notice the daemon going away");
+    }
+    auto response = client.runInference(request);
+    assert(!response.success && !response.error.empty());
+
+    bool refused = false;
+    try {
+        MettaClient late(fixture.socketPath());
+    } catch (const std::runtime_error&) {
+        refused = true;
+    }
+    if (!refused) {
+        throw std::runtime_error("Connected to a stopped daemon");
+    }
+
+    std::cout << "✓ Disconnect test passed\n";
+}
+
+void testStopCancelsInFlight() {
+    DaemonFixture fixture;
+    fixture.setScript("sleep 30");
+
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+
+    MettaServer server(api, {fixture.socketPath()});
+    server.start();
+    MettaClient client(fixture.socketPath());
+    InferenceRequest request;
+    request.exampleContent = "; hangs\n";
+    auto future = client.runInferenceAsync(request);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // Not held up by the REPL's timeout
+    auto start = std::chrono::steady_clock::now();
+    server.stop();
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(5)) {
+        throw std::runtime_error("Stop waited for in-flight requests to finish");
+    }
+    if (server.stats().cancelled != 1 || future.get().success) {
+        throw std::runtime_error("In-flight request not cancelled at stop");
+    }
+
+    std::cout << "✓ Stop cancels in-flight test passed\n";
+}
+
+void testSlowReaderDropped() {
+    DaemonFixture fixture;
+    // Responses far larger than the socket buffer
+    fixture.setScript("head -c 2000000 /dev/zero | tr '\\0' x");
+
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+
+    MettaServer::Options options{fixture.socketPath()};
+    options.maxOutboundBytes = 4096;
+    MettaServer server(api, options);
+    server.start();
+
+    // Sends requests and never reads
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, fixture.socketPath().c_str());
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Cannot connect to the daemon");
+    }
+    for (uint32_t id = 1; id <= 3; ++id) {
+        InferenceRequest request;
+        request.exampleContent = "; large " + std::to_string(id) + "\n";
+        request.metricsDetail = "counts";
+        std::string frame = WireProtocol::encodeRequest(id, request);
+        if (::send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(frame.size())) {
+            throw std::runtime_error("Request not sent");
+        }
+    }
+
+    for (int i = 0; i < 500 && server.stats().slowReaders == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    close(fd);
+    if (server.stats().slowReaders != 1) {
+        throw std::runtime_error("Client that does not read was kept");
+    }
+
+    std::cout << "✓ Slow reader dropped test passed\n";
+}
+
+void testCacheFollowsConfiguration() {
+    DaemonFixture fixture;
+    fs::path configFile = fixture.root / "config.json";
+    std::ofstream(configFile) << R"({"entityMappings": {"soa_elam": "East Lamma Anchorage"}})";
+
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+    api.setInferenceConfigFile(configFile.string());
+    api.enableModuleWatching();
+
+    MettaServer server(api, {fixture.socketPath()});
+    server.start();
+    MettaClient client(fixture.socketPath());
+    InferenceRequest request;
+    request.exampleContent = "; cached\n";
+    client.runInference(request);
+    client.runInference(request);
+    if (server.stats().cacheHits != 1) {
+        throw std::runtime_error("Repeated request was not served from the cache");
+    }
+
+    // Another mapping may change the report, so the cached one is not used
+    std::ofstream(configFile) << R"({"entityMappings": {"soa_elam": "Elam"}})";
+    client.runInference(request);
+    if (server.stats().cacheHits != 1) {
+        throw std::runtime_error("Cached response served after a configuration change");
+    }
+
+    std::cout << "✓ Cache follows configuration test passed\n";
+}
+
+void testWatcherSwapDuringRequests() {
+    DaemonFixture fixture;
+
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+    api.enableModuleWatching();
+    SchedulingOptions scheduling;
+    scheduling.maxConcurrent = 4;
+    api.enableScheduling(true, scheduling);
+
+    // Requests read the watcher on worker threads while it is replaced
+    std::vector<std::future<InferenceResponse>> futures;
+    for (int i = 0; i < 16; ++i) {
+        InferenceRequest request;
+        request.exampleContent = "; swap " + std::to_string(i) + "\n";
+        futures.push_back(api.runInferenceAsync(request));
+        if (i % 4 == 0) {
+            api.enableModuleWatching(i % 8 == 0);
+            api.setDefaultModulePaths(fixture.modules);
+        }
+    }
+    for (auto& future : futures) {
+        auto response = future.get();
+        if (!response.success) {
+            throw std::runtime_error("Request failed while the watcher changed: " + response.error);
+        }
+    }
+
+    std::cout << "✓ Watcher swap during requests test passed\n";
+}
+
+void testScheduledFilesWithConfigFile() {
+    DaemonFixture fixture;
+    fixture.setScript("echo '[(conflict not_opt soa_elam)]'");
+    fs::path configFile = fixture.root / "custom.json";
+    std::ofstream(configFile) << R"({"entityMappings": {"soa_elam": "East Lamma Anchorage"}})";
+
+    // How metta_cli runs several examples with -c and -j
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+    api.setInferenceConfigFile(configFile.string());
+    SchedulingOptions scheduling;
+    scheduling.maxConcurrent = 2;
+    api.enableScheduling(true, scheduling);
+
+    InferenceRequest request;
+    request.outputFormat = "pretty";
+    std::vector<std::future<InferenceResponse>> futures;
+    for (int i = 0; i < 4; ++i) {
+        fs::path example = fixture.root / ("example" + std::to_string(i) + ".metta");
+        std::ofstream(example) << "!(conflicts)\n";
+        futures.push_back(api.runInferenceFromFileAsync(example.string(), request));
+    }
+    for (auto& future : futures) {
+        auto response = future.get();
+        if (!response.success || response.metrics.conflicts != 1) {
+            throw std::runtime_error("Scheduled file request failed: " + response.error);
+        }
+        if (response.formattedOutput.find("East Lamma Anchorage") == std::string::npos) {
+            throw std::runtime_error("Report does not use the configuration file:\n" + response.formattedOutput);
+        }
+    }
+
+    bool threw = false;
+    try {
+        api.setInferenceConfigFile((fixture.root / "missing.json").string());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Missing configuration file accepted");
+    }
+
+    std::cout << "✓ Scheduled files with configuration file test passed\n";
+}
+
+void testBlockingCallFromCallback() {
+    DaemonFixture fixture;
+
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+    SchedulingOptions scheduling;
+    scheduling.maxConcurrent = 1;
+    api.enableScheduling(true, scheduling);
+    api.enableRequestCoalescing(true);
+
+    // The callback holds the only slot and a completion thread
+    auto nested = std::make_shared<std::promise<InferenceResponse>>();
+    auto answered = nested->get_future();
+    InferenceRequest request;
+    request.exampleContent = "; outer\n";
+    api.runInferenceAsync(request, [&api, nested](InferenceResponse) {
+        InferenceRequest inner;
+        inner.exampleContent = "; inner\n";
+        nested->set_value(api.runInference(inner));
+    });
+
+    if (answered.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+        throw std::runtime_error("Blocking call from a callback deadlocked");
+    }
+    auto response = answered.get();
+    if (!response.success) {
+        throw std::runtime_error("Blocking call from a callback failed: " + response.error);
+    }
+
+    std::cout << "✓ Blocking call from callback test passed\n";
+}
+
+void testConfigNextToOutputDir() {
+    DaemonFixture fixture;
+    fixture.setScript("echo '[(conflict not_opt soa_elam)]'");
+    fs::create_directories(fixture.root / "config");
+    fs::create_directories(fixture.root / "results");
+    std::ofstream(fixture.root / "config" / "inference_config.json")
+        << R"({"entityMappings": {"soa_elam": "Outer Anchorage"}})";
+
+    // Where metta_cli looks with -o and without -c
+    MettaAPI api;
+    api.setMettaReplPath(fixture.repl);
+    api.setDefaultModulePaths(fixture.modules);
+    api.setOutputDir((fixture.root / "results").string());
+
+    fs::path example = fixture.root / "example.metta";
+    std::ofstream(example) << "!(conflicts)\n";
+    InferenceRequest request;
+    request.outputFormat = "pretty";
+    auto response = api.runInferenceFromFile(example.string(), request);
+    if (response.formattedOutput.find("Outer Anchorage") == std::string::npos) {
+        throw std::runtime_error("Configuration next to the output directory not used:\n" +
+                                 response.formattedOutput + response.error);
+    }
+
+    std::cout << "✓ Configuration next to output directory test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running inference daemon tests...\n";
+
+        testProtocolRoundTrip();
+        testMalformedFrames();
+        testLruCache();
+        testServeAndCache();
+        testDisconnect();
+        testStopCancelsInFlight();
+        testSlowReaderDropped();
+        testCacheFollowsConfiguration();
+        testWatcherSwapDuringRequests();
+        testScheduledFilesWithConfigFile();
+        testBlockingCallFromCallback();
+        testConfigNextToOutputDir();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
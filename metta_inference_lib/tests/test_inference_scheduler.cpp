@@ -0,0 +1,153 @@
+#include "metta_inference/inference_scheduler.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+using namespace std::chrono_literals;
+using Priority = mi::InferenceScheduler::Priority;
+
+// Records what started (holding its slot until released) and what was shed
+struct Recorder {
+    std::vector<std::string> started;
+    std::vector<mi::InferenceScheduler::Slot> slots;
+    std::vector<std::string> rejected;
+
+    void submit(mi::InferenceScheduler& scheduler, const std::string& name, Priority priority,
+                const std::string& tenant = {}) {
+        scheduler.submit(priority, tenant,
+                         [this, name](mi::InferenceScheduler::Slot slot) {
+                             started.push_back(name);
+                             slots.push_back(std::move(slot));
+                         },
+                         [this, name](const std::string&) { rejected.push_back(name); });
+    }
+
+    // Finishes the job that started index-th
+    void finish(size_t index) {
+        auto slot = std::move(slots[index]);
+    }
+};
+
+void testPriorityOrder() {
+    auto scheduler = mi::InferenceScheduler::create({1, 1, 0, 16});
+    Recorder recorder;
+
+    recorder.submit(*scheduler, "running", Priority::Batch);
+    recorder.submit(*scheduler, "batch", Priority::Batch);
+    recorder.submit(*scheduler, "normal", Priority::Normal);
+    recorder.submit(*scheduler, "interactive", Priority::Interactive);
+    assert(scheduler->stats().running == 1 && scheduler->stats().queued == 3);
+
+    // Each finished job makes room for the most urgent waiting one
+    for (size_t i = 0; i < 3; ++i) {
+        recorder.finish(i);
+    }
+    if (recorder.started != std::vector<std::string>{"running", "interactive", "normal", "batch"}) {
+        throw std::runtime_error("Jobs did not start in priority order");
+    }
+
+    recorder.finish(3);
+    auto stats = scheduler->stats();
+    assert(stats.running == 0 && stats.queued == 0 && stats.started == 4);
+    if (stats.running != 0) {
+        throw std::runtime_error("Released slots not returned");
+    }
+
+    std::cout << "✓ Priority order test passed\n";
+}
+
+void testBatchCapAndTenants() {
+    auto scheduler = mi::InferenceScheduler::create({4, 1, 1, 16});
+    Recorder recorder;
+
+    // Batch work is held to its share, leaving room for everything else
+    recorder.submit(*scheduler, "batch1", Priority::Batch);
+    recorder.submit(*scheduler, "batch2", Priority::Batch);
+    recorder.submit(*scheduler, "interactive", Priority::Interactive, "port-a");
+    assert(recorder.started.size() == 2);
+
+    // One at a time per tenant; others and requests without a tenant pass
+    recorder.submit(*scheduler, "port-a again", Priority::Interactive, "port-a");
+    recorder.submit(*scheduler, "port-b", Priority::Interactive, "port-b");
+    if (recorder.started != std::vector<std::string>{"batch1", "interactive", "port-b"}) {
+        throw std::runtime_error("Batch cap or tenant limit not applied");
+    }
+    recorder.submit(*scheduler, "anonymous", Priority::Normal);
+    assert(recorder.started.size() == 4);
+
+    // Freeing port-a's slot starts its queued request ahead of the batch job
+    recorder.finish(1);
+    if (recorder.started.back() != "port-a again") {
+        throw std::runtime_error("Tenant's queued request not started");
+    }
+    recorder.finish(0);
+    assert(recorder.started.back() == "batch2");
+
+    std::cout << "✓ Batch cap and tenant limit test passed\n";
+}
+
+void testLoadShedding() {
+    auto scheduler = mi::InferenceScheduler::create({1, 1, 0, 2});
+    Recorder recorder;
+
+    recorder.submit(*scheduler, "running", Priority::Normal);
+    recorder.submit(*scheduler, "batch1", Priority::Batch);
+    recorder.submit(*scheduler, "batch2", Priority::Batch);
+
+    // A full queue sheds the newest lower-priority job for interactive work
+    recorder.submit(*scheduler, "interactive", Priority::Interactive);
+    if (recorder.rejected != std::vector<std::string>{"batch2"}) {
+        throw std::runtime_error("Lower-priority job not shed");
+    }
+
+    // ...and rejects work that outranks nothing queued
+    recorder.submit(*scheduler, "batch3", Priority::Batch);
+    assert(recorder.rejected.size() == 2 && recorder.rejected.back() == "batch3");
+    assert(scheduler->stats().rejected == 2);
+
+    std::this_thread::sleep_for(20ms);
+    recorder.finish(0);
+    if (recorder.started.back() != "interactive" || recorder.slots.back().queueTime() < 20ms) {
+        throw std::runtime_error("Queue time not reported");
+    }
+
+    // Closing fails what is queued and anything submitted later
+    scheduler->close();
+    recorder.submit(*scheduler, "late", Priority::Interactive);
+    if (recorder.rejected != std::vector<std::string>{"batch2", "batch3", "batch1", "late"}) {
+        throw std::runtime_error("Closed scheduler kept jobs");
+    }
+
+    std::cout << "✓ Load shedding test passed\n";
+}
+
+void testParsePriority() {
+    assert(mi::InferenceScheduler::parsePriority("interactive") == Priority::Interactive);
+    assert(mi::InferenceScheduler::parsePriority("batch") == Priority::Batch);
+    assert(mi::InferenceScheduler::parsePriority("normal") == Priority::Normal);
+    if (mi::InferenceScheduler::parsePriority("urgent") != Priority::Normal) {
+        throw std::runtime_error("Unknown priority not treated as normal");
+    }
+
+    std::cout << "✓ Parse priority test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running InferenceScheduler tests...\n";
+
+        testPriorityOrder();
+        testBatchCapAndTenants();
+        testLoadShedding();
+        testParsePriority();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
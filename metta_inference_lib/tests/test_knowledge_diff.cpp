@@ -0,0 +1,101 @@
+#include "metta_inference/knowledge_io.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+const char* BASE_SOA = R"(
+(ct-triple soa_emam type soaMoor)
+(ct-triple soa_emam type rexist)
+(ct-triple soa_emam soaHas_agent soa_ALEXANDRA_MAERSK)
+(ct-triple soa_emam soaHas_location soa_BERTH_A)
+(ct-triple soa_epam type soaPay)
+(ct-triple soa_epam soaHas_agent soa_ALEXANDRA_MAERSK)
+(ct-simple-not soa_enmam soa_emam)
+)";
+
+void testIdenticalDocuments() {
+    auto soa = mi::KnowledgeIO::extractStateOfAffairsFromMetta(BASE_SOA);
+    auto diff = mi::KnowledgeIO::diffStateOfAffairs(soa, soa);
+
+    assert(diff.empty());
+    assert(!diff.requiresReevaluation());
+    assert(diff.affectedSubjects().empty());
+
+    std::cout << "✓ Identical documents test passed\n";
+}
+
+void testChangedAddedRemoved() {
+    std::string changed = BASE_SOA;
+    // Object change on a single-valued slot
+    changed.replace(changed.find("soa_BERTH_A"), 11, "soa_BERTH_B");
+    // Remove the payment agent, add a leave eventuality
+    changed.erase(changed.find("(ct-triple soa_epam soaHas_agent"),
+                  std::string("(ct-triple soa_epam soaHas_agent soa_ALEXANDRA_MAERSK)").size());
+    changed += "(ct-triple soa_elam type soaLeave)\n";
+
+    auto before = mi::KnowledgeIO::extractStateOfAffairsFromMetta(BASE_SOA);
+    auto after = mi::KnowledgeIO::extractStateOfAffairsFromMetta(changed);
+    auto diff = mi::KnowledgeIO::diffStateOfAffairs(before, after);
+
+    assert(diff.changedFacts.size() == 1);
+    assert(diff.changedFacts[0].before.object == "soa_BERTH_A");
+    assert(diff.changedFacts[0].after.object == "soa_BERTH_B");
+    assert(diff.addedFacts.size() == 1);
+    assert(diff.addedFacts[0].subject == "soa_elam");
+    assert(diff.removedFacts.size() == 1);
+    assert(diff.removedFacts[0].subject == "soa_epam");
+
+    assert(diff.addedEventualities.size() == 1);
+    assert(diff.changedEventualities.size() == 2);  // soa_emam role, soa_epam agent
+    assert(diff.addedConstraints.empty() && diff.removedConstraints.empty());
+
+    auto subjects = diff.affectedSubjects();
+    assert(subjects.count("soa_emam") && subjects.count("soa_epam") && subjects.count("soa_elam"));
+
+    // Scenario that never mentions the changed subjects is unaffected
+    auto unrelated = mi::KnowledgeIO::extractStateOfAffairsFromMetta(
+        "(ct-triple soa_eaxx soaHas_agent soa_OTHER)");
+    assert(!diff.requiresReevaluation(unrelated));
+    assert(diff.requiresReevaluation(before));
+
+    std::cout << "✓ Changed/added/removed test passed\n";
+}
+
+void testDuplicateFactsAndConstraints() {
+    std::string doubled = std::string(BASE_SOA) + "(ct-triple soa_emam type soaMoor)\n";
+    auto before = mi::KnowledgeIO::extractStateOfAffairsFromMetta(BASE_SOA);
+    auto after = mi::KnowledgeIO::extractStateOfAffairsFromMetta(doubled);
+
+    // Facts are a multiset: the second copy is an addition
+    auto diff = mi::KnowledgeIO::diffStateOfAffairs(before, after);
+    assert(diff.addedFacts.size() == 1);
+    assert(diff.removedFacts.empty());
+
+    std::string noNegation = BASE_SOA;
+    noNegation.erase(noNegation.find("(ct-simple-not"),
+                     std::string("(ct-simple-not soa_enmam soa_emam)").size());
+    auto withoutNeg = mi::KnowledgeIO::extractStateOfAffairsFromMetta(noNegation);
+    auto negDiff = mi::KnowledgeIO::diffStateOfAffairs(before, withoutNeg);
+    assert(negDiff.removedConstraints.size() == 1);
+    assert(negDiff.requiresReevaluation());
+
+    std::cout << "✓ Duplicates and constraints test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running KnowledgeIO diff tests...\n";
+
+        testIdenticalDocuments();
+        testChangedAddedRemoved();
+        testDuplicateFactsAndConstraints();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,130 @@
+#include "metta_inference/semantic_analyzer.hpp"
+#include "metta_inference/formatters.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+mi::SemanticAnalyzer::AnalysisResult makeResult() {
+    mi::SemanticAnalyzer::AnalysisResult result;
+
+    mi::StateOfAffairs moor;
+    moor.entity = "soa_emam";
+    moor.action = "moor";
+    moor.agent = "ALEXANDRA MAERSK";
+    result.inferredFacts.push_back(moor);
+
+    mi::LogicalContradiction contradiction;
+    contradiction.type = "payment_method";
+    contradiction.positive.entity = "soa_epamINRS";
+    contradiction.positive.action = "pay";
+    contradiction.positive.instrument = "INRS";
+    contradiction.negative.entity = "soa_epamUSDS";
+    contradiction.negative.action = "pay";
+    contradiction.negative.instrument = "USDS";
+    contradiction.negative.exists = false;
+    result.contradictions.push_back(contradiction);
+
+    result.conflicts.push_back({"not_opt", "soa_elam", "leave", "ALEXANDRA MAERSK"});
+    result.violations.push_back({"must_not_leave", "soa_elam", "obligation to pay"});
+    result.compliances.push_back({"soa_epam", "pay", "soa_epamINRS"});
+    return result;
+}
+
+void testLazyMatchesFull() {
+    auto result = makeResult();
+    auto full = result.toMetrics(mi::MetricsDetail::Full);
+    auto lazy = result.toMetrics(mi::MetricsDetail::Lazy);
+
+    assert(lazy.total() == full.total());
+    assert(lazy.contradictionDetails.size() == full.contradictionDetails.size());
+    assert(lazy.conflictDetails.size() == full.conflictDetails.size());
+    assert(lazy.violationDetails.size() == full.violationDetails.size());
+
+    // Nothing is rendered until a description is asked for
+    assert(lazy.contradictionDetails[0].description.empty());
+    assert(lazy.describer);
+
+    for (size_t i = 0; i < full.contradictionDetails.size(); ++i) {
+        assert(lazy.contradictionDescription(i) == full.contradictionDetails[i].description);
+    }
+    for (size_t i = 0; i < full.conflictDetails.size(); ++i) {
+        assert(lazy.conflictDescription(i) == full.conflictDetails[i].description);
+    }
+    for (size_t i = 0; i < full.violationDetails.size(); ++i) {
+        assert(lazy.violationDescription(i) == full.violationDetails[i].description);
+    }
+
+    std::cout << "✓ Lazy matches full test passed\n";
+}
+
+void testMovedResultOutlivesSource() {
+    auto full = makeResult().toMetrics(mi::MetricsDetail::Full);
+
+    mi::Metrics lazy;
+    {
+        auto result = makeResult();
+        lazy = std::move(result).toMetrics(mi::MetricsDetail::Lazy);
+    }
+    assert(lazy.conflictDescription(0) == full.conflictDetails[0].description);
+
+    lazy.materializeDescriptions();
+    assert(!lazy.describer);
+    assert(lazy.violationDetails[0].description == full.violationDetails[0].description);
+
+    std::cout << "✓ Moved result test passed\n";
+}
+
+void testCountsOnly() {
+    auto result = makeResult();
+    auto full = result.toMetrics(mi::MetricsDetail::Full);
+    auto counts = result.toMetrics(mi::MetricsDetail::CountsOnly);
+
+    assert(counts.contradictions == full.contradictions);
+    assert(counts.contradictionPairs == full.contradictionPairs);
+    assert(counts.conflicts == full.conflicts);
+    assert(counts.violations == full.violations);
+    assert(counts.compliances == full.compliances);
+    assert(counts.total() == full.total());
+    assert(counts.contradictionDetails.empty());
+    assert(counts.conflictDetails.empty());
+    assert(counts.violationDetails.empty());
+    assert(!counts.describer);
+
+    std::cout << "✓ Counts only test passed\n";
+}
+
+void testFormattersRenderLazyDetails() {
+    mi::Config config;
+    auto result = makeResult();
+    auto full = result.toMetrics(mi::MetricsDetail::Full);
+    auto lazy = result.toMetrics(mi::MetricsDetail::Lazy);
+
+    for (auto format : {mi::OutputFormat::Pretty, mi::OutputFormat::JSON,
+                        mi::OutputFormat::CSV, mi::OutputFormat::Markdown,
+                        mi::OutputFormat::Binary}) {
+        auto formatter = mi::FormatterFactory::create(format);
+        [[maybe_unused]] std::string expected = formatter->format(config, full, "", "example");
+        [[maybe_unused]] std::string actual = formatter->format(config, lazy, "", "example");
+        assert(actual == expected);
+    }
+
+    std::cout << "✓ Formatter output test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running metrics detail tests...\n";
+
+        testLazyMatchesFull();
+        testMovedResultOutlivesSource();
+        testCountsOnly();
+        testFormattersRenderLazyDetails();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,137 @@
+#include "metta_inference/output_sink.hpp"
+#include "metta_inference/formatters.hpp"
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include <unistd.h>
+
+namespace mi = metta_inference;
+
+mi::Metrics makeLargeMetrics(size_t details) {
+    mi::Metrics metrics;
+    for (size_t i = 0; i < details; ++i) {
+        mi::ContradictionDetail detail;
+        detail.entity1 = "soa_emam" + std::to_string(i);
+        detail.entity2 = "soa_enmam" + std::to_string(i);
+        detail.description = "Vessel " + std::to_string(i) + " both moors and does not moor";
+        metrics.contradictionDetails.push_back(detail);
+        metrics.inferredStateOfAffairs.push_back("fact " + std::to_string(i));
+    }
+    metrics.contradictions = static_cast<int>(details);
+    metrics.contradictionPairs = static_cast<int>(details);
+    metrics.inferredFacts = static_cast<int>(details);
+    return metrics;
+}
+
+void testFormatMatchesStreaming() {
+    mi::Config config;
+    auto metrics = makeLargeMetrics(2000);
+
+    for (auto format : {mi::OutputFormat::Pretty, mi::OutputFormat::JSON,
+                        mi::OutputFormat::CSV, mi::OutputFormat::Markdown}) {
+        auto formatter = mi::FormatterFactory::create(format);
+        // Pretty and Markdown embed the current time, so compare lengths
+        std::string collected = formatter->format(config, metrics, "", "large");
+
+        std::ostringstream stream;
+        mi::StreamSink sink(stream);
+        formatter->formatTo(config, metrics, "", "large", sink);
+
+        assert(!collected.empty());
+        assert(stream.str().size() == collected.size());
+    }
+
+    std::cout << "✓ format/formatTo equivalence test passed\n";
+}
+
+void testCallbackSinkChunks() {
+    mi::Config config;
+    auto metrics = makeLargeMetrics(2000);
+    auto formatter = mi::FormatterFactory::create(mi::OutputFormat::Markdown);
+
+    std::string reassembled;
+    size_t chunks = 0;
+    size_t largest = 0;
+    {
+        mi::CallbackSink sink([&](std::string_view chunk) {
+            reassembled.append(chunk);
+            ++chunks;
+            largest = std::max(largest, chunk.size());
+        }, 4096);
+        formatter->formatTo(config, metrics, "", "large", sink);
+    }
+
+    assert(chunks > 1);
+    // At most one chunk plus one staging buffer of the stream adapter
+    assert(largest < 4096 + 4096);
+    assert(reassembled.find("# MeTTa Inference Results: large") == 0);
+    assert(reassembled.find("soa_enmam1999") != std::string::npos);
+
+    std::cout << "✓ Callback sink chunking test passed\n";
+}
+
+void testFdSink() {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("pipe() failed");
+    }
+
+    {
+        mi::FdSink sink(fds[1], 8);
+        sink.write("hello ");
+        sink.write("streaming ");
+        sink.write("world");
+    }
+    close(fds[1]);
+
+    std::string received;
+    char buf[64];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+        received.append(buf, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+
+    assert(received == "hello streaming world");
+
+    std::cout << "✓ Fd sink test passed\n";
+}
+
+void testSinkErrorsPropagate() {
+    mi::Config config;
+    auto metrics = makeLargeMetrics(100);
+    auto formatter = mi::FormatterFactory::create(mi::OutputFormat::Pretty);
+
+    bool threw = false;
+    try {
+        mi::CallbackSink sink([](std::string_view) {
+            throw std::runtime_error("client went away");
+        }, 256);
+        formatter->formatTo(config, metrics, "", "large", sink);
+    } catch (const std::runtime_error& e) {
+        threw = std::string(e.what()) == "client went away";
+    }
+    if (!threw) {
+        throw std::runtime_error("sink failure was swallowed");
+    }
+
+    std::cout << "✓ Sink error propagation test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running OutputSink tests...\n";
+
+        testFormatMatchesStreaming();
+        testCallbackSinkChunks();
+        testFdSink();
+        testSinkErrorsPropagate();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,51 @@
+#include "metta_inference/process_executor.hpp"
+#include "metta_inference/inference_engine.hpp"
+#include <iostream>
+#include <type_traits>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+// Large results are moved, never copied
+static_assert(!std::is_copy_constructible_v<mi::InferenceEngine::Result>);
+static_assert(std::is_nothrow_move_constructible_v<mi::InferenceEngine::Result>);
+
+void testLargeOutput() {
+    // Several growth steps past the initial buffer
+    auto result = mi::ProcessExecutor::execute("head -c 3000000 /dev/zero | tr '\\0' 'x'");
+    if (result.output.size() != 3000000) {
+        throw std::runtime_error("Expected 3000000 bytes, got " + std::to_string(result.output.size()));
+    }
+    assert(result.output.find_first_not_of('x') == std::string::npos);
+    assert(result.exitCode == 0);
+
+    std::cout << "✓ Large output test passed\n";
+}
+
+void testBinaryOutput() {
+    // Embedded NUL bytes are kept, not treated as terminators
+    auto result = mi::ProcessExecutor::execute("printf 'a\\000b\\000c'");
+    if (result.output != std::string("a\0b\0c", 5)) {
+        throw std::runtime_error("NUL bytes lost from command output");
+    }
+
+    auto empty = mi::ProcessExecutor::execute("true");
+    assert(empty.output.empty());
+
+    std::cout << "✓ Binary output test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running ProcessExecutor tests...\n";
+
+        testLargeOutput();
+        testBinaryOutput();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,177 @@
+#include "metta_inference/process_reactor.hpp"
+#include <iostream>
+#include <future>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <string_view>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+using namespace std::chrono_literals;
+
+struct Outcome {
+    mi::ProcessExecutor::ExecutionResult result{};
+    std::string error;
+};
+
+std::future<Outcome> submit(mi::ProcessReactor& reactor, const std::string& command,
+                            std::chrono::milliseconds timeout = 10s,
+                            mi::ProcessExecutor::OutputObserver observer = {}) {
+    auto promise = std::make_shared<std::promise<Outcome>>();
+    auto future = promise->get_future();
+    reactor.submit(command, timeout, [promise](mi::ProcessExecutor::ExecutionResult&& result,
+                                               std::exception_ptr error) {
+        Outcome outcome;
+        outcome.result = std::move(result);
+        try {
+            if (error) std::rethrow_exception(error);
+        } catch (const std::exception& e) {
+            outcome.error = e.what();
+        }
+        promise->set_value(std::move(outcome));
+    }, {}, std::move(observer));
+    return future;
+}
+
+void testConcurrentCommands() {
+    // Two completion threads for 40 sleeping commands: only multiplexing
+    // finishes them in about the time of one
+    mi::ProcessReactor reactor(2);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<Outcome>> futures;
+    for (int i = 0; i < 40; ++i) {
+        futures.push_back(submit(reactor, "sleep 0.3; echo job" + std::to_string(i)));
+    }
+    assert(reactor.inFlight() > 0);
+
+    for (int i = 0; i < 40; ++i) {
+        auto outcome = futures[i].get();
+        if (!outcome.error.empty() || outcome.result.output != "job" + std::to_string(i) + "\n") {
+            throw std::runtime_error("Unexpected output from job " + std::to_string(i));
+        }
+        assert(outcome.result.exitCode == 0);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed > 5s) {
+        throw std::runtime_error("Commands did not run concurrently");
+    }
+    assert(reactor.inFlight() == 0);
+
+    std::cout << "✓ Concurrent commands test passed\n";
+}
+
+void testExitCodesAndLargeOutput() {
+    mi::ProcessReactor reactor(1);
+
+    auto failing = submit(reactor, "echo partial; exit 3");
+    auto large = submit(reactor, "head -c 2000000 /dev/zero | tr '\\0' 'y'");
+
+    auto failed = failing.get();
+    assert(failed.error.empty());
+    if (failed.result.exitCode != 3 || failed.result.output != "partial\n") {
+        throw std::runtime_error("Exit code or output of a failing command lost");
+    }
+
+    auto big = large.get();
+    if (big.result.output.size() != 2000000) {
+        throw std::runtime_error("Expected 2000000 bytes, got " + std::to_string(big.result.output.size()));
+    }
+
+    std::cout << "✓ Exit code and large output test passed\n";
+}
+
+void testTimeoutAndShutdown() {
+    std::future<Outcome> abandoned;
+    {
+        mi::ProcessReactor reactor(1);
+
+        auto start = std::chrono::steady_clock::now();
+        auto slow = submit(reactor, "echo started; sleep 30", 200ms).get();
+        if (slow.error != "Command timed out") {
+            throw std::runtime_error("Expected a timeout, got '" + slow.error + "'");
+        }
+        // The whole process group went, not just the shell
+        if (std::chrono::steady_clock::now() - start > 5s) {
+            throw std::runtime_error("Timed-out command was not killed");
+        }
+
+        abandoned = submit(reactor, "sleep 30");
+    }
+
+    // Destroying the reactor fails what is still running
+    auto outcome = abandoned.get();
+    assert(outcome.error == "Process reactor shut down");
+    if (outcome.error.empty()) {
+        throw std::runtime_error("Running command survived reactor shutdown");
+    }
+
+    std::cout << "✓ Timeout and shutdown test passed\n";
+}
+
+void testObservers() {
+    mi::ProcessReactor reactor(2);
+    if (mi::ProcessReactor::onReactorThread()) {
+        throw std::runtime_error("Caller mistaken for a reactor thread");
+    }
+
+    // A slow observer holds up neither the reactor nor other commands
+    auto seen = std::make_shared<std::atomic<size_t>>(0);
+    auto slow = submit(reactor, "echo one; sleep 0.2; echo two", 10s, [seen](std::string_view chunk) {
+        if (!mi::ProcessReactor::onReactorThread()) {
+            throw std::runtime_error("Observer ran on a foreign thread");
+        }
+        std::this_thread::sleep_for(500ms);
+        *seen += chunk.size();
+        return true;
+    });
+    auto start = std::chrono::steady_clock::now();
+    auto quick = submit(reactor, "echo quick").get();
+    if (quick.result.output != "quick\n" || std::chrono::steady_clock::now() - start > 400ms) {
+        throw std::runtime_error("Slow observer held up another command");
+    }
+
+    // The completion follows the last observed chunk
+    auto observed = slow.get();
+    if (!observed.error.empty() || *seen != observed.result.output.size()) {
+        throw std::runtime_error("Completion ran before the observer saw all output");
+    }
+
+    // Returning false stops the command, keeping its output
+    auto stopped = submit(reactor, "echo found; sleep 30", 10s, [](std::string_view chunk) {
+        return chunk.find("found") == std::string_view::npos;
+    }).get();
+    if (!stopped.error.empty() || !stopped.result.stoppedEarly || stopped.result.output != "found\n") {
+        throw std::runtime_error("Observer could not stop its command");
+    }
+
+    // A throwing observer fails the command
+    auto failed = submit(reactor, "echo bad; sleep 30", 10s, [](std::string_view) -> bool {
+        throw std::runtime_error("bad output");
+    }).get();
+    if (failed.error != "bad output") {
+        throw std::runtime_error("Observer error lost: '" + failed.error + "'");
+    }
+
+    std::cout << "✓ Observer test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running ProcessReactor tests...\n";
+
+        testConcurrentCommands();
+        testExitCodesAndLargeOutput();
+        testTimeoutAndShutdown();
+        testObservers();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
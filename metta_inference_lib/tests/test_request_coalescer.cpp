@@ -0,0 +1,194 @@
+#include "metta_inference/request_coalescer.hpp"
+#include <iostream>
+#include <atomic>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+using namespace std::chrono_literals;
+
+const std::string EXAMPLE_A = R"(
+; Payment obligation
+(ct-triple soa_epiam type soaPay)
+(ct-triple soa_epiam soaHas_agent soa_MAERSK)
+(ct-triple soa_epiam soaHas_instrument soaINRS)
+!(make-triples)
+!(is-in-conflict-with $eo $e)
+)";
+
+const std::string EXAMPLE_B = R"(
+(ct-triple soa_epiam type soaPay)
+(ct-triple soa_epiam soaHas_agent soa_MAERSK)
+(ct-triple soa_epiam soaHas_instrument soaINRS)
+(ct-triple soa_ebiam type obligatory)
+!(make-triples)
+)";
+
+size_t count(const std::string& text, const std::string& what) {
+    size_t n = 0;
+    for (size_t pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + 1)) ++n;
+    return n;
+}
+
+void testCoalesceExamples() {
+    auto batch = mi::coalesceExamples({EXAMPLE_A, EXAMPLE_B});
+    const auto& content = batch.content;
+
+    assert(batch.layout.namespaces.size() == 2);
+    if (batch.layout.queryCounts != std::vector<size_t>{2, 1}) {
+        throw std::runtime_error("Queries not counted per example");
+    }
+
+    // Eventualities and agents are namespaced; vocabulary and shared
+    // entities such as instruments are not
+    if (content.find("(ct-triple soa_epiam__cq0 soaHas_agent soa_MAERSK__cq0)") == std::string::npos ||
+        content.find("(ct-triple soa_epiam__cq1 soaHas_agent soa_MAERSK__cq1)") == std::string::npos) {
+        throw std::runtime_error("Entities not namespaced:\n" + content);
+    }
+    assert(content.find("soaHas_instrument soaINRS\n") == std::string::npos);
+    assert(content.find("soaHas_instrument soaINRS)") != std::string::npos);
+    assert(content.find("soaPay__") == std::string::npos);
+
+    // Queries stay per example, in order
+    assert(count(content, "!(make-triples)") == 2);
+    assert(content.find("!(is-in-conflict-with $eo $e)") < content.rfind("!(make-triples)"));
+    assert(content.find("Payment obligation") == std::string::npos);
+
+    // Definitions repeated verbatim are kept once
+    auto repeated = mi::coalesceExamples({"(= (rule) (fact))\n!(rule)\n", "(= (rule) (fact))\n!(rule)\n"});
+    if (count(repeated.content, "(= (rule) (fact))") != 1 || count(repeated.content, "!(rule)") != 2) {
+        throw std::runtime_error("Repeated definitions not collapsed:\n" + repeated.content);
+    }
+
+    std::cout << "✓ Coalesce examples test passed\n";
+}
+
+void testSharedDefinitions() {
+    // Rules apply to every coalesced example's facts, so only examples
+    // with the same rules are grouped; their facts do not matter
+    const std::string rule = "(= (obliged $e) (ct-triple $e type obligatory))\n";
+    const std::string otherRule = "(= (obliged $e) (ct-triple $e type soaPay))\n";
+    std::string a = EXAMPLE_B + rule;
+    std::string b = EXAMPLE_A + rule;
+    std::string c = EXAMPLE_B + otherRule;
+
+    if (mi::sharedDefinitions(a) != mi::sharedDefinitions(b)) {
+        throw std::runtime_error("Examples with the same rules kept apart");
+    }
+    if (mi::sharedDefinitions(a) == mi::sharedDefinitions(c)) {
+        throw std::runtime_error("Examples with different rules grouped");
+    }
+    if (mi::sharedDefinitions(a).find("soa_epiam") != std::string::npos) {
+        throw std::runtime_error("Facts counted as shared definitions");
+    }
+
+    std::cout << "✓ Shared definitions test passed\n";
+}
+
+void testDemultiplex() {
+    mi::CoalescedLayout layout{{"__cq0", "__cq1"}, {2, 1}};
+
+    // Later queries see earlier examples' facts; those are dropped again
+    std::string output =
+        "[()]\n"
+        "[(conflict soa_ea__cq0 soa_eb__cq0), (conflict soa_ea__cq0 soa_ex__cq1), True]\n"
+        "Warning: soa_ea__cq1 has no agent\n"
+        "[(triple soa_ea__cq0 type soaPay), (triple soa_ea__cq1 type soaPay) (triple soaINRS type soaStablecoin)]\n";
+
+    auto outputs = mi::SemanticAnalyzer::demultiplex(output, layout);
+    assert(outputs.size() == 2);
+    if (outputs[0] != "[()]\n[(conflict soa_ea soa_eb), True]\n") {
+        throw std::runtime_error("Unexpected first output:\n" + outputs[0]);
+    }
+    if (outputs[1] != "Warning: soa_ea has no agent\n"
+                      "[(triple soa_ea type soaPay), (triple soaINRS type soaStablecoin)]\n") {
+        throw std::runtime_error("Unexpected second output:\n" + outputs[1]);
+    }
+
+    // Strings are left alone, even when they look namespaced
+    auto quoted = mi::SemanticAnalyzer::demultiplex("[\"soa_x__cq1\"]\n[]\n[]\n", layout);
+    assert(quoted[0] == "[\"soa_x__cq1\"]\n[]\n");
+
+    // A REPL that stopped early cannot be split reliably
+    bool threw = false;
+    try {
+        mi::SemanticAnalyzer::demultiplex("[()]\n[()]\n", layout);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Missing results not detected");
+    }
+
+    threw = false;
+    try {
+        mi::SemanticAnalyzer::demultiplex("[()]\n[()]\n[(triple", layout);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "✓ Demultiplex test passed\n";
+}
+
+void testGrouping() {
+    std::mutex mutex;
+    std::vector<std::vector<int>> flushed;
+    auto record = [&](std::vector<int> tickets) {
+        std::lock_guard<std::mutex> lock(mutex);
+        flushed.push_back(std::move(tickets));
+    };
+
+    {
+        mi::RequestCoalescer<int> coalescer({50ms, 3}, record);
+
+        // A full group is flushed right away, by the adding thread
+        coalescer.add("a", 1);
+        coalescer.add("a", 2);
+        coalescer.add("b", 10);
+        coalescer.add("a", 3);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (flushed.size() != 1 || flushed[0] != std::vector<int>{1, 2, 3}) {
+                throw std::runtime_error("Full group not flushed immediately");
+            }
+        }
+
+        // The rest waits for its window
+        std::this_thread::sleep_for(200ms);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            assert(flushed.size() == 2);
+            if (flushed.size() != 2 || flushed[1] != std::vector<int>{10}) {
+                throw std::runtime_error("Group not flushed when its window closed");
+            }
+        }
+
+        coalescer.add("c", 20);
+        coalescer.add("c", 21);
+    }
+
+    // Destruction flushes what was still waiting
+    if (flushed.size() != 3 || flushed[2] != std::vector<int>{20, 21}) {
+        throw std::runtime_error("Pending group lost on destruction");
+    }
+
+    std::cout << "✓ Grouping test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running RequestCoalescer tests...\n";
+
+        testCoalesceExamples();
+        testSharedDefinitions();
+        testDemultiplex();
+        testGrouping();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
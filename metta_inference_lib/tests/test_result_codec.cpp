@@ -0,0 +1,218 @@
+#include "metta_inference/result_codec.hpp"
+#include "metta_inference/formatters.hpp"
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+
+namespace mi = metta_inference;
+
+mi::Metrics makeMetrics() {
+    mi::Metrics metrics;
+    metrics.contradictions = 4;
+    metrics.contradictionPairs = 2;
+    metrics.compliances = 1;
+    metrics.conflicts = 1;
+    metrics.violations = 1;
+    metrics.inferredFacts = 2;
+    metrics.inferredStateOfAffairs = {"ALEXANDRA MAERSK moor", "ALEXANDRA MAERSK pay using INRS"};
+    metrics.contradictionDetails.push_back({"soa_epamINRS", "soa_epamUSDS", "pays in INRS and USDS"});
+    metrics.contradictionDetails.push_back({"soa_epamUSDS", "soa_epamINRS", "pays in INRS and USDS"});
+    metrics.conflictDetails.push_back({"not_opt", "soa_elam", "leaving is both forbidden and permitted"});
+    metrics.violationDetails.push_back({"soa_elam", "must_not_leave", ""});
+    return metrics;
+}
+
+void testMetricsRoundTrip() {
+    auto metrics = makeMetrics();
+    std::string encoded = mi::ResultCodec::encode(metrics);
+
+    assert(mi::ResultCodec::isEncoded(encoded));
+
+    mi::ResultReader reader(encoded);
+    assert(reader.kind() == mi::ResultCodec::Kind::Metrics);
+    assert(reader.contradictions() == 4);
+    assert(reader.total() == metrics.total());
+    assert(reader.recordCount() == 6);
+    // Repeated entities and descriptions are stored once
+    assert(reader.stringCount() < 6 * 3);
+
+    auto decoded = reader.toMetrics();
+    assert(decoded.inferredStateOfAffairs == metrics.inferredStateOfAffairs);
+    assert(decoded.contradictionDetails.size() == 2);
+    assert(decoded.contradictionDetails[1].entity1 == "soa_epamUSDS");
+    assert(decoded.conflictDetails[0].description == metrics.conflictDetails[0].description);
+    assert(decoded.violationDetails[0].violated_rule == "must_not_leave");
+    assert(decoded.violationDetails[0].description.empty());
+
+    // Views point into the caller's buffer
+    assert(reader.record(0).field(0).data() >= encoded.data() &&
+           reader.record(0).field(0).data() < encoded.data() + encoded.size());
+
+    std::cout << "✓ Metrics round trip test passed\n";
+}
+
+void testAnalysisRoundTrip() {
+    mi::SemanticAnalyzer::AnalysisResult result;
+
+    mi::StateOfAffairs moor;
+    moor.entity = "soa_emam";
+    moor.action = "moor";
+    moor.agent = "ALEXANDRA MAERSK";
+    moor.properties["location"] = "BERTH A";
+    result.inferredFacts.push_back(moor);
+
+    mi::LogicalContradiction contradiction;
+    contradiction.type = "payment_method";
+    contradiction.positive.entity = "soa_epamINRS";
+    contradiction.positive.instrument = "INRS";
+    contradiction.negative.entity = "soa_epamINRS";
+    contradiction.negative.exists = false;
+    result.contradictions.push_back(contradiction);
+
+    result.conflicts.push_back({"not_opt", "soa_elam", "leave", "ALEXANDRA MAERSK"});
+    result.violations.push_back({"must_not_leave", "soa_elam", "obligation to pay"});
+    result.compliances.push_back({"soa_epam", "pay", "soa_epamINRS"});
+
+    std::string encoded = mi::ResultCodec::encode(result);
+    mi::ResultReader reader(encoded);
+    assert(reader.kind() == mi::ResultCodec::Kind::Analysis);
+    assert(reader.contradictionPairs() == 1);
+
+    auto decoded = reader.toAnalysisResult();
+    assert(decoded.inferredFacts.size() == 1);
+    assert(decoded.inferredFacts[0].properties.at("location") == "BERTH A");
+    assert(decoded.contradictions.size() == 1);
+    assert(decoded.contradictions[0].positive.instrument == "INRS");
+    assert(decoded.contradictions[0].positive.exists);
+    assert(!decoded.contradictions[0].negative.exists);
+    assert(decoded.conflicts[0].affectedEntity == "ALEXANDRA MAERSK");
+    assert(decoded.violations[0].reason == "obligation to pay");
+    assert(decoded.compliances[0].fulfilledBy == "soa_epamINRS");
+
+    std::cout << "✓ Analysis round trip test passed\n";
+}
+
+// Counts how often a description is rendered
+class CountingDescriber : public mi::DetailDescriber {
+public:
+    std::string describeContradiction(size_t index) const override { return render("contradiction", index); }
+    std::string describeConflict(size_t index) const override { return render("conflict", index); }
+    std::string describeViolation(size_t index) const override { return render("violation", index); }
+
+    mutable int calls = 0;
+
+private:
+    std::string render(const char* kind, size_t index) const {
+        ++calls;
+        return std::string(kind) + " " + std::to_string(index);
+    }
+};
+
+void testPartialAndLazyDescriptions() {
+    auto metrics = makeMetrics();
+    metrics.partial = true;
+    metrics.coverage = 0.625;
+    metrics.violationDetails[0].description.clear();
+    auto describer = std::make_shared<CountingDescriber>();
+    metrics.describer = describer;
+
+    // Not asked for: nothing is rendered, stored descriptions still travel
+    mi::ResultReader counts(mi::ResultCodec::encode(metrics, false));
+    if (describer->calls != 0) {
+        throw std::runtime_error("Encoding rendered descriptions nobody asked for");
+    }
+    assert(counts.partial());
+    assert(counts.coverage() == 0.625);
+    assert(counts.descriptionsOmitted());
+    auto decoded = counts.toMetrics();
+    assert(decoded.partial && decoded.coverage == 0.625);
+    assert(decoded.conflictDetails[0].description == metrics.conflictDetails[0].description);
+    assert(decoded.violationDetails[0].description.empty());
+
+    // Asked for: only the missing description is rendered
+    std::string rendered = mi::ResultCodec::encode(metrics);
+    if (describer->calls != 1) {
+        throw std::runtime_error("Expected one rendered description");
+    }
+    mi::ResultReader full(rendered);
+    assert(!full.descriptionsOmitted());
+    assert(full.toMetrics().violationDetails[0].description == "violation 0");
+
+    // Complete results carry no partial flag
+    mi::ResultReader complete(mi::ResultCodec::encode(makeMetrics()));
+    assert(!complete.partial() && complete.coverage() == 1.0);
+    assert(!complete.toMetrics().partial);
+
+    // CSV reports partial results in extra columns
+    mi::Config config;
+    auto csv = mi::FormatterFactory::create(mi::OutputFormat::CSV);
+    std::string partialCsv = csv->format(config, metrics, "", "example");
+    if (partialCsv.find("Total,Partial,Coverage\n") == std::string::npos ||
+        partialCsv.find(",true,0.625") == std::string::npos) {
+        throw std::runtime_error("CSV lacks partial columns: " + partialCsv);
+    }
+    std::string completeCsv = csv->format(config, makeMetrics(), "", "example");
+    assert(completeCsv.find("Partial") == std::string::npos);
+
+    std::cout << "✓ Partial and lazy description test passed\n";
+}
+
+void testMalformedInputRejected() {
+    std::string encoded = mi::ResultCodec::encode(makeMetrics());
+
+    [[maybe_unused]] auto rejects = [](const std::string& data) {
+        try {
+            mi::ResultReader reader(data);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+
+    assert(rejects(""));
+    assert(rejects("{\"example\": \"json\"}"));
+    assert(rejects(encoded.substr(0, encoded.size() - 1)));
+
+    std::string badVersion = encoded;
+    badVersion[4] = 9;
+    assert(rejects(badVersion));
+
+    std::string badRecordCount = encoded;
+    badRecordCount[16] = static_cast<char>(0xFF);
+    badRecordCount[19] = static_cast<char>(0xFF);
+    assert(rejects(badRecordCount));
+
+    std::cout << "✓ Malformed input test passed\n";
+}
+
+void testBinaryFormatter() {
+    mi::Config config;
+    auto formatter = mi::FormatterFactory::create(mi::OutputFormat::Binary);
+    assert(formatter->getExtension() == ".mtrb");
+
+    auto metrics = makeMetrics();
+    std::string output = formatter->format(config, metrics, "", "example");
+    assert(output == mi::ResultCodec::encode(metrics));
+
+    std::cout << "✓ Binary formatter test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running ResultCodec tests...\n";
+
+        testMetricsRoundTrip();
+        testAnalysisRoundTrip();
+        testPartialAndLazyDescriptions();
+        testMalformedInputRejected();
+        testBinaryFormatter();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
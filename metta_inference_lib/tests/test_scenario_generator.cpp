@@ -0,0 +1,104 @@
+#include "metta_inference/scenario_generator.hpp"
+#include "metta_inference/knowledge_io.hpp"
+#include <iostream>
+#include <cassert>
+#include <sstream>
+#include <set>
+#include <stdexcept>
+
+namespace mi = metta_inference;
+
+std::string generate(const mi::ScenarioGenerator::Options& options,
+                     mi::ScenarioGenerator::Stats* stats = nullptr) {
+    mi::ScenarioGenerator generator(mi::ScenarioGenerator::defaultOntology(), options);
+    std::ostringstream out;
+    auto result = generator.generate(out);
+    if (stats) *stats = result;
+    return out.str();
+}
+
+void testDeterministicForSeed() {
+    mi::ScenarioGenerator::Options options;
+    options.vessels = 5;
+    options.eventualities = 40;
+
+    assert(generate(options) == generate(options));
+
+    auto other = options;
+    other.seed = options.seed + 1;
+    if (generate(options) == generate(other)) {
+        throw std::runtime_error("Different seeds generated the same scenario");
+    }
+
+    std::cout << "✓ Deterministic seed test passed\n";
+}
+
+void testOutputParsesBack() {
+    mi::ScenarioGenerator::Options options;
+    options.vessels = 8;
+    options.eventualities = 60;
+    options.contradictionRatio = 0.2;
+    options.includeQueries = false;
+
+    mi::ScenarioGenerator::Stats stats;
+    auto soa = mi::KnowledgeIO::extractStateOfAffairsFromMetta(generate(options, &stats));
+
+    assert(stats.eventualities == 60);
+    assert(soa.facts.size() == stats.facts);
+    assert(soa.negations.size() == stats.negations + stats.contradictions);
+    assert(soa.logicalExpressions.size() == stats.disjunctions);
+
+    // Generated eventualities follow the repo naming convention
+    for (const auto& [name, eventuality] : soa.eventualities) {
+        if (!eventuality.agent.empty()) {
+            assert(name == eventuality.getExpectedName());
+            assert(mi::KnowledgeIO::isValidEventualityType(eventuality.type));
+        }
+    }
+
+    // An eventuality has each role at most once
+    std::set<std::pair<std::string, std::string>> roles;
+    for (const auto& fact : soa.facts) {
+        if (fact.predicate.compare(0, 7, "soaHas_") == 0 &&
+            !roles.emplace(fact.subject, fact.predicate).second) {
+            throw std::runtime_error("Role " + fact.predicate + " repeated for " + fact.subject);
+        }
+    }
+
+    std::cout << "✓ Output parses back test passed\n";
+}
+
+void testRejectsUnsatisfiableOptions() {
+    mi::ScenarioGenerator::Options options;
+    options.vessels = 1;
+    options.eventualities = 1000;  // More than unique names available for one vessel
+
+    bool threw = false;
+    try {
+        generate(options);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("Unsatisfiable options accepted");
+    }
+
+    std::cout << "✓ Unsatisfiable options test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running ScenarioGenerator tests...\n";
+
+        testDeterministicForSeed();
+        testOutputParsesBack();
+        testRejectsUnsatisfiableOptions();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,138 @@
+#include "metta_inference/scenario_partitioner.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cassert>
+#include <unistd.h>
+
+namespace mi = metta_inference;
+namespace fs = std::filesystem;
+
+const char* SCENARIO = R"(
+; Rule shared by every shard
+(= (pay-obligatory $v $spt)
+  (let* ((True (ct-triple $e type soaMoor))
+;         (True (trace! (check $e) True))
+         (True (ct-triple $e soaHas_agent $v)))
+    True))
+
+(ct-triple soa_berthMICT type soa_mooringBerth)
+
+(ct-triple soa_emam type soaMoor)
+(ct-triple soa_emam type rexist)
+(ct-triple soa_emam soaHas_agent soa_ALEXANDRA_MAERSK)
+(ct-triple soa_emam soaHas_location soa_berthMICT)
+(ct-triple soa_ALEXANDRA_MAERSK type soaContainerVessel)
+
+(ct-triple soa_eplm type soaPay)
+(ct-triple soa_eplm soaHas_agent soa_LAURA_MAERSK)
+(ct-triple soa_eplm soaHas_location soa_berthMICT)
+(ct-simple-not soa_enplm soa_eplm)
+(ct-triple soa_enplm type rexist)
+
+!(make-triples)
+!(is_in_contradiction_with $a $b)
+)";
+
+void testComponentsBecomeShards() {
+    auto shards = mi::ScenarioPartitioner::partition(SCENARIO);
+    assert(shards.size() == 2);
+
+    // The shared berth does not join the two vessels
+    assert((shards[0].eventualities == std::vector<std::string>{"soa_emam"}));
+    assert((shards[1].eventualities == std::vector<std::string>{"soa_enplm", "soa_eplm"}));
+
+    for (const auto& shard : shards) {
+        if (shard.content.find("(= (pay-obligatory $v $spt)") == std::string::npos ||
+            shard.content.find("soa_berthMICT type soa_mooringBerth") == std::string::npos ||
+            shard.content.find("!(is_in_contradiction_with $a $b)") == std::string::npos) {
+            throw std::runtime_error("Shard " + std::to_string(shard.index) + " lacks the shared rules or queries");
+        }
+    }
+
+    assert(shards[0].content.find("soa_ALEXANDRA_MAERSK type soaContainerVessel") != std::string::npos);
+    assert(shards[0].content.find("soa_eplm") == std::string::npos);
+    assert(shards[1].content.find("soa_emam") == std::string::npos);
+
+    std::cout << "✓ Components become shards test passed\n";
+}
+
+void testMaxShardsPacksComponents() {
+    auto shards = mi::ScenarioPartitioner::partition(SCENARIO, 1);
+    assert(shards.size() == 1);
+    assert(shards[0].eventualities.size() == 3);
+    assert(shards[0].content.find("soa_emam") != std::string::npos);
+    assert(shards[0].content.find("soa_eplm") != std::string::npos);
+
+    std::cout << "✓ Max shards packing test passed\n";
+}
+
+void testMergeMetricsDropsDuplicates() {
+    mi::Metrics a;
+    a.conflicts = 1;
+    a.conflictDetails.push_back({"soa_x", "soa_y", "x conflicts with y"});
+    a.compliances = 2;
+    a.inferredFacts = 1;
+    a.inferredStateOfAffairs = {"(ct-triple soa_x type hold)"};
+
+    mi::Metrics b = a;  // Same finding reported from a replicated fact
+    b.violations = 1;
+    b.violationDetails.push_back({"soa_v", "rule", "v violates rule"});
+
+    auto merged = mi::ScenarioPartitioner::mergeMetrics({a, b});
+    assert(merged.conflicts == 1);
+    assert(merged.conflictDetails.size() == 1);
+    assert(merged.violations == 1);
+    assert(merged.inferredFacts == 1);
+    assert(merged.compliances == 4);
+
+    std::cout << "✓ Merge metrics test passed\n";
+}
+
+void testFailingShardFailsRun() {
+    fs::path root = fs::temp_directory_path() / ("metta_partition_test_" + std::to_string(getpid()));
+    fs::create_directories(root);
+
+    mi::Config config;
+    config.mettaReplPath = root / "fake-repl";
+    std::ofstream(config.mettaReplPath) << "#!/bin/sh\necho '[()]'\n";
+    fs::permissions(config.mettaReplPath, fs::perms::owner_all);
+    // Module validation fails in every shard
+    config.modulePaths = {root / "missing"};
+
+    fs::path example = root / "scenario.metta";
+    std::ofstream(example) << SCENARIO;
+
+    bool threw = false;
+    try {
+        mi::ScenarioPartitioner::runParallel(config, example, 0);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    if (!threw) {
+        throw std::runtime_error("Failed shards merged as a clean result");
+    }
+
+    std::cout << "✓ Failing shard test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running ScenarioPartitioner tests...\n";
+
+        testComponentsBecomeShards();
+        testMaxShardsPacksComponents();
+        testMergeMetricsDropsDuplicates();
+        testFailingShardFailsRun();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,79 @@
+#include "metta_inference/sexpr_parser.hpp"
+#include <iostream>
+#include <cassert>
+
+namespace mi = metta_inference;
+
+void testIdenticalSubtreesShareNodes() {
+    auto exprs = mi::SExprParser::parseMultiple(
+        "[((meta-id soa_emam type rexist true) (id_not_not_false soa_emam)),"
+        " ((meta-id soa_emam type rexist true) (id_not_not_false soa_emam))]");
+
+    assert(exprs.size() == 1);
+    // REPL separators are kept as "," atoms
+    assert(exprs[0]->length() == 3);
+    // Same structure, same node
+    assert(*exprs[0]->nth(0) == *exprs[0]->nth(2));
+    assert(exprs[0]->asList()[0]->asList()[1]->asList()[1] ==
+           exprs[0]->asList()[0]->asList()[0]->asList()[1]);
+
+    std::cout << "✓ Identical subtrees share nodes test passed\n";
+}
+
+void testSharedInternerAcrossParses() {
+    mi::SExprInterner interner;
+    auto a = mi::SExprParser::parse("(triple soa_emam type soaMoor)", interner);
+    auto b = mi::SExprParser::parse("(triple  soa_emam\ttype soaMoor)", interner);
+    auto c = mi::SExprParser::parse("(triple soa_emam type soaLeave)", interner);
+
+    assert(a == b);
+    assert(a != c);
+    assert(interner.hits() > 0);
+
+    std::cout << "✓ Shared interner test passed\n";
+}
+
+void testStructuralEqualityWithoutInterning() {
+    auto a = mi::SExprParser::parse("(conflict (mod-not-id soa_elam permitted) soa_elam)");
+    auto b = mi::SExprParser::parse("(conflict (mod-not-id soa_elam permitted) soa_elam)");
+    auto c = mi::SExprParser::parse("(conflict (mod-not-id soa_elam obligatory) soa_elam)");
+
+    // Separate parses use separate pools, so compare structurally
+    assert(a != b);
+    assert(a->hash() == b->hash());
+    assert(mi::SExprEqual{}(a, b));
+    assert(!mi::SExprEqual{}(a, c));
+
+    // An atom and a singleton list are different expressions
+    auto atom = mi::SExprParser::parse("x");
+    auto singleton = mi::SExprParser::parse("(x)");
+    assert(!atom->equals(*singleton));
+
+    std::cout << "✓ Structural equality test passed\n";
+}
+
+void testToStringRoundTrip() {
+    auto expr = mi::SExprParser::parse("( a  (b c) [d] ())");
+    assert(expr->toString() == "(a (b c) (d) ())");
+    assert(mi::SExprParser::parse(expr->toString())->equals(*expr));
+
+    std::cout << "✓ toString round trip test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running SExprParser tests...\n";
+
+        testIdenticalSubtreesShareNodes();
+        testSharedInternerAcrossParses();
+        testStructuralEqualityWithoutInterning();
+        testToStringRoundTrip();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
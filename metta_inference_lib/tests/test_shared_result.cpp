@@ -0,0 +1,180 @@
+#include "metta_api.hpp"
+#include "metta_server.hpp"
+#include "metta_client.hpp"
+#include "metta_inference/result_codec.hpp"
+#include "fake_repl.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cassert>
+#include <cerrno>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+namespace mi = metta_inference;
+using namespace metta_api;
+
+// Fake REPL printing lineCount result lines
+struct ShmFixture : FakeRepl {
+    static constexpr int lineCount = 20000;
+
+    ShmFixture() : FakeRepl("shm_test", "yes '[()]' | head -n " + std::to_string(lineCount)) {}
+
+    void configure(MettaAPI& api) const {
+        api.setMettaReplPath(repl);
+        api.setDefaultModulePaths(modules);
+    }
+
+    static size_t expectedRawSize() {
+        return lineCount * std::string("[()]\n").size();
+    }
+};
+
+void testSegment() {
+    auto segment = SharedResult::create("metrics", "raw output");
+    if (segment->metrics() != "metrics" || segment->rawOutput() != "raw output") {
+        throw std::runtime_error("Segment does not hold what was written");
+    }
+
+    // Sealed: nobody can change it under a reader's mapping
+    if (write(segment->fd(), "x", 1) >= 0 || ftruncate(segment->fd(), 0) == 0) {
+        throw std::runtime_error("Segment is writable");
+    }
+
+    // What another process does with the descriptor it was passed
+    auto reader = SharedResult::adopt(dup(segment->fd()));
+    if (reader->rawOutput() != "raw output" || reader->rawOutput().data() == segment->rawOutput().data()) {
+        throw std::runtime_error("Adopted segment not mapped on its own");
+    }
+
+    auto empty = SharedResult::create("", "");
+    assert(empty->metrics().empty() && empty->rawOutput().empty());
+
+    std::cout << "✓ Segment test passed\n";
+}
+
+void testAdoptRejectsUnsealed() {
+    int fd = memfd_create("unsealed", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        throw std::runtime_error("memfd_create failed");
+    }
+    std::string bytes(64, '\0');
+    if (write(fd, bytes.data(), bytes.size()) != static_cast<ssize_t>(bytes.size())) {
+        throw std::runtime_error("Failed to fill memfd");
+    }
+
+    bool rejected = false;
+    try {
+        SharedResult::adopt(fd);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    if (!rejected) {
+        throw std::runtime_error("Unsealed segment accepted");
+    }
+    // adopt closed the descriptor
+    if (fcntl(fd, F_GETFD) != -1 || errno != EBADF) {
+        throw std::runtime_error("Rejected descriptor left open");
+    }
+
+    std::cout << "✓ Adopt rejects unsealed test passed\n";
+}
+
+void testApi() {
+    ShmFixture fixture;
+    MettaAPI api;
+    fixture.configure(api);
+
+    InferenceRequest request;
+    request.exampleContent = "; shm\n";
+    request.rawOutputMode = "shm";
+    auto response = api.runInference(request);
+
+    if (!response.success || !response.sharedResult) {
+        throw std::runtime_error("No shared result: " + response.error);
+    }
+    if (!response.rawOutput.empty() || response.raw().size() != ShmFixture::expectedRawSize() ||
+        response.raw().data() != response.sharedResult->rawOutput().data()) {
+        throw std::runtime_error("Raw output not served from the segment");
+    }
+
+    mi::ResultReader metrics(response.sharedResult->metrics());
+    assert(metrics.kind() == mi::ResultCodec::Kind::Metrics);
+    if (metrics.contradictions() != response.metrics.contradictions ||
+        metrics.violations() != response.metrics.violations) {
+        throw std::runtime_error("Encoded metrics differ from the response");
+    }
+
+    std::cout << "✓ API shared result test passed\n";
+}
+
+void testDaemon() {
+    ShmFixture fixture;
+    MettaAPI api;
+    fixture.configure(api);
+    api.enableModuleWatching();
+
+    std::string socketPath = (fixture.root / "daemon.sock").string();
+    MettaServer server(api, {socketPath});
+    server.start();
+
+    {
+        MettaClient client(socketPath);
+
+        InferenceRequest shm;
+        shm.exampleContent = "; remote shm\n";
+        shm.rawOutputMode = "shm";
+        InferenceRequest other = shm;
+        other.exampleContent = "; another remote shm\n";
+        InferenceRequest plain;
+        plain.exampleContent = "; remote plain\n";
+
+        // Descriptors and frames must pair up when responses interleave
+        auto first = client.runInferenceAsync(shm);
+        auto second = client.runInferenceAsync(plain);
+        auto third = client.runInferenceAsync(other);
+
+        for (auto* pending : {&first, &third}) {
+            auto response = pending->get();
+            if (!response.success || !response.sharedResult ||
+                response.raw().size() != ShmFixture::expectedRawSize()) {
+                throw std::runtime_error("Shared result not passed through the daemon: " + response.error);
+            }
+            mi::ResultReader metrics(response.sharedResult->metrics());
+            assert(metrics.total() >= 0);
+        }
+        auto response = second.get();
+        if (response.sharedResult || response.rawOutput.size() != ShmFixture::expectedRawSize()) {
+            throw std::runtime_error("Plain response mixed up with a shared one");
+        }
+
+        // The cached answer hands out the same sealed segment again
+        auto cached = client.runInference(shm);
+        if (!cached.sharedResult || cached.raw().size() != ShmFixture::expectedRawSize() ||
+            server.stats().cacheHits != 1) {
+            throw std::runtime_error("Cached shared result not delivered");
+        }
+    }
+
+    server.stop();
+    std::cout << "✓ Daemon shared result test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running shared result tests...\n";
+
+        testSegment();
+        testAdoptRejectsUnsealed();
+        testApi();
+        testDaemon();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}
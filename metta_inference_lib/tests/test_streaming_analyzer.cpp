@@ -0,0 +1,371 @@
+#include "metta_inference/streaming_analyzer.hpp"
+#include "metta_inference/process_reactor.hpp"
+#include "metta_inference/inference_engine.hpp"
+#include "fake_repl.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <future>
+#include <functional>
+#include <cassert>
+
+namespace fs = std::filesystem;
+namespace mi = metta_inference;
+
+using namespace std::chrono_literals;
+
+// Prints one result, the start of a second, then hangs
+const char* SLOW_OUTPUT = "printf '[(conflict not_opt soa_elam)]\\n[(conflict not_opt' ; sleep 30";
+
+void testFeed() {
+    mi::StreamingAnalyzer stream(mi::InferenceConfiguration::getInstance().current(), 4);
+
+    // Lines split across chunks are parsed once complete
+    std::string output = "[(conflict not_opt soa_elam)]\n[()]\nnot a result\n[(conflict not_opt";
+    for (char c : output) {
+        stream.feed(std::string_view(&c, 1));
+    }
+    if (stream.results() != 2 || stream.coverage() != 0.5) {
+        throw std::runtime_error("Results miscounted: " + std::to_string(stream.results()));
+    }
+
+    auto result = stream.analyze();
+    if (result.conflicts.size() != 1) {
+        throw std::runtime_error("Unfinished line analyzed, or finished one missed");
+    }
+
+    stream.feed(" soa_elam)]\n");
+    assert(stream.results() == 3);
+    if (stream.analyze().conflicts.size() != 2) {
+        throw std::runtime_error("Completed line not analyzed");
+    }
+
+    mi::StreamingAnalyzer unknown(mi::InferenceConfiguration::getInstance().current());
+    unknown.feed("[()]\n");
+    assert(unknown.coverage() == 0.0);
+
+    // A last line without a newline counts once the output has ended
+    stream.feed("[(conflict not_opt soa_enplm)]");
+    assert(stream.bytesFed() == output.size() + std::string(" soa_elam)]\n[(conflict not_opt soa_enplm)]").size());
+    stream.finish();
+    if (stream.results() != 4 || stream.analyze().conflicts.size() != 3) {
+        throw std::runtime_error("Unterminated last line not analyzed at the end");
+    }
+
+    std::cout << "✓ Feed test passed\n";
+}
+
+void testMultiLineResults() {
+    mi::StreamingAnalyzer stream(mi::InferenceConfiguration::getInstance().current(), 2);
+
+    // A result spanning lines is parsed once all its brackets are closed
+    std::string output = "[(conflict not_opt soa_elam),\n (conflict not_opt soa_enplm)]\n";
+    for (char c : output) {
+        stream.feed(std::string_view(&c, 1));
+        if (c == ',' && stream.results() != 0) {
+            throw std::runtime_error("Unfinished result counted");
+        }
+    }
+    stream.finish();
+    auto plain = mi::SemanticAnalyzer(mi::InferenceConfiguration::getInstance().current()).analyze(output);
+    if (stream.results() != 1 || !stream.wellFormed() ||
+        stream.analyze().conflicts.size() != plain.conflicts.size() || plain.conflicts.size() != 2) {
+        throw std::runtime_error("Multi-line result not analyzed as a whole");
+    }
+
+    // Output SemanticAnalyzer parses line by line is reported
+    mi::StreamingAnalyzer stray(mi::InferenceConfiguration::getInstance().current());
+    stray.feed("error: unexpected )\n[()]\n");
+    stray.finish();
+    mi::StreamingAnalyzer unclosed(mi::InferenceConfiguration::getInstance().current());
+    unclosed.feed("[(conflict not_opt\n");
+    unclosed.finish();
+    if (stray.wellFormed() || unclosed.wellFormed()) {
+        throw std::runtime_error("Malformed output not reported");
+    }
+
+    std::cout << "✓ Multi-line results test passed\n";
+}
+
+void testCountQueries() {
+    std::string program = "; !(commented out)\n"
+                          "(= (rule $x) (! $x))\n"
+                          "!(match &self (conflict $a $b) ($a $b))\n"
+                          "! (violation)\n";
+    if (mi::StreamingAnalyzer::countQueries(program) != 2) {
+        throw std::runtime_error("Queries miscounted");
+    }
+    std::cout << "✓ Count queries test passed\n";
+}
+
+void testWatchForFindings() {
+    mi::StreamingAnalyzer stream(mi::InferenceConfiguration::getInstance().current());
+    stream.feed("[(conflict not_opt soa_elam)]\n");
+    assert(!stream.foundFinding());  // Not watched yet
+
+    stream.watchForFindings();
+    stream.feed("[()]\n[(soa_elam)]\n");
+    if (stream.foundFinding()) {
+        throw std::runtime_error("Finding reported for results without one");
+    }
+    stream.feed("[(conflict not_opt");
+    assert(!stream.foundFinding());  // Line not complete yet
+    stream.feed(" soa_elam)]\n");
+    if (!stream.foundFinding()) {
+        throw std::runtime_error("Conflict not noticed");
+    }
+
+    // Within a result printed over several lines
+    mi::StreamingAnalyzer multiLine(mi::InferenceConfiguration::getInstance().current());
+    multiLine.watchForFindings();
+    multiLine.feed("[(soa_elam),\n");
+    multiLine.feed(" (conflict not_opt soa_elam)]\n");
+    if (!multiLine.foundFinding()) {
+        throw std::runtime_error("Conflict in a multi-line result not noticed");
+    }
+
+    std::cout << "✓ Watch for findings test passed\n";
+}
+
+void testExecutorDeadline() {
+    std::string observed;
+    auto start = std::chrono::steady_clock::now();
+    auto result = mi::ProcessExecutor::execute(SLOW_OUTPUT, 10s, {},
+                                               [&](std::string_view chunk) {
+                                                   observed.append(chunk);
+                                                   return true;
+                                               },
+                                               start + 300ms);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!result.stoppedEarly || result.exitCode != -1 || elapsed > 5s) {
+        throw std::runtime_error("Command not stopped at its deadline");
+    }
+    if (result.output.rfind("[(conflict not_opt soa_elam)]\n", 0) != 0 || observed != result.output) {
+        throw std::runtime_error("Output before the deadline lost");
+    }
+
+    // Finishing in time is unaffected
+    auto quick = mi::ProcessExecutor::execute("echo done", 10s, {}, {}, std::chrono::steady_clock::now() + 5s);
+    assert(!quick.stoppedEarly && quick.exitCode == 0 && quick.output == "done\n");
+
+    std::cout << "✓ Executor deadline test passed\n";
+}
+
+void testObserverStops() {
+    // Stopped by its observer, without any deadline
+    auto start = std::chrono::steady_clock::now();
+    auto result = mi::ProcessExecutor::execute("echo first; sleep 30", 10s, {},
+                                               [](std::string_view) { return false; });
+    if (!result.stoppedEarly || result.output != "first\n" || std::chrono::steady_clock::now() - start > 5s) {
+        throw std::runtime_error("Executor not stopped by its observer");
+    }
+
+    mi::ProcessReactor reactor(1);
+    std::promise<mi::ProcessExecutor::ExecutionResult> promise;
+    auto future = promise.get_future();
+    reactor.submit("echo first; sleep 30", 10s, [&promise](mi::ProcessExecutor::ExecutionResult&& result,
+                                                           std::exception_ptr) {
+        promise.set_value(std::move(result));
+    }, {}, [](std::string_view) { return false; });
+    auto reacted = future.get();
+    if (!reacted.stoppedEarly || reacted.output != "first\n") {
+        throw std::runtime_error("Reactor command not stopped by its observer");
+    }
+
+    std::cout << "✓ Observer stops test passed\n";
+}
+
+void testReactorDeadline() {
+    mi::ProcessReactor reactor(1);
+    auto promise = std::make_shared<std::promise<mi::ProcessExecutor::ExecutionResult>>();
+    auto future = promise->get_future();
+    auto observed = std::make_shared<std::string>();
+
+    auto start = std::chrono::steady_clock::now();
+    reactor.submit(SLOW_OUTPUT, 10s, [promise](mi::ProcessExecutor::ExecutionResult&& result,
+                                               std::exception_ptr error) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(std::move(result));
+        }
+    }, {}, [observed](std::string_view chunk) {
+        observed->append(chunk);
+        return true;
+    }, start + 300ms);
+
+    auto result = future.get();
+    if (!result.stoppedEarly || std::chrono::steady_clock::now() - start > 5s) {
+        throw std::runtime_error("Reactor did not stop the command at its deadline");
+    }
+    if (*observed != result.output || result.output.find("soa_elam") == std::string::npos) {
+        throw std::runtime_error("Reactor lost output before the deadline");
+    }
+
+    std::cout << "✓ Reactor deadline test passed\n";
+}
+
+void testEngineDeadline() {
+    FakeRepl repl("streaming_test", SLOW_OUTPUT);
+    auto config = repl.config();
+
+    fs::path example = repl.root / "example.metta";
+    std::ofstream(example) << "!(first)\n!(second)\n!(third)\n!(fourth)\n";
+
+    config.outputFormat = mi::OutputFormat::JSON;
+    config.deadline = std::chrono::steady_clock::now() + 300ms;
+    auto engine = mi::createInferenceEngineV2(config);
+    auto result = engine->run(example);
+
+    if (!result.metrics.partial || result.metrics.coverage != 0.25 || result.metrics.conflicts != 1) {
+        throw std::runtime_error("Partial result not reported");
+    }
+    if (result.formattedOutput.find("\"partial\": true") == std::string::npos ||
+        result.formattedOutput.find("\"coverage\": 0.250") == std::string::npos) {
+        throw std::runtime_error("Report not marked as partial");
+    }
+
+    std::cout << "✓ Engine deadline test passed\n";
+}
+
+void testEngineStopOnFirst() {
+    FakeRepl repl("stop_first_test", "printf '[()]\\n[(conflict not_opt soa_elam)]\\n' ; sleep 30");
+    auto config = repl.config();
+
+    fs::path example = repl.root / "example.metta";
+    std::ofstream(example) << "!(first)\n!(second)\n!(third)\n!(fourth)\n";
+
+    config.stopOnFirst = true;
+    auto start = std::chrono::steady_clock::now();
+    auto engine = mi::createInferenceEngineV2(config);
+    auto result = engine->run(example);
+
+    if (std::chrono::steady_clock::now() - start > 5s) {
+        throw std::runtime_error("Run not stopped at its first finding");
+    }
+    if (!result.metrics.partial || result.metrics.coverage != 0.5 || result.metrics.conflicts != 1) {
+        throw std::runtime_error("Stopped run not reported as partial");
+    }
+
+    std::cout << "✓ Engine stop on first test passed\n";
+}
+
+// Metrics of one run with config adjusted by configure, on a fresh engine
+mi::Metrics runWith(const std::string& script, const std::function<void(mi::Config&)>& configure) {
+    FakeRepl repl("streamed_test", script);
+    auto config = repl.config();
+    fs::path example = repl.root / "example.metta";
+    std::ofstream(example) << "!(first)\n!(second)\n!(third)\n";
+    configure(config);
+
+    auto result = mi::createInferenceEngineV2(config)->run(example);
+    return std::move(result.metrics);
+}
+
+bool sameCounts(const mi::Metrics& a, const mi::Metrics& b) {
+    return a.contradictions == b.contradictions && a.conflicts == b.conflicts &&
+           a.violations == b.violations && a.compliances == b.compliances &&
+           a.inferredFacts == b.inferredFacts && a.partial == b.partial && a.coverage == b.coverage;
+}
+
+void testStreamedRunMatchesPlainRun() {
+    // Finishes well before its deadline; the last line has no newline
+    const char* script = "printf '[(conflict not_opt soa_elam)]\\n[()]\\n[(conflict not_opt soa_enplm)]'";
+    auto plain = runWith(script, [](mi::Config&) {});
+    auto streamed = runWith(script, [](mi::Config& config) {
+        config.deadline = std::chrono::steady_clock::now() + 30s;
+    });
+    if (plain.conflicts != 2 || !sameCounts(plain, streamed)) {
+        throw std::runtime_error("Streamed analysis differs from the plain one");
+    }
+
+    std::cout << "✓ Streamed run matches plain run test passed\n";
+}
+
+void testStreamedMultiLineMatchesPlainRun() {
+    const char* script = "printf '[(conflict not_opt soa_elam),\\n (conflict not_opt soa_enplm)]\\n[()]\\n'";
+    auto plain = runWith(script, [](mi::Config&) {});
+    auto streamed = runWith(script, [](mi::Config& config) {
+        config.deadline = std::chrono::steady_clock::now() + 30s;
+    });
+    if (plain.conflicts != 2 || !sameCounts(plain, streamed)) {
+        throw std::runtime_error("Streamed analysis of a multi-line result differs from the plain one");
+    }
+
+    // Unbalanced output gets SemanticAnalyzer's line-by-line fallback either way
+    const char* stray = "printf '[(conflict not_opt soa_elam)]\\n)\\n[(conflict not_opt soa_enplm)]\\n'";
+    plain = runWith(stray, [](mi::Config&) {});
+    streamed = runWith(stray, [](mi::Config& config) {
+        config.deadline = std::chrono::steady_clock::now() + 30s;
+    });
+    if (plain.conflicts != 2 || !sameCounts(plain, streamed)) {
+        throw std::runtime_error("Streamed analysis of malformed output differs from the plain one");
+    }
+
+    std::cout << "✓ Streamed multi-line run matches plain run test passed\n";
+}
+
+void testStopOnFirstWithoutFinding() {
+    // Nothing to stop at, so the run completes and its streamed analysis is
+    // the result, not a partial one
+    const char* script = "printf '[()]\\n[(soa_elam)]\\n[()]\\n'";
+    auto plain = runWith(script, [](mi::Config&) {});
+    auto watched = runWith(script, [](mi::Config& config) {
+        config.stopOnFirst = true;
+    });
+    if (watched.partial || !sameCounts(plain, watched)) {
+        throw std::runtime_error("Completed stop-on-first run analyzed differently");
+    }
+
+    std::cout << "✓ Stop on first without finding test passed\n";
+}
+
+void testStopOnFirstInMultiLineResult() {
+    const char* script = "printf '[()]\\n[(soa_elam),\\n (conflict not_opt soa_elam)]\\n' ; sleep 30";
+    auto start = std::chrono::steady_clock::now();
+    auto stopped = runWith(script, [](mi::Config& config) {
+        config.stopOnFirst = true;
+    });
+    if (std::chrono::steady_clock::now() - start > 5s || !stopped.partial || stopped.conflicts != 1) {
+        throw std::runtime_error("Run not stopped at a finding in a multi-line result");
+    }
+
+    // Completed with malformed output: the plain analysis, not the stream's
+    const char* stray = "printf '[(soa_elam)]\\n)\\n[(conflict not_opt soa_enplm)]'";
+    auto plain = runWith(stray, [](mi::Config&) {});
+    auto watched = runWith(stray, [](mi::Config& config) {
+        config.stopOnFirst = true;
+    });
+    if (!sameCounts(plain, watched)) {
+        throw std::runtime_error("Completed stop-on-first run analyzed differently");
+    }
+
+    std::cout << "✓ Stop on first in multi-line result test passed\n";
+}
+
+int main() {
+    try {
+        std::cout << "Running streaming analyzer tests...\n";
+
+        testFeed();
+        testMultiLineResults();
+        testCountQueries();
+        testWatchForFindings();
+        testExecutorDeadline();
+        testObserverStops();
+        testReactorDeadline();
+        testEngineDeadline();
+        testStreamedRunMatchesPlainRun();
+        testStreamedMultiLineMatchesPlainRun();
+        testEngineStopOnFirst();
+        testStopOnFirstWithoutFinding();
+        testStopOnFirstInMultiLineResult();
+
+        std::cout << "\nAll tests passed! ✅\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << "\n";
+        return 1;
+    }
+}